@@ -0,0 +1,133 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <CubismFramework.hpp>
+#include <ICubismModelSetting.hpp>
+#include <QElapsedTimer>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "LAppTextureManager.hpp"
+#include "LAppFileView.hpp"
+
+class QObject;
+class QThreadPool;
+
+/**
+ * @brief ワーカースレッドで準備済みのモデル資源
+ *        在工作线程中准备好的模型资源：model3.json的解析结果、引用文件的内容和解码后的贴图。
+ *        GL相关的处理（渲染器创建、贴图上传）留给GL线程。
+ */
+struct LAppModelAssets
+{
+    LAppModelAssets() = default;
+    ~LAppModelAssets();
+
+    /**
+     * @brief 預かったファイルの内容を取得する
+     *
+     * @param[in]   path    モデルディレクトリを含むファイルパス
+     * @return      読み込み済みならそのビュー、なければNULL
+     */
+    const LAppFileView* FindFile(const std::string& path) const;
+
+    std::string dir;                                        ///< model3.jsonが置かれたディレクトリ
+    std::string fileName;                                   ///< model3.jsonのファイル名
+    Csm::ICubismModelSetting* setting = nullptr;            ///< 解析済みの設定。LAppModelに渡したらNULLにする
+    std::unordered_map<std::string, std::shared_ptr<LAppFileView>> files;  ///< ファイルパス → 内容（moc3、表情、物理演算、ポーズ、モーション等）
+    std::vector<LAppTextureManager::DecodedImage> images;   ///< テクスチャ番号順のデコード済み画像。ファイル名が空の番号は空のまま
+    bool succeeded = false;                                 ///< model3.jsonとmoc3が読めたか
+    double loadSeconds = 0.0;                               ///< 読み込み開始から全画像デコード完了まで
+
+private:
+    LAppModelAssets(const LAppModelAssets&) = delete;
+    LAppModelAssets& operator=(const LAppModelAssets&) = delete;
+};
+
+/**
+ * @brief モデル資源のバックグラウンド読み込み
+ *        模型资源的后台加载器。
+ *
+ * ファイル読み込み、model3.jsonの解析はワーカーで、PNGのデコード（とプリマルチプライ）は
+ * テクスチャごとに並列で行う。完了通知はメインスレッドで呼ばれる。
+ * 同じモデルの読み込みが進行中または完了済みで未取得の場合は、それを再利用する。
+ *
+ * モデルバンドル（LAppModelBundle）があればディレクトリの代わりにそれを使う。
+ *
+ * 文件读取和model3.json解析在工作线程中进行，PNG解码（及预乘）按贴图并行执行，
+ * 完成回调在主线程调用。Cubism的ID管理器不是线程安全的，所以Moc、动作、表情对象的
+ * 构建仍在主线程从内存中完成。
+ */
+class LAppAssetLoader
+{
+public:
+    using Callback = std::function<void(const std::shared_ptr<LAppModelAssets>& assets)>;
+
+    /**
+    * @brief   クラスのインスタンス（シングルトン）を返す。
+    */
+    static LAppAssetLoader* GetInstance();
+
+    /**
+    * @brief   クラスのインスタンス（シングルトン）を解放する。進行中の読み込みの完了を待つ。
+    */
+    static void ReleaseInstance();
+
+    /**
+     * @brief 先行読み込みを開始する
+     *        提前开始加载，结果保留到Take取走为止。CubismFramework::StartUp之后才能调用。
+     *
+     * @param[in]   dir         model3.jsonが置かれたディレクトリ（末尾に/を含む）
+     * @param[in]   fileName    model3.jsonのファイル名
+     * @param[in]   onFinished  読み込み完了時にメインスレッドで呼ばれる（結果は取得しない）
+     */
+    void Preload(const std::string& dir, const std::string& fileName, const std::function<void(bool)>& onFinished = nullptr);
+
+    /**
+     * @brief 読み込み結果を取得する
+     *        取得加载结果；尚未开始时开始加载。callback在主线程调用。
+     *        结果只交给一个调用方：加载中重复调用时，只有最后一次的callback会被调用。
+     */
+    void Take(const std::string& dir, const std::string& fileName, const Callback& callback);
+
+    /**
+     * @brief モデルバンドルがあればそこから資源を準備する（同期、どのスレッドからでも呼べる）
+     *        有打包文件时从中准备资源：无压缩的段直接指向映射，预解码的贴图不再解码。
+     *
+     * @param[in,out]   assets  dirとfileNameを設定して渡す
+     * @return          バンドルが無い、または壊れている場合はfalse（assetsは変更しない）
+     */
+    static bool LoadFromBundle(LAppModelAssets& assets);
+
+private:
+    struct Request
+    {
+        std::shared_ptr<LAppModelAssets> assets;
+        std::atomic_int pendingImages{0};
+        QElapsedTimer timer;
+        bool finished = false;                              ///< メインスレッドでのみ参照
+        Callback taker;                                     ///< 最後にTakeした呼び出し側。メインスレッドでのみ参照
+        std::vector<std::function<void(bool)>> observers;   ///< メインスレッドでのみ参照
+    };
+
+    LAppAssetLoader();
+    ~LAppAssetLoader();
+
+    std::shared_ptr<Request> Start(const std::string& dir, const std::string& fileName);
+    void LoadFiles(const std::shared_ptr<Request>& request);
+    void DecodeImage(const std::shared_ptr<Request>& request, size_t index, const std::string& path);
+    void Finish(const std::string& key, const std::shared_ptr<Request>& request);
+
+    QThreadPool* _pool;
+    QObject* _receiver;     ///< 完了通知を受けるメインスレッドのオブジェクト。破棄後に届いた通知は捨てられる
+    std::unordered_map<std::string, std::shared_ptr<Request>> _requests;   ///< キーはdir + fileName。メインスレッドでのみ参照
+};
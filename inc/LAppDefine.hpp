@@ -53,6 +53,11 @@ namespace LAppDefine {
     extern const csmInt32 PriorityNormal;           ///< モーションの優先度定数: 2
     extern const csmInt32 PriorityForce;            ///< モーションの優先度定数: 3
 
+    extern const csmSizeInt MotionCacheBudget;      ///< 再生時に読み込んだモーションを保持するメモリ上限（バイト） 按需加载的动作缓存上限
+    extern const csmInt32 ModelWarmPoolSize;        ///< 切り替え後も保持しておく直前のモデル数 切换后保留的模型数
+    extern const csmSizeInt TextureMemoryBudget;    ///< テクスチャのGPUメモリ予算（バイト） 超出时释放未被引用的贴图
+    extern const csmBool SimulationThreadEnable;    ///< モデルの更新を描画と別スレッドで行うか 模型更新与绘制是否分线程
+
                                                     // デバッグ用ログの表示
     extern const csmBool DebugLogEnable;            ///< デバッグ用ログ表示の有効・無効 调试用日志显示的启用/禁用
     extern const csmBool DebugTouchLogEnable;       ///< タッチ処理のデバッグ用ログ表示の有効・無効
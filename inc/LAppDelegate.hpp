@@ -39,6 +39,21 @@ public:
     */
     bool Initialize(GLWidget *window);
 
+    /**
+    * @brief   ウィンドウなしで初期化する。呼び出し側で作成したGLコンテキストと描画先を有効にしてから呼ぶ。
+    *          无头渲染（基准测试、截图）用，GetWindow()返回nullptr。
+    *
+    * @param[in]   width   描画先の幅
+    * @param[in]   height  描画先の高さ
+    */
+    bool InitializeOffscreen(int width, int height);
+
+    /**
+    * @brief   Cubism SDK を起動する。GLコンテキストを必要としないため、<br>
+    *           ウィンドウ生成前に呼び出してもよい。二回目以降の呼び出しは何もしない。
+    */
+    void StartUpCubism();
+
     /**
     * @brief   解放する。
     */
@@ -88,6 +103,13 @@ public:
     */
     GLWidget *GetWindow() { return _window; }
 
+    /**
+    * @brief   描画先のサイズを取得する。ウィンドウがある場合はresizeで追従する。
+    */
+    int GetWindowWidth() const { return _windowWidth; }
+
+    int GetWindowHeight() const { return _windowHeight; }
+
     /**
     * @brief   View情報を取得する。
     */
@@ -107,6 +129,12 @@ public:
 
     void SetAlpha(float alpha) { _alpha = alpha; }
 
+    /**
+    * @brief   モデルが動き始めたことをウィンドウに知らせ、高フレームレートに戻す
+    *          拖动、口型、动作等事件调用，任意线程可调用
+    */
+    void NotifyActivity();
+
 private:
     /**
     * @brief   コンストラクタ
@@ -123,6 +151,11 @@ private:
     */
     void InitializeCubism();
 
+    /**
+    * @brief   GLの初期設定、View、Cubism SDKの初期化。ウィンドウの有無によらず共通
+    */
+    bool InitializeRendering(int width, int height);
+
     /**
      * @brief   CreateShader内部関数 エラーチェック
      */
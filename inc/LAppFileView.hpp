@@ -0,0 +1,88 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <CubismFramework.hpp>
+#include <memory>
+#include <string>
+
+/**
+ * @brief 読み取り専用のファイルビュー
+ *        文件内容的只读视图：大文件用 mmap / MapViewOfFile 映射，不再复制到堆上；
+ *        小文件或映射失败时退回到一次性读取。
+ *
+ * 先頭アドレスは常にcsmAlignofMoc（64バイト）以上にアラインされるので、moc3もそのまま渡せる。
+ * 寿命はshared_ptrで管理し、最後の参照が外れたときにアンマップ／解放する。
+ * 映射使用写时复制（MAP_PRIVATE / FILE_MAP_COPY），调用方即使写入也不会改动磁盘上的文件。
+ */
+class LAppFileView
+{
+public:
+    static const Csm::csmSizeInt MapThreshold = 64 * 1024;   ///< これ未満のファイルは読み込みで済ませる
+    static const Csm::csmSizeInt DataAlignment = 64;         ///< 読み込み時の先頭アラインメント（csmAlignofMoc）
+
+    /**
+     * @brief ファイルを開く
+     *
+     * @param[in]   filePath    ファイルパス（UTF-8）
+     * @return      失敗時はnullptr
+     */
+    static std::shared_ptr<LAppFileView> Open(const std::string& filePath);
+
+    /**
+     * @brief 通常ファイルが存在するか
+     */
+    static bool Exists(const std::string& filePath);
+
+    /**
+     * @brief 既存のビューの一部を指すビューを作る（バンドル内のセクション用）
+     *        元のビューは参照が残る限り解放されない。アラインメントはoffsetに依存する
+     *
+     * @return      範囲外ならnullptr
+     */
+    static std::shared_ptr<LAppFileView> CreateSlice(const std::shared_ptr<LAppFileView>& parent, Csm::csmSizeInt offset, Csm::csmSizeInt size);
+
+    /**
+     * @brief 書き込み可能なアライン済みバッファを確保する（展開先などに使う）
+     */
+    static std::shared_ptr<LAppFileView> Allocate(Csm::csmSizeInt size);
+
+    /**
+     * @brief メモリマッピングの有効・無効を切り替える（ベンチマーク用、既定は有効）
+     */
+    static void SetMappingEnabled(bool enabled);
+
+    ~LAppFileView();
+
+    const Csm::csmByte* GetData() const { return _data; }
+    Csm::csmByte* GetWritableData() { return _data; }    ///< Allocateしたバッファ、または書き込み時コピーのマッピング
+    Csm::csmSizeInt GetSize() const { return _size; }
+
+    /**
+     * @brief メモリマッピングされているか（falseなら読み込んだヒープ上のコピー）
+     */
+    bool IsMapped() const { return _mapped; }
+
+private:
+    LAppFileView();
+    LAppFileView(const LAppFileView&) = delete;
+    LAppFileView& operator=(const LAppFileView&) = delete;
+
+    bool Map(const std::string& filePath, Csm::csmSizeInt size);
+    bool Read(const std::string& filePath, Csm::csmSizeInt size);
+    void AllocateBuffer(Csm::csmSizeInt size);
+
+    Csm::csmByte* _data;
+    Csm::csmSizeInt _size;
+    bool _mapped;
+    Csm::csmByte* _buffer;      ///< 読み込み時に確保した領域（アライン前の先頭）
+    std::shared_ptr<LAppFileView> _parent;  ///< スライスの場合の元のビュー
+#ifdef _WIN32
+    void* _mapping;             ///< CreateFileMappingのハンドル
+#endif
+};
@@ -11,18 +11,42 @@
 #include <Math/CubismMatrix44.hpp>
 #include <Type/csmVector.hpp>
 #include <QByteArray>
+#include <QString>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 class LAppModel;
+struct LAppModelAssets;
 
 /**
 * @brief サンプルアプリケーションにおいてCubismModelを管理するクラス<br>
 *         モデル生成と破棄、タップイベントの処理、モデル切り替えを行う。
 *
+* LAppDefine::SimulationThreadEnableが有効な場合、モデルの更新（モーション・表情・まばたき・呼吸・物理演算）は
+* シミュレーションスレッドで行い、OnUpdateは最新のスナップショットを描くだけにする。
+* 描画後に次の更新を要求するので、更新は描画と同じ頻度で一フレーム先を進む。
+* モデルの状態を変更する処理はシミュレーションの合間に行う必要があるため、このクラスの公開関数は内部でロックを取る。
+* GetModelで得たモデルを直接操作する場合はLockSimulationでロックを保持すること。
 */
 class LAppLive2DManager
 {
 
 public:
+    /**
+    * @brief   モデル切り替えの完了通知。描画中（GLコンテキストが有効な状態）に呼ばれる
+    *          在绘制过程中调用，调整窗口等操作请放回事件循环。
+    */
+    typedef std::function<void(bool success)> SceneChangedCallback;
+
     /**
     * @brief   クラスのインスタンス（シングルトン）を返す。<br>
     *           インスタンスが生成されていない場合は内部でインスタンを生成する。
@@ -45,6 +69,27 @@ public:
     */
     LAppModel* GetModel(Csm::csmUint32 no) const;
 
+    /**
+    * @brief   モデルの状態を外部から変更する間、シミュレーションを止めておくロックを取得する
+    *          通过GetModel直接调用SetExpression、StartMotion等时持有。最多等待一次更新的时间
+    *
+    * @return  保持している間シミュレーションスレッドはモデルを更新しない
+    */
+    std::unique_lock<std::mutex> LockSimulation();
+
+    /**
+    * @brief   モデルの更新をシミュレーションスレッドで行うかを切り替える
+    *          基准测试等需要逐帧同步更新时关闭。GLコンテキストが有効なスレッドから呼ぶ
+    *
+    * @param[in]   threaded    trueならシミュレーションスレッドで更新する
+    */
+    void SetSimulationThreaded(bool threaded);
+
+    /**
+    * @brief   モデルの更新をシミュレーションスレッドで行っているか
+    */
+    bool IsSimulationThreaded() const { return _simulationThread.joinable(); }
+
     /**
     * @brief   現在のシーンで保持しているすべてのモデルを解放する 释放当前场景中所持有的所有模型。
     *
@@ -57,7 +102,7 @@ public:
     * @param[in]   x   画面のX座標
     * @param[in]   y   画面のY座標
     */
-    void OnDrag(Csm::csmFloat32 x, Csm::csmFloat32 y) const;
+    void OnDrag(Csm::csmFloat32 x, Csm::csmFloat32 y);
 
     /**
     * @brief   画面をタップしたときの処理
@@ -71,7 +116,24 @@ public:
     * @brief   画面を更新するときの処理
     *          モデルの更新処理および描画処理を行う
     */
-    void OnUpdate() const;
+    void OnUpdate();
+
+    /**
+    * @brief   表示中のモデルが動いているか、切り替え中か
+    *          有非待机的活动或正在切换模型时返回true，用于选择帧率
+    */
+    bool IsActive() const;
+
+    /**
+    * @brief   直近のOnUpdateで全モデルの更新（モーション・物理演算など）にかかった時間[ns]
+    *          基准测试用。シミュレーションスレッド使用時は最後に完了した更新の時間（描画と並行して進む）
+    */
+    int64_t GetLastUpdateNs() const { return _lastUpdateNs.load(std::memory_order_relaxed); }
+
+    /**
+    * @brief   直近のOnUpdateで全モデルの描画命令の発行にかかった時間[ns]。GPUの完了は待たない
+    */
+    int64_t GetLastDrawNs() const { return _lastDrawNs; }
 
     /**
     * @brief   次のシーンに切り替える<br>
@@ -85,6 +147,23 @@ public:
     */
     bool ChangeScene(const QString &name);
 
+    /**
+    * @brief   シーンをバックグラウンド読み込みで切り替える<br>
+    *           文件读取和贴图解码在后台进行，完成后在下一帧构建模型，贴图逐帧上传；
+    *           上传期间继续绘制当前模型，全部就绪后在一帧内替换。最近换下的模型保留在预热池中，
+    *           切回时不需要重新加载。
+    *
+    * @param[in]   name        モデル名
+    * @param[in]   onChanged   切り替え完了時のコールバック。後続の要求で取り消された場合は呼ばれない。
+    *                          省略時は失敗を app_current_model_load_fail として上報する
+    */
+    void ChangeSceneAsync(const QString &name, SceneChangedCallback onChanged = nullptr);
+
+    /**
+    * @brief   モデル名からmodel3.jsonのディレクトリとファイル名を得る
+    */
+    static void GetModelFilePath(const QString &name, std::string &dir, std::string &fileName);
+
     /**
      * @brief   モデル個数を得る
      * @return  所持モデル個数
@@ -126,7 +205,92 @@ private:
     */
     virtual ~LAppLive2DManager();
 
+    /**
+    * @brief  読み込み済みの資源で切り替え先のモデルを構築する（GL線程で呼ぶ）
+    */
+    void AdoptPendingAssets();
+
+    /**
+    * @brief  切り替え先のモデルのテクスチャが揃っていれば現在のモデルと入れ替える
+    */
+    void SwapInIncomingModel();
+
+    /**
+    * @brief  切り替え要求の完了を通知する
+    */
+    void FinishSceneChange(bool success);
+
+    /**
+    * @brief  モデルを次の描画時に解放する（GLリソースはコンテキストが有効な間に解放する）
+    */
+    void RetireModel(LAppModel* model);
+
+    /**
+    * @brief  切り替え中のモデルと予熱池のモデルを解放待ちにする
+    */
+    void RetireInactiveModels();
+
+    /**
+    * @brief  解放待ちのモデルを解放する
+    */
+    void ReleaseRetiredModels();
+
+    /**
+    * @brief  描画ターゲットの設定
+    */
+    void SetupRenderTarget();
+
+    /**
+    * @brief  表示に加える前のモデルを描画できる状態にする
+    *         シミュレーションスレッド使用時は現在の状態を一度更新してスナップショットを発行・取り込み、
+    *         不使用時はスナップショットを外す
+    */
+    void PrimeModel(LAppModel* model);
+
+    /**
+    * @brief  シミュレーションスレッドを起動する
+    */
+    void StartSimulation();
+
+    /**
+    * @brief  シミュレーションスレッドを止めて終了を待つ
+    */
+    void StopSimulation();
+
+    /**
+    * @brief  シミュレーションスレッドの本体。要求が来るたびに溜まった経過時間だけ更新する
+    */
+    void SimulationLoop();
+
+    /**
+    * @brief  表示中の全モデルを更新してスナップショットを発行する（シミュレーションスレッド）
+    */
+    void SimulateModels(Csm::csmFloat32 deltaTimeSeconds);
+
+    /**
+    * @brief  次の更新を要求する。前の要求が未処理なら経過時間を足し込む
+    */
+    void RequestSimulation(Csm::csmFloat32 deltaTimeSeconds);
+
     Csm::CubismMatrix44*        _viewMatrix; ///< モデル描画に用いるView行列
     Csm::csmVector<LAppModel*>  _models; ///< 模型实例容器
+    std::shared_ptr<LAppModelAssets> _pendingAssets; ///< 读完、等待在下一帧构建的模型资源
+    Csm::csmUint32              _loadTicket; ///< 最新的切换请求编号，旧请求的结果直接丢弃
+    QString                     _currentName; ///< 表示中のモデル名
+    QString                     _incomingName; ///< 切り替え先のモデル名
+    LAppModel*                  _incomingModel; ///< 构建完成、贴图上传中的切换目标，就绪前不绘制
+    SceneChangedCallback        _onSceneChanged; ///< 当前切换请求的完成回调
+    std::list<std::pair<QString, LAppModel*>> _warmModels; ///< 最近换下的模型（预热池），先頭ほど新しい
+    std::vector<LAppModel*>     _retiredModels; ///< 下一帧释放的模型
+    std::atomic<int64_t>        _lastUpdateNs; ///< 直近のフレームの更新時間
+    int64_t                     _lastDrawNs; ///< 直近のフレームの描画命令の発行時間
+    std::mutex                  _simulationMutex; ///< 更新中と、_modelsやモデルの状態を変更する間に保持する
+    std::thread                 _simulationThread; ///< シミュレーションスレッド。未起動ならjoinable()がfalse
+    std::mutex                  _requestMutex; ///< 以下の要求の受け渡し用
+    std::condition_variable     _requestCondition;
+    bool                        _simulationRequested; ///< 未処理の更新要求がある
+    bool                        _simulationQuit; ///< シミュレーションスレッドの終了要求
+    Csm::csmFloat32             _pendingDeltaTime; ///< 未処理の要求の経過時間の合計[秒]
+    std::atomic<bool>           _simulationActive; ///< 直近の更新で待機以外の動きがあったか
     //Csm::csmInt32               _sceneIndex; ///< 表示するシーンのインデックス値
 };
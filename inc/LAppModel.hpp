@@ -10,10 +10,19 @@
 #include <CubismFramework.hpp>
 #include <Model/CubismUserModel.hpp>
 #include <ICubismModelSetting.hpp>
+#include <Motion/CubismMotion.hpp>
 #include <Type/csmRectF.hpp>
 #include <Rendering/OpenGL/CubismOffscreenSurface_OpenGLES2.hpp>
 #include "QByteArray"
 #include "LAppWavFileHandler.hpp"
+#include "LAppSnapshotMailbox.hpp"
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct LAppModelAssets;
 
 /**
  * @brief ユーザーが実際に使用するモデルの実装クラス<br>
@@ -23,6 +32,18 @@
 class LAppModel : public Csm::CubismUserModel
 {
 public:
+    /**
+     * @brief 再生時に読み込んだモーションのキャッシュの統計
+     */
+    struct MotionCacheStats
+    {
+        Csm::csmUint32 hits;        ///< キャッシュから再生した回数
+        Csm::csmUint32 misses;      ///< ファイルから読み込んだ回数
+        Csm::csmUint32 evictions;   ///< 上限を超えて解放した回数
+        Csm::csmInt32 count;        ///< 保持しているモーション数
+        Csm::csmSizeInt bytes;      ///< 保持しているモーションのメモリ量
+    };
+
     /**
      * @brief コンストラクタ
      */
@@ -40,6 +61,32 @@ public:
      */
     bool LoadAssets(const Csm::csmChar* dir, const  Csm::csmChar* fileName);
 
+    /**
+     * @brief バックグラウンドで読み込み済みの資源からモデルを生成する
+     * 用后台加载好的资源生成模型：只在内存中构建Cubism对象，不再读盘和解码。
+     * 贴图在之后每次Draw时上传一张，全部上传完成前不绘制。需要在GL线程调用。
+     */
+    bool LoadAssets(const std::shared_ptr<LAppModelAssets>& assets);
+
+    /**
+     * @brief テクスチャのアップロードまで完了して描画できる状態か
+     */
+    bool IsReady() const;
+
+    /**
+     * @brief 待機以外の動きがあるか。フレームレートの切り替えに使う
+     *        非待机动作、拖动或口型进行中时返回true，此时需要高帧率绘制。会在模拟线程调用
+     */
+    bool IsActive() const;
+
+    /**
+     * @brief デコード済みテクスチャを1枚ずつアップロードする。Drawから呼ばれるほか、
+     *        描画前のモデル（切り替え先）に対しても毎フレーム呼んで準備を進められる。需要在GL线程调用。
+     *
+     * @return すべてのテクスチャがアップロード済みならtrue
+     */
+    bool UploadPendingTextures();
+
     /**
      * @brief レンダラを再構築する
      *
@@ -52,6 +99,31 @@ public:
      */
     void Update();
 
+    /**
+     * @brief   経過時間を指定してモデルを更新する。シミュレーションスレッドから呼ぶ場合はこちら
+     *
+     * @param[in]  deltaTimeSeconds  前回の更新からの経過時間[秒]
+     */
+    void Update(Csm::csmFloat32 deltaTimeSeconds);
+
+    /**
+     * @brief   Update後の頂点・不透明度・描画順などをスナップショットとして発行する（シミュレーションスレッド）
+     */
+    void PublishSnapshot();
+
+    /**
+     * @brief   最新のスナップショットを描画に使うよう切り替える（描画スレッド）
+     *          以后Draw和HitTest读取快照，不再读取模拟线程正在更新的模型本体。
+     *
+     * @return  描画できるスナップショットがあればtrue
+     */
+    bool LatchSnapshot();
+
+    /**
+     * @brief   スナップショットの使用をやめ、モデル本体から描画する（同期更新に戻すとき）
+     */
+    void DetachSnapshot();
+
     /**
      * @brief   モデルを描画する処理。モデルを描画する空間のView-Projection行列を渡す。
      *
@@ -141,6 +213,11 @@ public:
      */
     void UpdateLipSyncFromPCM(const QByteArray &pcmData, int sampleRate);
 
+    /**
+     * @brief 再生時に読み込んだモーションのキャッシュの統計を返す
+     */
+    MotionCacheStats GetMotionCacheStats() const;
+
 protected:
     /**
      *  @brief  モデルを描画する処理。モデルを描画する空間のView-Projection行列を渡す。
@@ -148,6 +225,17 @@ protected:
      */
     void DoDraw();
 
+    /**
+     * @brief   モーションデータの読み込み。LAppMotionCacheを経由し、キャッシュがあればJSONの解析を省略する。
+     *
+     * @param[in]   buffer                      motion3.jsonが読み込まれているバッファ
+     * @param[in]   size                        バッファのサイズ
+     * @param[in]   name                        モーションの名前
+     * @param[in]   onFinishedMotionHandler     モーション再生終了時に呼び出されるコールバック関数
+     */
+    Csm::ACubismMotion* LoadMotion(const Csm::csmByte* buffer, Csm::csmSizeInt size, const Csm::csmChar* name,
+                                   Csm::ACubismMotion::FinishedMotionCallback onFinishedMotionHandler = NULL) override;
+
 private:
     /**
      * @brief model3.jsonからモデルを生成する。<br>
@@ -158,12 +246,28 @@ private:
      */
     bool SetupModel(Csm::ICubismModelSetting* setting);
 
+    /**
+     * @brief レンダラを生成し、このアプリでの描画設定を行う
+     *
+     */
+    void SetupRenderer();
+
     /**
      * @brief OpenGLのテクスチャユニットにテクスチャをロードする
      *
      */
     void SetupTextures();
 
+    /**
+     * @brief ファイルをバイトデータとして取得する。先読み済みの資源があればそれを返す
+     */
+    Csm::csmByte* CreateBuffer(const Csm::csmChar* path, Csm::csmSizeInt* size);
+
+    /**
+     * @brief CreateBufferで取得したバイトデータを解放する
+     */
+    void DeleteBuffer(Csm::csmByte* buffer, const Csm::csmChar* path = "");
+
     /**
      * @brief   モーションデータをグループ名から一括でロードする。<br>
      *           モーションデータの名前は内部でModelSettingから取得する。
@@ -172,6 +276,40 @@ private:
      */
     void PreloadMotionGroup(const Csm::csmChar* group);
 
+    /**
+     * @brief   モーションファイルを読み込み、model3.jsonのフェード時間とエフェクトIDを設定する
+     *
+     * @return  読み込んだモーション。失敗した場合はnullptr
+     */
+    Csm::CubismMotion* LoadMotionFile(const Csm::csmChar* group, Csm::csmInt32 no,
+                                      Csm::ACubismMotion::FinishedMotionCallback onFinishedMotionHandler);
+
+    /**
+     * @brief   先読みされていないモーションをキャッシュから取得する。無ければ読み込んでキャッシュに入れる
+     *
+     * @param[in]   name                        モーション名（例: TapBody_0）
+     * @param[in]   onFinishedMotionHandler     終了時のコールバック。キャッシュ済みのモーションにも付け直す
+     */
+    Csm::CubismMotion* AcquireCachedMotion(const Csm::csmChar* group, Csm::csmInt32 no, const std::string& name,
+                                           Csm::ACubismMotion::FinishedMotionCallback onFinishedMotionHandler);
+
+    /**
+     * @brief   キャッシュが上限を超えていれば、再生中でないものを使われていない順に解放する
+     */
+    void TrimMotionCache();
+
+    struct CachedMotion;
+
+    /**
+     * @brief   キャッシュしたモーションが再生キューに残っているか。キューから外れたハンドルはここで捨てる
+     */
+    bool IsMotionInUse(CachedMotion& entry) const;
+
+    /**
+     * @brief   キャッシュしたモーションをすべて解放する
+     */
+    void ReleaseMotionCache();
+
     /**
      * @brief   モーションデータをグループ名から一括で解放する。<br>
      *           モーションデータの名前は内部でModelSettingから取得する。
@@ -194,6 +332,13 @@ private:
     */
     void ReleaseExpressions();
 
+    /**
+    * @brief テクスチャの参照を返す
+    *
+    * 他のモデルが使っていなければ、テクスチャマネージャーの予算に従って削除される。
+    */
+    void ReleaseTextures();
+
     Csm::ICubismModelSetting* _modelSetting; ///< 模型设置信息
     Csm::csmString _modelHomeDir; ///< 模型设置所在的目录
     Csm::csmFloat32 _userTimeSeconds; ///< デルタ時間の積算値[秒]
@@ -201,6 +346,18 @@ private:
     Csm::csmVector<Csm::CubismIdHandle> _lipSyncIds; ///< モデルに設定されたリップシンク機能用パラメータID
     Csm::csmMap<Csm::csmString, Csm::ACubismMotion*>   _motions; ///< 読み込まれているモーションのリスト
     Csm::csmMap<Csm::csmString, Csm::ACubismMotion*>   _expressions; ///< 読み込まれている表情のリスト
+
+    struct CachedMotion
+    {
+        Csm::CubismMotion* motion;
+        Csm::csmSizeInt bytes;
+        std::vector<Csm::CubismMotionQueueEntryHandle> handles;    ///< このモーションで開始したキューエントリ（再生中は解放しない）
+        std::list<std::string>::iterator lruPosition;
+    };
+    std::unordered_map<std::string, CachedMotion> _motionCache; ///< 再生時に読み込んだモーション
+    std::list<std::string> _motionCacheLru; ///< キャッシュ内のモーション名。先頭ほど最近使われた
+    Csm::csmSizeInt _motionCacheBytes;
+    MotionCacheStats _motionCacheStats;
     Csm::csmVector<Csm::csmRectF> _hitArea;
     Csm::csmVector<Csm::csmRectF> _userArea;
     const Csm::CubismId* _idParamAngleX; ///< パラメータID: ParamAngleX
@@ -212,6 +369,12 @@ private:
 
     LAppWavFileHandler _wavFileHandler; ///< wavファイルハンドラ
 
+    std::shared_ptr<LAppModelAssets> _assets; ///< バックグラウンドで読み込んだ資源。テクスチャのアップロードが終わると解放する。_modelsに入る前に解放されるのでGLスレッドからしか触らない
+    Csm::csmInt32 _nextTextureIndex; ///< 次にアップロードするテクスチャ番号
+    Csm::csmVector<Csm::csmUint32> _textureIds; ///< 参照しているテクスチャID。デストラクタで参照を返す
+    Csm::csmBool _dragMoving; ///< 前回の更新でドラッグによる向きが変化したか
+    LAppSnapshotMailbox _snapshots; ///< シミュレーションスレッドから描画スレッドへの受け渡し
+
     Csm::Rendering::CubismOffscreenFrame_OpenGLES2  _renderBuffer;   ///< フレームバッファ以外の描画先
 };
 
@@ -0,0 +1,131 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "LAppFileView.hpp"
+
+/**
+ * @brief モデルバンドル（1ファイルにまとめたモデル）の読み込み
+ *        把一个模型目录打包成单个文件，启动时只打开/映射一次。
+ *
+ * レイアウト（リトルエンディアン）:
+ *   Header（64バイト） | Entry × entryCount（各64バイト） | パス文字列表 | セクション…
+ * 各セクションは64バイト境界に置かれるので、無圧縮のセクションはマッピングからそのまま使える。
+ *
+ * エントリの種類:
+ *   - File:    モデルディレクトリ内のファイル（model3.json、moc3、モーション等）の内容
+ *   - Texture: デコード済みRGBA8画像のミップマップチェーン（レベル0から順に連続して格納）
+ *
+ * セクションは個別に圧縮できる（Codec_Zlib、qCompress形式）。
+ * 作成は tools/ModelBundlePacker で行う。
+ */
+class LAppModelBundle
+{
+public:
+    static const uint32_t Version = 1;
+    static const uint32_t SectionAlignment = 64;
+
+    enum EntryType
+    {
+        EntryType_File = 0,
+        EntryType_Texture = 1,
+    };
+
+    enum Codec
+    {
+        Codec_None = 0,
+        Codec_Zlib = 1,     ///< 4バイトのビッグエンディアン展開後サイズ + zlibストリーム（qCompress形式）
+    };
+
+    enum TextureFlag
+    {
+        TextureFlag_Premultiplied = 1 << 0,     ///< プリマルチプライ済み
+    };
+
+    struct Header
+    {
+        char magic[8];              ///< "HMRBNDL\0"
+        uint32_t version;
+        uint32_t entryCount;
+        uint64_t indexOffset;       ///< Entry配列の位置
+        uint64_t stringsOffset;     ///< パス文字列表の位置
+        uint64_t stringsSize;
+        uint8_t reserved[24];
+    };
+
+    struct Entry
+    {
+        uint64_t offset;            ///< セクションの位置（64バイト境界）
+        uint64_t storedSize;        ///< 格納サイズ（圧縮後）
+        uint64_t rawSize;           ///< 展開後のサイズ
+        uint32_t pathOffset;        ///< パス文字列表内の位置（モデルディレクトリからの相対パス、UTF-8）
+        uint32_t pathLength;
+        uint16_t type;              ///< EntryType
+        uint16_t codec;             ///< Codec
+        uint32_t width;             ///< Texture: レベル0の横幅
+        uint32_t height;            ///< Texture: レベル0の高さ
+        uint32_t mipLevels;         ///< Texture: 格納されているレベル数
+        uint32_t flags;             ///< Texture: TextureFlag
+        uint8_t reserved[12];
+    };
+
+    static const char Magic[8];
+
+    /**
+     * @brief model3.jsonに対応するバンドルのパス（<モデル名>.bundle）
+     */
+    static std::string GetBundlePath(const std::string& dir, const std::string& modelFileName);
+
+    /**
+     * @brief バンドルを開いてインデックスを検証する
+     *
+     * @return      存在しない、または壊れている場合はnullptr
+     */
+    static std::shared_ptr<LAppModelBundle> Open(const std::string& path);
+
+    /**
+     * @brief エントリを探す
+     *
+     * @param[in]   path    モデルディレクトリからの相対パス
+     * @return      なければNULL
+     */
+    const Entry* Find(const std::string& path, EntryType type) const;
+
+    uint32_t GetEntryCount() const { return _header.entryCount; }
+    const Entry& GetEntry(uint32_t index) const { return _entries[index]; }
+    std::string GetPath(const Entry& entry) const;
+
+    /**
+     * @brief セクションの内容を取得する。無圧縮ならマッピングの一部をそのまま返し、圧縮されていれば展開する
+     *
+     * @return      展開に失敗した場合はnullptr
+     */
+    std::shared_ptr<LAppFileView> ReadSection(const Entry& entry) const;
+
+    /**
+     * @brief テクスチャのミップレベル0からlevelまでの合計バイト数
+     */
+    static uint64_t GetMipChainSize(uint32_t width, uint32_t height, uint32_t levels);
+
+private:
+    LAppModelBundle() = default;
+    LAppModelBundle(const LAppModelBundle&) = delete;
+    LAppModelBundle& operator=(const LAppModelBundle&) = delete;
+
+    bool Validate();
+
+    std::shared_ptr<LAppFileView> _file;
+    Header _header;
+    const Entry* _entries = nullptr;                        ///< マッピング上のEntry配列
+    const char* _strings = nullptr;
+    std::unordered_map<std::string, uint32_t> _index;       ///< 種類 + パス → エントリ番号
+};
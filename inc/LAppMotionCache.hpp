@@ -0,0 +1,66 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <Motion/CubismMotion.hpp>
+
+/**
+ * @brief モーションのバイナリキャッシュ
+ *        把解析后的motion3.json（曲线、段、控制点）以二进制形式缓存到磁盘，
+ *        再次加载时跳过JSON解析，只做一次映射和拷贝。
+ *
+ * キャッシュはJSONの内容のハッシュ（FNV-1a 64bit）とサイズ、バイナリ形式のバージョンで
+ * 識別するので、モーションファイルが書き換わると自動的に作り直される。
+ * 保存先は QStandardPaths::CacheLocation/motions/<key>.motion.bin。
+ * 読み込みに失敗したキャッシュは無視してJSONから解析し直し、上書きする。
+ *
+ * CubismIdManager がスレッドセーフでないため、CreateMotion はメインスレッドから呼ぶこと。
+ */
+class LAppMotionCache
+{
+public:
+    /**
+     * @brief motion3.jsonの内容からモーションを作成する。キャッシュがあればそれを使う。
+     *
+     * @param[in]   buffer                      motion3.jsonの内容
+     * @param[in]   size                        バッファのサイズ
+     * @param[in]   onFinishedMotionHandler     モーション再生終了時に呼び出されるコールバック関数
+     * @return      作成したモーション。失敗した場合はNULL
+     */
+    static Csm::CubismMotion* CreateMotion(const Csm::csmByte* buffer, Csm::csmSizeInt size,
+                                           Csm::ACubismMotion::FinishedMotionCallback onFinishedMotionHandler = NULL);
+
+    /**
+     * @brief キャッシュファイルのパスを返す（ディレクトリは作成しない）
+     */
+    static std::string GetCachePath(const Csm::csmByte* buffer, Csm::csmSizeInt size);
+
+    /**
+     * @brief キャッシュの使用を切り替える（ベンチマーク用、無効時は毎回JSONを解析する）
+     */
+    static void SetEnabled(bool enabled);
+
+    /**
+     * @brief キャッシュの保存先を変更する（空文字列で既定の場所に戻す）
+     */
+    static void SetCacheDirectory(const std::string& directory);
+
+    static uint32_t GetHitCount();
+    static uint32_t GetMissCount();
+
+    /**
+     * @brief 内容のハッシュ（FNV-1a 64bit）
+     */
+    static uint64_t HashContent(const Csm::csmByte* buffer, Csm::csmSizeInt size);
+
+private:
+    LAppMotionCache();
+};
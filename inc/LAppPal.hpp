@@ -22,11 +22,12 @@ public:
     /**
     * @brief 将文件读取为字节数据
     *
-    * ファイルをバイトデータとして読み込む
+    * ファイルをバイトデータとして読み込む。大きいファイルはメモリマッピングで返す（LAppFileView）。
+    * 返されるアドレスは64バイトにアラインされている。
     *
     * @param[in]   filePath    読み込み対象ファイルのパス
-    * @param[out]  outSize     ファイルサイズ
-    * @return                  バイトデータ
+    * @param[out]  outSize     ファイルサイズ（失敗時は0）
+    * @return                  バイトデータ。失敗時はNULL。ReleaseBytesで解放する
     */
     static Csm::csmByte* LoadFileAsBytes(std::string filePath, Csm::csmSizeInt* outSize);
 
@@ -34,7 +35,7 @@ public:
     /**
     * @brief 释放字节数据
     *
-    * バイトデータを解放する
+    * バイトデータを解放する。LoadFileAsBytesの戻り値以外を渡してはいけない
     *
     * @param[in]   byteData    解放したいバイトデータ
     */
@@ -50,6 +51,16 @@ public:
 
     static void UpdateTime();
 
+    /**
+    * @brief   固定のデルタ時間を設定する
+    *
+    * 0より大きい値を設定している間、UpdateTimeは実時間の代わりにこの値だけ時刻を進める。
+    * 无头渲染和基准测试用，每次运行得到相同的动画。
+    *
+    * @param[in]   seconds     1フレームの時間[秒]。0以下で実時間に戻す
+    */
+    static void SetFixedDeltaTime(double seconds);
+
     /**
     * @brief ログを出力する
     *
@@ -75,5 +86,6 @@ private:
     static double s_currentFrame;
     static double s_lastFrame;
     static double s_deltaTime;
+    static double s_fixedDeltaTime;
 };
 
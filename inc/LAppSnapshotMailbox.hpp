@@ -0,0 +1,58 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <Model/CubismDrawableSnapshot.hpp>
+#include <Model/CubismModel.hpp>
+
+/**
+ * @brief シミュレーションスレッドから描画スレッドへDrawableのスナップショットを受け渡す
+ *        三个槽轮换：写入槽归模拟线程，读取槽归绘制线程，中间的就绪槽用一次原子交换传递。
+ *        双方都不用等待对方：模拟线程总能写入下一帧，绘制线程总能拿到最新完成的一帧。
+ *
+ * 書き込み側がPublishを二回続けた場合、読まれなかった方は捨てられる。
+ * その間の変化フラグが失われないよう、Latchは通し番号が飛んでいればすべて変化したものとして扱う。
+ * Publish同士、Latch同士は同時に呼ばないこと（Publishを呼ぶスレッドが替わる場合はロックなどで前後関係を保証する）。
+ */
+class LAppSnapshotMailbox
+{
+public:
+    LAppSnapshotMailbox();
+
+    /**
+     * @brief モデルの現在の状態をスナップショットとして発行する（シミュレーションスレッド）
+     *
+     * @param[in]   model   Update済みのモデル
+     */
+    void Publish(const Csm::CubismModel& model);
+
+    /**
+     * @brief 最新のスナップショットを取り込む（描画スレッド）
+     *        新しいものが無ければ前回と同じものを返す。
+     *
+     * @return  描画に使うスナップショット。まだ一度も発行されていなければnullptr
+     */
+    const Csm::CubismDrawableSnapshot* Latch();
+
+private:
+    LAppSnapshotMailbox(const LAppSnapshotMailbox&) = delete;
+    LAppSnapshotMailbox& operator=(const LAppSnapshotMailbox&) = delete;
+
+    static const uint32_t SlotMask = 0x3;   ///< _readyの下位ビット：就绪槽的序号
+    static const uint32_t FreshBit = 0x4;   ///< 就绪槽发布后尚未被读取
+
+    Csm::CubismDrawableSnapshot _slots[3];
+    uint64_t                    _sequences[3]; ///< 各槽に書かれたスナップショットの通し番号
+    std::atomic<uint32_t>       _ready; ///< 就绪槽的序号和FreshBit
+    uint32_t                    _writeSlot; ///< 模拟线程独占
+    uint32_t                    _readSlot; ///< 绘制线程独占
+    uint64_t                    _publishedSequence; ///< 最後に発行した通し番号（模拟线程）
+    uint64_t                    _latchedSequence; ///< 最後に取り込んだ通し番号（绘制线程）、0は未取得
+};
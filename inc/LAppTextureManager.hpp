@@ -7,7 +7,11 @@
 
 #pragma once
 
+#include <list>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include <GL/glew.h>
 //#include <GLFW/glfw3.h>
 #include <Type/csmVector.hpp>
@@ -16,6 +20,9 @@
 * @brief テクスチャ管理クラス
 *
 * 画像読み込み、管理を行うクラス。
+* テクスチャはファイル名で共有され、参照数で管理する。参照が無くなったテクスチャはすぐには削除せず、
+* 合計サイズがメモリ予算を超えたときに使われていない順に削除する。
+* 贴图按文件名在模型之间共享并计数引用；不再被引用的贴图保留到超出预算时按LRU释放。
 */
 class LAppTextureManager
 {
@@ -30,6 +37,22 @@ public:
         int width;              ///< 横幅
         int height;             ///< 高さ
         std::string fileName;   ///< ファイル名
+        size_t memorySize;      ///< ミップマップを含むGPUメモリ使用量（バイト）
+        int referenceCount;     ///< 参照数。0のテクスチャは予算を超えると削除される
+    };
+
+    /**
+    * @brief デコード済み画像
+    *        已解码、尚未上传到GL的图像（RGBA8）
+    */
+    struct DecodedImage
+    {
+        std::string fileName;           ///< ファイル名
+        int width = 0;                  ///< 横幅
+        int height = 0;                 ///< 高さ
+        unsigned char* pixels = NULL;   ///< 画素データ。ReleaseDecodedImageで解放する
+        int mipLevels = 1;              ///< pixelsに連続して格納されたミップレベル数。1ならアップロード時に生成する
+        std::shared_ptr<void> owner;    ///< 設定されていればpixelsはこれが所有する（バンドルのマッピング等）
     };
 
     /**
@@ -54,7 +77,7 @@ public:
     *
     * @return プリマルチプライ処理後のカラー値
     */
-    inline unsigned int Premultiply(unsigned char red, unsigned char green, unsigned char blue, unsigned char alpha)
+    static inline unsigned int Premultiply(unsigned char red, unsigned char green, unsigned char blue, unsigned char alpha)
     {
         return static_cast<unsigned>(\
             (red * (alpha + 1) >> 8) | \
@@ -67,22 +90,57 @@ public:
     /**
     * @brief 画像読み込み
     *
+    * 読み込み済みならそれを返す。どちらの場合も参照数を1つ増やすので、
+    * 使い終わったらReleaseTextureを呼ぶ。
+    *
     * @param[in] fileName  読み込む画像ファイルパス名
     * @return 画像情報。読み込み失敗時はNULLを返す
     */
     TextureInfo* CreateTextureFromPngFile(std::string fileName);
 
+    /**
+    * @brief PNGの読み込みとデコード
+    *        读取并解码PNG（需要时做预乘），不调用GL，可在工作线程中执行
+    *
+    * @param[in]  fileName  読み込む画像ファイルパス名
+    * @param[out] image     デコード結果
+    * @return 成功した場合true
+    */
+    static bool DecodePngFile(const std::string& fileName, DecodedImage& image);
+
+    /**
+    * @brief メモリ上のPNGのデコード（DecodePngFileと同じ処理）
+    *
+    * @param[in]  fileName  画像の識別に使うファイルパス名
+    */
+    static bool DecodePngMemory(const std::string& fileName, const unsigned char* data, unsigned int size, DecodedImage& image);
+
+    /**
+    * @brief デコード済み画像の解放
+    */
+    static void ReleaseDecodedImage(DecodedImage& image);
+
+    /**
+    * @brief デコード済み画像からテクスチャを生成する
+    *        把已解码的图像上传为GL贴图，必须在GL线程调用；同名贴图已存在时直接返回。都会增加引用数
+    *
+    * @param[in] image  デコード済み画像。画素データは呼び出し後も呼び出し側が所有する
+    * @return 画像情報。失敗時はNULLを返す
+    */
+    TextureInfo* CreateTextureFromDecodedImage(const DecodedImage& image);
+
     /**
     * @brief 画像の解放
     *
-    * 配列に存在する画像全てを解放する
+    * 参照数に関わらず、管理している画像全てをGLから削除する
     */
     void ReleaseTextures();
 
     /**
      * @brief 画像の解放
      *
-     * 指定したテクスチャIDの画像を解放する
+     * 指定したテクスチャIDの参照を1つ減らす。0になったテクスチャは未使用として保持され、
+     * メモリ予算を超えた分から削除される
      * @param[in] textureId  解放するテクスチャID
      **/
     void ReleaseTexture(Csm::csmUint32 textureId);
@@ -90,7 +148,7 @@ public:
     /**
     * @brief 画像の解放
     *
-    * 指定した名前の画像を解放する
+    * 指定した名前の画像の参照を1つ減らす
     * @param[in] fileName  解放する画像ファイルパス名
     **/
     void ReleaseTexture(std::string fileName);
@@ -103,6 +161,68 @@ public:
      */
     TextureInfo* GetTextureInfoById(GLuint textureId) const;
 
+    /**
+     * @brief テクスチャメモリ予算の設定
+     *        超出预算时立即释放未被引用的贴图；0表示引用数归零即释放
+     *
+     * @param[in] bytes  予算（バイト）
+     */
+    void SetMemoryBudget(size_t bytes);
+
+    /**
+     * @brief テクスチャメモリ予算の取得
+     */
+    size_t GetMemoryBudget() const { return _memoryBudget; }
+
+    /**
+     * @brief 管理しているテクスチャの合計メモリ使用量（未使用分を含む）
+     */
+    size_t GetTotalMemorySize() const { return _totalMemorySize; }
+
+    /**
+     * @brief 参照されていないテクスチャのメモリ使用量
+     */
+    size_t GetUnusedMemorySize() const { return _unusedMemorySize; }
+
+    /**
+     * @brief テクスチャごとの統計
+     *        各贴图的尺寸、显存占用和引用数，按占用从大到小排列
+     *
+     * @param[out] stats  テクスチャ情報のコピー
+     */
+    void GetTextureStats(std::vector<TextureInfo>& stats) const;
+
 private:
-    Csm::csmVector<TextureInfo*> _textures;
+    struct TextureEntry
+    {
+        TextureInfo info;
+        std::list<GLuint>::iterator unusedPosition;  ///< 未使用リスト内の位置。referenceCountが0のときだけ有効
+    };
+
+    /**
+     * @brief 参照数を1つ増やす。未使用リストに入っていれば取り出す
+     */
+    TextureInfo* AcquireTexture(TextureEntry* entry);
+
+    /**
+     * @brief 参照数を1つ減らす。0になったら未使用リストの末尾に入れる
+     */
+    void ReleaseTextureEntry(TextureEntry* entry);
+
+    /**
+     * @brief 予算に収まるまで未使用のテクスチャを古い順に削除する
+     */
+    void TrimTextures();
+
+    /**
+     * @brief GLテクスチャを削除し、管理から外す
+     */
+    void DeleteTexture(TextureEntry* entry);
+
+    std::unordered_map<GLuint, TextureEntry*> _texturesById;          ///< テクスチャIDから
+    std::unordered_map<std::string, TextureEntry*> _texturesByName;   ///< ファイル名から
+    std::list<GLuint> _unusedTextures;  ///< 参照されていないテクスチャ。先頭ほど古い
+    size_t _memoryBudget;
+    size_t _totalMemorySize;
+    size_t _unusedMemorySize;
 };
@@ -0,0 +1,37 @@
+#ifndef AESCTR_H
+#define AESCTR_H
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief AES-128 CTR模式加解密（MQTT+UDP音频通道使用）
+ *
+ * CTR模式加密与解密是同一操作。计数器块即UDP包头中的16字节nonce，
+ * 按大端整体递增，与小智服务端/ESP32固件（mbedtls_aes_crypt_ctr）一致。
+ * 只依赖标准库，避免为一条音频通道引入OpenSSL。
+ */
+class AesCtr
+{
+public:
+    static const size_t kKeySize = 16;
+    static const size_t kBlockSize = 16;
+
+    AesCtr();
+    explicit AesCtr(const uint8_t key[kKeySize]);
+
+    void setKey(const uint8_t key[kKeySize]);
+    bool hasKey() const { return m_hasKey; }
+
+    // 以nonce为初始计数器，对data原地加/解密len字节
+    void apply(const uint8_t nonce[kBlockSize], uint8_t *data, size_t len) const;
+
+    // 单块AES-128加密
+    void encryptBlock(const uint8_t in[kBlockSize], uint8_t out[kBlockSize]) const;
+
+private:
+    uint8_t m_roundKeys[176];
+    bool m_hasKey;
+};
+
+#endif // AESCTR_H
@@ -0,0 +1,289 @@
+#include "AppStartup.h"
+#include "StartupPipeline.h"
+#include "MainWindow.h"
+#include "ResourceLoader.hpp"
+#include "SimpleActivationWindow.h"
+#include "DeskPetIntegration.h"
+#include "SystemInitializer.h"
+#include "ConfigManager.h"
+#include "LAppDelegate.hpp"
+#include "LAppLive2DManager.hpp"
+#include "LAppAssetLoader.hpp"
+#include <QApplication>
+#include <QMessageBox>
+#include <QOpenGLWidget>
+#include <QHostInfo>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QTimer>
+#include <QUrl>
+#include <QDebug>
+#include <memory>
+
+AppStartup::AppStartup(QApplication *app, bool skipActivation, QObject *parent)
+    : QObject(parent)
+    , m_app(app)
+    , m_skipActivation(skipActivation)
+    , m_pipeline(new StartupPipeline(this))
+    , m_initializer(nullptr)
+    , m_mainWindow(nullptr)
+    , m_integration(nullptr)
+    , m_integrationReady(false)
+{
+    connect(m_pipeline, &StartupPipeline::finished, this, &AppStartup::onPipelineFinished);
+    connect(m_pipeline, &StartupPipeline::failed, this, &AppStartup::onPipelineFailed);
+    buildPipeline();
+}
+
+AppStartup::~AppStartup()
+{
+    // DeskPetIntegration 以主窗口为父对象，随主窗口释放
+    delete m_mainWindow;
+}
+
+void AppStartup::start()
+{
+    qDebug() << "Starting startup pipeline...";
+    m_pipeline->start();
+}
+
+void AppStartup::buildPipeline()
+{
+    using Affinity = StartupPipeline::Affinity;
+
+    m_pipeline->addTask("config", {}, Affinity::MainThread, []() {
+        ConfigManager::getInstance()->initializeClientId();
+        return true;
+    });
+
+    // config.json解析和模型列表，只涉及文件读取
+    m_pipeline->addTask("resources", {}, Affinity::Worker, []() {
+        return resource_loader::get_instance().initialize();
+    });
+
+    m_pipeline->addTask("cubism_init", {}, Affinity::MainThread, []() {
+        LAppDelegate::GetInstance()->StartUpCubism();
+        return true;
+    });
+
+    // 在后台线程读取当前模型的文件、解析JSON并解码贴图，与OTA/激活并行；
+    // 首帧创建场景时直接取用结果，主线程只剩构建模型和上传贴图
+    m_pipeline->addAsyncTask("asset_preload", {"resources", "cubism_init"}, [](const std::function<void(bool)> &done) {
+        const auto *model = resource_loader::get_instance().get_current_model();
+        if (!model) {
+            done(true);
+            return;
+        }
+        std::string dir;
+        std::string fileName;
+        LAppLive2DManager::GetModelFilePath(model->name, dir, fileName);
+        // 加载失败不阻塞启动，场景创建时会上报模型加载失败
+        LAppAssetLoader::GetInstance()->Preload(dir, fileName, [done](bool) { done(true); });
+    });
+
+    m_pipeline->addAsyncTask("ota", {"config"}, [this](const std::function<void(bool)> &done) {
+        if (m_skipActivation) {
+            qDebug() << "Skipping activation process (debug mode)";
+            done(true);
+            return;
+        }
+        qDebug() << "Checking activation status...";
+        m_initializer = new SystemInitializer(this);
+        connect(m_initializer, &SystemInitializer::initializationFinished, this,
+                [this, done](const QJsonObject &result) {
+                    m_initResult = result;
+                    done(true);
+                });
+        // 启动使用了缓存时，后台刷新的结果在集成就绪后交给连接层
+        connect(m_initializer, &SystemInitializer::otaConfigRevalidated, this, [this](bool credentialsChanged) {
+            if (credentialsChanged && m_integrationReady) {
+                m_integration->reloadCredentials();
+            }
+        });
+        m_initializer->startInitialization();
+    });
+
+    // 用上次OTA下发的地址预解析，填充Qt的主机名缓存，连接时省去DNS往返
+    m_pipeline->addAsyncTask("dns_prewarm", {"config"}, [this](const std::function<void(bool)> &done) {
+        const QUrl url(ConfigManager::getInstance()->getConfig("SYSTEM_OPTIONS.NETWORK.WEBSOCKET_URL").toString());
+        if (url.host().isEmpty()) {
+            done(true);
+            return;
+        }
+        QHostInfo::lookupHost(url.host(), this, [done](const QHostInfo &info) {
+            qDebug() << "DNS prewarm" << info.hostName() << "->" << info.addresses().size() << "addresses";
+            done(true);
+        });
+    });
+
+    m_pipeline->addAsyncTask("activation", {"ota"}, [this](const std::function<void(bool)> &done) {
+        runActivation(done);
+    });
+
+    m_pipeline->addTask("main_window", {"resources", "cubism_init", "activation"}, Affinity::MainThread, [this]() {
+        return createMainWindow();
+    });
+
+    m_pipeline->addTask("integration", {"main_window"}, Affinity::MainThread, [this]() {
+        return initializeIntegration();
+    });
+
+    // 握手在窗口显示前发起，与首帧的模型加载重叠
+    m_pipeline->addTask("connect", {"integration"}, Affinity::MainThread, [this]() {
+        if (!m_integrationReady) {
+            return true;
+        }
+        qDebug() << "Attempting to connect to WebSocket server...";
+        if (m_integration->connectToServer()) {
+            qDebug() << "WebSocket connection request sent successfully";
+        } else {
+            qDebug() << "Failed to send WebSocket connection request";
+        }
+        return true;
+    });
+
+    // 显示窗口，首帧（含模型加载）交换完成后结束
+    m_pipeline->addAsyncTask("first_frame", {"connect"}, [this](const std::function<void(bool)> &done) {
+        m_mainWindow->show();
+        if (m_integrationReady) {
+            m_mainWindow->showWebSocketChatDialog();
+        }
+
+        QOpenGLWidget *glWidget = qobject_cast<QOpenGLWidget *>(m_mainWindow->centralWidget());
+        if (!glWidget) {
+            done(true);
+            return;
+        }
+        auto presented = std::make_shared<bool>(false);
+        auto connection = std::make_shared<QMetaObject::Connection>();
+        *connection = connect(glWidget, &QOpenGLWidget::frameSwapped, this, [presented, connection, done]() {
+            QObject::disconnect(*connection);
+            *presented = true;
+            done(true);
+        });
+        // 窗口被遮挡时可能迟迟不绘制，不让耗时报告无限等待
+        QTimer::singleShot(10000, this, [presented, connection, done]() {
+            if (!*presented) {
+                qWarning() << "First frame not presented within 10s";
+                QObject::disconnect(*connection);
+                done(true);
+            }
+        });
+    });
+}
+
+void AppStartup::runActivation(const std::function<void(bool)> &done)
+{
+    if (m_skipActivation) {
+        done(true);
+        return;
+    }
+
+    // 检查是否需要激活
+    bool needActivation = m_initResult.value("need_activation_ui").toBool();
+    qDebug() << "Need activation UI:" << needActivation;
+    if (!needActivation) {
+        qDebug() << "Device already activated, proceeding to main application...";
+        done(true);
+        return;
+    }
+
+    qDebug() << "Device not activated, showing activation dialog...";
+
+    // 从初始化结果中获取激活数据
+    QJsonObject activationData;
+    if (m_initResult.contains("activation_data")) {
+        activationData = m_initResult["activation_data"].toObject();
+        qDebug() << "Got activation data from initResult:" << activationData;
+    } else {
+        // 如果没有激活数据，创建默认的激活数据
+        activationData["challenge"] = "default_challenge";
+        activationData["code"] = "123456";
+        activationData["message"] = "请在xiaozhi.me输入验证码";
+        qDebug() << "No activation data found, using default:" << activationData;
+    }
+
+    SimpleActivationWindow *activationWindow = new SimpleActivationWindow(activationData);
+    QObject::connect(activationWindow, &SimpleActivationWindow::activationCompleted, [](bool success) {
+        if (success) {
+            qDebug() << "Activation completed successfully";
+        } else {
+            qDebug() << "Activation failed or cancelled";
+        }
+    });
+
+    // 窗口关闭时才结束任务，其间其他启动任务照常在主事件循环中完成
+    QObject::connect(activationWindow, &QDialog::finished, this, [activationWindow, done](int result) {
+        qDebug() << "Activation window closed with result:" << result;
+        done(result == QDialog::Accepted && activationWindow->isActivated());
+        activationWindow->deleteLater();
+    });
+
+    qDebug() << "Showing activation window...";
+    activationWindow->open();
+}
+
+bool AppStartup::createMainWindow()
+{
+    m_mainWindow = new MainWindow(nullptr, m_app);
+    return true;
+}
+
+bool AppStartup::initializeIntegration()
+{
+    // 创建并初始化WebSocket桌宠集成
+    qDebug() << "Initializing WebSocket DeskPet Integration...";
+    m_integration = new DeskPetIntegration(m_mainWindow);
+
+    if (!m_integration->initialize(m_mainWindow)) {
+        // 集成失败不影响桌宠本身运行
+        qDebug() << "Failed to initialize DeskPetIntegration";
+        return true;
+    }
+
+    qDebug() << "DeskPetIntegration initialized successfully";
+    m_mainWindow->setDeskPetIntegration(m_integration);
+    m_integrationReady = true;
+    return true;
+}
+
+void AppStartup::onPipelineFinished(qint64 totalMs)
+{
+    qInfo().noquote() << "Startup finished in" << totalMs << "ms\n" + m_pipeline->reportTable();
+
+    if (m_reportPath.isEmpty()) {
+        return;
+    }
+    QFile file(m_reportPath);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        file.write(QJsonDocument(m_pipeline->report()).toJson(QJsonDocument::Indented));
+        qDebug() << "Startup report written to" << QFileInfo(file).absoluteFilePath();
+    } else {
+        qWarning() << "Failed to write startup report:" << m_reportPath;
+    }
+}
+
+void AppStartup::onPipelineFailed(const QString &taskName)
+{
+    qCritical().noquote() << "Startup failed at task" << taskName << "\n" + m_pipeline->reportTable();
+
+    if (taskName == "resources") {
+        // 获取详细的错误信息
+        QString errorMsg = QString("资源加载失败，程序无法启动\n\n"
+                                   "应用目录: %1\n"
+                                   "资源路径: %2\n"
+                                   "config.json: %3\n\n"
+                                   "请检查应用是否被移动或损坏。\n"
+                                   "如果问题持续，请尝试重新下载安装。")
+                               .arg(QCoreApplication::applicationDirPath())
+                               .arg(resource_loader::get_instance().get_resoures_path())
+                               .arg(resource_loader::get_instance().get_config_path());
+        QMessageBox::critical(nullptr, "错误", errorMsg);
+    } else if (taskName == "activation") {
+        qDebug() << "Activation failed or cancelled, exiting...";
+    } else {
+        QMessageBox::critical(nullptr, "错误", QString("启动失败（%1），程序无法启动").arg(taskName));
+    }
+    QCoreApplication::exit(1);
+}
@@ -0,0 +1,61 @@
+#ifndef APPSTARTUP_H
+#define APPSTARTUP_H
+
+#include <QObject>
+#include <QJsonObject>
+#include <QString>
+#include <functional>
+
+class QApplication;
+class MainWindow;
+class DeskPetIntegration;
+class SystemInitializer;
+class StartupPipeline;
+
+/**
+ * @brief 应用启动流程
+ *
+ * 用 StartupPipeline 描述启动各阶段及其依赖：
+ *
+ *   config         -> ota -> activation
+ *   config         -> dns_prewarm
+ *   resources + cubism_init -> asset_preload
+ *   resources + cubism_init + activation -> main_window -> integration -> connect -> first_frame
+ *
+ * OTA请求、资源配置解析、Cubism初始化、DNS预解析互不等待；模型文件读取和贴图解码
+ * 在后台线程进行，首帧直接取用。WebSocket握手在窗口显示之前发起，与模型加载重叠。
+ */
+class AppStartup : public QObject
+{
+    Q_OBJECT
+
+public:
+    AppStartup(QApplication *app, bool skipActivation, QObject *parent = nullptr);
+    ~AppStartup();
+
+    // 启动结束后把分阶段耗时以JSON写入该文件
+    void setReportPath(const QString &path) { m_reportPath = path; }
+
+    void start();
+
+private:
+    void buildPipeline();
+    // 激活窗口用open()打开而不阻塞，窗口关闭时通过done结束activation任务
+    void runActivation(const std::function<void(bool)> &done);
+    bool createMainWindow();
+    bool initializeIntegration();
+    void onPipelineFinished(qint64 totalMs);
+    void onPipelineFailed(const QString &taskName);
+
+    QApplication *m_app;
+    bool m_skipActivation;
+    QString m_reportPath;
+    StartupPipeline *m_pipeline;
+    SystemInitializer *m_initializer;
+    QJsonObject m_initResult;
+    MainWindow *m_mainWindow;
+    DeskPetIntegration *m_integration;
+    bool m_integrationReady;
+};
+
+#endif // APPSTARTUP_H
@@ -2,6 +2,7 @@
 #include "LogUtil.h"
 #include "PlatformConfig.hpp"
 #include "PortAudioEngine.h"
+#include "TraceProfiler.h"
 
 #ifdef _WIN32
 #include <windows.h>
@@ -322,6 +323,18 @@ void AudioPlayer::playAudio(const char *audioData, size_t dataSize) {
     )
 }
 
+void AudioPlayer::playReceivedAudioFrame(const AudioFrame &frame) {
+    if (frame.payload.isEmpty()) {
+        return;
+    }
+    
+    if (m_playbackThread) {
+        m_playbackThread->enqueueAudioFrame(frame);
+    } else {
+        CF_LOG_ERROR("Playback thread not available");
+    }
+}
+
 void AudioPlayer::playReceivedAudioData(const QByteArray &audioData) {
     if (audioData.isEmpty()) {
         CF_LOG_INFO("Empty audio data received, skipping playback");
@@ -362,7 +375,19 @@ AudioPlaybackThread::~AudioPlaybackThread()
 void AudioPlaybackThread::enqueueAudio(const QByteArray &audioData)
 {
     QMutexLocker locker(&m_queueMutex);
-    m_audioQueue.enqueue(audioData);
+    m_jitterBuffer.push(audioData);
+}
+
+void AudioPlaybackThread::enqueueAudioFrame(const AudioFrame &frame)
+{
+    QMutexLocker locker(&m_queueMutex);
+    m_jitterBuffer.push(frame);
+}
+
+AudioJitterBuffer::Stats AudioPlaybackThread::getJitterBufferStats()
+{
+    QMutexLocker locker(&m_queueMutex);
+    return m_jitterBuffer.stats();
 }
 
 void AudioPlaybackThread::stopPlayback()
@@ -376,22 +401,21 @@ void AudioPlaybackThread::clearAudioQueue()
     CF_LOG_INFO("AudioPlaybackThread: Clearing audio queue");
     
     QMutexLocker locker(&m_queueMutex);
-    int clearedCount = m_audioQueue.size();
-    m_audioQueue.clear();
+    int clearedCount = m_jitterBuffer.size();
+    m_jitterBuffer.clear();
     CF_LOG_INFO("AudioPlaybackThread: Cleared %d queued audio chunks", clearedCount);
 }
 
 void AudioPlaybackThread::run()
 {
     m_running = true;
+    CF_TRACE_THREAD_NAME("AudioPlayback");
     
     while (m_running) {
         QByteArray audioData;
         {
             QMutexLocker locker(&m_queueMutex);
-            if (!m_audioQueue.isEmpty()) {
-                audioData = m_audioQueue.dequeue();
-            }
+            m_jitterBuffer.pop(audioData);
         }
         
         if (!audioData.isEmpty()) {
@@ -404,6 +428,7 @@ void AudioPlaybackThread::run()
 
 void AudioPlaybackThread::processAudioData(const QByteArray &audioData)
 {
+    CF_TRACE_SCOPE_CAT("AudioPlaybackThread::decode", "audio");
     CF_LOG_INFO("AudioPlaybackThread: Processing %d bytes of Opus data", audioData.size());
     
     if (!m_opusDecoder || !m_opusDecoder->isInitialized()) {
@@ -462,6 +487,18 @@ void AudioPlayer::clearAudioQueue()
     }
 }
 
+void AudioPlayer::setVolume(int volume)
+{
+    if (m_playbackThread) {
+        m_playbackThread->setVolume(volume);
+    }
+}
+
+int AudioPlayer::volume() const
+{
+    return m_playbackThread ? m_playbackThread->volume() : 100;
+}
+
 // 处理解码后的PCM数据播放
 void AudioPlayer::onPCMDataReady(const QByteArray &pcmData)
 {
@@ -474,7 +511,7 @@ void AudioPlayer::onPCMDataReady(const QByteArray &pcmData)
     PortAudioEngine *portAudioEngine = qobject_cast<PortAudioEngine*>(static_cast<QObject*>(audioPlayer));
     if (portAudioEngine) {
         // 使用PortAudio引擎
-        portAudioEngine->enqueueAudio(pcmData);
+        portAudioEngine->enqueueAudio(AudioPlaybackThread::applyVolume(pcmData, volume()));
         if (!portAudioEngine->isPlaying()) {
             portAudioEngine->startPlayback();
         }
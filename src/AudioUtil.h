@@ -7,7 +7,10 @@
 #include <QThread>
 #include <QMutex>
 #include <QQueue>
+#include <QAtomicInt>
+#include <QtGlobal>
 #include "OpusDecoder.h"
+#include "BinaryAudioProtocol.h"
 
 // 音频播放工作线程
 class AudioPlaybackThread : public QThread {
@@ -17,8 +20,27 @@ public:
     ~AudioPlaybackThread();
     
     void enqueueAudio(const QByteArray &audioData);
+    void enqueueAudioFrame(const AudioFrame &frame);  // 带序号的帧经抖动缓冲重排
     void stopPlayback();
     void clearAudioQueue();  // 新增：清空音频队列
+    AudioJitterBuffer::Stats getJitterBufferStats();
+    
+    // 软件音量（0-100），只作用于送往声卡的PCM，口型同步仍使用原始幅度
+    void setVolume(int volume) { m_volume.storeRelaxed(qBound(0, volume, 100)); }
+    int volume() const { return m_volume.loadRelaxed(); }
+    static QByteArray applyVolume(const QByteArray &pcm16, int volume)
+    {
+        if (volume >= 100) {
+            return pcm16;
+        }
+        QByteArray scaled(pcm16);
+        qint16 *samples = reinterpret_cast<qint16 *>(scaled.data());
+        const int count = scaled.size() / static_cast<int>(sizeof(qint16));
+        for (int i = 0; i < count; ++i) {
+            samples[i] = static_cast<qint16>(samples[i] * volume / 100);
+        }
+        return scaled;
+    }
     
 signals:
     // 当音频解码完成后发射，用于口型同步
@@ -28,9 +50,10 @@ protected:
     void run() override;
     
 private:
-    QQueue<QByteArray> m_audioQueue;
+    AudioJitterBuffer m_jitterBuffer;
     QMutex m_queueMutex;
     volatile bool m_running;
+    QAtomicInt m_volume{100};
     OpusDecoder *m_opusDecoder;
     void *m_audioEngineManager;  // AudioEngineManager* (macOS特定)
     
@@ -49,10 +72,15 @@ public:
     
     // 新增：播放接收到的Opus编码音频数据 - 异步解码并播放
     void playReceivedAudioData(const QByteArray &audioData);
+    void playReceivedAudioFrame(const AudioFrame &frame);
     
     // 新增：清空音频队列（用于中断对话）
     void clearAudioQueue();
     
+    // 播放音量（0-100）
+    void setVolume(int volume);
+    int volume() const;
+    
     // 获取音频播放线程（用于连接信号）
     AudioPlaybackThread* getPlaybackThread() { return m_playbackThread; }
 
@@ -3,6 +3,7 @@
 //
 #include "AudioUtil.h"
 #include "PortAudioEngine.h"
+#include "TraceProfiler.h"
 #import <AVFoundation/AVFoundation.h>
 
 // Objective-C 类用于管理音频引擎
@@ -190,7 +191,17 @@ AudioPlaybackThread::~AudioPlaybackThread() {
 
 void AudioPlaybackThread::enqueueAudio(const QByteArray &audioData) {
     QMutexLocker locker(&m_queueMutex);
-    m_audioQueue.enqueue(audioData);
+    m_jitterBuffer.push(audioData);
+}
+
+void AudioPlaybackThread::enqueueAudioFrame(const AudioFrame &frame) {
+    QMutexLocker locker(&m_queueMutex);
+    m_jitterBuffer.push(frame);
+}
+
+AudioJitterBuffer::Stats AudioPlaybackThread::getJitterBufferStats() {
+    QMutexLocker locker(&m_queueMutex);
+    return m_jitterBuffer.stats();
 }
 
 void AudioPlaybackThread::stopPlayback() {
@@ -204,8 +215,8 @@ void AudioPlaybackThread::clearAudioQueue() {
     // 清空待处理的音频队列
     {
         QMutexLocker locker(&m_queueMutex);
-        int clearedCount = m_audioQueue.size();
-        m_audioQueue.clear();
+        int clearedCount = m_jitterBuffer.size();
+        m_jitterBuffer.clear();
         CF_LOG_INFO("AudioPlaybackThread: Cleared %d queued audio chunks", clearedCount);
     }
     
@@ -222,14 +233,13 @@ void AudioPlaybackThread::clearAudioQueue() {
 
 void AudioPlaybackThread::run() {
     m_running = true;
+    CF_TRACE_THREAD_NAME("AudioPlayback");
     
     while (m_running) {
         QByteArray audioData;
         {
             QMutexLocker locker(&m_queueMutex);
-            if (!m_audioQueue.isEmpty()) {
-                audioData = m_audioQueue.dequeue();
-            }
+            m_jitterBuffer.pop(audioData);
         }
         
         if (!audioData.isEmpty()) {
@@ -241,6 +251,7 @@ void AudioPlaybackThread::run() {
 }
 
 void AudioPlaybackThread::processAudioData(const QByteArray &audioData) {
+    CF_TRACE_SCOPE_CAT("AudioPlaybackThread::decode", "audio");
     CF_LOG_INFO("AudioPlaybackThread: Processing %d bytes of Opus data", audioData.size());
     
     if (!m_opusDecoder || !m_opusDecoder->isInitialized() || !m_audioEngineManager) {
@@ -259,7 +270,8 @@ void AudioPlaybackThread::processAudioData(const QByteArray &audioData) {
     
     // 将PCM数据加入播放队列
     @autoreleasepool {
-        NSData *nsData = [NSData dataWithBytes:pcmData.constData() length:pcmData.size()];
+        const QByteArray playbackData = applyVolume(pcmData, volume());
+        NSData *nsData = [NSData dataWithBytes:playbackData.constData() length:playbackData.size()];
         AudioEngineManager *manager = (AudioEngineManager*)m_audioEngineManager;
         [manager enqueuePCMData:nsData];
     }
@@ -340,6 +352,18 @@ void AudioPlayer::playAudio(const char *filePath) {
     }
 }
 
+void AudioPlayer::playReceivedAudioFrame(const AudioFrame &frame) {
+    if (frame.payload.isEmpty()) {
+        return;
+    }
+    
+    if (m_playbackThread) {
+        m_playbackThread->enqueueAudioFrame(frame);
+    } else {
+        CF_LOG_ERROR("Playback thread not available");
+    }
+}
+
 void AudioPlayer::playReceivedAudioData(const QByteArray &audioData) {
     if (audioData.isEmpty()) {
         CF_LOG_INFO("Received empty audio data, skipping");
@@ -374,6 +398,16 @@ void AudioPlayer::clearAudioQueue() {
     }
 }
 
+void AudioPlayer::setVolume(int volume) {
+    if (m_playbackThread) {
+        m_playbackThread->setVolume(volume);
+    }
+}
+
+int AudioPlayer::volume() const {
+    return m_playbackThread ? m_playbackThread->volume() : 100;
+}
+
 // 处理解码后的PCM数据播放
 void AudioPlayer::onPCMDataReady(const QByteArray &pcmData)
 {
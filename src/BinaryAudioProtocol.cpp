@@ -0,0 +1,215 @@
+#include "BinaryAudioProtocol.h"
+#include <QtEndian>
+#include <QDebug>
+
+namespace {
+// 超出该范围的序号跳变视为新的音频流（服务端重置了序号）
+const qint32 kSequenceResetWindow = 64;
+}
+
+QByteArray BinaryAudioProtocol::pack(int version, const QByteArray &payload, quint32 sequence, quint32 timestamp)
+{
+    if (version == 2) {
+        QByteArray frame(kHeaderSizeV2 + payload.size(), Qt::Uninitialized);
+        uchar *header = reinterpret_cast<uchar *>(frame.data());
+        qToBigEndian<quint16>(2, header);
+        qToBigEndian<quint16>(PayloadOpus, header + 2);
+        qToBigEndian<quint32>(sequence, header + 4);
+        qToBigEndian<quint32>(timestamp, header + 8);
+        qToBigEndian<quint32>(static_cast<quint32>(payload.size()), header + 12);
+        memcpy(frame.data() + kHeaderSizeV2, payload.constData(), payload.size());
+        return frame;
+    }
+
+    if (version == 3) {
+        if (payload.size() > 0xFFFF) {
+            qWarning() << "BinaryAudioProtocol: payload too large for v3 frame:" << payload.size();
+            return QByteArray();
+        }
+        QByteArray frame(kHeaderSizeV3 + payload.size(), Qt::Uninitialized);
+        uchar *header = reinterpret_cast<uchar *>(frame.data());
+        header[0] = PayloadOpus;
+        header[1] = static_cast<uchar>(sequence & 0xFF);
+        qToBigEndian<quint16>(static_cast<quint16>(payload.size()), header + 2);
+        memcpy(frame.data() + kHeaderSizeV3, payload.constData(), payload.size());
+        return frame;
+    }
+
+    return payload;
+}
+
+bool BinaryAudioProtocol::unpack(int version, const QByteArray &data, AudioFrame &frame)
+{
+    const uchar *header = reinterpret_cast<const uchar *>(data.constData());
+
+    if (version == 2) {
+        if (data.size() < kHeaderSizeV2) {
+            return false;
+        }
+        const quint16 frameVersion = qFromBigEndian<quint16>(header);
+        const quint16 type = qFromBigEndian<quint16>(header + 2);
+        const quint32 payloadSize = qFromBigEndian<quint32>(header + 12);
+        if (frameVersion != 2 || type != PayloadOpus
+            || payloadSize != static_cast<quint32>(data.size() - kHeaderSizeV2)) {
+            return false;
+        }
+        frame.sequence = qFromBigEndian<quint32>(header + 4);
+        frame.timestamp = qFromBigEndian<quint32>(header + 8);
+        frame.hasSequence = true;
+        frame.hasTimestamp = true;
+        frame.payload = data.mid(kHeaderSizeV2);
+        return true;
+    }
+
+    if (version == 3) {
+        if (data.size() < kHeaderSizeV3) {
+            return false;
+        }
+        const quint16 payloadSize = qFromBigEndian<quint16>(header + 2);
+        if (header[0] != PayloadOpus || payloadSize != data.size() - kHeaderSizeV3) {
+            return false;
+        }
+        frame.sequence = header[1];   // 由调用方用extendSequence8展开
+        frame.hasSequence = true;
+        frame.hasTimestamp = false;
+        frame.payload = data.mid(kHeaderSizeV3);
+        return true;
+    }
+
+    frame.payload = data;
+    frame.hasSequence = false;
+    frame.hasTimestamp = false;
+    return true;
+}
+
+quint32 BinaryAudioProtocol::extendSequence8(quint8 low, quint32 previous)
+{
+    // 取与上一帧距离最近的候选值
+    const quint32 candidate = (previous & 0xFFFFFF00u) | low;
+    const qint32 diff = static_cast<qint32>(candidate - previous);
+    if (diff < -128) {
+        return candidate + 0x100;
+    }
+    if (diff > 128) {
+        return candidate - 0x100;
+    }
+    return candidate;
+}
+
+// ---------------------------------------------------------------------------
+// AudioJitterBuffer
+// ---------------------------------------------------------------------------
+
+AudioJitterBuffer::AudioJitterBuffer(int targetDepth, int maxHoleWaitMs)
+    : m_expected(0)
+    , m_started(false)
+    , m_targetDepth(targetDepth < 1 ? 1 : targetDepth)
+    , m_maxHoleWaitMs(maxHoleWaitMs)
+    , m_waiting(false)
+{
+}
+
+void AudioJitterBuffer::push(const QByteArray &payload)
+{
+    m_stats.framesIn++;
+    m_unsequenced.enqueue(payload);
+}
+
+void AudioJitterBuffer::push(const AudioFrame &frame)
+{
+    if (!frame.hasSequence) {
+        push(frame.payload);
+        return;
+    }
+
+    m_stats.framesIn++;
+
+    if (m_started) {
+        const qint32 diff = sequenceDiff(frame.sequence, m_expected);
+        const bool farAway = diff > kSequenceResetWindow || diff < -kSequenceResetWindow;
+        if (diff < 0 && !farAway && !m_frames.isEmpty()) {
+            // 播放点已经越过该帧
+            m_stats.framesLate++;
+            return;
+        }
+        if (diff < 0 || farAway) {
+            // 新的一段音频（服务端重置序号或缓冲已排空）
+            m_stats.streamResets++;
+            m_stats.framesLost += m_frames.size();
+            m_frames.clear();
+            m_started = false;
+            m_waiting = false;
+        }
+    }
+
+    if (m_frames.contains(frame.sequence)) {
+        m_stats.framesDuplicate++;
+        return;
+    }
+    m_frames.insert(frame.sequence, frame.payload);
+
+    if (!m_started && !m_waiting) {
+        m_waitClock.start();
+        m_waiting = true;
+    }
+}
+
+bool AudioJitterBuffer::pop(QByteArray &payload)
+{
+    if (!m_frames.isEmpty()) {
+        if (!m_started) {
+            // 预缓冲：达到目标深度、等待超时，或后面已有无序帧排队时开始播放
+            const bool ready = m_frames.size() >= m_targetDepth || !m_unsequenced.isEmpty()
+                               || (m_waiting && m_waitClock.elapsed() >= m_maxHoleWaitMs);
+            if (!ready) {
+                return false;
+            }
+            m_started = true;
+            m_waiting = false;
+            m_expected = m_frames.firstKey();
+        }
+
+        auto it = m_frames.find(m_expected);
+        if (it == m_frames.end()) {
+            // 序号空洞：后续帧足够或等待超时则跳过
+            bool skip = m_frames.size() >= m_targetDepth || !m_unsequenced.isEmpty();
+            if (!skip) {
+                if (!m_waiting) {
+                    m_waitClock.start();
+                    m_waiting = true;
+                }
+                skip = m_waitClock.elapsed() >= m_maxHoleWaitMs;
+            }
+            if (!skip) {
+                return false;
+            }
+            const quint32 first = m_frames.firstKey();
+            m_stats.framesLost += static_cast<quint32>(sequenceDiff(first, m_expected));
+            m_expected = first;
+            it = m_frames.begin();
+        }
+
+        m_waiting = false;
+        payload = it.value();
+        m_frames.erase(it);
+        m_expected++;
+        m_stats.framesOut++;
+        return true;
+    }
+
+    if (!m_unsequenced.isEmpty()) {
+        payload = m_unsequenced.dequeue();
+        m_stats.framesOut++;
+        return true;
+    }
+
+    return false;
+}
+
+void AudioJitterBuffer::clear()
+{
+    m_frames.clear();
+    m_unsequenced.clear();
+    m_started = false;
+    m_waiting = false;
+}
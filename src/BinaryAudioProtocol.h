@@ -0,0 +1,102 @@
+#ifndef BINARYAUDIOPROTOCOL_H
+#define BINARYAUDIOPROTOCOL_H
+
+#include <QByteArray>
+#include <QMap>
+#include <QQueue>
+#include <QElapsedTimer>
+#include <QMetaType>
+
+// 一帧下行/上行音频及其时序信息
+struct AudioFrame {
+    QByteArray payload;          // Opus数据
+    quint32 sequence = 0;        // 帧序号（仅hasSequence时有效）
+    quint32 timestamp = 0;       // 采集时间戳，毫秒（仅hasTimestamp时有效）
+    qint64 receivedAtMs = 0;     // 本地接收时刻（单调时钟）
+    bool hasSequence = false;
+    bool hasTimestamp = false;
+};
+Q_DECLARE_METATYPE(AudioFrame)
+
+/**
+ * @brief 小智二进制音频帧协议
+ *
+ * 版本1：二进制帧即原始Opus数据。
+ * 版本2：16字节头（网络字节序）
+ *        uint16 version | uint16 type | uint32 reserved | uint32 timestamp | uint32 payload_size
+ *        reserved 字段用于携带帧序号（服务端不支持时为0，接收端会自动识别）。
+ * 版本3：4字节头
+ *        uint8 type | uint8 reserved | uint16 payload_size
+ *        reserved 字段携带帧序号低8位，接收端展开为32位。
+ */
+class BinaryAudioProtocol
+{
+public:
+    enum PayloadType {
+        PayloadOpus = 0,
+        PayloadJson = 1
+    };
+
+    static const int kHeaderSizeV2 = 16;
+    static const int kHeaderSizeV3 = 4;
+
+    static bool isSupportedVersion(int version) { return version >= 1 && version <= 3; }
+
+    // 按版本封装一帧Opus数据
+    static QByteArray pack(int version, const QByteArray &payload, quint32 sequence, quint32 timestamp);
+
+    // 解析一帧，失败返回false（头部与长度不一致等）
+    static bool unpack(int version, const QByteArray &data, AudioFrame &frame);
+
+    // 把8位序号展开为相对上一帧最近的32位序号
+    static quint32 extendSequence8(quint8 low, quint32 previous);
+};
+
+/**
+ * @brief 播放端抖动缓冲
+ *
+ * 带序号的帧按序号重排后输出：预缓冲到目标深度再开始播放，
+ * 空洞等待超过maxHoleWaitMs或后续帧已足够时跳过（计为丢失），迟到和重复帧直接丢弃。
+ * 不带序号的帧（原始协议）按到达顺序直接输出。
+ * 本类不加锁，由调用方（播放线程）负责同步。
+ */
+class AudioJitterBuffer
+{
+public:
+    struct Stats {
+        quint64 framesIn = 0;
+        quint64 framesOut = 0;
+        quint64 framesLost = 0;      // 被跳过的序号
+        quint64 framesLate = 0;      // 播放点之后才到达
+        quint64 framesDuplicate = 0;
+        quint64 streamResets = 0;
+    };
+
+    explicit AudioJitterBuffer(int targetDepth = 2, int maxHoleWaitMs = 80);
+
+    void push(const AudioFrame &frame);
+    void push(const QByteArray &payload);
+    bool pop(QByteArray &payload);
+    void clear();
+
+    int size() const { return m_frames.size() + m_unsequenced.size(); }
+    const Stats &stats() const { return m_stats; }
+
+    void setTargetDepth(int depth) { m_targetDepth = depth < 1 ? 1 : depth; }
+    void setMaxHoleWaitMs(int ms) { m_maxHoleWaitMs = ms; }
+
+private:
+    static qint32 sequenceDiff(quint32 a, quint32 b) { return static_cast<qint32>(a - b); }
+
+    QMap<quint32, QByteArray> m_frames;   // 按32位序号排序（序号回绕时在push中整体重置）
+    QQueue<QByteArray> m_unsequenced;
+    quint32 m_expected;
+    bool m_started;
+    int m_targetDepth;
+    int m_maxHoleWaitMs;
+    QElapsedTimer m_waitClock;            // 预缓冲或空洞等待计时
+    bool m_waiting;
+    Stats m_stats;
+};
+
+#endif // BINARYAUDIOPROTOCOL_H
@@ -16,9 +16,15 @@ const QJsonObject ConfigManager::DEFAULT_CONFIG = []() {
     
     QJsonObject network;
     network["OTA_VERSION_URL"] = "https://api.tenclass.net/xiaozhi/ota/";
+    network["OTA_CACHE_TTL"] = 21600; // OTA响应缓存有效期（秒），期内启动不请求服务器
+    network["OTA_CACHE_MAX_STALE"] = 604800; // 过期缓存仍可先用再后台刷新的最长时间（秒）
     network["WEBSOCKET_URL"] = QJsonValue::Null;
     network["WEBSOCKET_ACCESS_TOKEN"] = QJsonValue::Null;
+    network["WEBSOCKET_PROTOCOL_VERSION"] = 1; // 二进制音频帧格式：1原始Opus，2/3带序号和时间戳的头部
     network["MQTT_INFO"] = QJsonValue::Null;
+    network["TRANSPORT"] = "websocket"; // websocket / mqtt_udp / auto（auto：OTA只返回MQTT信息时使用MQTT+UDP）
+    network["TELEMETRY_DUMP_FILE"] = ""; // 连接遥测转储文件（相对路径位于配置目录），为空关闭
+    network["TELEMETRY_DUMP_INTERVAL"] = 60; // 转储间隔（秒）
     network["ACTIVATION_VERSION"] = "v2";
     network["AUTHORIZATION_URL"] = "https://xiaozhi.me/";
     
@@ -0,0 +1,340 @@
+#include "ConnectionTelemetry.h"
+#include "WebSocketManager.h"
+#include <QTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QDebug>
+#include <algorithm>
+
+QJsonObject ThroughputMeter::toJson() const
+{
+    QJsonObject json;
+    json["bytes"] = static_cast<qint64>(bytes);
+    json["audio_frames"] = static_cast<qint64>(audioFrames);
+    json["text_messages"] = static_cast<qint64>(textMessages);
+    json["bytes_per_sec"] = bytesPerSec;
+    json["frames_per_sec"] = framesPerSec;
+    return json;
+}
+
+QJsonObject ConnectionStats::toJson() const
+{
+    QJsonObject json;
+    json["transport"] = transport;
+    json["connected"] = connected;
+    json["uptime_ms"] = uptimeMs;
+
+    QJsonObject rtt;
+    rtt["samples"] = static_cast<qint64>(rttSamples);
+    rtt["last_ms"] = rttLastMs;
+    rtt["min_ms"] = rttMinMs;
+    rtt["max_ms"] = rttMaxMs;
+    rtt["avg_ms"] = rttAvgMs;
+    QJsonArray buckets;
+    const QVector<int> &bounds = ConnectionTelemetry::rttBucketBoundsMs();
+    for (int i = 0; i < rttHistogram.size(); ++i) {
+        QJsonObject bucket;
+        bucket["le_ms"] = i < bounds.size() ? QJsonValue(bounds[i]) : QJsonValue(QStringLiteral("inf"));
+        bucket["count"] = static_cast<qint64>(rttHistogram[i]);
+        buckets.append(bucket);
+    }
+    rtt["histogram"] = buckets;
+    rtt["heartbeat_timeouts"] = static_cast<qint64>(heartbeatTimeouts);
+    json["rtt"] = rtt;
+
+    QJsonObject audio;
+    audio["jitter_ms"] = audioJitterMs;
+    audio["jitter_max_ms"] = audioJitterMaxMs;
+    audio["stalls"] = static_cast<qint64>(audioStalls);
+    audio["longest_stall_ms"] = longestStallMs;
+    json["inbound_audio"] = audio;
+
+    json["inbound"] = inbound.toJson();
+    json["outbound"] = outbound.toJson();
+    json["write_backlog_bytes"] = writeBacklogBytes;
+    json["write_backlog_max_bytes"] = writeBacklogMaxBytes;
+
+    QJsonObject connection;
+    connection["attempts"] = static_cast<qint64>(connectAttempts);
+    connection["connects"] = static_cast<qint64>(connects);
+    connection["reconnects"] = static_cast<qint64>(reconnects);
+    QJsonObject causes;
+    for (auto it = disconnectCauses.constBegin(); it != disconnectCauses.constEnd(); ++it) {
+        causes[it.key()] = static_cast<qint64>(it.value());
+    }
+    connection["disconnect_causes"] = causes;
+    connection["last_disconnect_cause"] = lastDisconnectCause;
+    json["connection"] = connection;
+
+    QJsonObject states;
+    for (auto it = stateTimeMs.constBegin(); it != stateTimeMs.constEnd(); ++it) {
+        states[it.key()] = it.value();
+    }
+    json["state_time_ms"] = states;
+    return json;
+}
+
+ConnectionTelemetry::ConnectionTelemetry(QObject *parent)
+    : QObject(parent)
+    , m_connectedAtMs(-1)
+    , m_stateEnteredMs(0)
+    , m_currentState(QStringLiteral("DISCONNECTED"))
+    , m_rttTotalMs(0.0)
+    , m_tickTimer(new QTimer(this))
+    , m_lastTickMs(0)
+    , m_queuedWireBytes(0)
+    , m_writtenBytes(0)
+    , m_lastAudioArrivalMs(-1)
+    , m_stallThresholdMs(500)
+    , m_dumpTimer(new QTimer(this))
+{
+    m_clock.start();
+    m_stats.rttHistogram.fill(0, rttBucketBoundsMs().size() + 1);
+
+    connect(m_tickTimer, &QTimer::timeout, this, &ConnectionTelemetry::onTick);
+    m_tickTimer->start(1000);
+
+    connect(m_dumpTimer, &QTimer::timeout, this, [this]() { dumpNow(); });
+}
+
+ConnectionTelemetry::~ConnectionTelemetry()
+{
+}
+
+const QVector<int> &ConnectionTelemetry::rttBucketBoundsMs()
+{
+    static const QVector<int> bounds = {10, 20, 50, 100, 200, 500, 1000, 2000, 5000};
+    return bounds;
+}
+
+QString ConnectionTelemetry::stateName(DeviceState state)
+{
+    switch (state) {
+    case DeviceState::IDLE: return QStringLiteral("IDLE");
+    case DeviceState::LISTENING: return QStringLiteral("LISTENING");
+    case DeviceState::SPEAKING: return QStringLiteral("SPEAKING");
+    case DeviceState::CONNECTING: return QStringLiteral("CONNECTING");
+    case DeviceState::DISCONNECTED: return QStringLiteral("DISCONNECTED");
+    }
+    return QStringLiteral("UNKNOWN");
+}
+
+void ConnectionTelemetry::onConnectAttempt()
+{
+    QMutexLocker locker(&m_mutex);
+    m_stats.connectAttempts++;
+}
+
+void ConnectionTelemetry::onConnected(const QString &transport)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_stats.connects > 0) {
+        m_stats.reconnects++;
+    }
+    m_stats.connects++;
+    m_stats.connected = true;
+    m_stats.transport = transport;
+    m_connectedAtMs = m_clock.elapsed();
+    m_queuedWireBytes = 0;
+    m_writtenBytes = 0;
+    m_lastAudioArrivalMs = -1;
+}
+
+void ConnectionTelemetry::onDisconnected(const QString &cause)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_stats.connected) {
+        return;
+    }
+    m_stats.connected = false;
+    m_stats.disconnectCauses[cause]++;
+    m_stats.lastDisconnectCause = cause;
+    m_connectedAtMs = -1;
+    m_queuedWireBytes = 0;
+    m_writtenBytes = 0;
+}
+
+void ConnectionTelemetry::recordInbound(qint64 bytes, bool audio)
+{
+    QMutexLocker locker(&m_mutex);
+    m_stats.inbound.bytes += bytes;
+    if (audio) {
+        m_stats.inbound.audioFrames++;
+    } else {
+        m_stats.inbound.textMessages++;
+    }
+}
+
+void ConnectionTelemetry::recordOutbound(qint64 payloadBytes, qint64 wireBytes, bool audio)
+{
+    QMutexLocker locker(&m_mutex);
+    m_stats.outbound.bytes += payloadBytes;
+    if (audio) {
+        m_stats.outbound.audioFrames++;
+    } else {
+        m_stats.outbound.textMessages++;
+    }
+    m_queuedWireBytes += wireBytes;
+}
+
+void ConnectionTelemetry::onBytesWritten(qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_writtenBytes += bytes;
+}
+
+void ConnectionTelemetry::recordAudioArrival(qint64 arrivalMs, double jitterMs, bool speaking)
+{
+    QMutexLocker locker(&m_mutex);
+    m_stats.audioJitterMs = jitterMs;
+    m_stats.audioJitterMaxMs = std::max(m_stats.audioJitterMaxMs, jitterMs);
+
+    // 断流：说话期间两帧之间的空档超过阈值（句间停顿发生在tts stop之后，不计入）
+    if (speaking && m_lastAudioArrivalMs >= 0) {
+        const qint64 gap = arrivalMs - m_lastAudioArrivalMs;
+        if (gap > m_stallThresholdMs) {
+            m_stats.audioStalls++;
+            m_stats.longestStallMs = std::max(m_stats.longestStallMs, gap);
+        }
+    }
+    m_lastAudioArrivalMs = speaking ? arrivalMs : -1;
+}
+
+void ConnectionTelemetry::recordRtt(double rttMs)
+{
+    QMutexLocker locker(&m_mutex);
+    const QVector<int> &bounds = rttBucketBoundsMs();
+    int bucket = 0;
+    while (bucket < bounds.size() && rttMs > bounds[bucket]) {
+        ++bucket;
+    }
+    m_stats.rttHistogram[bucket]++;
+
+    if (m_stats.rttSamples == 0) {
+        m_stats.rttMinMs = rttMs;
+        m_stats.rttMaxMs = rttMs;
+    } else {
+        m_stats.rttMinMs = std::min(m_stats.rttMinMs, rttMs);
+        m_stats.rttMaxMs = std::max(m_stats.rttMaxMs, rttMs);
+    }
+    m_stats.rttSamples++;
+    m_stats.rttLastMs = rttMs;
+    m_rttTotalMs += rttMs;
+    m_stats.rttAvgMs = m_rttTotalMs / m_stats.rttSamples;
+}
+
+void ConnectionTelemetry::recordHeartbeatTimeout()
+{
+    QMutexLocker locker(&m_mutex);
+    m_stats.heartbeatTimeouts++;
+}
+
+void ConnectionTelemetry::onStateChanged(DeviceState state)
+{
+    QMutexLocker locker(&m_mutex);
+    accumulateStateTime();
+    m_currentState = stateName(state);
+    if (state != DeviceState::SPEAKING) {
+        m_lastAudioArrivalMs = -1;
+    }
+}
+
+void ConnectionTelemetry::setBacklogProvider(const std::function<qint64()> &provider)
+{
+    QMutexLocker locker(&m_mutex);
+    m_backlogProvider = provider;
+}
+
+void ConnectionTelemetry::setDumpFile(const QString &path, int intervalSec)
+{
+    m_dumpPath = path;
+    if (path.isEmpty() || intervalSec <= 0) {
+        m_dumpTimer->stop();
+        return;
+    }
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    m_dumpTimer->start(intervalSec * 1000);
+    qDebug() << "Connection telemetry dump:" << path << "every" << intervalSec << "s";
+}
+
+bool ConnectionTelemetry::dumpNow()
+{
+    if (m_dumpPath.isEmpty()) {
+        return false;
+    }
+
+    QJsonObject json = snapshot().toJson();
+    json["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODateWithMs);
+
+    QFile file(m_dumpPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        qWarning() << "Failed to open telemetry dump file:" << m_dumpPath << file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(json).toJson(QJsonDocument::Compact));
+    file.write("\n");
+    return true;
+}
+
+ConnectionStats ConnectionTelemetry::snapshot() const
+{
+    QMutexLocker locker(&m_mutex);
+    ConnectionStats stats = m_stats;
+    const qint64 now = m_clock.elapsed();
+    stats.uptimeMs = m_connectedAtMs >= 0 ? now - m_connectedAtMs : 0;
+    stats.stateTimeMs[m_currentState] += now - m_stateEnteredMs;
+    stats.writeBacklogBytes = currentBacklog();
+    stats.writeBacklogMaxBytes = std::max(stats.writeBacklogMaxBytes, stats.writeBacklogBytes);
+    return stats;
+}
+
+void ConnectionTelemetry::onTick()
+{
+    QMutexLocker locker(&m_mutex);
+    const qint64 now = m_clock.elapsed();
+    const qint64 elapsed = now - m_lastTickMs;
+    if (elapsed <= 0) {
+        return;
+    }
+
+    auto settle = [elapsed](ThroughputMeter &meter, const ThroughputMeter &previous) {
+        const double seconds = elapsed / 1000.0;
+        meter.bytesPerSec = (meter.bytes - previous.bytes) / seconds;
+        meter.framesPerSec = ((meter.audioFrames + meter.textMessages)
+                              - (previous.audioFrames + previous.textMessages)) / seconds;
+    };
+    settle(m_stats.inbound, m_inboundAtTick);
+    settle(m_stats.outbound, m_outboundAtTick);
+    m_inboundAtTick = m_stats.inbound;
+    m_outboundAtTick = m_stats.outbound;
+    m_lastTickMs = now;
+
+    m_stats.writeBacklogBytes = currentBacklog();
+    m_stats.writeBacklogMaxBytes = std::max(m_stats.writeBacklogMaxBytes, m_stats.writeBacklogBytes);
+
+    if (m_stats.connected) {
+        m_stats.uptimeMs = now - m_connectedAtMs;
+    }
+}
+
+void ConnectionTelemetry::accumulateStateTime()
+{
+    const qint64 now = m_clock.elapsed();
+    m_stats.stateTimeMs[m_currentState] += now - m_stateEnteredMs;
+    m_stateEnteredMs = now;
+}
+
+qint64 ConnectionTelemetry::currentBacklog() const
+{
+    if (m_backlogProvider) {
+        return m_backlogProvider();
+    }
+    // WebSocket不暴露底层socket，用 已排队帧字节 - bytesWritten 估算
+    return std::max<qint64>(0, m_queuedWireBytes - m_writtenBytes);
+}
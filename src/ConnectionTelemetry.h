@@ -0,0 +1,144 @@
+#ifndef CONNECTIONTELEMETRY_H
+#define CONNECTIONTELEMETRY_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QMap>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <functional>
+
+enum class DeviceState;
+class QTimer;
+
+// 单方向吞吐计量：累计值 + 最近一个统计周期的速率
+struct ThroughputMeter {
+    quint64 bytes = 0;
+    quint64 audioFrames = 0;
+    quint64 textMessages = 0;
+    double bytesPerSec = 0.0;
+    double framesPerSec = 0.0;
+
+    QJsonObject toJson() const;
+};
+
+// 连接健康状况快照（getConnectionStats返回值）
+struct ConnectionStats {
+    QString transport;
+    bool connected = false;
+    qint64 uptimeMs = 0;            // 当前连接已持续时间
+
+    // RTT（WebSocket ping/pong 或 MQTT PINGREQ/PINGRESP）
+    quint64 rttSamples = 0;
+    double rttLastMs = 0.0;
+    double rttMinMs = 0.0;
+    double rttMaxMs = 0.0;
+    double rttAvgMs = 0.0;
+    QVector<quint64> rttHistogram;  // 与 rttBucketBoundsMs() 对应，最后一格为溢出
+    quint64 heartbeatTimeouts = 0;
+
+    // 下行音频到达
+    double audioJitterMs = 0.0;     // RFC3550到达间隔抖动（当前TTS段）
+    double audioJitterMaxMs = 0.0;
+    quint64 audioStalls = 0;        // SPEAKING期间下行音频中断超过阈值的次数
+    qint64 longestStallMs = 0;
+
+    ThroughputMeter inbound;
+    ThroughputMeter outbound;
+
+    qint64 writeBacklogBytes = 0;   // 已排队未写入socket的字节
+    qint64 writeBacklogMaxBytes = 0;
+
+    quint64 connectAttempts = 0;
+    quint64 connects = 0;
+    quint64 reconnects = 0;         // 首次成功连接之后的再次连接
+    QMap<QString, quint64> disconnectCauses;
+    QString lastDisconnectCause;
+
+    QMap<QString, qint64> stateTimeMs;  // 各DeviceState累计停留时间
+
+    QJsonObject toJson() const;
+};
+
+/**
+ * @brief WebSocketManager 的连接健康遥测
+ *
+ * 由 WebSocketManager 在收发、心跳、状态切换处打点，
+ * 每秒结算一次吞吐速率和写积压，可随时查询快照，
+ * 也可按固定间隔将快照以JSON Lines追加写入文件。
+ */
+class ConnectionTelemetry : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ConnectionTelemetry(QObject *parent = nullptr);
+    ~ConnectionTelemetry();
+
+    static const QVector<int> &rttBucketBoundsMs();
+    static QString stateName(DeviceState state);
+
+    // 连接生命周期
+    void onConnectAttempt();
+    void onConnected(const QString &transport);
+    void onDisconnected(const QString &cause);
+
+    // 收发打点；wireBytes为实际写入socket的字节（含帧头）
+    void recordInbound(qint64 bytes, bool audio);
+    void recordOutbound(qint64 payloadBytes, qint64 wireBytes, bool audio);
+    void onBytesWritten(qint64 bytes);
+    void recordAudioArrival(qint64 arrivalMs, double jitterMs, bool speaking);
+
+    void recordRtt(double rttMs);
+    void recordHeartbeatTimeout();
+    void onStateChanged(DeviceState state);
+
+    // 非WebSocket传输由传输层直接报告写积压
+    void setBacklogProvider(const std::function<qint64()> &provider);
+
+    void setStallThresholdMs(int ms) { m_stallThresholdMs = ms; }
+
+    // 周期性转储，path为空或intervalSec<=0时关闭
+    void setDumpFile(const QString &path, int intervalSec);
+    bool dumpNow();
+
+    ConnectionStats snapshot() const;
+
+private slots:
+    void onTick();
+
+private:
+    void accumulateStateTime();
+    qint64 currentBacklog() const;
+
+    mutable QMutex m_mutex;
+    ConnectionStats m_stats;
+    QElapsedTimer m_clock;
+    qint64 m_connectedAtMs;
+    qint64 m_stateEnteredMs;
+    QString m_currentState;
+    double m_rttTotalMs;
+
+    // 速率结算
+    QTimer *m_tickTimer;
+    qint64 m_lastTickMs;
+    ThroughputMeter m_inboundAtTick;
+    ThroughputMeter m_outboundAtTick;
+
+    // 写积压估算
+    qint64 m_queuedWireBytes;
+    qint64 m_writtenBytes;
+    std::function<qint64()> m_backlogProvider;
+
+    // 断流检测
+    qint64 m_lastAudioArrivalMs;
+    int m_stallThresholdMs;
+
+    // 转储
+    QTimer *m_dumpTimer;
+    QString m_dumpPath;
+};
+
+#endif // CONNECTIONTELEMETRY_H
@@ -5,6 +5,9 @@
 #include <QAudioFormat>
 #include <QBuffer>
 #include <QThread>
+#include <QFileInfo>
+#include <QDir>
+#include <QStandardPaths>
 
 DeskPetController::DeskPetController(QObject *parent)
     : QObject(parent)
@@ -21,6 +24,9 @@ DeskPetController::DeskPetController(QObject *parent)
     , m_microphoneEnabled(true)
     , m_speakerEnabled(true)
     , m_animationEnabled(true)
+    , m_protocolVersion(1)
+    , m_telemetryIntervalSec(60)
+    , m_credentialSwapPending(false)
 {
     initializeComponents();
 }
@@ -124,6 +130,26 @@ bool DeskPetController::connectToServer()
     m_webSocketManager->setDeviceId(m_deviceId);
     m_webSocketManager->setClientId(m_clientId);
     m_webSocketManager->setAccessToken(m_accessToken);
+    m_webSocketManager->setProtocolVersion(m_protocolVersion);
+    
+    // 传输方式：auto时OTA只下发了MQTT信息才走MQTT+UDP（与固件选择逻辑一致）
+    const bool hasMqtt = !m_mqttInfo.isEmpty();
+    bool useMqtt = (m_transport == "mqtt_udp");
+    if (m_transport == "auto") {
+        useMqtt = hasMqtt && m_configManager->getConfig("SYSTEM_OPTIONS.NETWORK.WEBSOCKET_URL").toString().isEmpty();
+    }
+    if (useMqtt && !hasMqtt) {
+        qWarning() << "MQTT transport requested but MQTT_INFO is missing, falling back to WebSocket";
+        useMqtt = false;
+    }
+    if (useMqtt) {
+        m_webSocketManager->setMqttConfig(m_mqttInfo);
+        m_webSocketManager->setTransportType(TransportType::MqttUdp);
+    } else {
+        m_webSocketManager->setTransportType(TransportType::WebSocket);
+    }
+    
+    m_webSocketManager->setTelemetryDumpFile(m_telemetryFile, m_telemetryIntervalSec);
     
     // 连接服务器
     bool success = m_webSocketManager->connectToServer(m_serverUrl, m_accessToken);
@@ -242,6 +268,16 @@ DeviceState DeskPetController::getCurrentDeviceState() const
     return m_stateManager ? m_stateManager->getCurrentDeviceState() : DeviceState::DISCONNECTED;
 }
 
+ConnectionStats DeskPetController::getConnectionStats() const
+{
+    return m_webSocketManager ? m_webSocketManager->getConnectionStats() : ConnectionStats();
+}
+
+McpToolRegistry *DeskPetController::getMcpToolRegistry() const
+{
+    return m_webSocketManager ? m_webSocketManager->mcpToolRegistry() : nullptr;
+}
+
 bool DeskPetController::isListening() const
 {
     return m_stateManager ? m_stateManager->isListening() : false;
@@ -369,6 +405,8 @@ void DeskPetController::setupConnections()
     connect(m_webSocketManager, &WebSocketManager::llmMessageReceived, this, &DeskPetController::onWebSocketLLMReceived);
     connect(m_webSocketManager, &WebSocketManager::iotCommandReceived, this, &DeskPetController::onWebSocketIoTReceived);
     connect(m_webSocketManager, &WebSocketManager::audioDataReceived, this, &DeskPetController::onWebSocketAudioReceived);
+    connect(m_webSocketManager, &WebSocketManager::audioFrameReceived, this, &DeskPetController::onWebSocketAudioFrameReceived);
+    connect(m_webSocketManager, &WebSocketManager::stateChanged, this, &DeskPetController::onConnectionStateChanged);
     
     // 状态管理信号连接
     connect(m_stateManager, &DeskPetStateManager::behaviorChanged, this, &DeskPetController::onBehaviorChanged);
@@ -386,6 +424,52 @@ void DeskPetController::setupConnections()
     connect(m_stateManager, &DeskPetStateManager::emotionChanged, this, &DeskPetController::onEmotionChanged);
 }
 
+bool DeskPetController::reloadCredentials()
+{
+    const QString oldUrl = m_serverUrl;
+    const QString oldToken = m_accessToken;
+    const QJsonObject oldMqtt = m_mqttInfo;
+    
+    loadConfiguration();
+    
+    const bool changed = m_serverUrl != oldUrl || m_accessToken != oldToken || m_mqttInfo != oldMqtt;
+    if (!changed) {
+        qDebug() << "Credentials unchanged, keeping current connection";
+        return false;
+    }
+    
+    // 未连接时下次connectToServer会直接使用新配置
+    if (m_webSocketManager && m_webSocketManager->isConnected()) {
+        qDebug() << "Credentials changed, reconnecting when idle";
+        m_credentialSwapPending = true;
+        swapCredentialsIfIdle();
+    }
+    return true;
+}
+
+void DeskPetController::swapCredentialsIfIdle()
+{
+    if (!m_credentialSwapPending || !m_webSocketManager) {
+        return;
+    }
+    // 不打断正在进行的对话
+    if (m_webSocketManager->getCurrentState() != DeviceState::IDLE) {
+        return;
+    }
+    m_credentialSwapPending = false;
+    qDebug() << "Swapping credentials on live connection:" << m_serverUrl;
+    disconnectFromServer();
+    connectToServer();
+}
+
+void DeskPetController::onConnectionStateChanged(DeviceState newState)
+{
+    if (newState == DeviceState::IDLE && m_credentialSwapPending) {
+        // 状态变化信号中直接重连会重入WebSocketManager，放到下一轮事件循环
+        QTimer::singleShot(0, this, &DeskPetController::swapCredentialsIfIdle);
+    }
+}
+
 void DeskPetController::setupAudio()
 {
     // 设置音频格式
@@ -422,12 +506,24 @@ void DeskPetController::loadConfiguration()
     m_accessToken = m_configManager->getConfig("SYSTEM_OPTIONS.NETWORK.WEBSOCKET_ACCESS_TOKEN", "").toString();
     m_deviceId = m_configManager->getConfig("SYSTEM_OPTIONS.DEVICE_ID", "").toString();
     m_clientId = m_configManager->getConfig("SYSTEM_OPTIONS.CLIENT_ID", "").toString();
+    m_protocolVersion = m_configManager->getConfig("SYSTEM_OPTIONS.NETWORK.WEBSOCKET_PROTOCOL_VERSION", 1).toInt();
+    m_transport = m_configManager->getConfig("SYSTEM_OPTIONS.NETWORK.TRANSPORT", "websocket").toString();
+    if (m_transport.isEmpty()) {
+        m_transport = "websocket";
+    }
+    m_mqttInfo = QJsonObject::fromVariantMap(m_configManager->getConfig("SYSTEM_OPTIONS.NETWORK.MQTT_INFO").toMap());
+    m_telemetryFile = m_configManager->getConfig("SYSTEM_OPTIONS.NETWORK.TELEMETRY_DUMP_FILE", "").toString();
+    m_telemetryIntervalSec = m_configManager->getConfig("SYSTEM_OPTIONS.NETWORK.TELEMETRY_DUMP_INTERVAL", 60).toInt();
+    if (!m_telemetryFile.isEmpty() && QFileInfo(m_telemetryFile).isRelative()) {
+        m_telemetryFile = QDir(QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation)).filePath(m_telemetryFile);
+    }
     
     qDebug() << "Configuration loaded";
     qDebug() << "Server URL:" << m_serverUrl;
     qDebug() << "Access Token:" << m_accessToken;
     qDebug() << "Device ID:" << m_deviceId;
     qDebug() << "Client ID:" << m_clientId;
+    qDebug() << "Transport:" << m_transport;
 }
 
 void DeskPetController::saveConfiguration()
@@ -654,6 +750,12 @@ void DeskPetController::onWebSocketAudioReceived(const QByteArray &audioData)
     emit audioReceived(audioData);
 }
 
+void DeskPetController::onWebSocketAudioFrameReceived(const AudioFrame &frame)
+{
+    // 带时序信息的帧交给播放端抖动缓冲
+    emit audioFrameReceived(frame);
+}
+
 void DeskPetController::onBehaviorChanged(PetBehavior newBehavior)
 {
     emit behaviorChanged(newBehavior);
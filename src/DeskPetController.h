@@ -61,12 +61,16 @@ public:
     DeviceState getCurrentDeviceState() const;
     bool isListening() const;
     bool isSpeaking() const;
+    ConnectionStats getConnectionStats() const;
+    McpToolRegistry *getMcpToolRegistry() const;
     
     // 配置管理
     void setServerUrl(const QString &url);
     void setAccessToken(const QString &token);
     void setDeviceId(const QString &deviceId);
     void setClientId(const QString &clientId);
+    // OTA后台刷新后重新读取连接凭据，有变化且已连接时在空闲时重连，返回凭据是否变化
+    bool reloadCredentials();
     
     // 音频控制
     void setAudioEnabled(bool enabled);
@@ -95,6 +99,7 @@ signals:
     // 消息信号
     void messageReceived(const QString &message);
     void audioReceived(const QByteArray &audioData);
+    void audioFrameReceived(const AudioFrame &frame);
     void emotionChanged(const QString &emotion);
     void sttReceived(const QString &text);  // 用户语音识别消息
     
@@ -116,6 +121,7 @@ private slots:
     void onWebSocketLLMReceived(const QString &text, const QString &emotion);
     void onWebSocketIoTReceived(const QJsonObject &command);
     void onWebSocketAudioReceived(const QByteArray &audioData);
+    void onWebSocketAudioFrameReceived(const AudioFrame &frame);
     
     // 状态管理信号处理
     void onBehaviorChanged(PetBehavior newBehavior);
@@ -141,6 +147,7 @@ private slots:
     // 定时器处理
     void onHeartbeatTimeout();
     void onStatusUpdateTimeout();
+    void onConnectionStateChanged(DeviceState newState);
 
 private:
     // 核心组件
@@ -174,6 +181,12 @@ private:
     QString m_accessToken;
     QString m_deviceId;
     QString m_clientId;
+    int m_protocolVersion;
+    QString m_transport;          // websocket / mqtt_udp / auto
+    QJsonObject m_mqttInfo;       // OTA下发的MQTT连接信息
+    QString m_telemetryFile;      // 连接遥测转储文件（JSON Lines），为空不转储
+    int m_telemetryIntervalSec;
+    bool m_credentialSwapPending; // 凭据已更新，等会话空闲后重连
     
     // 内部方法
     void initializeComponents();
@@ -182,6 +195,7 @@ private:
     void setupTimers();
     void loadConfiguration();
     void saveConfiguration();
+    void swapCredentialsIfIdle();
     
     // 音频处理
     void startAudioInput();
@@ -1,4 +1,5 @@
 #include "DeskPetIntegration.h"
+#include "DeskPetMcpTools.h"
 #include <QDebug>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -71,6 +72,10 @@ bool DeskPetIntegration::initialize(MainWindow *mainWindow)
             return false;
         }
         
+        // 注册MCP工具，服务端通过tools/list发现
+        DeskPetMcpTools::registerAll(m_controller->getMcpToolRegistry(), m_mainWindow,
+                                     m_live2DManager, m_audioPlayer);
+        
         // 设置连接
         setupConnections();
         
@@ -173,6 +178,14 @@ void DeskPetIntegration::disconnectFromServer()
     m_connected = false;
 }
 
+void DeskPetIntegration::reloadCredentials()
+{
+    if (!m_initialized || !m_controller) {
+        return;
+    }
+    m_controller->reloadCredentials();
+}
+
 bool DeskPetIntegration::isConnected() const
 {
     return m_connected && m_controller && m_controller->isConnected();
@@ -426,6 +439,20 @@ void DeskPetIntegration::playAudioData(const QByteArray &audioData)
     }
 }
 
+void DeskPetIntegration::playAudioFrame(const AudioFrame &frame)
+{
+    if (frame.payload.isEmpty()) {
+        return;
+    }
+    
+    // 带序号的帧经过播放线程的抖动缓冲重排，原始帧按到达顺序播放
+    if (m_audioPlayer) {
+        m_audioPlayer->playReceivedAudioFrame(frame);
+    } else {
+        qWarning() << "AudioPlayer not initialized!";
+    }
+}
+
 void DeskPetIntegration::setupConnections()
 {
     if (!m_controller) return;
@@ -445,6 +472,7 @@ void DeskPetIntegration::setupConnections()
     connect(m_controller, &DeskPetController::deviceStateChanged, this, &DeskPetIntegration::onControllerDeviceStateChanged);
     connect(m_controller, &DeskPetController::messageReceived, this, &DeskPetIntegration::onControllerMessageReceived);
     connect(m_controller, &DeskPetController::audioReceived, this, &DeskPetIntegration::onControllerAudioReceived);
+    connect(m_controller, &DeskPetController::audioFrameReceived, this, &DeskPetIntegration::onControllerAudioFrameReceived);
     connect(m_controller, &DeskPetController::emotionChanged, this, &DeskPetIntegration::onControllerEmotionChanged);
     connect(m_controller, &DeskPetController::petInteraction, this, &DeskPetIntegration::onControllerPetInteraction);
     connect(m_controller, &DeskPetController::animationRequested, this, &DeskPetIntegration::onControllerAnimationRequested);
@@ -527,6 +555,7 @@ void DeskPetIntegration::handleEmotionChange(const QString &emotion)
     // 特殊处理：neutral 用于重置表情
     if (emotion.isEmpty() || emotion == "neutral") {
         qDebug() << "Resetting expression to neutral (F01)";
+        auto lock = m_live2DManager->LockSimulation();
         if (m_live2DManager->GetModel(0)) {
             m_live2DManager->GetModel(0)->SetExpression("F01");  // F01 是最温和的微笑
         }
@@ -596,7 +625,8 @@ void DeskPetIntegration::handleEmotionChange(const QString &emotion)
         expressionName = "F05";  // 默认开心表情
     }
     
-    // 调用 Live2D 管理器设置表情
+    // 调用 Live2D 管理器设置表情（持锁，避免与模拟线程同时修改模型）
+    auto lock = m_live2DManager->LockSimulation();
     if (m_live2DManager->GetModel(0)) {
         qDebug() << "Setting Live2D expression:" << expressionName << "for emotion:" << emotion;
         m_live2DManager->GetModel(0)->SetExpression(expressionName.toUtf8().constData());
@@ -716,13 +746,15 @@ void DeskPetIntegration::onControllerAudioReceived(const QByteArray &audioData)
     qDebug() << "=== Size:" << audioData.size() << "bytes";
     qDebug() << "========================================";
     
-    // 播放接收到的音频数据
-    playAudioData(audioData);
-    
-    // 发出信号供其他组件使用
+    // 播放由onControllerAudioFrameReceived负责，这里只转发给其他组件
     emit audioReceived(audioData);
 }
 
+void DeskPetIntegration::onControllerAudioFrameReceived(const AudioFrame &frame)
+{
+    playAudioFrame(frame);
+}
+
 void DeskPetIntegration::onControllerEmotionChanged(const QString &emotion)
 {
     qDebug() << "Emotion changed to:" << emotion;
@@ -28,6 +28,7 @@ public:
     bool connectToServer();
     void disconnectFromServer();
     bool isConnected() const;
+    void reloadCredentials();  // OTA配置刷新后重新读取连接凭据
     
     // 桌宠控制
     void startListening();
@@ -64,6 +65,7 @@ public:
     
     // 音频播放
     void playAudioData(const QByteArray &audioData);
+    void playAudioFrame(const AudioFrame &frame);
 
 signals:
     // 连接状态信号
@@ -97,6 +99,7 @@ private slots:
     void onControllerDeviceStateChanged(DeviceState newState);
     void onControllerMessageReceived(const QString &message);
     void onControllerAudioReceived(const QByteArray &audioData);
+    void onControllerAudioFrameReceived(const AudioFrame &frame);
     void onControllerEmotionChanged(const QString &emotion);
     void onControllerPetInteraction(const QString &interaction);
     void onControllerAnimationRequested(const QString &animationName);
@@ -0,0 +1,223 @@
+#include "DeskPetMcpTools.h"
+#include "McpToolRegistry.h"
+#include "MainWindow.h"
+#include "LAppLive2DManager.hpp"
+#include "LAppModel.hpp"
+#include "LAppDefine.hpp"
+#include "ResourceLoader.hpp"
+#include "AudioUtil.h"
+#include <QGuiApplication>
+#include <QScreen>
+#include <QPixmap>
+#include <QImage>
+#include <QBuffer>
+#include <QPointer>
+#include <QJsonArray>
+#include <QDebug>
+
+namespace {
+
+QJsonObject objectSchema(const QJsonObject &properties, const QStringList &required = QStringList())
+{
+    QJsonObject schema;
+    schema["type"] = "object";
+    schema["properties"] = properties;
+    if (!required.isEmpty()) {
+        schema["required"] = QJsonArray::fromStringList(required);
+    }
+    return schema;
+}
+
+McpTool setExpressionTool(LAppLive2DManager *live2DManager)
+{
+    McpTool tool;
+    tool.name = "self.live2d.set_expression";
+    tool.description = "设置桌宠的面部表情。name为模型表情ID，例如F01(微笑)、F04(惊讶)、F05(眯眼笑)。";
+    tool.inputSchema = objectSchema({
+        {"name", QJsonObject{{"type", "string"}, {"description", "表情ID"}}}
+    }, {"name"});
+    tool.handler = [live2DManager](const QJsonObject &arguments, const McpCallContext &context) {
+        const QByteArray name = arguments["name"].toString().toUtf8();
+        if (name.isEmpty()) {
+            return McpToolResult::error("Missing expression name");
+        }
+        bool found = false;
+        const bool ran = context.runOnMainThread([live2DManager, name, &found]() {
+            auto lock = live2DManager->LockSimulation();
+            LAppModel *model = live2DManager->GetModel(0);
+            if (model && model->ExpressionExists(name.constData())) {
+                model->SetExpression(name.constData());
+                found = true;
+            }
+        });
+        if (!ran) {
+            return McpToolResult::error("Cancelled");
+        }
+        return found ? McpToolResult::text(QString("Expression set: %1").arg(QString::fromUtf8(name)))
+                     : McpToolResult::error(QString("Unknown expression: %1").arg(QString::fromUtf8(name)));
+    };
+    return tool;
+}
+
+McpTool playMotionTool(LAppLive2DManager *live2DManager)
+{
+    McpTool tool;
+    tool.name = "self.live2d.play_motion";
+    tool.description = "播放桌宠的动作。group为动作组名（如Idle、TapBody），index省略时随机选择组内动作。";
+    tool.inputSchema = objectSchema({
+        {"group", QJsonObject{{"type", "string"}, {"description", "动作组名"}}},
+        {"index", QJsonObject{{"type", "integer"}, {"minimum", 0}, {"description", "组内动作序号"}}}
+    }, {"group"});
+    tool.handler = [live2DManager](const QJsonObject &arguments, const McpCallContext &context) {
+        const QByteArray group = arguments["group"].toString().toUtf8();
+        const int index = arguments.contains("index") ? arguments["index"].toInt(-1) : -1;
+        if (group.isEmpty()) {
+            return McpToolResult::error("Missing motion group");
+        }
+        QString error;
+        const bool ran = context.runOnMainThread([live2DManager, group, index, &error]() {
+            auto lock = live2DManager->LockSimulation();
+            LAppModel *model = live2DManager->GetModel(0);
+            if (!model) {
+                error = "Live2D model not loaded";
+                return;
+            }
+            if (!model->MotionGroupExists(group.constData())) {
+                error = QString("Unknown motion group: %1").arg(QString::fromUtf8(group));
+                return;
+            }
+            const Csm::CubismMotionQueueEntryHandle handle = index >= 0
+                ? model->StartMotion(group.constData(), index, LAppDefine::PriorityForce)
+                : model->StartRandomMotion(group.constData(), LAppDefine::PriorityForce);
+            if (handle == Csm::InvalidMotionQueueEntryHandleValue) {
+                error = "Motion could not be started";
+            }
+        });
+        if (!ran) {
+            return McpToolResult::error("Cancelled");
+        }
+        return error.isEmpty() ? McpToolResult::text(QString("Motion started: %1").arg(QString::fromUtf8(group)))
+                               : McpToolResult::error(error);
+    };
+    return tool;
+}
+
+McpTool changeModelTool(MainWindow *mainWindow)
+{
+    QJsonArray names;
+    for (const auto &model : resource_loader::get_instance().get_model_list()) {
+        names.append(model.name);
+    }
+
+    McpTool tool;
+    tool.name = "self.live2d.change_model";
+    tool.description = "切换桌宠使用的Live2D模型。";
+    tool.inputSchema = objectSchema({
+        {"name", QJsonObject{{"type", "string"}, {"enum", names}, {"description", "模型名"}}}
+    }, {"name"});
+    // 切换在后台进行，这里只发起请求；新模型就绪后才替换显示
+    tool.timeoutMs = 15000;
+    QPointer<MainWindow> window(mainWindow);
+    tool.handler = [window](const QJsonObject &arguments, const McpCallContext &context) {
+        const QString name = arguments["name"].toString();
+        bool switched = false;
+        const bool ran = context.runOnMainThread([window, name, &switched]() {
+            if (window) {
+                switched = window->switchModel(name);
+            }
+        });
+        if (!ran) {
+            return McpToolResult::error("Cancelled");
+        }
+        return switched ? McpToolResult::text(QString("Switching model to: %1").arg(name))
+                        : McpToolResult::error(QString("Unknown model: %1").arg(name));
+    };
+    return tool;
+}
+
+McpTool setVolumeTool(AudioPlayer *audioPlayer)
+{
+    McpTool tool;
+    tool.name = "self.audio_speaker.set_volume";
+    tool.description = "设置桌宠说话的音量，范围0-100。";
+    tool.inputSchema = objectSchema({
+        {"volume", QJsonObject{{"type", "integer"}, {"minimum", 0}, {"maximum", 100}}}
+    }, {"volume"});
+    tool.handler = [audioPlayer](const QJsonObject &arguments, const McpCallContext &) {
+        if (!arguments["volume"].isDouble()) {
+            return McpToolResult::error("Missing volume");
+        }
+        // 音量为原子量，可在工作线程直接设置
+        const int volume = qBound(0, arguments["volume"].toInt(), 100);
+        audioPlayer->setVolume(volume);
+        return McpToolResult::text(QString("Volume set to %1").arg(volume));
+    };
+    return tool;
+}
+
+McpTool captureScreenTool()
+{
+    McpTool tool;
+    tool.name = "self.screen.capture";
+    tool.description = "截取主屏幕画面，返回JPEG图片。max_width限制输出宽度（默认1280）。";
+    tool.inputSchema = objectSchema({
+        {"max_width", QJsonObject{{"type", "integer"}, {"minimum", 160}, {"maximum", 3840}}},
+        {"quality", QJsonObject{{"type", "integer"}, {"minimum", 10}, {"maximum", 100}}}
+    });
+    tool.timeoutMs = 10000;
+    tool.handler = [](const QJsonObject &arguments, const McpCallContext &context) {
+        const int maxWidth = qBound(160, arguments["max_width"].toInt(1280), 3840);
+        const int quality = qBound(10, arguments["quality"].toInt(70), 100);
+
+        // 截屏必须在主线程，缩放和编码放在工作线程
+        QImage image;
+        const bool ran = context.runOnMainThread([&image]() {
+            QScreen *screen = QGuiApplication::primaryScreen();
+            if (screen) {
+                image = screen->grabWindow(0).toImage();
+            }
+        });
+        if (!ran) {
+            return McpToolResult::error("Cancelled");
+        }
+        if (image.isNull()) {
+            return McpToolResult::error("Screen capture failed");
+        }
+        if (image.width() > maxWidth) {
+            image = image.scaledToWidth(maxWidth, Qt::SmoothTransformation);
+        }
+        if (context.isCancelled()) {
+            return McpToolResult::error("Cancelled");
+        }
+
+        QByteArray jpeg;
+        QBuffer buffer(&jpeg);
+        buffer.open(QIODevice::WriteOnly);
+        if (!image.save(&buffer, "JPEG", quality)) {
+            return McpToolResult::error("JPEG encoding failed");
+        }
+        return McpToolResult::image(jpeg, "image/jpeg");
+    };
+    return tool;
+}
+
+} // namespace
+
+void DeskPetMcpTools::registerAll(McpToolRegistry *registry, MainWindow *mainWindow,
+                                  LAppLive2DManager *live2DManager, AudioPlayer *audioPlayer)
+{
+    if (!registry) {
+        return;
+    }
+    if (live2DManager) {
+        registry->registerTool(setExpressionTool(live2DManager));
+        registry->registerTool(playMotionTool(live2DManager));
+    }
+    if (mainWindow) {
+        registry->registerTool(changeModelTool(mainWindow));
+    }
+    if (audioPlayer) {
+        registry->registerTool(setVolumeTool(audioPlayer));
+    }
+    registry->registerTool(captureScreenTool());
+}
@@ -0,0 +1,22 @@
+#ifndef DESKPETMCPTOOLS_H
+#define DESKPETMCPTOOLS_H
+
+class McpToolRegistry;
+class MainWindow;
+class AudioPlayer;
+class LAppLive2DManager;
+
+/**
+ * @brief 桌宠对外提供的MCP工具
+ *
+ * 表情、动作、模型切换、音量、截屏。处理函数运行在MCP工作线程上，
+ * 涉及Live2D和界面的操作通过 McpCallContext::runOnMainThread 切回主线程。
+ */
+class DeskPetMcpTools
+{
+public:
+    static void registerAll(McpToolRegistry *registry, MainWindow *mainWindow,
+                            LAppLive2DManager *live2DManager, AudioPlayer *audioPlayer);
+};
+
+#endif // DESKPETMCPTOOLS_H
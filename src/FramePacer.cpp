@@ -0,0 +1,295 @@
+#include "FramePacer.h"
+#include <QTimer>
+#include <QWidget>
+#include <QWindow>
+#include <QEvent>
+#include <QJsonArray>
+#include <QMetaObject>
+#include <QStringList>
+#include <QDebug>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+constexpr int kDefaultActiveIntervalMs = 16;    // 约60fps
+constexpr int kDefaultIdleIntervalMs = 66;      // 约15fps
+constexpr int kDefaultIdleDelayMs = 1000;
+
+// 进程累计CPU时间（用户态+内核态）
+qint64 processCpuTimeMs()
+{
+#ifdef _WIN32
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+        return 0;
+    }
+    auto toMs = [](const FILETIME &time) {
+        ULARGE_INTEGER value;
+        value.LowPart = time.dwLowDateTime;
+        value.HighPart = time.dwHighDateTime;
+        return static_cast<qint64>(value.QuadPart / 10000);    // 100ns为单位
+    };
+    return toMs(kernelTime) + toMs(userTime);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return static_cast<qint64>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000
+           + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000;
+#endif
+}
+
+} // namespace
+
+QJsonObject FramePacer::ModeStats::toJson() const
+{
+    QJsonObject obj;
+    obj["wall_ms"] = wallMs;
+    obj["cpu_ms"] = cpuMs;
+    obj["cpu_percent"] = wallMs > 0 ? 100.0 * cpuMs / wallMs : 0.0;
+    obj["render_ms"] = renderUs / 1000.0;
+    obj["frames"] = static_cast<qint64>(frames);
+    obj["fps"] = wallMs > 0 ? 1000.0 * frames / wallMs : 0.0;
+    return obj;
+}
+
+FramePacer::FramePacer(QWidget *target, QObject *parent)
+    : QObject(parent)
+    , m_target(target)
+    , m_timer(new QTimer(this))
+    , m_mode(Mode::Paused)
+    , m_started(false)
+    , m_activeIntervalMs(kDefaultActiveIntervalMs)
+    , m_idleIntervalMs(kDefaultIdleIntervalMs)
+    , m_idleDelayMs(kDefaultIdleDelayMs)
+    , m_lastActiveMs(0)
+    , m_wakePending(false)
+    , m_modeEnteredMs(0)
+    , m_modeEnteredCpuMs(0)
+{
+    connect(m_timer, &QTimer::timeout, m_target, [this]() { m_target->update(); });
+}
+
+FramePacer::~FramePacer()
+{
+    if (m_started) {
+        accumulate();
+        qInfo().noquote() << "Frame pacing\n" + reportTable();
+    }
+}
+
+QString FramePacer::modeName(Mode mode)
+{
+    switch (mode) {
+    case Mode::Active:
+        return QStringLiteral("active");
+    case Mode::Idle:
+        return QStringLiteral("idle");
+    case Mode::Paused:
+        return QStringLiteral("paused");
+    }
+    return QString();
+}
+
+void FramePacer::setActiveInterval(int ms)
+{
+    m_activeIntervalMs = qMax(1, ms);
+    if (m_mode == Mode::Active && m_timer->isActive()) {
+        m_timer->start(m_activeIntervalMs);
+    }
+}
+
+void FramePacer::setIdleInterval(int ms)
+{
+    m_idleIntervalMs = qMax(1, ms);
+    if (m_mode == Mode::Idle && m_timer->isActive()) {
+        m_timer->start(m_idleIntervalMs);
+    }
+}
+
+void FramePacer::start()
+{
+    if (m_started) {
+        return;
+    }
+    m_started = true;
+    m_clock.start();
+    m_modeEnteredMs = 0;
+    m_modeEnteredCpuMs = processCpuTimeMs();
+    m_lastActiveMs = 0;
+
+    // 顶层窗口的显示/隐藏/最小化，以及原生窗口的暴露状态（被遮挡、切到其他桌面）
+    m_target->window()->installEventFilter(this);
+    if (QWindow *handle = m_target->window()->windowHandle()) {
+        handle->installEventFilter(this);
+    }
+    updateVisibility();
+}
+
+void FramePacer::frameRendered(bool active, qint64 renderUs)
+{
+    if (!m_started) {
+        return;
+    }
+    ModeStats &stats = m_stats[static_cast<int>(m_mode)];
+    stats.frames++;
+    stats.renderUs += renderUs;
+
+    const qint64 now = m_clock.elapsed();
+    if (active) {
+        m_lastActiveMs = now;
+        if (m_mode == Mode::Idle) {
+            setMode(Mode::Active);
+        }
+    } else if (m_mode == Mode::Active && now - m_lastActiveMs > m_idleDelayMs) {
+        setMode(Mode::Idle);
+    }
+}
+
+void FramePacer::notifyActivity()
+{
+    // 口型数据按音频包到达，合并成一次唤醒
+    if (m_wakePending.exchange(true)) {
+        return;
+    }
+    QMetaObject::invokeMethod(this, [this]() { wake(); }, Qt::QueuedConnection);
+}
+
+void FramePacer::wake()
+{
+    m_wakePending = false;
+    if (!m_started) {
+        return;
+    }
+    m_lastActiveMs = m_clock.elapsed();
+    if (m_mode == Mode::Idle) {
+        setMode(Mode::Active);
+        m_target->update();
+    }
+}
+
+bool FramePacer::eventFilter(QObject *watched, QEvent *event)
+{
+    switch (event->type()) {
+    case QEvent::Show:
+        // 原生窗口在首次显示时才创建
+        if (QWindow *handle = m_target->window()->windowHandle()) {
+            handle->installEventFilter(this);
+        }
+        updateVisibility();
+        break;
+    case QEvent::Hide:
+    case QEvent::WindowStateChange:
+    case QEvent::Expose:
+        // 在事件处理之后再检查状态
+        QMetaObject::invokeMethod(this, [this]() { updateVisibility(); }, Qt::QueuedConnection);
+        break;
+    default:
+        break;
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void FramePacer::updateVisibility()
+{
+    if (!m_started) {
+        return;
+    }
+    QWidget *window = m_target->window();
+    const QWindow *handle = window->windowHandle();
+    const bool visible = m_target->isVisible() && !window->isMinimized() && (handle == nullptr || handle->isExposed());
+
+    if (!visible) {
+        setMode(Mode::Paused);
+    } else if (m_mode == Mode::Paused) {
+        // 恢复时先按高帧率绘制，活动结束后再降下来
+        m_lastActiveMs = m_clock.elapsed();
+        setMode(Mode::Active);
+        m_target->update();
+    }
+}
+
+void FramePacer::setMode(Mode mode)
+{
+    if (m_mode == mode) {
+        return;
+    }
+    accumulate();
+    const Mode previous = m_mode;
+    m_mode = mode;
+
+    if (mode == Mode::Paused) {
+        m_timer->stop();
+    } else {
+        // 低帧率时允许合并定时器唤醒
+        m_timer->setTimerType(mode == Mode::Active ? Qt::PreciseTimer : Qt::CoarseTimer);
+        m_timer->start(intervalFor(mode));
+    }
+    qDebug() << "Frame pacing:" << modeName(previous) << "->" << modeName(mode);
+    emit modeChanged(mode);
+}
+
+void FramePacer::accumulate()
+{
+    const qint64 now = m_clock.elapsed();
+    const qint64 cpu = processCpuTimeMs();
+    ModeStats &stats = m_stats[static_cast<int>(m_mode)];
+    stats.wallMs += now - m_modeEnteredMs;
+    stats.cpuMs += cpu - m_modeEnteredCpuMs;
+    m_modeEnteredMs = now;
+    m_modeEnteredCpuMs = cpu;
+}
+
+int FramePacer::intervalFor(Mode mode) const
+{
+    return mode == Mode::Active ? m_activeIntervalMs : m_idleIntervalMs;
+}
+
+FramePacer::ModeStats FramePacer::stats(Mode mode) const
+{
+    ModeStats result = m_stats[static_cast<int>(mode)];
+    if (m_started && mode == m_mode) {
+        // 当前模式加上尚未结算的部分
+        result.wallMs += m_clock.elapsed() - m_modeEnteredMs;
+        result.cpuMs += processCpuTimeMs() - m_modeEnteredCpuMs;
+    }
+    return result;
+}
+
+QJsonObject FramePacer::report() const
+{
+    QJsonObject modes;
+    for (Mode mode : {Mode::Active, Mode::Idle, Mode::Paused}) {
+        modes[modeName(mode)] = stats(mode).toJson();
+    }
+    QJsonObject result;
+    result["mode"] = modeName(m_mode);
+    result["active_interval_ms"] = m_activeIntervalMs;
+    result["idle_interval_ms"] = m_idleIntervalMs;
+    result["modes"] = modes;
+    return result;
+}
+
+QString FramePacer::reportTable() const
+{
+    QStringList lines;
+    lines << QString("%1 %2 %3 %4 %5 %6")
+                 .arg("mode", -7).arg("time_s", 9).arg("fps", 6).arg("cpu%", 6).arg("render_ms", 10).arg("frames", 8);
+    for (Mode mode : {Mode::Active, Mode::Idle, Mode::Paused}) {
+        const ModeStats modeStats = stats(mode);
+        lines << QString("%1 %2 %3 %4 %5 %6")
+                     .arg(modeName(mode), -7)
+                     .arg(modeStats.wallMs / 1000.0, 9, 'f', 1)
+                     .arg(modeStats.wallMs > 0 ? 1000.0 * modeStats.frames / modeStats.wallMs : 0.0, 6, 'f', 1)
+                     .arg(modeStats.wallMs > 0 ? 100.0 * modeStats.cpuMs / modeStats.wallMs : 0.0, 6, 'f', 1)
+                     .arg(modeStats.renderUs / 1000.0, 10, 'f', 1)
+                     .arg(modeStats.frames, 8);
+    }
+    return lines.join('\n');
+}
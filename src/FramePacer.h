@@ -0,0 +1,97 @@
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <QObject>
+#include <QString>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include <atomic>
+
+class QTimer;
+class QWidget;
+
+/**
+ * @brief 按需调度重绘
+ *
+ * 三种模式：
+ *   Active  动作、拖动、口型等进行中，高帧率
+ *   Idle    只有待机动作和呼吸，低帧率
+ *   Paused  窗口隐藏、最小化或被完全遮挡，不再重绘
+ *
+ * 每帧绘制后由目标控件报告模型是否仍在活动；拖动、口型音频、
+ * 播放动作等外部事件通过 notifyActivity() 立即切回高帧率。
+ * 按模式累计耗时、进程CPU时间、绘制耗时和帧数。
+ */
+class FramePacer : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Mode {
+        Active,
+        Idle,
+        Paused
+    };
+
+    struct ModeStats {
+        qint64 wallMs = 0;      // 处于该模式的时间
+        qint64 cpuMs = 0;       // 该模式期间进程消耗的CPU时间（所有线程）
+        qint64 renderUs = 0;    // 绘制（paintGL）本身的耗时
+        quint64 frames = 0;
+
+        QJsonObject toJson() const;
+    };
+
+    explicit FramePacer(QWidget *target, QObject *parent = nullptr);
+    ~FramePacer();
+
+    static QString modeName(Mode mode);
+
+    void setActiveInterval(int ms);
+    void setIdleInterval(int ms);
+    // 活动结束后保持高帧率的时间，避免动作衔接处来回切换
+    void setIdleDelay(int ms) { m_idleDelayMs = ms; }
+
+    void start();
+
+    // 每帧绘制结束后调用
+    void frameRendered(bool active, qint64 renderUs);
+
+    // 任意线程可调用
+    void notifyActivity();
+
+    Mode mode() const { return m_mode; }
+    ModeStats stats(Mode mode) const;
+    QJsonObject report() const;
+    QString reportTable() const;
+
+signals:
+    void modeChanged(FramePacer::Mode mode);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    void wake();
+    void updateVisibility();
+    void setMode(Mode mode);
+    void accumulate();
+    int intervalFor(Mode mode) const;
+
+    QWidget *m_target;
+    QTimer *m_timer;
+    Mode m_mode;
+    bool m_started;
+    int m_activeIntervalMs;
+    int m_idleIntervalMs;
+    int m_idleDelayMs;
+    qint64 m_lastActiveMs;
+    std::atomic<bool> m_wakePending;
+
+    QElapsedTimer m_clock;
+    qint64 m_modeEnteredMs;
+    qint64 m_modeEnteredCpuMs;
+    ModeStats m_stats[3];
+};
+
+#endif // FRAMEPACER_H
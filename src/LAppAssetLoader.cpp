@@ -0,0 +1,319 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppAssetLoader.hpp"
+#include "LAppModelBundle.hpp"
+#include <CubismModelSettingJson.hpp>
+#include <QObject>
+#include <QMetaObject>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <cstring>
+#include "LogUtil.h"
+#include "TraceProfiler.h"
+
+using namespace Csm;
+
+namespace {
+    LAppAssetLoader* s_instance = nullptr;
+}
+
+LAppModelAssets::~LAppModelAssets()
+{
+    delete setting;
+    for (size_t i = 0; i < images.size(); i++) {
+        LAppTextureManager::ReleaseDecodedImage(images[i]);
+    }
+}
+
+const LAppFileView* LAppModelAssets::FindFile(const std::string& path) const
+{
+    const auto it = files.find(path);
+    return it != files.end() ? it->second.get() : nullptr;
+}
+
+LAppAssetLoader* LAppAssetLoader::GetInstance()
+{
+    if (s_instance == nullptr) {
+        s_instance = new LAppAssetLoader();
+    }
+    return s_instance;
+}
+
+void LAppAssetLoader::ReleaseInstance()
+{
+    delete s_instance;
+    s_instance = nullptr;
+}
+
+LAppAssetLoader::LAppAssetLoader()
+    : _pool(new QThreadPool())
+    , _receiver(new QObject())
+{
+    _pool->setObjectName("AssetLoaderPool");
+    // 贴图解码是主要耗时，线程数按核数取，但给主线程和音频线程留出余量
+    _pool->setMaxThreadCount(qMax(2, QThread::idealThreadCount() - 1));
+}
+
+LAppAssetLoader::~LAppAssetLoader()
+{
+    _pool->waitForDone();
+    delete _pool;
+    delete _receiver;
+}
+
+void LAppAssetLoader::Preload(const std::string& dir, const std::string& fileName, const std::function<void(bool)>& onFinished)
+{
+    const std::string key = dir + fileName;
+    auto it = _requests.find(key);
+    std::shared_ptr<Request> request = it != _requests.end() ? it->second : Start(dir, fileName);
+
+    if (!onFinished) {
+        return;
+    }
+    if (request->finished) {
+        const bool succeeded = request->assets->succeeded;
+        QMetaObject::invokeMethod(_receiver, [onFinished, succeeded]() { onFinished(succeeded); }, Qt::QueuedConnection);
+    } else {
+        request->observers.push_back(onFinished);
+    }
+}
+
+void LAppAssetLoader::Take(const std::string& dir, const std::string& fileName, const Callback& callback)
+{
+    const std::string key = dir + fileName;
+    auto it = _requests.find(key);
+    std::shared_ptr<Request> request = it != _requests.end() ? it->second : Start(dir, fileName);
+
+    if (request->finished) {
+        _requests.erase(key);
+        std::shared_ptr<LAppModelAssets> assets = request->assets;
+        QMetaObject::invokeMethod(_receiver, [callback, assets]() { callback(assets); }, Qt::QueuedConnection);
+    } else {
+        request->taker = callback;
+    }
+}
+
+std::shared_ptr<LAppAssetLoader::Request> LAppAssetLoader::Start(const std::string& dir, const std::string& fileName)
+{
+    CF_LOG_DEBUG("start background loading: %s%s", dir.c_str(), fileName.c_str());
+
+    std::shared_ptr<Request> request = std::make_shared<Request>();
+    request->assets = std::make_shared<LAppModelAssets>();
+    request->assets->dir = dir;
+    request->assets->fileName = fileName;
+    request->timer.start();
+    _requests[dir + fileName] = request;
+
+    _pool->start(QRunnable::create([this, request]() {
+        LoadFiles(request);
+    }));
+    return request;
+}
+
+void LAppAssetLoader::LoadFiles(const std::shared_ptr<Request>& request)
+{
+    CF_TRACE_SCOPE_CAT("LAppAssetLoader::LoadFiles", "asset");
+    LAppModelAssets& assets = *request->assets;
+    const std::string key = assets.dir + assets.fileName;
+
+    if (LoadFromBundle(assets)) {
+        QMetaObject::invokeMethod(_receiver, [this, key, request]() { Finish(key, request); }, Qt::QueuedConnection);
+        return;
+    }
+
+    const std::shared_ptr<LAppFileView> settingFile = LAppFileView::Open(key);
+    if (!settingFile) {
+        QMetaObject::invokeMethod(_receiver, [this, key, request]() { Finish(key, request); }, Qt::QueuedConnection);
+        return;
+    }
+    CubismModelSettingJson* setting = new CubismModelSettingJson(settingFile->GetData(), settingFile->GetSize());
+    assets.setting = setting;
+    if (setting->GetJsonPointer() == NULL) {
+        CF_LOG_ERROR("failed to parse model setting: %s", key.c_str());
+        QMetaObject::invokeMethod(_receiver, [this, key, request]() { Finish(key, request); }, Qt::QueuedConnection);
+        return;
+    }
+
+    // model3.jsonが参照するファイルをすべて開く。大きいファイル（moc3等）はマッピングするだけでコピーしない
+    std::vector<std::string> paths;
+    const auto addFile = [&paths, &assets](const csmChar* name) {
+        if (name != NULL && strcmp(name, "") != 0) {
+            paths.push_back(assets.dir + name);
+        }
+    };
+    addFile(setting->GetModelFileName());
+    for (csmInt32 i = 0; i < setting->GetExpressionCount(); i++) {
+        addFile(setting->GetExpressionFileName(i));
+    }
+    addFile(setting->GetPhysicsFileName());
+    addFile(setting->GetPoseFileName());
+    addFile(setting->GetUserDataFile());
+    for (csmInt32 i = 0; i < setting->GetMotionGroupCount(); i++) {
+        const csmChar* group = setting->GetMotionGroupName(i);
+        for (csmInt32 j = 0; j < setting->GetMotionCount(group); j++) {
+            addFile(setting->GetMotionFileName(group, j));
+        }
+    }
+    for (size_t i = 0; i < paths.size(); i++) {
+        if (assets.files.find(paths[i]) != assets.files.end()) {
+            continue;
+        }
+        std::shared_ptr<LAppFileView> file = LAppFileView::Open(paths[i]);
+        if (file) {
+            assets.files.emplace(paths[i], file);
+        }
+    }
+    assets.succeeded = strcmp(setting->GetModelFileName(), "") == 0
+                       || assets.FindFile(assets.dir + setting->GetModelFileName()) != nullptr;
+
+    // テクスチャはそれぞれ別のワーカーでデコードする
+    const csmInt32 textureCount = setting->GetTextureCount();
+    assets.images.resize(textureCount);
+    std::vector<std::pair<size_t, std::string> > textures;
+    for (csmInt32 i = 0; i < textureCount; i++) {
+        if (strcmp(setting->GetTextureFileName(i), "") != 0) {
+            textures.push_back(std::make_pair(static_cast<size_t>(i), assets.dir + setting->GetTextureFileName(i)));
+        }
+    }
+    if (textures.empty()) {
+        QMetaObject::invokeMethod(_receiver, [this, key, request]() { Finish(key, request); }, Qt::QueuedConnection);
+        return;
+    }
+    request->pendingImages.store(static_cast<int>(textures.size()));
+    for (size_t i = 0; i < textures.size(); i++) {
+        const size_t index = textures[i].first;
+        const std::string path = textures[i].second;
+        _pool->start(QRunnable::create([this, request, index, path]() {
+            DecodeImage(request, index, path);
+        }));
+    }
+}
+
+void LAppAssetLoader::DecodeImage(const std::shared_ptr<Request>& request, size_t index, const std::string& path)
+{
+    CF_TRACE_SCOPE_CAT("LAppAssetLoader::DecodeImage", "asset");
+    // 各ワーカーは自分の番号の要素だけを書き換える
+    if (!LAppTextureManager::DecodePngFile(path, request->assets->images[index])) {
+        CF_LOG_ERROR("failed to decode texture: %s", path.c_str());
+    }
+
+    if (request->pendingImages.fetch_sub(1) == 1) {
+        const std::string key = request->assets->dir + request->assets->fileName;
+        QMetaObject::invokeMethod(_receiver, [this, key, request]() { Finish(key, request); }, Qt::QueuedConnection);
+    }
+}
+
+bool LAppAssetLoader::LoadFromBundle(LAppModelAssets& assets)
+{
+    const std::string bundlePath = LAppModelBundle::GetBundlePath(assets.dir, assets.fileName);
+    const std::shared_ptr<LAppModelBundle> bundle = LAppModelBundle::Open(bundlePath);
+    if (!bundle) {
+        return false;
+    }
+    CF_TRACE_SCOPE_CAT("LAppAssetLoader::LoadFromBundle", "asset");
+
+    const LAppModelBundle::Entry* settingEntry = bundle->Find(assets.fileName, LAppModelBundle::EntryType_File);
+    const std::shared_ptr<LAppFileView> settingFile = settingEntry != NULL ? bundle->ReadSection(*settingEntry) : nullptr;
+    if (!settingFile) {
+        CF_LOG_ERROR("model setting not found in bundle: %s", bundlePath.c_str());
+        return false;
+    }
+    CubismModelSettingJson* setting = new CubismModelSettingJson(settingFile->GetData(), settingFile->GetSize());
+    if (setting->GetJsonPointer() == NULL) {
+        CF_LOG_ERROR("failed to parse model setting in bundle: %s", bundlePath.c_str());
+        delete setting;
+        return false;
+    }
+    assets.setting = setting;
+
+    // 無圧縮のセクションはマッピングの一部を指すだけでコピーしない
+    for (uint32_t i = 0; i < bundle->GetEntryCount(); i++) {
+        const LAppModelBundle::Entry& entry = bundle->GetEntry(i);
+        if (entry.type != LAppModelBundle::EntryType_File) {
+            continue;
+        }
+        std::shared_ptr<LAppFileView> section = bundle->ReadSection(entry);
+        if (section) {
+            assets.files[assets.dir + bundle->GetPath(entry)] = section;
+        }
+    }
+    assets.succeeded = strcmp(setting->GetModelFileName(), "") == 0
+                       || assets.FindFile(assets.dir + setting->GetModelFileName()) != nullptr;
+
+#ifdef PREMULTIPLIED_ALPHA_ENABLE
+    const bool premultiplied = true;
+#else
+    const bool premultiplied = false;
+#endif
+    const csmInt32 textureCount = setting->GetTextureCount();
+    assets.images.resize(textureCount);
+    for (csmInt32 i = 0; i < textureCount; i++) {
+        const std::string name = setting->GetTextureFileName(i);
+        if (name.empty()) {
+            continue;
+        }
+        LAppTextureManager::DecodedImage& image = assets.images[i];
+        image.fileName = assets.dir + name;
+
+        const LAppModelBundle::Entry* texture = bundle->Find(name, LAppModelBundle::EntryType_Texture);
+        if (texture != NULL && ((texture->flags & LAppModelBundle::TextureFlag_Premultiplied) != 0) != premultiplied) {
+            CF_LOG_ERROR("texture alpha mode in bundle does not match this build, decoding png instead: %s", name.c_str());
+            texture = NULL;
+        }
+        const std::shared_ptr<LAppFileView> pixels = texture != NULL ? bundle->ReadSection(*texture) : nullptr;
+        if (pixels) {
+            image.width = static_cast<int>(texture->width);
+            image.height = static_cast<int>(texture->height);
+            image.mipLevels = static_cast<int>(texture->mipLevels);
+            image.pixels = const_cast<unsigned char*>(pixels->GetData());
+            image.owner = pixels;
+            continue;
+        }
+
+        // デコード済みの画像が無ければPNGからデコードする（バンドル内、なければディレクトリ）
+        const LAppModelBundle::Entry* png = bundle->Find(name, LAppModelBundle::EntryType_File);
+        const std::shared_ptr<LAppFileView> pngFile = png != NULL ? bundle->ReadSection(*png) : nullptr;
+        const bool decoded = pngFile
+                             ? LAppTextureManager::DecodePngMemory(image.fileName, pngFile->GetData(), pngFile->GetSize(), image)
+                             : LAppTextureManager::DecodePngFile(image.fileName, image);
+        if (!decoded) {
+            CF_LOG_ERROR("failed to decode texture: %s", image.fileName.c_str());
+        }
+    }
+
+    CF_LOG_DEBUG("model assets loaded from bundle: %s", bundlePath.c_str());
+    return true;
+}
+
+void LAppAssetLoader::Finish(const std::string& key, const std::shared_ptr<Request>& request)
+{
+    request->finished = true;
+    request->assets->loadSeconds = static_cast<double>(request->timer.nsecsElapsed()) / 1e9;
+    CF_LOG_INFO("background loading finished: %s (%.1f ms, %d files, %d textures)", key.c_str(),
+                request->assets->loadSeconds * 1000.0, static_cast<int>(request->assets->files.size()),
+                static_cast<int>(request->assets->images.size()));
+
+    const std::vector<std::function<void(bool)> > observers = request->observers;
+    request->observers.clear();
+    for (size_t i = 0; i < observers.size(); i++) {
+        observers[i](request->assets->succeeded);
+    }
+
+    if (!request->taker) {
+        // Takeされるまで保持する
+        return;
+    }
+    const auto it = _requests.find(key);
+    if (it != _requests.end() && it->second == request) {
+        _requests.erase(it);
+    }
+    const Callback taker = request->taker;
+    request->taker = nullptr;
+    taker(request->assets);
+}
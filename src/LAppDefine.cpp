@@ -68,6 +68,19 @@ namespace LAppDefine {
     const csmInt32 PriorityNormal = 2;
     const csmInt32 PriorityForce = 3;
 
+    // 待機以外のモーションは再生時に読み込み、この上限まで保持する（超えたら使われていない順に解放）
+    const csmSizeInt MotionCacheBudget = 4 * 1024 * 1024;
+
+    // モデルを切り替えたあと、直前のモデルをテクスチャごと保持しておく数（すぐに戻すときは読み込み不要）
+    const csmInt32 ModelWarmPoolSize = 1;
+
+    // テクスチャの合計がこれを超えたら、どのモデルからも参照されていないものを古い順に削除する
+    const csmSizeInt TextureMemoryBudget = 128 * 1024 * 1024;
+
+    // モーション・物理演算などの更新をシミュレーションスレッドで行い、描画スレッドは前回の結果を描くだけにする
+    // 显示会比同步更新晚一帧；关闭后在paintGL里依次更新和绘制
+    const csmBool SimulationThreadEnable = true;
+
     // デバッグ用ログの表示オプション
 #ifdef QF_DEBUG
     const csmBool DebugLogEnable = true;
@@ -13,7 +13,9 @@
 #include "LAppDefine.hpp"
 #include "LAppLive2DManager.hpp"
 #include "LAppTextureManager.hpp"
+#include "LAppAssetLoader.hpp"
 #include "LogUtil.h"
+#include "TraceProfiler.h"
 
 using namespace Csm;
 using namespace std;
@@ -41,6 +43,7 @@ void LAppDelegate::ReleaseInstance() {
 
 bool LAppDelegate::Initialize(GLWidget *window) {
     CF_LOG_DEBUG("START" );
+    CF_TRACE_SCOPE("LAppDelegate::Initialize");
 
 
     if (glewInit() != GLEW_OK) {
@@ -48,6 +51,25 @@ bool LAppDelegate::Initialize(GLWidget *window) {
         return GL_FALSE;
     }
 
+    _window = window;
+    return InitializeRendering(window->width(), window->height());
+}
+
+bool LAppDelegate::InitializeOffscreen(int width, int height) {
+    CF_TRACE_SCOPE("LAppDelegate::InitializeOffscreen");
+
+    // EGLのコンテキストにはGLXのディスプレイがないので、GL関数を取得した後のGLX拡張の初期化だけが失敗する
+    const GLenum glewResult = glewInit();
+    if (glewResult != GLEW_OK && glewResult != GLEW_ERROR_NO_GLX_DISPLAY) {
+        CF_LOG_ERROR("Failed to initialize GLEW: %d", glewResult);
+        return GL_FALSE;
+    }
+
+    _window = nullptr;
+    return InitializeRendering(width, height);
+}
+
+bool LAppDelegate::InitializeRendering(int width, int height) {
     //テクスチャサンプリング設定
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -57,9 +79,8 @@ bool LAppDelegate::Initialize(GLWidget *window) {
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     //コールバック関数の登録
     // ウィンドウサイズ記憶
-    _windowWidth = window->width();
-    _windowHeight = window->height();
-    _window = window;
+    _windowWidth = width;
+    _windowHeight = height;
     //AppViewの初期化
     _view->Initialize();
 
@@ -75,12 +96,17 @@ void LAppDelegate::Release() {
     // Windowの削除
     glfwTerminate();
 
-    delete _textureManager;
     delete _view;
 
-    // リソースを解放
+    // 読み込み中のワーカーを待ってから、未使用の読み込み結果を捨てる
+    LAppAssetLoader::ReleaseInstance();
+
+    // リソースを解放（モデルがテクスチャの参照を返すので、テクスチャマネージャーより先に）
     LAppLive2DManager::ReleaseInstance();
 
+    delete _textureManager;
+    _textureManager = nullptr;
+
     //Cubism SDK の解放
     CubismFramework::Dispose();
 }
@@ -88,19 +114,25 @@ void LAppDelegate::Release() {
 
 void LAppDelegate::resize(int width, int height) {
     if ((_windowWidth != width || _windowHeight != height) && width > 0 && height > 0) {
+        // サイズを保存しておく（Viewはこのサイズを参照する）
+        _windowWidth = width;
+        _windowHeight = height;
         //AppViewの初期化
         _view->Initialize();
         // スプライトサイズを再設定
         //_view->ResizeSprite();
-        // サイズを保存しておく
-        _windowWidth = width;
-        _windowHeight = height;
 
         // ビューポート変更
         glViewport(0, 0, width, height);
     }
 }
 
+void LAppDelegate::NotifyActivity() {
+    if (_window != nullptr) {
+        _window->notifyActivity();
+    }
+}
+
 void LAppDelegate::update() {
     // 時間更新
     LAppPal::UpdateTime();
@@ -175,7 +207,11 @@ LAppDelegate::LAppDelegate() :
 
 LAppDelegate::~LAppDelegate() = default;
 
-void LAppDelegate::InitializeCubism() {
+void LAppDelegate::StartUpCubism() {
+    if (CubismFramework::IsInitialized()) {
+        return;
+    }
+
     //setup cubism
     _cubismOption.LogFunction = LAppPal::PrintMessage;
     _cubismOption.LoggingLevel = LAppDefine::CubismLoggingLevel;
@@ -183,6 +219,11 @@ void LAppDelegate::InitializeCubism() {
 
     //Initialize cubism
     CubismFramework::Initialize();
+}
+
+void LAppDelegate::InitializeCubism() {
+    // 起動パイプラインで先に起動済みの場合はスキップされる
+    StartUpCubism();
     
     // 强制使用 OpenGL 后端，避免 DirectX 检测
     CF_LOG_DEBUG("Forcing OpenGL backend for Live2D Cubism");
@@ -0,0 +1,199 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppFileView.hpp"
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#include "LogUtil.h"
+
+using namespace Csm;
+
+namespace {
+    std::atomic_bool s_mappingEnabled(true);
+
+#ifdef _WIN32
+    std::wstring ToWide(const std::string& utf8)
+    {
+        const int length = MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(), -1, NULL, 0);
+        std::wstring wide(length > 0 ? length - 1 : 0, L'\0');
+        if (length > 1) {
+            MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(), -1, &wide[0], length);
+        }
+        return wide;
+    }
+#endif
+
+    bool QueryFileSize(const std::string& filePath, csmSizeInt* outSize)
+    {
+#ifdef _WIN32
+        struct _stat64 statBuf;
+        if (_wstat64(ToWide(filePath).c_str(), &statBuf) != 0) {
+            return false;
+        }
+#else
+        struct stat statBuf;
+        if (stat(filePath.c_str(), &statBuf) != 0) {
+            return false;
+        }
+#endif
+        if ((statBuf.st_mode & S_IFMT) != S_IFREG || statBuf.st_size > 0xFFFFFFFF) {
+            return false;
+        }
+        *outSize = static_cast<csmSizeInt>(statBuf.st_size);
+        return true;
+    }
+}
+
+std::shared_ptr<LAppFileView> LAppFileView::Open(const std::string& filePath)
+{
+    csmSizeInt size = 0;
+    if (!QueryFileSize(filePath, &size)) {
+        CF_LOG_ERROR("file stat error： %s", filePath.c_str());
+        return nullptr;
+    }
+
+    std::shared_ptr<LAppFileView> view(new LAppFileView());
+    if (size >= MapThreshold && s_mappingEnabled.load(std::memory_order_relaxed) && view->Map(filePath, size)) {
+        return view;
+    }
+    if (!view->Read(filePath, size)) {
+        CF_LOG_ERROR("file open error： %s", filePath.c_str());
+        return nullptr;
+    }
+    return view;
+}
+
+bool LAppFileView::Exists(const std::string& filePath)
+{
+    csmSizeInt size = 0;
+    return QueryFileSize(filePath, &size);
+}
+
+std::shared_ptr<LAppFileView> LAppFileView::CreateSlice(const std::shared_ptr<LAppFileView>& parent, csmSizeInt offset, csmSizeInt size)
+{
+    if (!parent || offset > parent->_size || size > parent->_size - offset) {
+        return nullptr;
+    }
+    std::shared_ptr<LAppFileView> view(new LAppFileView());
+    view->_parent = parent;
+    view->_data = parent->_data + offset;
+    view->_size = size;
+    return view;
+}
+
+std::shared_ptr<LAppFileView> LAppFileView::Allocate(csmSizeInt size)
+{
+    std::shared_ptr<LAppFileView> view(new LAppFileView());
+    view->AllocateBuffer(size);
+    return view;
+}
+
+void LAppFileView::SetMappingEnabled(bool enabled)
+{
+    s_mappingEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+LAppFileView::LAppFileView()
+    : _data(NULL)
+    , _size(0)
+    , _mapped(false)
+    , _buffer(NULL)
+#ifdef _WIN32
+    , _mapping(NULL)
+#endif
+{
+}
+
+LAppFileView::~LAppFileView()
+{
+    if (_mapped) {
+#ifdef _WIN32
+        UnmapViewOfFile(_data);
+        CloseHandle(_mapping);
+#else
+        munmap(_data, _size);
+#endif
+    }
+    delete[] _buffer;
+}
+
+bool LAppFileView::Map(const std::string& filePath, csmSizeInt size)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileW(ToWide(filePath).c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    // マッピングオブジェクトがファイルを参照し続けるので、ハンドルはすぐ閉じてよい
+    CloseHandle(file);
+    if (mapping == NULL) {
+        return false;
+    }
+    void* address = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, size);
+    if (address == NULL) {
+        CloseHandle(mapping);
+        return false;
+    }
+    _mapping = mapping;
+#else
+    const int fd = open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    void* address = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    // マッピングはファイルディスクリプタを閉じても有効
+    close(fd);
+    if (address == MAP_FAILED) {
+        return false;
+    }
+#ifdef POSIX_MADV_WILLNEED
+    // 読み込み直後にパースされるので先読みさせる
+    posix_madvise(address, size, POSIX_MADV_WILLNEED);
+#endif
+#endif
+    _data = static_cast<csmByte*>(address);
+    _size = size;
+    _mapped = true;
+    return true;
+}
+
+bool LAppFileView::Read(const std::string& filePath, csmSizeInt size)
+{
+    std::ifstream file;
+#ifdef _WIN32
+    file.open(ToWide(filePath).c_str(), std::ios::in | std::ios::binary);
+#else
+    file.open(filePath.c_str(), std::ios::in | std::ios::binary);
+#endif
+    if (!file.is_open()) {
+        return false;
+    }
+
+    AllocateBuffer(size);
+    file.read(reinterpret_cast<char*>(_data), size);
+    return static_cast<csmSizeInt>(file.gcount()) == size;
+}
+
+void LAppFileView::AllocateBuffer(csmSizeInt size)
+{
+    // 空ファイルでも一意な非NULLアドレスを返せるよう、常にアラインメント分の余白を取る
+    _buffer = new csmByte[size + DataAlignment];
+    const uintptr_t address = reinterpret_cast<uintptr_t>(_buffer);
+    _data = _buffer + (DataAlignment - address % DataAlignment) % DataAlignment;
+    _size = size;
+}
@@ -13,9 +13,11 @@
 #include "LAppDefine.hpp"
 #include "LAppDelegate.hpp"
 #include "LAppModel.hpp"
+#include "LAppAssetLoader.hpp"
 #include "LAppView.hpp"
 #include "ResourceLoader.hpp"
 #include "EventHandler.hpp"
+#include "TraceProfiler.h"
 
 using namespace Csm;
 using namespace LAppDefine;
@@ -46,23 +48,29 @@ void LAppLive2DManager::ReleaseInstance() {
 }
 
 LAppLive2DManager::LAppLive2DManager()
-        : _viewMatrix(NULL) {
+        : _viewMatrix(NULL), _loadTicket(0), _incomingModel(nullptr), _lastUpdateNs(0), _lastDrawNs(0),
+          _simulationRequested(false), _simulationQuit(false), _pendingDeltaTime(0.0f), _simulationActive(false) {
     _viewMatrix = new CubismMatrix44();
 
+    if (SimulationThreadEnable) {
+        StartSimulation();
+    }
+
     //ChangeScene(_sceneIndex);
+    // 初回のモデルはバックグラウンドで読み込み、ウィンドウの表示を待たせない
     auto m = resource_loader::get_instance().get_current_model();
-    QByteArray model_name = m->name.toUtf8();
-    if (!ChangeScene((Csm::csmChar *) model_name.data())) {
-        CF_LOG_ERROR("current module load fail");
-        event_handler::get_instance().report<QString>(msg_queue::message_type::app_current_model_load_fail, nullptr);
-    }
+    ChangeSceneAsync(m->name);
 }
 
 LAppLive2DManager::~LAppLive2DManager() {
+    StopSimulation();
     ReleaseAllModel();
+    RetireInactiveModels();
+    ReleaseRetiredModels();
 }
 
 void LAppLive2DManager::ReleaseAllModel() {
+    std::lock_guard<std::mutex> lock(_simulationMutex);
     for (csmUint32 i = 0; i < _models.GetSize(); i++) {
         delete _models[(int) i];
     }
@@ -78,7 +86,13 @@ LAppModel *LAppLive2DManager::GetModel(csmUint32 no) const {
     return nullptr;
 }
 
-void LAppLive2DManager::OnDrag(csmFloat32 x, csmFloat32 y) const {
+std::unique_lock<std::mutex> LAppLive2DManager::LockSimulation() {
+    return std::unique_lock<std::mutex>(_simulationMutex);
+}
+
+void LAppLive2DManager::OnDrag(csmFloat32 x, csmFloat32 y) {
+    LAppDelegate::GetInstance()->NotifyActivity();
+    std::lock_guard<std::mutex> lock(_simulationMutex);
     for (csmUint32 i = 0; i < _models.GetSize(); i++) {
         LAppModel *model = GetModel(i);
 
@@ -88,6 +102,8 @@ void LAppLive2DManager::OnDrag(csmFloat32 x, csmFloat32 y) const {
 
 void LAppLive2DManager::OnTap(csmFloat32 x, csmFloat32 y) {
     CF_LOG_DEBUG("tap point: {x:%.2f y:%.2f}", x, y);
+    // 当たり判定は描画中のスナップショットの頂点で行う
+    std::lock_guard<std::mutex> lock(_simulationMutex);
     if (_models.GetSize() != 1) {
         CF_LOG_ERROR("model size is not 1: %d", _models.GetSize());
         return;
@@ -100,13 +116,41 @@ void LAppLive2DManager::OnTap(csmFloat32 x, csmFloat32 y) {
 
 }
 
-void LAppLive2DManager::OnUpdate() const {
+bool LAppLive2DManager::IsActive() const {
+    if (_pendingAssets || _incomingModel != nullptr) {
+        return true;
+    }
+    if (IsSimulationThreaded()) {
+        return _simulationActive.load(std::memory_order_relaxed);
+    }
+    for (csmUint32 i = 0; i < _models.GetSize(); i++) {
+        if (_models[i]->IsActive()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void LAppLive2DManager::OnUpdate() {
+    CF_TRACE_SCOPE("LAppLive2DManager::OnUpdate");
+    ReleaseRetiredModels();
+    if (_pendingAssets) {
+        AdoptPendingAssets();
+    }
+    if (_incomingModel != nullptr) {
+        SwapInIncomingModel();
+    }
+
     //int width, height;
-    int width = LAppDelegate::GetInstance()->GetWindow()->width();
-    int height = LAppDelegate::GetInstance()->GetWindow()->height();
+    int width = LAppDelegate::GetInstance()->GetWindowWidth();
+    int height = LAppDelegate::GetInstance()->GetWindowHeight();
     //glfwGetWindowSize(LAppDelegate::GetInstance()->GetWindow(), &width, &height);
 
+    // _modelsを変更するのはこのスレッドだけなので、読むだけならロックは要らない
+    const bool threaded = IsSimulationThreaded();
     CubismMatrix44 projection;
+    int64_t updateNs = 0;
+    int64_t drawNs = 0;
     csmUint32 modelCount = _models.GetSize();
     for (csmUint32 i = 0; i < modelCount; ++i) {
         LAppModel *model = GetModel(i);
@@ -127,12 +171,125 @@ void LAppLive2DManager::OnUpdate() const {
         // モデル1体描画前コール
         LAppDelegate::GetInstance()->GetView()->PreModelDraw(*model);
 
-        model->Update();
+        const int64_t updateStart = TraceProfiler::nowNs();
+        if (threaded) {
+            // 更新はシミュレーションスレッドで済んでいる。最新の結果を取り込むだけ
+            model->LatchSnapshot();
+        } else {
+            model->Update();
+        }
+        const int64_t drawStart = TraceProfiler::nowNs();
         model->Draw(projection);///< 参照渡しなのでprojectionは変質する
+        updateNs += drawStart - updateStart;
+        drawNs += TraceProfiler::nowNs() - drawStart;
 
         // モデル1体描画後コール
         LAppDelegate::GetInstance()->GetView()->PostModelDraw(*model);
     }
+    if (threaded) {
+        // 描き終えたので次のフレームを進めてもらう。GUIの処理や通信と並行して更新される
+        RequestSimulation(LAppPal::GetDeltaTime());
+    } else {
+        _lastUpdateNs.store(updateNs, std::memory_order_relaxed);
+    }
+    _lastDrawNs = drawNs;
+}
+
+void LAppLive2DManager::SetSimulationThreaded(bool threaded) {
+    if (threaded == IsSimulationThreaded()) {
+        return;
+    }
+    if (threaded) {
+        StartSimulation();
+    } else {
+        StopSimulation();
+    }
+
+    std::lock_guard<std::mutex> lock(_simulationMutex);
+    for (csmUint32 i = 0; i < _models.GetSize(); i++) {
+        PrimeModel(_models[(int) i]);
+    }
+}
+
+void LAppLive2DManager::PrimeModel(LAppModel *model) {
+    if (!IsSimulationThreaded()) {
+        // 予熱池から戻ったモデルが古いスナップショットを指したままにならないように外す
+        model->DetachSnapshot();
+        return;
+    }
+
+    // 最初の要求が処理されるまでの間も描けるよう、経過時間0で一度評価しておく
+    model->Update(0.0f);
+    model->PublishSnapshot();
+    model->LatchSnapshot();
+}
+
+void LAppLive2DManager::StartSimulation() {
+    if (_simulationThread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_requestMutex);
+        _simulationQuit = false;
+        _simulationRequested = false;
+        _pendingDeltaTime = 0.0f;
+    }
+    _simulationThread = std::thread(&LAppLive2DManager::SimulationLoop, this);
+}
+
+void LAppLive2DManager::StopSimulation() {
+    if (!_simulationThread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_requestMutex);
+        _simulationQuit = true;
+    }
+    _requestCondition.notify_one();
+    _simulationThread.join();
+    _simulationActive.store(false, std::memory_order_relaxed);
+}
+
+void LAppLive2DManager::RequestSimulation(csmFloat32 deltaTimeSeconds) {
+    {
+        std::lock_guard<std::mutex> lock(_requestMutex);
+        // 前の要求が終わっていなければ合算し、モデルの時間が実時間から遅れないようにする
+        _pendingDeltaTime += deltaTimeSeconds;
+        _simulationRequested = true;
+    }
+    _requestCondition.notify_one();
+}
+
+void LAppLive2DManager::SimulationLoop() {
+    for (;;) {
+        csmFloat32 deltaTimeSeconds;
+        {
+            std::unique_lock<std::mutex> lock(_requestMutex);
+            _requestCondition.wait(lock, [this]() { return _simulationQuit || _simulationRequested; });
+            if (_simulationQuit) {
+                return;
+            }
+            deltaTimeSeconds = _pendingDeltaTime;
+            _pendingDeltaTime = 0.0f;
+            _simulationRequested = false;
+        }
+        SimulateModels(deltaTimeSeconds);
+    }
+}
+
+void LAppLive2DManager::SimulateModels(csmFloat32 deltaTimeSeconds) {
+    CF_TRACE_SCOPE("LAppLive2DManager::SimulateModels");
+    std::lock_guard<std::mutex> lock(_simulationMutex);
+    const int64_t start = TraceProfiler::nowNs();
+    bool active = false;
+    for (csmUint32 i = 0; i < _models.GetSize(); i++) {
+        LAppModel *model = _models[(int) i];
+        model->Update(deltaTimeSeconds);
+        model->PublishSnapshot();
+        active = active || model->IsActive();
+    }
+    _lastUpdateNs.store(TraceProfiler::nowNs() - start, std::memory_order_relaxed);
+    _simulationActive.store(active, std::memory_order_relaxed);
 }
 
 //void LAppLive2DManager::NextScene()
@@ -141,15 +298,169 @@ void LAppLive2DManager::OnUpdate() const {
 //   ChangeScene(no);
 //}
 
+void LAppLive2DManager::GetModelFilePath(const QString &name, std::string &dir, std::string &fileName) {
+    QString modelPath = resource_loader::get_instance().get_resoures_path() + "/models/live2d/" + name + "/";
+    QString modelJsonName = name + ".model3.json";
+    dir = modelPath.toUtf8().toStdString();
+    fileName = modelJsonName.toUtf8().toStdString();
+}
+
+void LAppLive2DManager::ChangeSceneAsync(const QString &name, SceneChangedCallback onChanged) {
+    CF_LOG_DEBUG("model (async) : %s", name.toStdString().c_str());
+
+    // 進行中の切り替えは取り消す。コールバックも呼ばない
+    const csmUint32 ticket = ++_loadTicket;
+    _pendingAssets.reset();
+    if (_incomingModel != nullptr) {
+        RetireModel(_incomingModel);
+        _incomingModel = nullptr;
+    }
+    _incomingName = name;
+    _onSceneChanged = std::move(onChanged);
+
+    // 予熱池にあれば読み込まずに次のフレームで差し替える
+    for (auto it = _warmModels.begin(); it != _warmModels.end(); ++it) {
+        if (it->first == name) {
+            CF_LOG_DEBUG("model from warm pool : %s", name.toStdString().c_str());
+            _incomingModel = it->second;
+            _warmModels.erase(it);
+            LAppDelegate::GetInstance()->NotifyActivity();
+            return;
+        }
+    }
+
+    std::string dir;
+    std::string fileName;
+    GetModelFilePath(name, dir, fileName);
+    LAppAssetLoader::GetInstance()->Take(dir, fileName, [this, ticket](const std::shared_ptr<LAppModelAssets> &assets) {
+        if (ticket != _loadTicket) {
+            // 読み込み中に別のモデルへの切り替えが要求された
+            return;
+        }
+        // GLコンテキストが有効な次の描画で構築する
+        _pendingAssets = assets;
+        LAppDelegate::GetInstance()->NotifyActivity();
+    });
+}
+
+void LAppLive2DManager::AdoptPendingAssets() {
+    std::shared_ptr<LAppModelAssets> assets = _pendingAssets;
+    _pendingAssets.reset();
+
+    // 現在のモデルは切り替え先の準備が整うまで描画し続ける。
+    // 読み込みはIDを登録するので、CubismIdManagerを使うシミュレーションスレッドと排他にする
+    std::unique_lock<std::mutex> lock(_simulationMutex);
+    LAppModel *model = new LAppModel();
+    const bool loaded = model->LoadAssets(assets);
+    lock.unlock();
+    if (!loaded) {
+        delete model;
+        CF_LOG_ERROR("current module load fail");
+        FinishSceneChange(false);
+        return;
+    }
+    _incomingModel = model;
+}
+
+void LAppLive2DManager::SwapInIncomingModel() {
+    // テクスチャは1フレームに1枚ずつ上げ、揃ったフレームで入れ替える
+    if (!_incomingModel->UploadPendingTextures()) {
+        return;
+    }
+    // 予熱の更新でもモーションを読み込んでIDを登録することがあるので、ロックの中で行う
+    std::unique_lock<std::mutex> lock(_simulationMutex);
+    PrimeModel(_incomingModel);
+    if (_models.GetSize() == 1 && !_currentName.isEmpty() && ModelWarmPoolSize > 0) {
+        _warmModels.emplace_front(_currentName, _models[0]);
+    } else {
+        for (csmUint32 i = 0; i < _models.GetSize(); i++) {
+            RetireModel(_models[(int) i]);
+        }
+    }
+    while (static_cast<csmInt32>(_warmModels.size()) > ModelWarmPoolSize) {
+        RetireModel(_warmModels.back().second);
+        _warmModels.pop_back();
+    }
+
+    _models.Clear();
+    _models.PushBack(_incomingModel);
+    lock.unlock();
+    _incomingModel = nullptr;
+    _currentName = _incomingName;
+    SetupRenderTarget();
+    CF_LOG_INFO("model swapped in: %s", _currentName.toStdString().c_str());
+    FinishSceneChange(true);
+}
+
+void LAppLive2DManager::FinishSceneChange(bool success) {
+    SceneChangedCallback callback = std::move(_onSceneChanged);
+    _onSceneChanged = nullptr;
+    if (callback) {
+        callback(success);
+    } else if (!success) {
+        event_handler::get_instance().report<QString>(msg_queue::message_type::app_current_model_load_fail, nullptr);
+    }
+}
+
+void LAppLive2DManager::RetireModel(LAppModel *model) {
+    _retiredModels.push_back(model);
+}
+
+void LAppLive2DManager::RetireInactiveModels() {
+    if (_incomingModel != nullptr) {
+        RetireModel(_incomingModel);
+        _incomingModel = nullptr;
+    }
+    for (auto &item : _warmModels) {
+        RetireModel(item.second);
+    }
+    _warmModels.clear();
+}
+
+void LAppLive2DManager::ReleaseRetiredModels() {
+    for (LAppModel *model : _retiredModels) {
+        delete model;
+    }
+    _retiredModels.clear();
+}
+
+void LAppLive2DManager::SetupRenderTarget() {
+#if defined(USE_RENDER_TARGET)
+    // LAppViewの持つターゲットに描画を行う場合、こちらを選択
+    LAppView::SelectTarget useRenderTarget = LAppView::SelectTarget_ViewFrameBuffer;
+#elif defined(USE_MODEL_RENDER_TARGET)
+    // 各LAppModelの持つターゲットに描画を行う場合、こちらを選択
+    LAppView::SelectTarget useRenderTarget = LAppView::SelectTarget_ModelFrameBuffer;
+#else
+    // デフォルトのメインフレームバッファへレンダリングする(通常)
+    LAppView::SelectTarget useRenderTarget = LAppView::SelectTarget_None;
+#endif
+
+    LAppDelegate::GetInstance()->GetView()->SwitchRenderingTarget(useRenderTarget);
+
+    // 別レンダリング先を選択した際の背景クリア色
+    float clearColor[3] = {0.0f, 0.0f, 0.0f};
+    LAppDelegate::GetInstance()->GetView()->SetRenderTargetClearColor(clearColor[0], clearColor[1], clearColor[2]);
+}
+
 bool LAppLive2DManager::ChangeScene(const QString &name) {
     //_sceneIndex = index;
     CF_LOG_DEBUG("model : %s", name.toStdString().c_str());
     QString modelPath = resource_loader::get_instance().get_resoures_path() + "/models/live2d/" + name + "/";
     QString modelJsonName = name + ".model3.json";
+    // 進行中のバックグラウンド読み込みの結果は使わない
+    ++_loadTicket;
+    _pendingAssets.reset();
+    _onSceneChanged = nullptr;
+    RetireInactiveModels();
+    ReleaseRetiredModels();
     ReleaseAllModel();
+    _currentName.clear();
+    std::unique_lock<std::mutex> lock(_simulationMutex);
     _models.PushBack(new LAppModel());
     //_models[0]->LoadAssets(modelPath.c_str(), modelJsonName.c_str());
     if (!_models[0]->LoadAssets(modelPath.toUtf8().data(), modelJsonName.toUtf8().data())) {
+        lock.unlock();
         ReleaseAllModel();
         return false;
     }
@@ -160,30 +471,20 @@ bool LAppLive2DManager::ChangeScene(const QString &name) {
      * 別のレンダリングターゲットにモデルを描画し、描画結果をテクスチャとして別のスプライトに張り付ける。
      */
     {
-#if defined(USE_RENDER_TARGET)
-        // LAppViewの持つターゲットに描画を行う場合、こちらを選択
-        LAppView::SelectTarget useRenderTarget = LAppView::SelectTarget_ViewFrameBuffer;
-#elif defined(USE_MODEL_RENDER_TARGET)
-        // 各LAppModelの持つターゲットに描画を行う場合、こちらを選択
-        LAppView::SelectTarget useRenderTarget = LAppView::SelectTarget_ModelFrameBuffer;
-#else
-        // デフォルトのメインフレームバッファへレンダリングする(通常)
-        LAppView::SelectTarget useRenderTarget = LAppView::SelectTarget_None;
-#endif
-
 #if defined(USE_RENDER_TARGET) || defined(USE_MODEL_RENDER_TARGET)
         // モデル個別にαを付けるサンプルとして、もう1体モデルを作成し、少し位置をずらす
         _models.PushBack(new LAppModel());
         _models[1]->LoadAssets(modelPath.c_str(), modelJsonName.c_str());
         _models[1]->GetModelMatrix()->TranslateX(0.2f);
 #endif
+        for (csmUint32 i = 0; i < _models.GetSize(); i++) {
+            PrimeModel(_models[(int) i]);
+        }
+        lock.unlock();
 
-        LAppDelegate::GetInstance()->GetView()->SwitchRenderingTarget(useRenderTarget);
-
-        // 別レンダリング先を選択した際の背景クリア色
-        float clearColor[3] = {0.0f, 0.0f, 0.0f};
-        LAppDelegate::GetInstance()->GetView()->SetRenderTargetClearColor(clearColor[0], clearColor[1], clearColor[2]);
+        SetupRenderTarget();
     }
+    _currentName = name;
     return true;
 }
 
@@ -200,6 +501,7 @@ void LAppLive2DManager::SetViewMatrix(CubismMatrix44 *m) {
 void LAppLive2DManager::RobotControl(Csm::csmChar *motion_group, Csm::csmChar *expression,
                                      const std::shared_ptr<QByteArray> &sound) {
     CF_LOG_DEBUG("motion: %s, expression: %s", motion_group, expression);
+    std::lock_guard<std::mutex> lock(_simulationMutex);
     if (_models.GetSize() != 1) {
         CF_LOG_ERROR("model size is %d", _models.GetSize());
         return;
@@ -218,6 +520,7 @@ void LAppLive2DManager::RobotControl(Csm::csmChar *motion_group, Csm::csmChar *e
 }
 
 void LAppLive2DManager::UpdateLipSyncAudio(const std::shared_ptr<QByteArray> &sound) {
+    std::lock_guard<std::mutex> lock(_simulationMutex);
     if (_models.GetSize() != 1) {
         CF_LOG_ERROR("model size is %d", _models.GetSize());
         return;
@@ -229,6 +532,7 @@ void LAppLive2DManager::UpdateLipSyncAudio(const std::shared_ptr<QByteArray> &so
 }
 
 void LAppLive2DManager::UpdateLipSyncFromPCM(const QByteArray& pcmData, int sampleRate) {
+    std::lock_guard<std::mutex> lock(_simulationMutex);
     if (_models.GetSize() != 1) {
         CF_LOG_ERROR("model size is %d", _models.GetSize());
         return;
@@ -18,27 +18,20 @@
 #include "LAppDefine.hpp"
 #include "LAppPal.hpp"
 #include "LAppTextureManager.hpp"
+#include "LAppAssetLoader.hpp"
+#include "LAppMotionCache.hpp"
 #include "LogUtil.h"
+#include "TraceProfiler.h"
 #include "LAppDelegate.hpp"
+#include "ResourceLoader.hpp"
 #define DRAG_SCALE 0.3f
 using namespace Live2D::Cubism::Framework;
 using namespace Live2D::Cubism::Framework::DefaultParameterId;
 using namespace LAppDefine;
 
-namespace {
-    csmByte *CreateBuffer(const csmChar *path, csmSizeInt *size) {
-        CF_LOG_DEBUG("create buffer: %s", path);
-        return LAppPal::LoadFileAsBytes(path, size);
-    }
-
-    void DeleteBuffer(csmByte *buffer, const csmChar *path = "") {
-        CF_LOG_DEBUG("delete buffer: %s", path);
-        LAppPal::ReleaseBytes(buffer);
-    }
-}
-
 LAppModel::LAppModel()
-        : CubismUserModel(), _modelSetting(nullptr), _userTimeSeconds(0.0f) {
+        : CubismUserModel(), _modelSetting(nullptr), _userTimeSeconds(0.0f), _motionCacheBytes(0), _motionCacheStats(),
+          _nextTextureIndex(0), _dragMoving(false) {
     if (DebugLogEnable) {
         _debugMode = true;
     }
@@ -55,7 +48,9 @@ LAppModel::~LAppModel() {
     _renderBuffer.DestroyOffscreenFrame();
 
     ReleaseMotions();
+    ReleaseMotionCache();
     ReleaseExpressions();
+    ReleaseTextures();
     if (_modelSetting) {
         for (csmInt32 i = 0; i < _modelSetting->GetMotionGroupCount(); i++) {
             const csmChar *group = _modelSetting->GetMotionGroupName(i);
@@ -66,8 +61,24 @@ LAppModel::~LAppModel() {
 }
 
 bool LAppModel::LoadAssets(const csmChar *dir, const csmChar *fileName) {
+    CF_TRACE_SCOPE("LAppModel::LoadAssets");
     _modelHomeDir = dir;
 
+    // バンドルがあればそちらから読む
+    std::shared_ptr<LAppModelAssets> assets = std::make_shared<LAppModelAssets>();
+    assets->dir = dir;
+    assets->fileName = fileName;
+    if (LAppAssetLoader::LoadFromBundle(*assets)) {
+        if (!LoadAssets(assets)) {
+            return false;
+        }
+        // 同期読み込みではここで全テクスチャを上げ、_modelsに入る前に_assetsを解放しておく
+        // （_modelsに入ったモデルはシミュレーションスレッドからも参照される）
+        while (!UploadPendingTextures()) {
+        }
+        return true;
+    }
+
     CF_LOG_DEBUG("load model setting: %s", fileName);
 
     csmSizeInt size;
@@ -77,17 +88,94 @@ bool LAppModel::LoadAssets(const csmChar *dir, const csmChar *fileName) {
     if (buffer == nullptr) {
         return false;
     }
-    ICubismModelSetting *setting = new CubismModelSettingJson(buffer, size);
+    CubismModelSettingJson *setting = new CubismModelSettingJson(buffer, size);
     DeleteBuffer(buffer, path.GetRawString());
+    if (setting->GetJsonPointer() == NULL) {
+        CF_LOG_ERROR("failed to parse model setting: %s", path.GetRawString());
+        delete setting;
+        return false;
+    }
 
     SetupModel(setting);
 
-    CreateRenderer();
+    SetupRenderer();
 
     SetupTextures();
     return true;
 }
 
+bool LAppModel::LoadAssets(const std::shared_ptr<LAppModelAssets> &assets) {
+    CF_TRACE_SCOPE("LAppModel::LoadAssets");
+    if (!assets || !assets->succeeded || assets->setting == nullptr) {
+        return false;
+    }
+    _modelHomeDir = assets->dir.c_str();
+
+    // 所有権を引き取る
+    ICubismModelSetting *setting = assets->setting;
+    assets->setting = nullptr;
+
+    _assets = assets;
+    if (!SetupModel(setting)) {
+        _assets.reset();
+        return false;
+    }
+    // 文件内容已经转成Cubism对象，只保留待上传的贴图
+    _assets->files.clear();
+
+    SetupRenderer();
+
+    _nextTextureIndex = 0;
+    return true;
+}
+
+bool LAppModel::IsReady() const {
+    return _model != nullptr && !_assets;
+}
+
+bool LAppModel::IsActive() const {
+    // 口の開きがこれ以下なら無音とみなす（無音になると毎フレーム減衰していく）
+    const csmFloat32 LIP_SYNC_ACTIVE_THRESHOLD = 0.02f;
+
+    if (_motionManager->GetCurrentPriority() > PriorityIdle || _motionManager->GetReservePriority() > PriorityIdle) {
+        return true;
+    }
+    if (_dragMoving) {
+        return true;
+    }
+    if (_lipSync && _lastLipSyncValue > LIP_SYNC_ACTIVE_THRESHOLD) {
+        return true;
+    }
+    // シミュレーションスレッドから呼ばれるので_assetsは参照しない。
+    // テクスチャのアップロード中はLAppLive2DManager::IsActiveが切り替え先のモデルを見て高フレームレートにする
+    return false;
+}
+
+csmByte *LAppModel::CreateBuffer(const csmChar *path, csmSizeInt *size) {
+    if (_assets) {
+        const LAppFileView *file = _assets->FindFile(path);
+        if (file != nullptr) {
+            CF_LOG_DEBUG("use preloaded buffer: %s", path);
+            *size = file->GetSize();
+            return const_cast<csmByte *>(file->GetData());
+        }
+    }
+    CF_LOG_DEBUG("create buffer: %s", path);
+    return LAppPal::LoadFileAsBytes(path, size);
+}
+
+void LAppModel::DeleteBuffer(csmByte *buffer, const csmChar *path) {
+    if (_assets) {
+        const LAppFileView *file = _assets->FindFile(path);
+        if (file != nullptr && file->GetData() == buffer) {
+            // 先読み済みのデータはLAppModelAssetsが解放する
+            return;
+        }
+    }
+    CF_LOG_DEBUG("delete buffer: %s", path);
+    LAppPal::ReleaseBytes(buffer);
+}
+
 
 bool LAppModel::SetupModel(ICubismModelSetting *setting) {
     _updating = true;
@@ -218,10 +306,8 @@ bool LAppModel::SetupModel(ICubismModelSetting *setting) {
 
     _model->SaveParameters();
 
-    for (csmInt32 i = 0; i < _modelSetting->GetMotionGroupCount(); i++) {
-        const csmChar *group = _modelSetting->GetMotionGroupName(i);
-        PreloadMotionGroup(group);
-    }
+    // 待機モーションだけ先に読み込む。他のグループは再生時に読み込み、キャッシュに保持する
+    PreloadMotionGroup(MotionGroupIdle);
 
     _motionManager->StopAllMotions();
 
@@ -230,40 +316,132 @@ bool LAppModel::SetupModel(ICubismModelSetting *setting) {
     return true;
 }
 
+ACubismMotion *LAppModel::LoadMotion(const csmByte *buffer, csmSizeInt size, const csmChar *name,
+                                     ACubismMotion::FinishedMotionCallback onFinishedMotionHandler) {
+    CF_TRACE_SCOPE("LAppModel::LoadMotion");
+    return LAppMotionCache::CreateMotion(buffer, size, onFinishedMotionHandler);
+}
+
 void LAppModel::PreloadMotionGroup(const csmChar *group) {
     const csmInt32 count = _modelSetting->GetMotionCount(group);
 
     for (csmInt32 i = 0; i < count; i++) {
         //ex) idle_0
         csmString name = Utils::CubismString::GetFormatedString("%s_%d", group, i);
-        csmString path = _modelSetting->GetMotionFileName(group, i);
-        path = _modelHomeDir + path;
-        CF_LOG_DEBUG("load motion: %s => [%s_%d] ", path.GetRawString(), group, i);
-
-        csmByte *buffer;
-        csmSizeInt size;
-        buffer = CreateBuffer(path.GetRawString(), &size);
-        if (buffer) {
-            auto *tmpMotion = dynamic_cast<CubismMotion *>(LoadMotion(buffer, size, name.GetRawString()));
-            csmFloat32 fadeTime = _modelSetting->GetMotionFadeInTimeValue(group, i);
-            if (fadeTime >= 0.0f) {
-                tmpMotion->SetFadeInTime(fadeTime);
-            }
+        CF_LOG_DEBUG("load motion: [%s_%d] ", group, i);
 
-            fadeTime = _modelSetting->GetMotionFadeOutTimeValue(group, i);
-            if (fadeTime >= 0.0f) {
-                tmpMotion->SetFadeOutTime(fadeTime);
-            }
-            tmpMotion->SetEffectIds(_eyeBlinkIds, _lipSyncIds);
-
-            if (_motions[name] != nullptr) {
+        CubismMotion *tmpMotion = LoadMotionFile(group, i, nullptr);
+        if (tmpMotion) {
+            if (_motions.IsExist(name)) {
                 ACubismMotion::Delete(_motions[name]);
             }
             _motions[name] = tmpMotion;
+        }
+    }
+}
 
-            DeleteBuffer(buffer, path.GetRawString());
+CubismMotion *LAppModel::LoadMotionFile(const csmChar *group, csmInt32 no,
+                                        ACubismMotion::FinishedMotionCallback onFinishedMotionHandler) {
+    csmString path = _modelSetting->GetMotionFileName(group, no);
+    path = _modelHomeDir + path;
+
+    csmSizeInt size;
+    csmByte *buffer = CreateBuffer(path.GetRawString(), &size);
+    if (buffer == nullptr) {
+        CF_LOG_ERROR("failed to load motion: %s", path.GetRawString());
+        return nullptr;
+    }
+    CubismMotion *motion = dynamic_cast<CubismMotion *>(LoadMotion(buffer, size, nullptr, onFinishedMotionHandler));
+    DeleteBuffer(buffer, path.GetRawString());
+    if (motion == nullptr) {
+        CF_LOG_ERROR("failed to parse motion: %s", path.GetRawString());
+        return nullptr;
+    }
+
+    csmFloat32 fadeTime = _modelSetting->GetMotionFadeInTimeValue(group, no);
+    if (fadeTime >= 0.0f) {
+        motion->SetFadeInTime(fadeTime);
+    }
+
+    fadeTime = _modelSetting->GetMotionFadeOutTimeValue(group, no);
+    if (fadeTime >= 0.0f) {
+        motion->SetFadeOutTime(fadeTime);
+    }
+    motion->SetEffectIds(_eyeBlinkIds, _lipSyncIds);
+    return motion;
+}
+
+CubismMotion *LAppModel::AcquireCachedMotion(const csmChar *group, csmInt32 no, const std::string &name,
+                                             ACubismMotion::FinishedMotionCallback onFinishedMotionHandler) {
+    auto it = _motionCache.find(name);
+    if (it != _motionCache.end()) {
+        _motionCacheStats.hits++;
+        _motionCacheLru.splice(_motionCacheLru.begin(), _motionCacheLru, it->second.lruPosition);
+        it->second.motion->SetFinishedMotionHandler(onFinishedMotionHandler);
+        return it->second.motion;
+    }
+
+    _motionCacheStats.misses++;
+    CubismMotion *motion = LoadMotionFile(group, no, onFinishedMotionHandler);
+    if (motion == nullptr) {
+        return nullptr;
+    }
+    _motionCacheLru.push_front(name);
+    CachedMotion &entry = _motionCache[name];
+    entry.motion = motion;
+    entry.bytes = motion->GetMemorySize();
+    entry.lruPosition = _motionCacheLru.begin();
+    _motionCacheBytes += entry.bytes;
+    return motion;
+}
+
+void LAppModel::TrimMotionCache() {
+    auto position = _motionCacheLru.end();
+    while (_motionCacheBytes > MotionCacheBudget && position != _motionCacheLru.begin()) {
+        --position;
+        CachedMotion &entry = _motionCache[*position];
+        if (IsMotionInUse(entry)) {
+            // キューに残っているモーションは解放できない
+            continue;
+        }
+
+        CF_LOG_DEBUG("evict motion: %s (%u bytes)", position->c_str(), static_cast<unsigned int>(entry.bytes));
+        _motionCacheBytes -= entry.bytes;
+        _motionCacheStats.evictions++;
+        ACubismMotion::Delete(entry.motion);
+        _motionCache.erase(*position);
+        position = _motionCacheLru.erase(position);
+    }
+}
+
+bool LAppModel::IsMotionInUse(CachedMotion &entry) const {
+    std::vector<CubismMotionQueueEntryHandle> &handles = entry.handles;
+    for (size_t i = 0; i < handles.size();) {
+        // 終了フラグが立っていてもキューから外れるまではモーションが参照される
+        if (_motionManager->GetCubismMotionQueueEntry(handles[i]) == nullptr) {
+            handles[i] = handles.back();
+            handles.pop_back();
+        } else {
+            i++;
         }
     }
+    return !handles.empty();
+}
+
+void LAppModel::ReleaseMotionCache() {
+    for (auto &item : _motionCache) {
+        ACubismMotion::Delete(item.second.motion);
+    }
+    _motionCache.clear();
+    _motionCacheLru.clear();
+    _motionCacheBytes = 0;
+}
+
+LAppModel::MotionCacheStats LAppModel::GetMotionCacheStats() const {
+    MotionCacheStats stats = _motionCacheStats;
+    stats.count = static_cast<csmInt32>(_motionCache.size());
+    stats.bytes = _motionCacheBytes;
+    return stats;
 }
 
 void LAppModel::ReleaseMotionGroup(const csmChar *group) const {
@@ -304,13 +482,31 @@ void LAppModel::ReleaseExpressions() {
     _expressions.Clear();
 }
 
+void LAppModel::ReleaseTextures() {
+    LAppTextureManager *textureManager = LAppDelegate::GetInstance()->GetTextureManager();
+    if (textureManager != nullptr) {
+        for (csmUint32 i = 0; i < _textureIds.GetSize(); i++) {
+            textureManager->ReleaseTexture(_textureIds[i]);
+        }
+    }
+
+    _textureIds.Clear();
+}
+
 void LAppModel::Update() {
-    const csmFloat32 deltaTimeSeconds = LAppPal::GetDeltaTime();
+    Update(LAppPal::GetDeltaTime());
+}
+
+void LAppModel::Update(csmFloat32 deltaTimeSeconds) {
+    CF_TRACE_SCOPE("LAppModel::Update");
     _userTimeSeconds += deltaTimeSeconds;
 
+    const csmFloat32 lastDragX = _dragX;
+    const csmFloat32 lastDragY = _dragY;
     _dragManager->Update(deltaTimeSeconds);
     _dragX = _dragManager->GetX();
     _dragY = _dragManager->GetY();
+    _dragMoving = fabsf(_dragX - lastDragX) > 0.001f || fabsf(_dragY - lastDragY) > 0.001f;
 
     // 根据运动更新参数的存在与否
     csmBool motionUpdated = false;
@@ -384,6 +580,28 @@ void LAppModel::Update() {
 
 }
 
+void LAppModel::PublishSnapshot() {
+    if (_model == nullptr) {
+        return;
+    }
+    _snapshots.Publish(*_model);
+}
+
+bool LAppModel::LatchSnapshot() {
+    if (_model == nullptr) {
+        return false;
+    }
+    const CubismDrawableSnapshot *snapshot = _snapshots.Latch();
+    _model->SetDrawableSnapshot(snapshot);
+    return snapshot != nullptr;
+}
+
+void LAppModel::DetachSnapshot() {
+    if (_model != nullptr) {
+        _model->SetDrawableSnapshot(nullptr);
+    }
+}
+
 Csm::CubismMotionQueueEntryHandle
 LAppModel::StartMotion(const Csm::csmChar *group, Csm::csmInt32 no, Csm::csmInt32 priority,
                        Csm::ACubismMotion::FinishedMotionCallback onFinishedMotionHandler,
@@ -394,39 +612,27 @@ LAppModel::StartMotion(const Csm::csmChar *group, Csm::csmInt32 no, Csm::csmInt3
         CF_LOG_DEBUG("can't start motion");
         return InvalidMotionQueueEntryHandleValue;
     }
-
-    const csmString fileName = _modelSetting->GetMotionFileName(group, no);
+    if (priority > PriorityIdle) {
+        LAppDelegate::GetInstance()->NotifyActivity();
+    }
 
     //ex) idle_0
     csmString name = Utils::CubismString::GetFormatedString("%s_%d", group, no);
-    CubismMotion *motion = dynamic_cast<CubismMotion *>(_motions[name.GetRawString()]);
-    csmBool autoDelete = false;
-
-    if (motion == nullptr) {
-        csmString path = fileName;
-        path = _modelHomeDir + path;
-
-        csmByte *buffer;
-        csmSizeInt size;
-        buffer = CreateBuffer(path.GetRawString(), &size);
-        if (buffer) {
-            motion = dynamic_cast<CubismMotion *>(LoadMotion(buffer, size, nullptr, onFinishedMotionHandler));
-            csmFloat32 fadeTime = _modelSetting->GetMotionFadeInTimeValue(group, no);
-            if (fadeTime >= 0.0f) {
-                motion->SetFadeInTime(fadeTime);
-            }
+    CubismMotion *motion = nullptr;
+    CachedMotion *cached = nullptr;
 
-            fadeTime = _modelSetting->GetMotionFadeOutTimeValue(group, no);
-            if (fadeTime >= 0.0f) {
-                motion->SetFadeOutTime(fadeTime);
-            }
-            motion->SetEffectIds(_eyeBlinkIds, _lipSyncIds);
-            autoDelete = true; // 終了時にメモリから削除
-
-            DeleteBuffer(buffer, path.GetRawString());
-        }
-    } else {
+    if (_motions.IsExist(name)) {
+        motion = dynamic_cast<CubismMotion *>(_motions[name]);
         motion->SetFinishedMotionHandler(onFinishedMotionHandler);
+    } else {
+        // 先読みされていないモーションはキャッシュに保持し、次回以降は読み込みと解析を省く
+        const std::string key = name.GetRawString();
+        motion = AcquireCachedMotion(group, no, key, onFinishedMotionHandler);
+        if (motion == nullptr) {
+            _motionManager->SetReservePriority(PriorityNone);
+            return InvalidMotionQueueEntryHandleValue;
+        }
+        cached = &_motionCache[key];
     }
 
     //voice
@@ -441,7 +647,13 @@ LAppModel::StartMotion(const Csm::csmChar *group, Csm::csmInt32 no, Csm::csmInt3
 
     }
     CF_LOG_DEBUG("start motion: [%s_%d]", group, no);
-    return _motionManager->StartMotionPriority(motion, autoDelete, priority);
+    const CubismMotionQueueEntryHandle handle = _motionManager->StartMotionPriority(motion, false, priority);
+    if (cached != nullptr) {
+        IsMotionInUse(*cached);
+        cached->handles.push_back(handle);
+        TrimMotionCache();
+    }
+    return handle;
 }
 
 CubismMotionQueueEntryHandle LAppModel::StartRandomMotion(const csmChar *group, csmInt32 priority,
@@ -463,10 +675,16 @@ void LAppModel::DoDraw() {
 }
 
 void LAppModel::Draw(CubismMatrix44 &matrix) {
+    CF_TRACE_SCOPE("LAppModel::Draw");
     if (_model == nullptr) {
         return;
     }
 
+    // テクスチャが揃うまでは描画しない
+    if (!UploadPendingTextures()) {
+        return;
+    }
+
     matrix.MultiplyByMatrix(_modelMatrix);
 
     GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->SetMvpMatrix(&matrix);
@@ -496,6 +714,8 @@ void LAppModel::SetExpression(const csmChar *expressionID) {
     if (motion != nullptr) {
         CF_LOG_INFO("✅ Expression motion found, starting it");
         _expressionManager->StartMotionPriority(motion, false, PriorityForce); // 将表情设置为强制优先级（优先级最高）
+        // 表情的淡入淡出期间保持高帧率
+        LAppDelegate::GetInstance()->NotifyActivity();
     } else {
         CF_LOG_ERROR("❌ Expression [%s] is nullptr - expression not loaded!", expressionID);
         if (_debugMode) LAppPal::PrintLog("[APP]expression[%s] is nullptr ", expressionID);
@@ -523,11 +743,19 @@ void LAppModel::SetRandomExpression() {
 void LAppModel::ReloadRenderer() {
     DeleteRenderer();
 
-    CreateRenderer();
+    SetupRenderer();
 
     SetupTextures();
 }
 
+void LAppModel::SetupRenderer() {
+    CreateRenderer();
+
+    // GLWidget的上下文里只画模型，DrawModel之后没有代码依赖之前的GL状态，
+    // 不必每帧查询并恢复几十项状态
+    GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->UseProfileSaveRestore(false);
+}
+
 void LAppModel::SetupTextures() {
     for (csmInt32 modelTextureNumber = 0; modelTextureNumber < _modelSetting->GetTextureCount(); modelTextureNumber++) {
         // テクスチャ名が空文字だった場合はロード・バインド処理をスキップ
@@ -543,6 +771,7 @@ void LAppModel::SetupTextures() {
                 texturePath.GetRawString());
         if (texture != nullptr) {
             const csmInt32 glTextueNumber = texture->id;
+            _textureIds.PushBack(texture->id);
             //OpenGL
             GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->BindTexture(modelTextureNumber, glTextueNumber);
         }
@@ -556,6 +785,46 @@ void LAppModel::SetupTextures() {
 
 }
 
+bool LAppModel::UploadPendingTextures() {
+    if (!_assets) {
+        return true;
+    }
+    CF_TRACE_SCOPE("LAppModel::UploadPendingTextures");
+
+    // 1フレームにつき1枚だけアップロードし、読み込み中もフレームを落とさない
+    LAppTextureManager *textureManager = LAppDelegate::GetInstance()->GetTextureManager();
+    const csmInt32 textureCount = static_cast<csmInt32>(_assets->images.size());
+    while (_nextTextureIndex < textureCount) {
+        const csmInt32 modelTextureNumber = _nextTextureIndex++;
+        LAppTextureManager::DecodedImage &image = _assets->images[modelTextureNumber];
+        if (image.pixels == nullptr) {
+            // テクスチャ名が空、またはデコードに失敗した
+            continue;
+        }
+
+        LAppTextureManager::TextureInfo *texture = textureManager->CreateTextureFromDecodedImage(image);
+        LAppTextureManager::ReleaseDecodedImage(image);
+        if (texture != nullptr) {
+            _textureIds.PushBack(texture->id);
+            GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->BindTexture(modelTextureNumber, texture->id);
+        }
+        break;
+    }
+    if (_nextTextureIndex < textureCount) {
+        return false;
+    }
+
+#ifdef PREMULTIPLIED_ALPHA_ENABLE
+    GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->IsPremultipliedAlpha(true);
+#else
+    GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->IsPremultipliedAlpha(false);
+#endif
+
+    CF_LOG_INFO("model ready, assets loaded in %.1f ms", _assets->loadSeconds * 1000.0);
+    _assets.reset();
+    return true;
+}
+
 void LAppModel::MotionEventFired(const csmString &eventValue) {
     CubismLogInfo("%s is fired on LAppModel!!", eventValue.GetRawString());
 }
@@ -620,6 +889,7 @@ void LAppModel::UpdateLipSyncAudio(std::shared_ptr<QByteArray> sound) {
     if (sound && !sound->isEmpty()) {
         CF_LOG_DEBUG("UpdateLipSyncAudio: updating audio for lip sync, size: %d", sound->size());
         _wavFileHandler.Start(sound);
+        LAppDelegate::GetInstance()->NotifyActivity();
     }
 }
 
@@ -681,6 +951,7 @@ void LAppModel::UpdateLipSyncFromPCM(const QByteArray &pcmData, int sampleRate)
     // 平滑处理：新值和旧值之间插值，避免突变
     const float SMOOTHING = 0.3f;
     _lastLipSyncValue = _lastLipSyncValue * (1.0f - SMOOTHING) + rms * SMOOTHING;
+    LAppDelegate::GetInstance()->NotifyActivity();
     
     CF_LOG_DEBUG("LipSync - RMS: %.3f, ZCR: %.3f, Speech: %d, Final: %.3f", 
                  rms, zeroCrossingRate, likelySpeech, _lastLipSyncValue);
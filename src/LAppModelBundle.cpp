@@ -0,0 +1,133 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppModelBundle.hpp"
+#include <QByteArray>
+#include <cstring>
+#include "LogUtil.h"
+
+using namespace Csm;
+
+static_assert(sizeof(LAppModelBundle::Header) == 64, "bundle header must be 64 bytes");
+static_assert(sizeof(LAppModelBundle::Entry) == 64, "bundle entry must be 64 bytes");
+
+const char LAppModelBundle::Magic[8] = {'H', 'M', 'R', 'B', 'N', 'D', 'L', '\0'};
+
+namespace {
+    std::string IndexKey(LAppModelBundle::EntryType type, const std::string& path)
+    {
+        return std::string(1, static_cast<char>('0' + type)) + path;
+    }
+}
+
+std::string LAppModelBundle::GetBundlePath(const std::string& dir, const std::string& modelFileName)
+{
+    static const std::string suffix = ".model3.json";
+    std::string name = modelFileName;
+    if (name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+        name.erase(name.size() - suffix.size());
+    }
+    return dir + name + ".bundle";
+}
+
+std::shared_ptr<LAppModelBundle> LAppModelBundle::Open(const std::string& path)
+{
+    // 無い場合はディレクトリから読むので、エラーにしない
+    if (!LAppFileView::Exists(path)) {
+        return nullptr;
+    }
+
+    std::shared_ptr<LAppModelBundle> bundle(new LAppModelBundle());
+    bundle->_file = LAppFileView::Open(path);
+    if (!bundle->_file || !bundle->Validate()) {
+        CF_LOG_ERROR("invalid model bundle: %s", path.c_str());
+        return nullptr;
+    }
+    return bundle;
+}
+
+bool LAppModelBundle::Validate()
+{
+    const uint64_t fileSize = _file->GetSize();
+    if (fileSize < sizeof(Header)) {
+        return false;
+    }
+    memcpy(&_header, _file->GetData(), sizeof(Header));
+    if (memcmp(_header.magic, Magic, sizeof(Magic)) != 0 || _header.version != Version) {
+        return false;
+    }
+    if (_header.indexOffset % alignof(Entry) != 0
+        || _header.indexOffset > fileSize
+        || _header.entryCount > (fileSize - _header.indexOffset) / sizeof(Entry)
+        || _header.stringsOffset > fileSize
+        || _header.stringsSize > fileSize - _header.stringsOffset) {
+        return false;
+    }
+    _entries = reinterpret_cast<const Entry*>(_file->GetData() + _header.indexOffset);
+    _strings = reinterpret_cast<const char*>(_file->GetData() + _header.stringsOffset);
+
+    for (uint32_t i = 0; i < _header.entryCount; i++) {
+        const Entry& entry = _entries[i];
+        if (entry.pathOffset > _header.stringsSize || entry.pathLength > _header.stringsSize - entry.pathOffset
+            || entry.offset % SectionAlignment != 0
+            || entry.offset > fileSize || entry.storedSize > fileSize - entry.offset
+            || entry.codec > Codec_Zlib || entry.type > EntryType_Texture) {
+            return false;
+        }
+        if (entry.codec == Codec_None && entry.storedSize != entry.rawSize) {
+            return false;
+        }
+        if (entry.type == EntryType_Texture
+            && (entry.width == 0 || entry.height == 0 || entry.mipLevels == 0 || entry.mipLevels > 32
+                || GetMipChainSize(entry.width, entry.height, entry.mipLevels) != entry.rawSize)) {
+            return false;
+        }
+        _index[IndexKey(static_cast<EntryType>(entry.type), GetPath(entry))] = i;
+    }
+    return true;
+}
+
+const LAppModelBundle::Entry* LAppModelBundle::Find(const std::string& path, EntryType type) const
+{
+    const auto it = _index.find(IndexKey(type, path));
+    return it != _index.end() ? &_entries[it->second] : NULL;
+}
+
+std::string LAppModelBundle::GetPath(const Entry& entry) const
+{
+    return std::string(_strings + entry.pathOffset, entry.pathLength);
+}
+
+std::shared_ptr<LAppFileView> LAppModelBundle::ReadSection(const Entry& entry) const
+{
+    if (entry.codec == Codec_None) {
+        return LAppFileView::CreateSlice(_file, static_cast<csmSizeInt>(entry.offset), static_cast<csmSizeInt>(entry.storedSize));
+    }
+
+    // 圧縮データはマッピングを直接参照して展開する
+    const QByteArray compressed = QByteArray::fromRawData(
+            reinterpret_cast<const char*>(_file->GetData() + entry.offset), static_cast<int>(entry.storedSize));
+    const QByteArray raw = qUncompress(compressed);
+    if (static_cast<uint64_t>(raw.size()) != entry.rawSize) {
+        CF_LOG_ERROR("failed to decompress bundle section: %s", GetPath(entry).c_str());
+        return nullptr;
+    }
+    std::shared_ptr<LAppFileView> view = LAppFileView::Allocate(static_cast<csmSizeInt>(raw.size()));
+    memcpy(view->GetWritableData(), raw.constData(), raw.size());
+    return view;
+}
+
+uint64_t LAppModelBundle::GetMipChainSize(uint32_t width, uint32_t height, uint32_t levels)
+{
+    uint64_t total = 0;
+    for (uint32_t level = 0; level < levels; level++) {
+        const uint64_t w = width >> level > 0 ? width >> level : 1;
+        const uint64_t h = height >> level > 0 ? height >> level : 1;
+        total += w * h * 4;
+    }
+    return total;
+}
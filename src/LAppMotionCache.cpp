@@ -0,0 +1,124 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppMotionCache.hpp"
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QString>
+#include <cstdio>
+#include <mutex>
+#include "LAppFileView.hpp"
+#include "LogUtil.h"
+
+using namespace Csm;
+
+namespace {
+    std::atomic_bool s_enabled(true);
+    std::atomic<uint32_t> s_hitCount(0);
+    std::atomic<uint32_t> s_missCount(0);
+    std::mutex s_directoryMutex;
+    std::string s_directory;
+
+    std::string GetCacheDirectory()
+    {
+        std::lock_guard<std::mutex> lock(s_directoryMutex);
+        if (s_directory.empty()) {
+            s_directory = QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation))
+                              .filePath("motions").toStdString();
+        }
+        return s_directory;
+    }
+
+    void WriteCache(const std::string& path, csmVector<csmByte>& data)
+    {
+        // 次回起動時の高速化のためだけなので、書けなくても読み込みは成功させる
+        if (!QDir().mkpath(QFileInfo(QString::fromStdString(path)).absolutePath())) {
+            CF_LOG_ERROR("motion cache: cannot create directory for %s", path.c_str());
+            return;
+        }
+        QSaveFile file(QString::fromStdString(path));
+        const qint64 size = static_cast<qint64>(data.GetSize());
+        if (!file.open(QIODevice::WriteOnly)
+            || file.write(reinterpret_cast<const char*>(data.GetPtr()), size) != size
+            || !file.commit()) {
+            CF_LOG_ERROR("motion cache: failed to write %s", path.c_str());
+        }
+    }
+}
+
+CubismMotion* LAppMotionCache::CreateMotion(const csmByte* buffer, csmSizeInt size,
+                                            ACubismMotion::FinishedMotionCallback onFinishedMotionHandler)
+{
+    if (!s_enabled.load(std::memory_order_relaxed)) {
+        return CubismMotion::Create(buffer, size, onFinishedMotionHandler);
+    }
+
+    const std::string cachePath = GetCachePath(buffer, size);
+    if (LAppFileView::Exists(cachePath)) {
+        std::shared_ptr<LAppFileView> view = LAppFileView::Open(cachePath);
+        if (view) {
+            CubismMotion* motion = CubismMotion::CreateFromBinary(view->GetData(), view->GetSize(), onFinishedMotionHandler);
+            if (motion) {
+                s_hitCount++;
+                return motion;
+            }
+        }
+        CF_LOG_ERROR("motion cache: discarding invalid cache %s", cachePath.c_str());
+    }
+
+    s_missCount++;
+    CubismMotion* motion = CubismMotion::Create(buffer, size, onFinishedMotionHandler);
+    if (motion) {
+        // フェード時間などを呼び出し側が上書きする前に、JSONの内容そのものを保存する
+        csmVector<csmByte> data;
+        motion->SerializeBinary(data);
+        WriteCache(cachePath, data);
+    }
+    return motion;
+}
+
+std::string LAppMotionCache::GetCachePath(const csmByte* buffer, csmSizeInt size)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "%016llx-%x-v%u.motion.bin",
+             static_cast<unsigned long long>(HashContent(buffer, size)),
+             static_cast<unsigned int>(size), static_cast<unsigned int>(CubismMotion::BinaryFormatVersion));
+    return GetCacheDirectory() + "/" + name;
+}
+
+void LAppMotionCache::SetEnabled(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void LAppMotionCache::SetCacheDirectory(const std::string& directory)
+{
+    std::lock_guard<std::mutex> lock(s_directoryMutex);
+    s_directory = directory;
+}
+
+uint32_t LAppMotionCache::GetHitCount()
+{
+    return s_hitCount.load(std::memory_order_relaxed);
+}
+
+uint32_t LAppMotionCache::GetMissCount()
+{
+    return s_missCount.load(std::memory_order_relaxed);
+}
+
+uint64_t LAppMotionCache::HashContent(const csmByte* buffer, csmSizeInt size)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (csmSizeInt i = 0; i < size; ++i) {
+        hash ^= buffer[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
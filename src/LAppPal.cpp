@@ -8,12 +8,14 @@
 #include "LAppPal.hpp"
 #include <cstdio>
 #include <cstdarg>
-#include <sys/stat.h>
 #include <iostream>
-#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <GL/glew.h>
 #include <Model/CubismMoc.hpp>
 #include "LAppDefine.hpp"
+#include "LAppFileView.hpp"
 #ifdef __APPLE__
 #include <CoreFoundation/CoreFoundation.h>
 #else
@@ -29,34 +31,47 @@ using namespace LAppDefine;
 double LAppPal::s_currentFrame = 0.0;
 double LAppPal::s_lastFrame = 0.0;
 double LAppPal::s_deltaTime = 0.0;
+double LAppPal::s_fixedDeltaTime = 0.0;
 
-csmByte *LAppPal::LoadFileAsBytes(const string filePath, csmSizeInt *outSize) {
-    //filePath;//
-    const char *path = filePath.c_str();
-
-    int size = 0;
-    struct stat statBuf;
-    if (stat(path, &statBuf) == 0) {
-        size = statBuf.st_size;
-    }
-
-    std::fstream file;
-    char *buf = new char[size];
+namespace {
+    // LoadFileAsBytesが返したアドレス → ファイルビュー。ReleaseBytesで参照を外す
+    std::mutex s_viewMutex;
+    std::map<const csmByte *, std::shared_ptr<LAppFileView> > s_views;
+}
 
-    file.open(path, std::ios::in | std::ios::binary);
-    if (!file.is_open()) {
-        CF_LOG_ERROR("file open error： %s", path);
+csmByte *LAppPal::LoadFileAsBytes(const string filePath, csmSizeInt *outSize) {
+    *outSize = 0;
+    std::shared_ptr<LAppFileView> view = LAppFileView::Open(filePath);
+    if (!view) {
         return NULL;
     }
-    file.read(buf, size);
-    file.close();
 
-    *outSize = size;
-    return reinterpret_cast<csmByte *>(buf);
+    // マッピングは書き込み時コピーなので、呼び出し側が書き換えてもファイルには影響しない
+    csmByte *data = const_cast<csmByte *>(view->GetData());
+    {
+        std::lock_guard<std::mutex> lock(s_viewMutex);
+        s_views[data] = view;
+    }
+    *outSize = view->GetSize();
+    return data;
 }
 
 void LAppPal::ReleaseBytes(csmByte *byteData) {
-    delete[] byteData;
+    if (byteData == NULL) {
+        return;
+    }
+    std::shared_ptr<LAppFileView> view;
+    {
+        std::lock_guard<std::mutex> lock(s_viewMutex);
+        auto it = s_views.find(byteData);
+        if (it == s_views.end()) {
+            CF_LOG_ERROR("release unknown buffer: %p", byteData);
+            return;
+        }
+        view = it->second;
+        s_views.erase(it);
+    }
+    // アンマップはロックの外で行う
 }
 
 
@@ -65,6 +80,13 @@ csmFloat32 LAppPal::GetDeltaTime() {
 }
 
 void LAppPal::UpdateTime() {
+    if (s_fixedDeltaTime > 0.0) {
+        s_currentFrame = s_lastFrame + s_fixedDeltaTime;
+        s_deltaTime = s_fixedDeltaTime;
+        s_lastFrame = s_currentFrame;
+        return;
+    }
+
 #ifdef __APPLE__
     s_currentFrame = CFAbsoluteTimeGetCurrent();
 #else
@@ -75,6 +97,10 @@ void LAppPal::UpdateTime() {
 }
 
 
+void LAppPal::SetFixedDeltaTime(double seconds) {
+    s_fixedDeltaTime = seconds;
+}
+
 void LAppPal::PrintLog(const csmChar *format, ...) {
     va_list args;
     csmChar buf[256];
@@ -0,0 +1,39 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppSnapshotMailbox.hpp"
+
+using namespace Csm;
+
+LAppSnapshotMailbox::LAppSnapshotMailbox()
+        : _sequences{0, 0, 0}, _ready(1), _writeSlot(0), _readSlot(2), _publishedSequence(0), _latchedSequence(0) {
+}
+
+void LAppSnapshotMailbox::Publish(const CubismModel &model) {
+    _slots[_writeSlot].Capture(model);
+    _sequences[_writeSlot] = ++_publishedSequence;
+
+    // 書き終えた槽を就绪槽と入れ替える。読まれていない前の就绪槽は次の書き込み先になる
+    const uint32_t previous = _ready.exchange(_writeSlot | FreshBit, std::memory_order_acq_rel);
+    _writeSlot = previous & SlotMask;
+}
+
+const CubismDrawableSnapshot *LAppSnapshotMailbox::Latch() {
+    if ((_ready.load(std::memory_order_relaxed) & FreshBit) != 0) {
+        const uint32_t previous = _ready.exchange(_readSlot, std::memory_order_acq_rel);
+        _readSlot = previous & SlotMask;
+
+        const uint64_t sequence = _sequences[_readSlot];
+        if (_latchedSequence != 0 && sequence != _latchedSequence + 1) {
+            // 途中のフレームを読み飛ばした。頂点などの変化フラグはそのフレームにしか立っていない
+            _slots[_readSlot].MarkAllChanged();
+        }
+        _latchedSequence = sequence;
+    }
+
+    return _latchedSequence != 0 ? &_slots[_readSlot] : nullptr;
+}
@@ -6,14 +6,43 @@
  */
 
 #include "LAppTextureManager.hpp"
+#include <algorithm>
 #include <iostream>
+#include <memory>
 #define STBI_NO_STDIO
 #define STBI_ONLY_PNG
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #include "LAppPal.hpp"
+#include "LAppFileView.hpp"
+#include "LAppDefine.hpp"
+#include "LogUtil.h"
+
+namespace {
+
+// RGBA8のミップマップチェーンのサイズ。mipLevelsが1以下ならglGenerateMipmapで1x1まで生成される
+size_t TextureMemorySize(int width, int height, int mipLevels)
+{
+    size_t bytes = 0;
+    for (int level = 0; mipLevels <= 1 || level < mipLevels; level++)
+    {
+        const size_t levelWidth = width >> level > 0 ? width >> level : 1;
+        const size_t levelHeight = height >> level > 0 ? height >> level : 1;
+        bytes += levelWidth * levelHeight * 4;
+        if (levelWidth == 1 && levelHeight == 1)
+        {
+            break;
+        }
+    }
+    return bytes;
+}
+
+}
 
 LAppTextureManager::LAppTextureManager()
+    : _memoryBudget(LAppDefine::TextureMemoryBudget)
+    , _totalMemorySize(0)
+    , _unusedMemorySize(0)
 {
 }
 
@@ -25,120 +54,256 @@ LAppTextureManager::~LAppTextureManager()
 LAppTextureManager::TextureInfo* LAppTextureManager::CreateTextureFromPngFile(std::string fileName)
 {
     //search loaded texture already.
-    for (Csm::csmUint32 i = 0; i < _textures.GetSize(); i++)
+    const auto loaded = _texturesByName.find(fileName);
+    if (loaded != _texturesByName.end())
     {
-        if (_textures[i]->fileName == fileName)
-        {
-            return _textures[i];
-        }
+        return AcquireTexture(loaded->second);
     }
 
-    GLuint textureId;
-    int width, height, channels;
-    unsigned int size;
-    unsigned char* png;
-    unsigned char* address;
+    DecodedImage image;
+    if (!DecodePngFile(fileName, image))
+    {
+        return NULL;
+    }
 
-    address = LAppPal::LoadFileAsBytes(fileName, &size);
+    TextureInfo* textureInfo = CreateTextureFromDecodedImage(image);
+    ReleaseDecodedImage(image);
+    return textureInfo;
+}
 
-    if(address == NULL)
+bool LAppTextureManager::DecodePngFile(const std::string& fileName, DecodedImage& image)
+{
+    // マッピングしたファイルから直接デコードする
+    const std::shared_ptr<LAppFileView> file = LAppFileView::Open(fileName);
+    if (!file)
     {
-        return NULL;
+        return false;
     }
+    return DecodePngMemory(fileName, file->GetData(), file->GetSize(), image);
+}
+
+bool LAppTextureManager::DecodePngMemory(const std::string& fileName, const unsigned char* data, unsigned int size, DecodedImage& image)
+{
+    int width, height, channels;
+    unsigned char* png;
+
     // png情報を取得する
     png = stbi_load_from_memory(
-        address,
+        data,
         static_cast<int>(size),
         &width,
         &height,
         &channels,
         STBI_rgb_alpha);
+
+    if (png == NULL)
     {
+        return false;
+    }
 
 #ifdef PREMULTIPLIED_ALPHA_ENABLE
-        unsigned int* fourBytes = reinterpret_cast<unsigned int*>(png);
-        for (int i = 0; i < width * height; i++)
-        {
-            unsigned char* p = png + i * 4;
-            fourBytes[i] = Premultiply(p[0], p[1], p[2], p[3]);
-        }
+    unsigned int* fourBytes = reinterpret_cast<unsigned int*>(png);
+    for (int i = 0; i < width * height; i++)
+    {
+        unsigned char* p = png + i * 4;
+        fourBytes[i] = Premultiply(p[0], p[1], p[2], p[3]);
+    }
 #endif
+
+    image.fileName = fileName;
+    image.width = width;
+    image.height = height;
+    image.pixels = png;
+    image.mipLevels = 1;
+    image.owner.reset();
+    return true;
+}
+
+void LAppTextureManager::ReleaseDecodedImage(DecodedImage& image)
+{
+    if (image.owner)
+    {
+        image.owner.reset();
+    }
+    else if (image.pixels != NULL)
+    {
+        stbi_image_free(image.pixels);
+    }
+    image.pixels = NULL;
+}
+
+LAppTextureManager::TextureInfo* LAppTextureManager::CreateTextureFromDecodedImage(const DecodedImage& image)
+{
+    const auto loaded = _texturesByName.find(image.fileName);
+    if (loaded != _texturesByName.end())
+    {
+        return AcquireTexture(loaded->second);
+    }
+
+    if (image.pixels == NULL)
+    {
+        return NULL;
     }
 
     // OpenGL用のテクスチャを生成する
+    GLuint textureId;
     glGenTextures(1, &textureId);
     glBindTexture(GL_TEXTURE_2D, textureId);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, png);
-    glGenerateMipmap(GL_TEXTURE_2D);
+    if (image.mipLevels > 1)
+    {
+        // 事前に縮小済みのミップマップをそのまま転送する
+        const unsigned char* level = image.pixels;
+        for (int i = 0; i < image.mipLevels; i++)
+        {
+            const int width = image.width >> i > 0 ? image.width >> i : 1;
+            const int height = image.height >> i > 0 ? image.height >> i : 1;
+            glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, level);
+            level += static_cast<size_t>(width) * height * 4;
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image.mipLevels - 1);
+    }
+    else
+    {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.pixels);
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glBindTexture(GL_TEXTURE_2D, 0);
 
-    // 解放処理
-    stbi_image_free(png);
-    LAppPal::ReleaseBytes(address);
+    TextureEntry* entry = new TextureEntry();
+    entry->info.fileName = image.fileName;
+    entry->info.width = image.width;
+    entry->info.height = image.height;
+    entry->info.id = textureId;
+    entry->info.memorySize = TextureMemorySize(image.width, image.height, image.mipLevels);
+    entry->info.referenceCount = 1;
+    entry->unusedPosition = _unusedTextures.end();
 
-    LAppTextureManager::TextureInfo* textureInfo = new LAppTextureManager::TextureInfo();
-    if (textureInfo != NULL)
-    {
-        textureInfo->fileName = fileName;
-        textureInfo->width = width;
-        textureInfo->height = height;
-        textureInfo->id = textureId;
-
-        _textures.PushBack(textureInfo);
-    }
+    _texturesById[textureId] = entry;
+    _texturesByName[image.fileName] = entry;
+    _totalMemorySize += entry->info.memorySize;
 
-    return textureInfo;
+    // 新しいテクスチャの分だけ、使われていないテクスチャを追い出す
+    TrimTextures();
 
+    return &entry->info;
 }
 
 void LAppTextureManager::ReleaseTextures()
 {
-    for (Csm::csmUint32 i = 0; i < _textures.GetSize(); i++)
+    for (auto& texture : _texturesById)
     {
-        delete _textures[i];
+        glDeleteTextures(1, &texture.first);
+        delete texture.second;
     }
 
-    _textures.Clear();
+    _texturesById.clear();
+    _texturesByName.clear();
+    _unusedTextures.clear();
+    _totalMemorySize = 0;
+    _unusedMemorySize = 0;
 }
 
 void LAppTextureManager::ReleaseTexture(Csm::csmUint32 textureId)
 {
-    for (Csm::csmUint32 i = 0; i < _textures.GetSize(); i++)
+    const auto texture = _texturesById.find(textureId);
+    if (texture != _texturesById.end())
     {
-        if (_textures[i]->id != textureId)
-        {
-            continue;
-        }
-        delete _textures[i];
-        _textures.Remove(i);
-        break;
+        ReleaseTextureEntry(texture->second);
     }
 }
 
 void LAppTextureManager::ReleaseTexture(std::string fileName)
 {
-    for (Csm::csmUint32 i = 0; i < _textures.GetSize(); i++)
+    const auto texture = _texturesByName.find(fileName);
+    if (texture != _texturesByName.end())
     {
-        if (_textures[i]->fileName == fileName)
-        {
-            delete _textures[i];
-            _textures.Remove(i);
-            break;
-        }
+        ReleaseTextureEntry(texture->second);
     }
 }
 
 LAppTextureManager::TextureInfo* LAppTextureManager::GetTextureInfoById(GLuint textureId) const
 {
-    for (Csm::csmUint32 i = 0; i < _textures.GetSize(); i++)
+    const auto texture = _texturesById.find(textureId);
+    if (texture != _texturesById.end())
     {
-        if (_textures[i]->id == textureId)
-        {
-            return _textures[i];
-        }
+        return &texture->second->info;
     }
 
     return NULL;
 }
+
+void LAppTextureManager::SetMemoryBudget(size_t bytes)
+{
+    _memoryBudget = bytes;
+    TrimTextures();
+}
+
+void LAppTextureManager::GetTextureStats(std::vector<TextureInfo>& stats) const
+{
+    stats.clear();
+    stats.reserve(_texturesById.size());
+    for (const auto& texture : _texturesById)
+    {
+        stats.push_back(texture.second->info);
+    }
+    std::sort(stats.begin(), stats.end(), [](const TextureInfo& a, const TextureInfo& b) {
+        return a.memorySize > b.memorySize;
+    });
+}
+
+LAppTextureManager::TextureInfo* LAppTextureManager::AcquireTexture(TextureEntry* entry)
+{
+    if (entry->info.referenceCount == 0)
+    {
+        _unusedTextures.erase(entry->unusedPosition);
+        entry->unusedPosition = _unusedTextures.end();
+        _unusedMemorySize -= entry->info.memorySize;
+    }
+    entry->info.referenceCount++;
+    return &entry->info;
+}
+
+void LAppTextureManager::ReleaseTextureEntry(TextureEntry* entry)
+{
+    if (entry->info.referenceCount <= 0)
+    {
+        return;
+    }
+    entry->info.referenceCount--;
+    if (entry->info.referenceCount > 0)
+    {
+        return;
+    }
+
+    // すぐに再利用される（モデルを元に戻す等）こともあるので、予算内なら残しておく
+    entry->unusedPosition = _unusedTextures.insert(_unusedTextures.end(), entry->info.id);
+    _unusedMemorySize += entry->info.memorySize;
+    TrimTextures();
+}
+
+void LAppTextureManager::TrimTextures()
+{
+    while (_totalMemorySize > _memoryBudget && !_unusedTextures.empty())
+    {
+        const auto texture = _texturesById.find(_unusedTextures.front());
+        CF_LOG_DEBUG("evict texture %s (%zu KB)", texture->second->info.fileName.c_str(), texture->second->info.memorySize / 1024);
+        DeleteTexture(texture->second);
+    }
+}
+
+void LAppTextureManager::DeleteTexture(TextureEntry* entry)
+{
+    if (entry->info.referenceCount == 0)
+    {
+        _unusedTextures.erase(entry->unusedPosition);
+        _unusedMemorySize -= entry->info.memorySize;
+    }
+    _totalMemorySize -= entry->info.memorySize;
+    _texturesByName.erase(entry->info.fileName);
+    _texturesById.erase(entry->info.id);
+
+    glDeleteTextures(1, &entry->info.id);
+    delete entry;
+}
@@ -59,8 +59,8 @@ void LAppView::Initialize()
 {
     //int width, height;
     //glfwGetWindowSize(LAppDelegate::GetInstance()->GetWindow(), &width, &height);
-    int width = LAppDelegate::GetInstance()->GetWindow()->width();
-    int height = LAppDelegate::GetInstance()->GetWindow()->height();
+    int width = LAppDelegate::GetInstance()->GetWindowWidth();
+    int height = LAppDelegate::GetInstance()->GetWindowHeight();
     if(width==0 || height==0)
     {
         return;
@@ -146,8 +146,8 @@ void LAppView::InitializeSprite()
 
     //int width, height;
     //glfwGetWindowSize(LAppDelegate::GetInstance()->GetWindow(), &width, &height);
-    int width = LAppDelegate::GetInstance()->GetWindow()->width();
-    int height = LAppDelegate::GetInstance()->GetWindow()->height();
+    int width = LAppDelegate::GetInstance()->GetWindowWidth();
+    int height = LAppDelegate::GetInstance()->GetWindowHeight();
     float x = width * 0.5f;
     float y = height * 0.5f;
 #if 0
@@ -272,8 +272,8 @@ void LAppView::PreModelDraw(LAppModel& refModel)
         {// 描画ターゲット内部未作成の場合はここで作成
             //int width, height;
             //glfwGetWindowSize(LAppDelegate::GetInstance()->GetWindow(), &width, &height);
-            int width = LAppDelegate::GetInstance()->GetWindow()->width();
-            int height = LAppDelegate::GetInstance()->GetWindow()->height();
+            int width = LAppDelegate::GetInstance()->GetWindowWidth();
+            int height = LAppDelegate::GetInstance()->GetWindowHeight();
             if (width != 0 && height != 0)
             {
                 // モデル描画キャンバス
@@ -96,6 +96,11 @@ Csm::csmBool LAppWavFileHandler::LoadWavFile(const Csm::csmString &filePath, std
 
     // 如果文件加载失败或者没有给定以"RIFF"开头的大小，则失败。
     if ((_byteReader._fileByte == nullptr) || (_byteReader._fileSize < 4)) {
+        if (sound == nullptr) {
+            LAppPal::ReleaseBytes(_byteReader._fileByte);
+        }
+        _byteReader._fileByte = nullptr;
+        _byteReader._fileSize = 0;
         return false;
     }
 
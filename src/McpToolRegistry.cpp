@@ -0,0 +1,135 @@
+#include "McpToolRegistry.h"
+#include <QCoreApplication>
+#include <QMetaObject>
+#include <QSemaphore>
+#include <QThread>
+#include <QDebug>
+
+McpToolResult McpToolResult::text(const QString &text)
+{
+    McpToolResult result;
+    result.content.append(QJsonObject{{"type", "text"}, {"text", text}});
+    return result;
+}
+
+McpToolResult McpToolResult::image(const QByteArray &data, const QString &mimeType)
+{
+    McpToolResult result;
+    result.content.append(QJsonObject{
+        {"type", "image"},
+        {"data", QString::fromLatin1(data.toBase64())},
+        {"mimeType", mimeType}
+    });
+    return result;
+}
+
+McpToolResult McpToolResult::error(const QString &message)
+{
+    McpToolResult result = text(message);
+    result.isError = true;
+    return result;
+}
+
+QJsonObject McpToolResult::toJson() const
+{
+    QJsonObject json;
+    json["content"] = content;
+    json["isError"] = isError;
+    return json;
+}
+
+McpCallContext::McpCallContext(const QJsonValue &requestId, std::shared_ptr<std::atomic_bool> cancelled)
+    : m_requestId(requestId)
+    , m_cancelled(std::move(cancelled))
+{
+}
+
+bool McpCallContext::runOnMainThread(const std::function<void()> &fn) const
+{
+    QCoreApplication *app = QCoreApplication::instance();
+    if (!app) {
+        return false;
+    }
+    if (QThread::currentThread() == app->thread()) {
+        fn();
+        return true;
+    }
+
+    // 信号量由共享指针持有，工作线程放弃等待后主线程仍可安全释放。
+    // 取消标志也在主线程设置，fn要么已执行完，要么不会再执行，可以安全引用调用方栈上的变量
+    auto done = std::make_shared<QSemaphore>(0);
+    auto cancelled = m_cancelled;
+    QMetaObject::invokeMethod(app, [fn, done, cancelled]() {
+        if (!cancelled->load()) {
+            fn();
+        }
+        done->release();
+    }, Qt::QueuedConnection);
+
+    while (!done->tryAcquire(1, 20)) {
+        if (isCancelled()) {
+            return false;
+        }
+    }
+    return !isCancelled();
+}
+
+bool McpToolRegistry::registerTool(const McpTool &tool)
+{
+    if (tool.name.isEmpty() || !tool.handler) {
+        qWarning() << "Refusing to register MCP tool without name or handler";
+        return false;
+    }
+    QMutexLocker locker(&m_mutex);
+    if (m_tools.contains(tool.name)) {
+        qWarning() << "MCP tool already registered:" << tool.name;
+        return false;
+    }
+    m_tools.insert(tool.name, tool);
+    qDebug() << "Registered MCP tool:" << tool.name;
+    return true;
+}
+
+bool McpToolRegistry::unregisterTool(const QString &name)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_tools.remove(name) > 0;
+}
+
+bool McpToolRegistry::contains(const QString &name) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_tools.contains(name);
+}
+
+bool McpToolRegistry::tool(const QString &name, McpTool *out) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_tools.constFind(name);
+    if (it == m_tools.constEnd()) {
+        return false;
+    }
+    if (out) {
+        *out = it.value();
+    }
+    return true;
+}
+
+QJsonArray McpToolRegistry::toolsListJson() const
+{
+    QMutexLocker locker(&m_mutex);
+    QJsonArray tools;
+    for (const McpTool &tool : m_tools) {
+        QJsonObject schema = tool.inputSchema;
+        if (schema.isEmpty()) {
+            schema["type"] = "object";
+            schema["properties"] = QJsonObject();
+        }
+        tools.append(QJsonObject{
+            {"name", tool.name},
+            {"description", tool.description},
+            {"inputSchema", schema}
+        });
+    }
+    return tools;
+}
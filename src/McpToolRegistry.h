@@ -0,0 +1,79 @@
+#ifndef MCPTOOLREGISTRY_H
+#define MCPTOOLREGISTRY_H
+
+#include <QString>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonValue>
+#include <QByteArray>
+#include <QMap>
+#include <QMutex>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+// MCP tools/call 的返回内容
+struct McpToolResult {
+    QJsonArray content;
+    bool isError = false;
+
+    static McpToolResult text(const QString &text);
+    static McpToolResult image(const QByteArray &data, const QString &mimeType);
+    static McpToolResult error(const QString &message);
+
+    QJsonObject toJson() const;
+};
+
+/**
+ * @brief 单次工具调用的上下文
+ *
+ * 处理函数运行在工作线程上，需要访问界面/Live2D等主线程对象时
+ * 通过 runOnMainThread 切回主线程；长耗时处理应定期检查 isCancelled()。
+ */
+class McpCallContext
+{
+public:
+    McpCallContext(const QJsonValue &requestId, std::shared_ptr<std::atomic_bool> cancelled);
+
+    QJsonValue requestId() const { return m_requestId; }
+    bool isCancelled() const { return m_cancelled->load(); }
+
+    // 在主线程执行fn并等待完成；调用被取消或超时时返回false（fn可能尚未执行）
+    bool runOnMainThread(const std::function<void()> &fn) const;
+
+private:
+    QJsonValue m_requestId;
+    std::shared_ptr<std::atomic_bool> m_cancelled;
+};
+
+using McpToolHandler = std::function<McpToolResult(const QJsonObject &arguments, const McpCallContext &context)>;
+
+struct McpTool {
+    QString name;
+    QString description;
+    QJsonObject inputSchema;    // JSON Schema，原样出现在tools/list中
+    McpToolHandler handler;
+    int timeoutMs = 5000;       // 单次调用超时
+};
+
+/**
+ * @brief MCP工具注册表
+ *
+ * 工具以名字为键保存，tools/list 按名字顺序输出。线程安全，
+ * 工作线程可以在调用过程中查询，主线程可以随时注册/注销。
+ */
+class McpToolRegistry
+{
+public:
+    bool registerTool(const McpTool &tool);
+    bool unregisterTool(const QString &name);
+    bool contains(const QString &name) const;
+    bool tool(const QString &name, McpTool *out) const;
+    QJsonArray toolsListJson() const;
+
+private:
+    mutable QMutex m_mutex;
+    QMap<QString, McpTool> m_tools;
+};
+
+#endif // MCPTOOLREGISTRY_H
@@ -0,0 +1,183 @@
+#include "McpToolRuntime.h"
+#include <QThreadPool>
+#include <QRunnable>
+#include <QTimer>
+#include <QMetaObject>
+#include <QStringList>
+#include <QDebug>
+#include <exception>
+
+namespace {
+
+// JSON-RPC 错误码
+constexpr int kInvalidRequest = -32600;
+constexpr int kInvalidParams = -32602;
+constexpr int kServerBusy = -32000;
+constexpr int kRequestTimeout = -32001;
+
+} // namespace
+
+McpToolRuntime::McpToolRuntime(McpToolRegistry *registry, QObject *parent)
+    : QObject(parent)
+    , m_registry(registry)
+    , m_pool(new QThreadPool(this))
+    , m_maxPendingCalls(8)
+    , m_nextGeneration(0)
+{
+    m_pool->setObjectName("McpToolPool");
+    m_pool->setMaxThreadCount(2);
+}
+
+McpToolRuntime::~McpToolRuntime()
+{
+    cancelAll();
+    // 已在执行的处理函数无法中断，等待其返回，避免回投到已销毁的对象
+    m_pool->waitForDone();
+}
+
+void McpToolRuntime::setMaxThreads(int threads)
+{
+    m_pool->setMaxThreadCount(qMax(1, threads));
+}
+
+QString McpToolRuntime::keyFor(const QJsonValue &requestId)
+{
+    // id可以是字符串或数字，加前缀区分 "1" 与 1
+    if (requestId.isString()) {
+        return QStringLiteral("s:") + requestId.toString();
+    }
+    return QStringLiteral("n:") + QString::number(requestId.toDouble(), 'g', 17);
+}
+
+QJsonObject McpToolRuntime::makeResult(const QJsonValue &requestId, const QJsonObject &result)
+{
+    QJsonObject response;
+    response["jsonrpc"] = "2.0";
+    response["id"] = requestId;
+    response["result"] = result;
+    return response;
+}
+
+QJsonObject McpToolRuntime::makeError(const QJsonValue &requestId, int code, const QString &message)
+{
+    QJsonObject response;
+    response["jsonrpc"] = "2.0";
+    response["id"] = requestId;
+    response["error"] = QJsonObject{{"code", code}, {"message", message}};
+    return response;
+}
+
+void McpToolRuntime::call(const QJsonValue &requestId, const QString &toolName, const QJsonObject &arguments)
+{
+    const QString key = keyFor(requestId);
+    if (m_pending.contains(key)) {
+        emit responseReady(makeError(requestId, kInvalidRequest, "Duplicate request id"));
+        return;
+    }
+
+    McpTool tool;
+    if (!m_registry || !m_registry->tool(toolName, &tool)) {
+        emit responseReady(makeError(requestId, kInvalidParams, QString("Unknown tool: %1").arg(toolName)));
+        return;
+    }
+
+    if (m_pending.size() >= m_maxPendingCalls) {
+        qWarning() << "MCP runtime busy, rejecting" << toolName << "pending:" << m_pending.size();
+        emit responseReady(makeError(requestId, kServerBusy, "Too many pending tool calls"));
+        return;
+    }
+
+    PendingCall pending;
+    pending.requestId = requestId;
+    pending.toolName = toolName;
+    pending.cancelled = std::make_shared<std::atomic_bool>(false);
+    pending.clock.start();
+    pending.generation = ++m_nextGeneration;
+    // 超时从提交时算起，排队时间也计入
+    pending.timeoutTimer = new QTimer(this);
+    pending.timeoutTimer->setSingleShot(true);
+    connect(pending.timeoutTimer, &QTimer::timeout, this, [this, key]() { onCallTimeout(key); });
+    pending.timeoutTimer->start(qMax(1, tool.timeoutMs));
+    m_pending.insert(key, pending);
+
+    const McpCallContext context(requestId, pending.cancelled);
+    const McpToolHandler handler = tool.handler;
+    const quint64 generation = pending.generation;
+    m_pool->start(QRunnable::create([this, key, generation, handler, arguments, context]() {
+        McpToolResult result;
+        if (context.isCancelled()) {
+            return;
+        }
+        try {
+            result = handler(arguments, context);
+        } catch (const std::exception &e) {
+            result = McpToolResult::error(QString("Tool failed: %1").arg(QString::fromUtf8(e.what())));
+        } catch (...) {
+            result = McpToolResult::error("Tool failed with unknown exception");
+        }
+        if (context.isCancelled()) {
+            return;
+        }
+        QMetaObject::invokeMethod(this, [this, key, generation, result]() {
+            finishCall(key, generation, result);
+        }, Qt::QueuedConnection);
+    }));
+
+    qDebug() << "MCP tool call queued:" << toolName << "id:" << requestId << "pending:" << m_pending.size();
+}
+
+void McpToolRuntime::cancel(const QJsonValue &requestId)
+{
+    const QString key = keyFor(requestId);
+    if (!m_pending.contains(key)) {
+        return;
+    }
+    qDebug() << "MCP tool call cancelled:" << m_pending.value(key).toolName << "id:" << requestId;
+    dropCall(key);
+}
+
+void McpToolRuntime::cancelAll()
+{
+    const QStringList keys = m_pending.keys();
+    for (const QString &key : keys) {
+        dropCall(key);
+    }
+}
+
+void McpToolRuntime::finishCall(const QString &key, quint64 generation, const McpToolResult &result)
+{
+    auto it = m_pending.find(key);
+    if (it == m_pending.end() || it->generation != generation || it->cancelled->load()) {
+        // 已超时或被取消（同一id可能已被新的调用占用），迟到的结果丢弃
+        return;
+    }
+    const QJsonValue requestId = it->requestId;
+    qDebug() << "MCP tool call finished:" << it->toolName << "id:" << requestId
+             << "elapsed:" << it->clock.elapsed() << "ms" << (result.isError ? "(error)" : "");
+    dropCall(key);
+    emit responseReady(makeResult(requestId, result.toJson()));
+}
+
+void McpToolRuntime::onCallTimeout(const QString &key)
+{
+    auto it = m_pending.find(key);
+    if (it == m_pending.end()) {
+        return;
+    }
+    const QJsonValue requestId = it->requestId;
+    qWarning() << "MCP tool call timed out:" << it->toolName << "id:" << requestId;
+    dropCall(key);
+    emit responseReady(makeError(requestId, kRequestTimeout, "Tool call timed out"));
+}
+
+void McpToolRuntime::dropCall(const QString &key)
+{
+    PendingCall pending = m_pending.take(key);
+    if (pending.cancelled) {
+        pending.cancelled->store(true);
+    }
+    if (pending.timeoutTimer) {
+        pending.timeoutTimer->stop();
+        pending.timeoutTimer->deleteLater();
+    }
+}
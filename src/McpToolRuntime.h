@@ -0,0 +1,71 @@
+#ifndef MCPTOOLRUNTIME_H
+#define MCPTOOLRUNTIME_H
+
+#include <QObject>
+#include <QHash>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QElapsedTimer>
+#include <atomic>
+#include <memory>
+#include "McpToolRegistry.h"
+
+class QThreadPool;
+class QTimer;
+
+/**
+ * @brief MCP tools/call 的异步执行器
+ *
+ * 调用在有界线程池上执行，不占用收发音频的socket线程。
+ * 每个请求按JSON-RPC id跟踪，支持多个请求同时在途、单独超时和取消；
+ * 超时或被取消的调用结果到达时直接丢弃，不会重复应答。
+ */
+class McpToolRuntime : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit McpToolRuntime(McpToolRegistry *registry, QObject *parent = nullptr);
+    ~McpToolRuntime();
+
+    void setMaxThreads(int threads);
+    void setMaxPendingCalls(int calls) { m_maxPendingCalls = calls; }
+
+    // 提交调用，应答通过responseReady发出（包括参数错误等立即失败的情况）
+    void call(const QJsonValue &requestId, const QString &toolName, const QJsonObject &arguments);
+    // notifications/cancelled：按MCP约定被取消的请求不再应答
+    void cancel(const QJsonValue &requestId);
+    void cancelAll();
+
+    int pendingCalls() const { return m_pending.size(); }
+
+    static QJsonObject makeResult(const QJsonValue &requestId, const QJsonObject &result);
+    static QJsonObject makeError(const QJsonValue &requestId, int code, const QString &message);
+
+signals:
+    // 完整的JSON-RPC应答，由调用方包装进MCP消息发送
+    void responseReady(const QJsonObject &response);
+
+private:
+    struct PendingCall {
+        QJsonValue requestId;
+        QString toolName;
+        std::shared_ptr<std::atomic_bool> cancelled;
+        QTimer *timeoutTimer = nullptr;
+        QElapsedTimer clock;
+        quint64 generation = 0; // 区分同一id先后提交的调用，旧调用迟到的结果不会应答新调用
+    };
+
+    static QString keyFor(const QJsonValue &requestId);
+    void finishCall(const QString &key, quint64 generation, const McpToolResult &result);
+    void onCallTimeout(const QString &key);
+    void dropCall(const QString &key);
+
+    McpToolRegistry *m_registry;
+    QThreadPool *m_pool;
+    int m_maxPendingCalls;
+    quint64 m_nextGeneration;
+    QHash<QString, PendingCall> m_pending;
+};
+
+#endif // MCPTOOLRUNTIME_H
@@ -2,6 +2,7 @@
 #import "MouseEvent.h"
 #import <Cocoa/Cocoa.h>
 #include "LAppDelegate.hpp"
+#include "ResourceLoader.hpp"
 #include "LogUtil.h"
 
 void MouseEventHandle::EnableMousePassThrough(WId windowId, bool enable) {
@@ -0,0 +1,386 @@
+#include "MqttClient.h"
+#include <QSslSocket>
+#include <QTimer>
+#include <QDebug>
+
+namespace MqttPacket {
+
+bool takePacket(QByteArray &buffer, Packet &packet, bool *malformed)
+{
+    if (malformed) {
+        *malformed = false;
+    }
+    if (buffer.size() < 2) {
+        return false;
+    }
+
+    // 剩余长度：1~4字节变长编码
+    int remaining = 0;
+    int multiplier = 1;
+    int pos = 1;
+    while (true) {
+        if (pos >= buffer.size()) {
+            return false;
+        }
+        if (pos > 4) {
+            if (malformed) {
+                *malformed = true;
+            }
+            return false;
+        }
+        const quint8 byte = static_cast<quint8>(buffer.at(pos++));
+        remaining += (byte & 0x7F) * multiplier;
+        multiplier *= 128;
+        if ((byte & 0x80) == 0) {
+            break;
+        }
+    }
+
+    if (buffer.size() < pos + remaining) {
+        return false;
+    }
+
+    const quint8 header = static_cast<quint8>(buffer.at(0));
+    packet.type = header >> 4;
+    packet.flags = header & 0x0F;
+    packet.body = buffer.mid(pos, remaining);
+    buffer.remove(0, pos + remaining);
+    return true;
+}
+
+QByteArray encode(quint8 type, quint8 flags, const QByteArray &body)
+{
+    QByteArray packet;
+    packet.reserve(body.size() + 5);
+    packet.append(static_cast<char>((type << 4) | (flags & 0x0F)));
+
+    int remaining = body.size();
+    do {
+        quint8 byte = remaining % 128;
+        remaining /= 128;
+        if (remaining > 0) {
+            byte |= 0x80;
+        }
+        packet.append(static_cast<char>(byte));
+    } while (remaining > 0);
+
+    packet.append(body);
+    return packet;
+}
+
+QByteArray encodeString(const QString &value)
+{
+    const QByteArray utf8 = value.toUtf8();
+    QByteArray out;
+    out.append(static_cast<char>((utf8.size() >> 8) & 0xFF));
+    out.append(static_cast<char>(utf8.size() & 0xFF));
+    out.append(utf8);
+    return out;
+}
+
+QByteArray encodeConnect(const QString &clientId, const QString &username, const QString &password,
+                         quint16 keepAliveSec)
+{
+    quint8 connectFlags = 0x02; // clean session
+    if (!username.isEmpty()) {
+        connectFlags |= 0x80;
+    }
+    if (!password.isEmpty()) {
+        connectFlags |= 0x40;
+    }
+
+    QByteArray body;
+    body.append(encodeString(QStringLiteral("MQTT")));
+    body.append(static_cast<char>(0x04)); // 协议级别 3.1.1
+    body.append(static_cast<char>(connectFlags));
+    body.append(static_cast<char>((keepAliveSec >> 8) & 0xFF));
+    body.append(static_cast<char>(keepAliveSec & 0xFF));
+    body.append(encodeString(clientId));
+    if (!username.isEmpty()) {
+        body.append(encodeString(username));
+    }
+    if (!password.isEmpty()) {
+        body.append(encodeString(password));
+    }
+    return encode(Connect, 0, body);
+}
+
+QByteArray encodePublish(const QString &topic, const QByteArray &payload)
+{
+    QByteArray body = encodeString(topic);
+    body.append(payload);
+    return encode(Publish, 0, body);
+}
+
+QByteArray encodeSubscribe(quint16 packetId, const QString &topic)
+{
+    QByteArray body;
+    body.append(static_cast<char>((packetId >> 8) & 0xFF));
+    body.append(static_cast<char>(packetId & 0xFF));
+    body.append(encodeString(topic));
+    body.append(static_cast<char>(0x00)); // 请求QoS0
+    return encode(Subscribe, 0x02, body);
+}
+
+bool readString(const QByteArray &body, int &offset, QString &value)
+{
+    if (offset + 2 > body.size()) {
+        return false;
+    }
+    const int length = (static_cast<quint8>(body.at(offset)) << 8) | static_cast<quint8>(body.at(offset + 1));
+    if (offset + 2 + length > body.size()) {
+        return false;
+    }
+    value = QString::fromUtf8(body.constData() + offset + 2, length);
+    offset += 2 + length;
+    return true;
+}
+
+bool parsePublish(const Packet &packet, QString &topic, QByteArray &payload, quint16 *packetId)
+{
+    int offset = 0;
+    if (!readString(packet.body, offset, topic)) {
+        return false;
+    }
+
+    const int qos = (packet.flags >> 1) & 0x03;
+    if (qos > 0) {
+        if (offset + 2 > packet.body.size()) {
+            return false;
+        }
+        if (packetId) {
+            *packetId = static_cast<quint16>((static_cast<quint8>(packet.body.at(offset)) << 8)
+                                             | static_cast<quint8>(packet.body.at(offset + 1)));
+        }
+        offset += 2;
+    }
+
+    payload = packet.body.mid(offset);
+    return true;
+}
+
+} // namespace MqttPacket
+
+MqttClient::MqttClient(QObject *parent)
+    : QObject(parent)
+    , m_socket(new QSslSocket(this))
+    , m_keepAliveTimer(new QTimer(this))
+    , m_nextPacketId(1)
+    , m_keepAliveSec(90) // 与小智固件一致
+    , m_forceTls(false)
+    , m_connected(false)
+    , m_pingOutstanding(false)
+{
+    connect(m_socket, &QSslSocket::connected, this, [this]() {
+        // TLS连接等encrypted之后再发CONNECT
+        if (m_socket->mode() == QSslSocket::UnencryptedMode) {
+            onSocketConnected();
+        }
+    });
+    connect(m_socket, &QSslSocket::encrypted, this, &MqttClient::onSocketConnected);
+    connect(m_socket, &QSslSocket::disconnected, this, &MqttClient::onSocketDisconnected);
+    connect(m_socket, &QSslSocket::readyRead, this, &MqttClient::onReadyRead);
+    connect(m_socket, &QSslSocket::errorOccurred, this, &MqttClient::onSocketError);
+    connect(m_keepAliveTimer, &QTimer::timeout, this, &MqttClient::onKeepAliveTimeout);
+}
+
+MqttClient::~MqttClient()
+{
+    disconnectFromBroker();
+}
+
+void MqttClient::connectToBroker(const QString &endpoint, const QString &clientId,
+                                 const QString &username, const QString &password)
+{
+    if (m_socket->state() != QAbstractSocket::UnconnectedState) {
+        m_socket->abort();
+    }
+
+    QString host = endpoint;
+    quint16 port = 8883;
+    const int colon = endpoint.lastIndexOf(':');
+    if (colon > 0) {
+        host = endpoint.left(colon);
+        port = static_cast<quint16>(endpoint.mid(colon + 1).toUInt());
+    }
+
+    m_clientId = clientId;
+    m_username = username;
+    m_password = password;
+    m_readBuffer.clear();
+    m_pendingSubscriptions.clear();
+    m_connected = false;
+    m_pingOutstanding = false;
+
+    const bool useTls = m_forceTls || port == 8883;
+    qDebug() << "Connecting to MQTT broker:" << host << port << (useTls ? "(TLS)" : "(plain)");
+    if (useTls) {
+        m_socket->connectToHostEncrypted(host, port);
+    } else {
+        m_socket->connectToHost(host, port);
+    }
+}
+
+void MqttClient::disconnectFromBroker()
+{
+    m_keepAliveTimer->stop();
+    if (m_socket->state() == QAbstractSocket::ConnectedState) {
+        if (m_connected) {
+            m_socket->write(MqttPacket::encode(MqttPacket::Disconnect, 0, QByteArray()));
+            m_socket->flush();
+        }
+        m_socket->disconnectFromHost();
+    } else if (m_socket->state() != QAbstractSocket::UnconnectedState) {
+        m_socket->abort();
+    }
+    m_connected = false;
+}
+
+void MqttClient::subscribe(const QString &topic)
+{
+    if (!m_connected) {
+        qWarning() << "Cannot subscribe: MQTT not connected";
+        return;
+    }
+    const quint16 packetId = m_nextPacketId++;
+    if (m_nextPacketId == 0) {
+        m_nextPacketId = 1;
+    }
+    m_pendingSubscriptions.insert(packetId, topic);
+    m_socket->write(MqttPacket::encodeSubscribe(packetId, topic));
+}
+
+bool MqttClient::publish(const QString &topic, const QByteArray &payload)
+{
+    if (!m_connected) {
+        qWarning() << "Cannot publish: MQTT not connected";
+        return false;
+    }
+    return m_socket->write(MqttPacket::encodePublish(topic, payload)) > 0;
+}
+
+qint64 MqttClient::bytesToWrite() const
+{
+    return m_socket->bytesToWrite();
+}
+
+void MqttClient::onSocketConnected()
+{
+    qDebug() << "MQTT socket connected, sending CONNECT";
+    m_socket->write(MqttPacket::encodeConnect(m_clientId, m_username, m_password,
+                                              static_cast<quint16>(m_keepAliveSec)));
+}
+
+void MqttClient::onSocketError()
+{
+    fail(QString("MQTT socket error: %1").arg(m_socket->errorString()));
+}
+
+void MqttClient::onSocketDisconnected()
+{
+    qDebug() << "MQTT socket disconnected";
+    m_keepAliveTimer->stop();
+    const bool wasConnected = m_connected;
+    m_connected = false;
+    if (wasConnected) {
+        emit disconnected();
+    }
+}
+
+void MqttClient::onReadyRead()
+{
+    m_readBuffer.append(m_socket->readAll());
+
+    MqttPacket::Packet packet;
+    bool malformed = false;
+    while (MqttPacket::takePacket(m_readBuffer, packet, &malformed)) {
+        handlePacket(packet);
+    }
+    if (malformed) {
+        fail("Malformed MQTT packet from broker");
+        m_socket->abort();
+    }
+}
+
+void MqttClient::onKeepAliveTimeout()
+{
+    if (!m_connected) {
+        return;
+    }
+    if (m_pingOutstanding) {
+        // 上一个PINGREQ在半个保活周期内没有回应
+        fail("MQTT keepalive timeout");
+        m_socket->abort();
+        return;
+    }
+    m_pingOutstanding = true;
+    m_pingClock.restart();
+    m_socket->write(MqttPacket::encode(MqttPacket::PingReq, 0, QByteArray()));
+}
+
+void MqttClient::handlePacket(const MqttPacket::Packet &packet)
+{
+    switch (packet.type) {
+    case MqttPacket::ConnAck: {
+        const int returnCode = packet.body.size() >= 2 ? static_cast<quint8>(packet.body.at(1)) : -1;
+        if (returnCode != 0) {
+            fail(QString("MQTT connection refused, code %1").arg(returnCode));
+            m_socket->disconnectFromHost();
+            return;
+        }
+        qDebug() << "MQTT connected, client id:" << m_clientId;
+        m_connected = true;
+        if (m_keepAliveSec > 0) {
+            m_keepAliveTimer->start(m_keepAliveSec * 1000 / 2);
+        }
+        emit connected();
+        break;
+    }
+    case MqttPacket::SubAck: {
+        if (packet.body.size() < 3) {
+            break;
+        }
+        const quint16 packetId = static_cast<quint16>((static_cast<quint8>(packet.body.at(0)) << 8)
+                                                      | static_cast<quint8>(packet.body.at(1)));
+        const QString topic = m_pendingSubscriptions.take(packetId);
+        if (static_cast<quint8>(packet.body.at(2)) == 0x80) {
+            fail(QString("MQTT subscribe rejected: %1").arg(topic));
+            break;
+        }
+        emit subscribed(topic);
+        break;
+    }
+    case MqttPacket::Publish: {
+        QString topic;
+        QByteArray payload;
+        quint16 packetId = 0;
+        if (!MqttPacket::parsePublish(packet, topic, payload, &packetId)) {
+            qWarning() << "Dropping malformed MQTT PUBLISH";
+            break;
+        }
+        // 服务端按QoS1下发时需要确认
+        if (((packet.flags >> 1) & 0x03) == 1) {
+            QByteArray ack;
+            ack.append(static_cast<char>((packetId >> 8) & 0xFF));
+            ack.append(static_cast<char>(packetId & 0xFF));
+            m_socket->write(MqttPacket::encode(MqttPacket::PubAck, 0, ack));
+        }
+        emit messageReceived(topic, payload);
+        break;
+    }
+    case MqttPacket::PingResp:
+        m_pingOutstanding = false;
+        qDebug() << "MQTT pong, RTT:" << m_pingClock.elapsed() << "ms";
+        emit pingRttMeasured(m_pingClock.elapsed());
+        break;
+    default:
+        qDebug() << "Ignoring MQTT packet type" << packet.type;
+        break;
+    }
+}
+
+void MqttClient::fail(const QString &error)
+{
+    qWarning() << error;
+    emit errorOccurred(error);
+}
@@ -0,0 +1,115 @@
+#ifndef MQTTCLIENT_H
+#define MQTTCLIENT_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <QElapsedTimer>
+#include <QHash>
+
+class QSslSocket;
+class QTimer;
+
+// MQTT 3.1.1 控制报文编解码（客户端与本地broker桩共用）
+namespace MqttPacket {
+
+enum Type : quint8 {
+    Connect = 1,
+    ConnAck = 2,
+    Publish = 3,
+    PubAck = 4,
+    Subscribe = 8,
+    SubAck = 9,
+    Unsubscribe = 10,
+    UnsubAck = 11,
+    PingReq = 12,
+    PingResp = 13,
+    Disconnect = 14
+};
+
+struct Packet {
+    quint8 type = 0;
+    quint8 flags = 0;
+    QByteArray body;   // 可变头 + 载荷
+};
+
+// 从流缓冲区头部取出一个完整报文；数据不足返回false且不消费，malformed置true表示无法继续解析
+bool takePacket(QByteArray &buffer, Packet &packet, bool *malformed = nullptr);
+
+QByteArray encode(quint8 type, quint8 flags, const QByteArray &body);
+QByteArray encodeString(const QString &value);
+QByteArray encodeConnect(const QString &clientId, const QString &username, const QString &password,
+                         quint16 keepAliveSec);
+QByteArray encodePublish(const QString &topic, const QByteArray &payload);
+QByteArray encodeSubscribe(quint16 packetId, const QString &topic);
+
+// 读取 2字节长度 + UTF-8 字符串，offset前移；越界返回false
+bool readString(const QByteArray &body, int &offset, QString &value);
+// 解析PUBLISH（QoS>0时输出packetId）
+bool parsePublish(const Packet &packet, QString &topic, QByteArray &payload, quint16 *packetId = nullptr);
+
+} // namespace MqttPacket
+
+/**
+ * @brief 最小化的MQTT 3.1.1客户端
+ *
+ * 只实现小智控制通道需要的子集：CONNECT / SUBSCRIBE / QoS0 PUBLISH /
+ * PINGREQ 保活 / DISCONNECT。端口8883或显式要求时使用TLS。
+ */
+class MqttClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MqttClient(QObject *parent = nullptr);
+    ~MqttClient();
+
+    // endpoint形如 "host" 或 "host:port"，未给端口时默认8883(TLS)
+    void connectToBroker(const QString &endpoint, const QString &clientId,
+                         const QString &username, const QString &password);
+    void disconnectFromBroker();
+    bool isConnected() const { return m_connected; }
+
+    void subscribe(const QString &topic);
+    bool publish(const QString &topic, const QByteArray &payload);
+
+    void setKeepAlive(int seconds) { m_keepAliveSec = seconds; }
+    void setUseTls(bool enabled) { m_forceTls = enabled; }
+
+    qint64 bytesToWrite() const;
+
+signals:
+    void connected();
+    void disconnected();
+    void subscribed(const QString &topic);
+    void messageReceived(const QString &topic, const QByteArray &payload);
+    void errorOccurred(const QString &error);
+    void pingRttMeasured(qint64 rttMs);
+
+private slots:
+    void onSocketConnected();
+    void onSocketError();
+    void onSocketDisconnected();
+    void onReadyRead();
+    void onKeepAliveTimeout();
+
+private:
+    void handlePacket(const MqttPacket::Packet &packet);
+    void fail(const QString &error);
+
+    QSslSocket *m_socket;
+    QTimer *m_keepAliveTimer;
+    QByteArray m_readBuffer;
+    QString m_clientId;
+    QString m_username;
+    QString m_password;
+    QHash<quint16, QString> m_pendingSubscriptions;
+    quint16 m_nextPacketId;
+    int m_keepAliveSec;
+    bool m_forceTls;
+    bool m_connected;
+    bool m_pingOutstanding;
+    QElapsedTimer m_pingClock;
+};
+
+#endif // MQTTCLIENT_H
@@ -0,0 +1,278 @@
+#include "MqttUdpTransport.h"
+#include "MqttClient.h"
+#include <QUdpSocket>
+#include <QNetworkDatagram>
+#include <QJsonDocument>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+inline void writeBe16(QByteArray &buffer, int offset, quint16 value)
+{
+    buffer[offset] = static_cast<char>((value >> 8) & 0xFF);
+    buffer[offset + 1] = static_cast<char>(value & 0xFF);
+}
+
+inline void writeBe32(QByteArray &buffer, int offset, quint32 value)
+{
+    buffer[offset] = static_cast<char>((value >> 24) & 0xFF);
+    buffer[offset + 1] = static_cast<char>((value >> 16) & 0xFF);
+    buffer[offset + 2] = static_cast<char>((value >> 8) & 0xFF);
+    buffer[offset + 3] = static_cast<char>(value & 0xFF);
+}
+
+inline quint32 readBe32(const QByteArray &buffer, int offset)
+{
+    return (static_cast<quint32>(static_cast<quint8>(buffer.at(offset))) << 24)
+         | (static_cast<quint32>(static_cast<quint8>(buffer.at(offset + 1))) << 16)
+         | (static_cast<quint32>(static_cast<quint8>(buffer.at(offset + 2))) << 8)
+         | static_cast<quint32>(static_cast<quint8>(buffer.at(offset + 3)));
+}
+
+const quint8 kAudioPacketType = 0x01;
+
+} // namespace
+
+MqttTransportConfig MqttTransportConfig::fromJson(const QJsonObject &mqttInfo)
+{
+    MqttTransportConfig config;
+    config.endpoint = mqttInfo["endpoint"].toString();
+    config.clientId = mqttInfo["client_id"].toString();
+    config.username = mqttInfo["username"].toString();
+    config.password = mqttInfo["password"].toString();
+    config.publishTopic = mqttInfo["publish_topic"].toString();
+    config.subscribeTopic = mqttInfo["subscribe_topic"].toString();
+    return config;
+}
+
+MqttUdpTransport::MqttUdpTransport(const MqttTransportConfig &config, QObject *parent)
+    : ProtocolTransport(parent)
+    , m_config(config)
+    , m_mqtt(new MqttClient(this))
+    , m_udp(new QUdpSocket(this))
+    , m_localSequence(0)
+    , m_remoteSequence(0)
+    , m_haveRemoteSequence(false)
+    , m_open(false)
+    , m_udpReady(false)
+{
+    connect(m_mqtt, &MqttClient::connected, this, &MqttUdpTransport::onMqttConnected);
+    connect(m_mqtt, &MqttClient::disconnected, this, &MqttUdpTransport::onMqttDisconnected);
+    connect(m_mqtt, &MqttClient::messageReceived, this, &MqttUdpTransport::onMqttMessage);
+    connect(m_mqtt, &MqttClient::errorOccurred, this, &MqttUdpTransport::errorOccurred);
+    connect(m_mqtt, &MqttClient::pingRttMeasured, this, [this](qint64 rttMs) {
+        emit rttMeasured(static_cast<double>(rttMs));
+    });
+    connect(m_mqtt, &MqttClient::subscribed, this, [this](const QString &topic) {
+        qDebug() << "MQTT subscribed:" << topic;
+        if (!m_open) {
+            m_open = true;
+            emit opened();
+        }
+    });
+    connect(m_udp, &QUdpSocket::readyRead, this, &MqttUdpTransport::onUdpReadyRead);
+}
+
+MqttUdpTransport::~MqttUdpTransport()
+{
+    closeAudioChannel();
+}
+
+bool MqttUdpTransport::open()
+{
+    if (!m_config.isValid()) {
+        emit errorOccurred("MQTT transport not configured (missing MQTT_INFO)");
+        return false;
+    }
+    m_mqtt->connectToBroker(m_config.endpoint, m_config.clientId, m_config.username, m_config.password);
+    return true;
+}
+
+void MqttUdpTransport::close()
+{
+    if (m_udpReady && !m_sessionId.isEmpty()) {
+        // 通知服务端释放UDP会话
+        QJsonObject goodbye;
+        goodbye["type"] = "goodbye";
+        goodbye["session_id"] = m_sessionId;
+        m_mqtt->publish(m_config.publishTopic, QJsonDocument(goodbye).toJson(QJsonDocument::Compact));
+    }
+    closeAudioChannel();
+    m_mqtt->disconnectFromBroker();
+
+    if (m_open) {
+        m_open = false;
+        emit closed();
+    }
+}
+
+bool MqttUdpTransport::sendText(const QString &text)
+{
+    return m_mqtt->publish(m_config.publishTopic, text.toUtf8());
+}
+
+bool MqttUdpTransport::sendAudio(const QByteArray &opusData, quint32 timestamp)
+{
+    // 服务器地址为域名时需等待解析完成
+    if (!m_udpReady || m_udp->state() != QAbstractSocket::ConnectedState) {
+        return false;
+    }
+
+    const QByteArray packet = sealPacket(m_aes, m_nonceTemplate, opusData, timestamp, ++m_localSequence);
+    if (m_udp->write(packet) != packet.size()) {
+        qWarning() << "UDP audio send failed:" << m_udp->errorString();
+        return false;
+    }
+    m_udpStats.packetsSent++;
+    m_udpStats.bytesSent += packet.size();
+    return true;
+}
+
+qint64 MqttUdpTransport::bytesToWrite() const
+{
+    return m_mqtt->bytesToWrite();
+}
+
+QByteArray MqttUdpTransport::sealPacket(const AesCtr &aes, const QByteArray &nonceTemplate, const QByteArray &payload,
+                                        quint32 timestamp, quint32 sequence)
+{
+    QByteArray packet(kNonceSize + payload.size(), Qt::Uninitialized);
+    std::copy(nonceTemplate.constBegin(), nonceTemplate.constBegin() + kNonceSize, packet.begin());
+    packet[0] = static_cast<char>(kAudioPacketType);
+    writeBe16(packet, 2, static_cast<quint16>(payload.size()));
+    writeBe32(packet, 8, timestamp);
+    writeBe32(packet, 12, sequence);
+
+    std::copy(payload.constBegin(), payload.constEnd(), packet.begin() + kNonceSize);
+    aes.apply(reinterpret_cast<const uint8_t *>(packet.constData()),
+              reinterpret_cast<uint8_t *>(packet.data() + kNonceSize), static_cast<size_t>(payload.size()));
+    return packet;
+}
+
+bool MqttUdpTransport::openPacket(const AesCtr &aes, const QByteArray &packet, QByteArray &payload,
+                                  quint32 &timestamp, quint32 &sequence)
+{
+    if (packet.size() < kNonceSize || static_cast<quint8>(packet.at(0)) != kAudioPacketType) {
+        return false;
+    }
+    const int payloadSize = (static_cast<quint8>(packet.at(2)) << 8) | static_cast<quint8>(packet.at(3));
+    if (payloadSize > packet.size() - kNonceSize) {
+        return false;
+    }
+
+    timestamp = readBe32(packet, 8);
+    sequence = readBe32(packet, 12);
+    payload = packet.mid(kNonceSize, payloadSize);
+    aes.apply(reinterpret_cast<const uint8_t *>(packet.constData()),
+              reinterpret_cast<uint8_t *>(payload.data()), static_cast<size_t>(payload.size()));
+    return true;
+}
+
+void MqttUdpTransport::onMqttConnected()
+{
+    if (m_config.subscribeTopic.isEmpty()) {
+        // 部分部署不下发subscribe_topic，服务端按client_id推送
+        m_open = true;
+        emit opened();
+        return;
+    }
+    m_mqtt->subscribe(m_config.subscribeTopic);
+}
+
+void MqttUdpTransport::onMqttDisconnected()
+{
+    closeAudioChannel();
+    if (m_open) {
+        m_open = false;
+        emit closed();
+    }
+}
+
+void MqttUdpTransport::onMqttMessage(const QString &topic, const QByteArray &payload)
+{
+    Q_UNUSED(topic)
+
+    const QJsonObject json = QJsonDocument::fromJson(payload).object();
+    const QString type = json["type"].toString();
+    if (type == "hello" && json["transport"].toString() == "udp") {
+        m_sessionId = json["session_id"].toString();
+        openAudioChannel(json["udp"].toObject());
+    } else if (type == "goodbye") {
+        const QString sessionId = json["session_id"].toString();
+        if (sessionId.isEmpty() || sessionId == m_sessionId) {
+            qDebug() << "Server closed UDP audio channel";
+            closeAudioChannel();
+        }
+    }
+
+    emit textReceived(QString::fromUtf8(payload));
+}
+
+void MqttUdpTransport::onUdpReadyRead()
+{
+    while (m_udp->hasPendingDatagrams()) {
+        const QByteArray packet = m_udp->receiveDatagram().data();
+
+        AudioFrame frame;
+        quint32 timestamp = 0;
+        quint32 sequence = 0;
+        if (!openPacket(m_aes, packet, frame.payload, timestamp, sequence)) {
+            m_udpStats.packetsMalformed++;
+            continue;
+        }
+
+        // 与服务端相同：序号回退的包直接丢弃，空洞交给抖动缓冲/丢包统计
+        if (m_haveRemoteSequence && static_cast<qint32>(sequence - m_remoteSequence) <= 0) {
+            m_udpStats.packetsOutOfOrder++;
+            continue;
+        }
+        m_remoteSequence = sequence;
+        m_haveRemoteSequence = true;
+
+        m_udpStats.packetsReceived++;
+        m_udpStats.bytesReceived += packet.size();
+
+        frame.sequence = sequence;
+        frame.timestamp = timestamp;
+        frame.hasSequence = true;
+        frame.hasTimestamp = true;
+        emit audioFrameReceived(frame);
+    }
+}
+
+bool MqttUdpTransport::openAudioChannel(const QJsonObject &udp)
+{
+    const QString server = udp["server"].toString();
+    const quint16 port = static_cast<quint16>(udp["port"].toInt());
+    const QByteArray key = QByteArray::fromHex(udp["key"].toString().toLatin1());
+    const QByteArray nonce = QByteArray::fromHex(udp["nonce"].toString().toLatin1());
+
+    if (server.isEmpty() || port == 0 || key.size() != static_cast<int>(AesCtr::kKeySize)
+        || nonce.size() != kNonceSize) {
+        qWarning() << "Invalid UDP parameters in hello:" << udp;
+        emit errorOccurred("Invalid UDP parameters from server");
+        return false;
+    }
+
+    closeAudioChannel();
+    m_aes.setKey(reinterpret_cast<const uint8_t *>(key.constData()));
+    m_nonceTemplate = nonce;
+    m_localSequence = 0;
+    m_remoteSequence = 0;
+    m_haveRemoteSequence = false;
+    m_udpStats = UdpAudioStats();
+
+    m_udp->connectToHost(server, port);
+    m_udpReady = true;
+    qDebug() << "UDP audio channel opened:" << server << port;
+    return true;
+}
+
+void MqttUdpTransport::closeAudioChannel()
+{
+    if (m_udp->state() != QAbstractSocket::UnconnectedState) {
+        m_udp->abort();
+    }
+    m_udpReady = false;
+}
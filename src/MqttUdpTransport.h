@@ -0,0 +1,96 @@
+#ifndef MQTTUDPTRANSPORT_H
+#define MQTTUDPTRANSPORT_H
+
+#include "ProtocolTransport.h"
+#include "AesCtr.h"
+#include <QJsonObject>
+
+class MqttClient;
+class QUdpSocket;
+
+// OTA返回的mqtt字段（保存在 SYSTEM_OPTIONS.NETWORK.MQTT_INFO）
+struct MqttTransportConfig {
+    QString endpoint;
+    QString clientId;
+    QString username;
+    QString password;
+    QString publishTopic;
+    QString subscribeTopic;
+
+    bool isValid() const { return !endpoint.isEmpty() && !clientId.isEmpty() && !publishTopic.isEmpty(); }
+    static MqttTransportConfig fromJson(const QJsonObject &mqttInfo);
+};
+
+// UDP音频通道统计
+struct UdpAudioStats {
+    quint64 packetsSent = 0;
+    quint64 bytesSent = 0;
+    quint64 packetsReceived = 0;
+    quint64 bytesReceived = 0;
+    quint64 packetsOutOfOrder = 0;  // 序号回退，按小智服务端规则丢弃
+    quint64 packetsMalformed = 0;   // 长度/类型不符
+};
+
+/**
+ * @brief MQTT控制通道 + UDP加密音频通道
+ *
+ * 流程与小智ESP32固件一致：
+ *  1. MQTT连接并订阅 subscribe_topic，JSON消息发布到 publish_topic；
+ *  2. 服务端hello回复携带 udp{server, port, key, nonce}，据此打开UDP音频通道；
+ *  3. 每个UDP包 = 16字节nonce明文头 + AES-128-CTR加密的Opus帧，
+ *     nonce布局 |type 1|flags 1|payload_len 2|ssrc 4|timestamp 4|sequence 4|（大端）；
+ *  4. 服务端goodbye关闭音频通道，下次listen前重新hello。
+ */
+class MqttUdpTransport : public ProtocolTransport
+{
+    Q_OBJECT
+
+public:
+    explicit MqttUdpTransport(const MqttTransportConfig &config, QObject *parent = nullptr);
+    ~MqttUdpTransport();
+
+    QString name() const override { return QStringLiteral("udp"); }
+
+    bool open() override;
+    void close() override;
+    bool isOpen() const override { return m_open; }
+    bool isAudioChannelOpen() const override { return m_udpReady; }
+
+    bool sendText(const QString &text) override;
+    bool sendAudio(const QByteArray &opusData, quint32 timestamp) override;
+    qint64 bytesToWrite() const override;
+
+    UdpAudioStats getUdpStats() const { return m_udpStats; }
+
+    // UDP包封装（本地UDP回显服务共用）
+    static const int kNonceSize = 16;
+    static QByteArray sealPacket(const AesCtr &aes, const QByteArray &nonceTemplate, const QByteArray &payload,
+                                 quint32 timestamp, quint32 sequence);
+    static bool openPacket(const AesCtr &aes, const QByteArray &packet, QByteArray &payload,
+                           quint32 &timestamp, quint32 &sequence);
+
+private slots:
+    void onMqttConnected();
+    void onMqttDisconnected();
+    void onMqttMessage(const QString &topic, const QByteArray &payload);
+    void onUdpReadyRead();
+
+private:
+    bool openAudioChannel(const QJsonObject &udp);
+    void closeAudioChannel();
+
+    MqttTransportConfig m_config;
+    MqttClient *m_mqtt;
+    QUdpSocket *m_udp;
+    AesCtr m_aes;
+    QByteArray m_nonceTemplate;
+    QString m_sessionId;
+    quint32 m_localSequence;
+    quint32 m_remoteSequence;
+    bool m_haveRemoteSequence;
+    bool m_open;
+    bool m_udpReady;
+    UdpAudioStats m_udpStats;
+};
+
+#endif // MQTTUDPTRANSPORT_H
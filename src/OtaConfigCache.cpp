@@ -0,0 +1,156 @@
+#include "OtaConfigCache.h"
+#include <QStandardPaths>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+
+namespace {
+constexpr int kCacheFormatVersion = 1;
+// 允许的时钟回拨，超过则认为时间戳不可信
+constexpr qint64 kMaxClockSkewMs = 24LL * 3600 * 1000;
+}
+
+OtaConfigCache::OtaConfigCache(const QString &path)
+    : m_path(path.isEmpty() ? defaultPath() : path)
+    , m_fetchedAtMs(0)
+    , m_valid(false)
+{
+}
+
+QString OtaConfigCache::defaultPath()
+{
+    QString configDir = QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation);
+    if (configDir.isEmpty()) {
+        configDir = QDir::homePath() + "/.config/Live2D桌宠";
+    }
+    QDir().mkpath(configDir);
+    return QDir(configDir).absoluteFilePath("ota_cache.json");
+}
+
+QByteArray OtaConfigCache::checksum(const QJsonObject &response)
+{
+    const QByteArray compact = QJsonDocument(response).toJson(QJsonDocument::Compact);
+    return QCryptographicHash::hash(compact, QCryptographicHash::Sha256).toHex();
+}
+
+bool OtaConfigCache::isUsableResponse(const QJsonObject &response)
+{
+    const QJsonObject websocket = response["websocket"].toObject();
+    return !websocket["url"].toString().isEmpty() || !response["mqtt"].toObject().isEmpty();
+}
+
+qint64 OtaConfigCache::ageSeconds() const
+{
+    if (!m_valid) {
+        return -1;
+    }
+    return qMax<qint64>(0, (QDateTime::currentMSecsSinceEpoch() - m_fetchedAtMs) / 1000);
+}
+
+bool OtaConfigCache::load()
+{
+    m_valid = false;
+    m_response = QJsonObject();
+    m_fetchedAtMs = 0;
+
+    QFile file(m_path);
+    if (!file.exists()) {
+        return false;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Cannot open OTA cache:" << m_path << file.errorString();
+        return false;
+    }
+    const QByteArray data = file.readAll();
+    file.close();
+
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(data, &error);
+    if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+        quarantine(QString("parse error: %1").arg(error.errorString()));
+        return false;
+    }
+
+    const QJsonObject root = doc.object();
+    if (root["version"].toInt() != kCacheFormatVersion) {
+        quarantine(QString("unsupported version %1").arg(root["version"].toInt()));
+        return false;
+    }
+
+    const QJsonObject response = root["response"].toObject();
+    if (root["sha256"].toString().toLatin1() != checksum(response)) {
+        quarantine("checksum mismatch");
+        return false;
+    }
+    if (!isUsableResponse(response)) {
+        quarantine("no connection info");
+        return false;
+    }
+
+    const qint64 fetchedAtMs = static_cast<qint64>(root["fetched_at"].toDouble());
+    if (fetchedAtMs <= 0 || fetchedAtMs > QDateTime::currentMSecsSinceEpoch() + kMaxClockSkewMs) {
+        quarantine("invalid timestamp");
+        return false;
+    }
+
+    m_response = response;
+    m_fetchedAtMs = fetchedAtMs;
+    m_valid = true;
+    qDebug() << "OTA cache loaded, age:" << ageSeconds() << "s";
+    return true;
+}
+
+bool OtaConfigCache::save(const QJsonObject &response)
+{
+    if (!isUsableResponse(response)) {
+        qWarning() << "Not caching OTA response without connection info";
+        return false;
+    }
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QJsonObject root;
+    root["version"] = kCacheFormatVersion;
+    root["fetched_at"] = static_cast<double>(now);
+    root["sha256"] = QString::fromLatin1(checksum(response));
+    root["response"] = response;
+
+    // QSaveFile先写临时文件再改名，中途崩溃不会留下半截缓存
+    QSaveFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot write OTA cache:" << m_path << file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    if (!file.commit()) {
+        qWarning() << "Failed to commit OTA cache:" << file.errorString();
+        return false;
+    }
+
+    m_response = response;
+    m_fetchedAtMs = now;
+    m_valid = true;
+    return true;
+}
+
+void OtaConfigCache::clear()
+{
+    QFile::remove(m_path);
+    m_valid = false;
+    m_response = QJsonObject();
+    m_fetchedAtMs = 0;
+}
+
+void OtaConfigCache::quarantine(const QString &reason)
+{
+    qWarning() << "OTA cache corrupt (" << reason << "), ignoring:" << m_path;
+    const QString corruptPath = m_path + ".corrupt";
+    QFile::remove(corruptPath);
+    if (!QFile::rename(m_path, corruptPath)) {
+        QFile::remove(m_path);
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef OTACONFIGCACHE_H
+#define OTACONFIGCACHE_H
+
+#include <QString>
+#include <QJsonObject>
+
+/**
+ * @brief 最近一次成功的OTA响应的本地缓存
+ *
+ * 保存WebSocket地址、token、MQTT信息和激活状态所在的完整OTA响应，
+ * 写入时附带获取时间和校验和。文件损坏（解析失败、版本不符、校验和不匹配、
+ * 缺少连接信息）时 load() 返回false，并把坏文件改名为 .corrupt 以便排查，
+ * 调用方按无缓存处理。
+ */
+class OtaConfigCache
+{
+public:
+    explicit OtaConfigCache(const QString &path = QString());
+
+    static QString defaultPath();
+
+    bool load();
+    bool save(const QJsonObject &response);
+    void clear();
+
+    bool isValid() const { return m_valid; }
+    QJsonObject response() const { return m_response; }
+    qint64 fetchedAtMs() const { return m_fetchedAtMs; }
+    qint64 ageSeconds() const;
+    QString path() const { return m_path; }
+
+    // 可用于连接的响应：至少包含websocket地址或mqtt信息
+    static bool isUsableResponse(const QJsonObject &response);
+
+private:
+    void quarantine(const QString &reason);
+    static QByteArray checksum(const QJsonObject &response);
+
+    QString m_path;
+    QJsonObject m_response;
+    qint64 m_fetchedAtMs;
+    bool m_valid;
+};
+
+#endif // OTACONFIGCACHE_H
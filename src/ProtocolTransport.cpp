@@ -0,0 +1,10 @@
+#include "ProtocolTransport.h"
+
+ProtocolTransport::ProtocolTransport(QObject *parent)
+    : QObject(parent)
+{
+}
+
+ProtocolTransport::~ProtocolTransport()
+{
+}
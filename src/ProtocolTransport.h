@@ -0,0 +1,49 @@
+#ifndef PROTOCOLTRANSPORT_H
+#define PROTOCOLTRANSPORT_H
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include "BinaryAudioProtocol.h"
+
+/**
+ * @brief 小智协议的可替换传输层
+ *
+ * WebSocketManager 对外接口不变，控制消息(JSON)和音频帧经由此接口收发。
+ * WebSocket 直连仍由 WebSocketManager 自身实现；其他传输（如MQTT控制 + UDP音频）
+ * 实现本接口，在hello/OTA阶段按配置选择。
+ */
+class ProtocolTransport : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ProtocolTransport(QObject *parent = nullptr);
+    virtual ~ProtocolTransport();
+
+    // hello消息中的transport字段
+    virtual QString name() const = 0;
+
+    virtual bool open() = 0;
+    virtual void close() = 0;
+    virtual bool isOpen() const = 0;
+
+    // 控制通道就绪后，音频通道可能还需要等待服务端hello
+    virtual bool isAudioChannelOpen() const = 0;
+
+    virtual bool sendText(const QString &text) = 0;
+    virtual bool sendAudio(const QByteArray &opusData, quint32 timestamp) = 0;
+
+    // 控制通道待发送字节数
+    virtual qint64 bytesToWrite() const { return 0; }
+
+signals:
+    void opened();
+    void closed();
+    void errorOccurred(const QString &error);
+    void textReceived(const QString &text);
+    void audioFrameReceived(const AudioFrame &frame);
+    void rttMeasured(double rttMs);  // 控制通道保活往返时延
+};
+
+#endif // PROTOCOLTRANSPORT_H
@@ -0,0 +1,319 @@
+#include "StartupPipeline.h"
+#include "TraceProfiler.h"
+#include <QThreadPool>
+#include <QRunnable>
+#include <QMetaObject>
+#include <QThread>
+#include <QJsonArray>
+#include <QDebug>
+#include <exception>
+
+namespace {
+
+QString affinityName(StartupPipeline::Affinity affinity)
+{
+    switch (affinity) {
+    case StartupPipeline::Affinity::MainThread:
+        return QStringLiteral("main");
+    case StartupPipeline::Affinity::Worker:
+        return QStringLiteral("worker");
+    case StartupPipeline::Affinity::Async:
+        return QStringLiteral("async");
+    }
+    return QString();
+}
+
+} // namespace
+
+StartupPipeline::StartupPipeline(QObject *parent)
+    : QObject(parent)
+    , m_pool(new QThreadPool(this))
+    , m_remaining(0)
+    , m_started(false)
+    , m_finished(false)
+{
+    m_pool->setObjectName("StartupPool");
+    m_pool->setMaxThreadCount(qMax(2, QThread::idealThreadCount() / 2));
+}
+
+StartupPipeline::~StartupPipeline()
+{
+    m_pool->waitForDone();
+}
+
+void StartupPipeline::addTask(const QString &name, const QStringList &dependencies, Affinity affinity, const SyncTask &task)
+{
+    Q_ASSERT(affinity != Affinity::Async);
+    Task entry;
+    entry.name = name;
+    entry.dependencies = dependencies;
+    entry.affinity = affinity;
+    entry.syncTask = task;
+    m_tasks.insert(name, entry);
+    m_order.append(name);
+}
+
+void StartupPipeline::addAsyncTask(const QString &name, const QStringList &dependencies, const AsyncTask &task)
+{
+    Task entry;
+    entry.name = name;
+    entry.dependencies = dependencies;
+    entry.affinity = Affinity::Async;
+    entry.asyncTask = task;
+    m_tasks.insert(name, entry);
+    m_order.append(name);
+}
+
+bool StartupPipeline::validate()
+{
+    for (const Task &task : std::as_const(m_tasks)) {
+        for (const QString &dependency : task.dependencies) {
+            if (!m_tasks.contains(dependency)) {
+                qCritical() << "Startup task" << task.name << "depends on unknown task" << dependency;
+                return false;
+            }
+        }
+    }
+
+    // 拓扑排序检查环
+    QHash<QString, int> indegree;
+    for (const Task &task : std::as_const(m_tasks)) {
+        indegree.insert(task.name, task.dependencies.size());
+    }
+    QStringList ready;
+    for (auto it = indegree.cbegin(); it != indegree.cend(); ++it) {
+        if (it.value() == 0) {
+            ready.append(it.key());
+        }
+    }
+    int visited = 0;
+    while (!ready.isEmpty()) {
+        const QString name = ready.takeLast();
+        visited++;
+        for (const Task &task : std::as_const(m_tasks)) {
+            if (task.dependencies.contains(name) && --indegree[task.name] == 0) {
+                ready.append(task.name);
+            }
+        }
+    }
+    if (visited != m_tasks.size()) {
+        qCritical() << "Startup task graph contains a dependency cycle";
+        return false;
+    }
+    return true;
+}
+
+void StartupPipeline::start()
+{
+    if (m_started) {
+        return;
+    }
+    m_started = true;
+    m_remaining = m_tasks.size();
+    m_clock.start();
+
+    if (!validate()) {
+        m_failedTask = QStringLiteral("<graph>");
+        QMetaObject::invokeMethod(this, [this]() { emit failed(m_failedTask); }, Qt::QueuedConnection);
+        return;
+    }
+    // 推迟到事件循环中调度，保证failed/finished发出时exec已经运行
+    QMetaObject::invokeMethod(this, [this]() { schedule(); }, Qt::QueuedConnection);
+}
+
+void StartupPipeline::schedule()
+{
+    if (!m_failedTask.isEmpty()) {
+        return;
+    }
+
+    for (const QString &name : std::as_const(m_order)) {
+        Task &task = m_tasks[name];
+        if (task.state != State::Pending) {
+            continue;
+        }
+        bool ready = true;
+        for (const QString &dependency : std::as_const(task.dependencies)) {
+            if (m_tasks.value(dependency).state != State::Done) {
+                ready = false;
+                break;
+            }
+        }
+        if (!ready) {
+            continue;
+        }
+
+        task.state = State::Running;
+        task.readyMs = m_clock.elapsed();
+
+        if (task.affinity == Affinity::Worker) {
+            const SyncTask work = task.syncTask;
+            const QElapsedTimer clock = m_clock;
+            m_pool->start(QRunnable::create([this, name, work, clock]() {
+                const qint64 startMs = clock.elapsed();
+                bool ok = false;
+                CF_TRACE_SCOPE_CAT(TraceProfiler::intern(name), "startup");
+                try {
+                    ok = work();
+                } catch (const std::exception &e) {
+                    qCritical() << "Startup task" << name << "threw:" << e.what();
+                }
+                QMetaObject::invokeMethod(this, [this, name, ok, startMs]() {
+                    m_tasks[name].startMs = startMs;
+                    completeTask(name, ok);
+                }, Qt::QueuedConnection);
+            }));
+        } else {
+            // 主线程任务逐个排队，中间让出事件循环处理网络回调和重绘
+            QMetaObject::invokeMethod(this, [this, name]() { runTask(name); }, Qt::QueuedConnection);
+        }
+    }
+}
+
+void StartupPipeline::runTask(const QString &name)
+{
+    if (!m_failedTask.isEmpty()) {
+        return;
+    }
+    Task &task = m_tasks[name];
+    task.startMs = m_clock.elapsed();
+
+    if (task.affinity == Affinity::Async) {
+        const AsyncTask work = task.asyncTask;
+        work([this, name](bool ok) {
+            // done可能在任意线程调用，统一回到本对象线程
+            QMetaObject::invokeMethod(this, [this, name, ok]() { completeTask(name, ok); }, Qt::QueuedConnection);
+        });
+        return;
+    }
+
+    bool ok = false;
+    CF_TRACE_SCOPE_CAT(TraceProfiler::intern(name), "startup");
+    try {
+        ok = task.syncTask();
+    } catch (const std::exception &e) {
+        qCritical() << "Startup task" << name << "threw:" << e.what();
+    }
+    completeTask(name, ok);
+}
+
+void StartupPipeline::completeTask(const QString &name, bool success)
+{
+    Task &task = m_tasks[name];
+    if (task.state != State::Running) {
+        // 重复的done调用
+        return;
+    }
+    task.endMs = m_clock.elapsed();
+    task.state = success ? State::Done : State::Failed;
+    m_remaining--;
+
+    const qint64 elapsed = task.endMs - task.startMs;
+#ifdef CF_TRACE
+    if (task.affinity == Affinity::Async) {
+        // 异步任务跨越多次事件循环，按发起到完成的时间补记一个事件
+        const int64_t endNs = TraceProfiler::nowNs();
+        TraceProfiler::instance().recordComplete(TraceProfiler::intern(name), "startup", endNs - elapsed * 1000000, endNs);
+    }
+#endif
+    qDebug() << "Startup task" << name << (success ? "done" : "FAILED") << "in" << elapsed << "ms";
+    emit taskFinished(name, success, elapsed);
+
+    if (!success) {
+        if (m_failedTask.isEmpty()) {
+            m_failedTask = name;
+            emit failed(name);
+        }
+        return;
+    }
+
+    if (m_remaining == 0) {
+        m_finished = true;
+        emit finished(m_clock.elapsed());
+        return;
+    }
+    schedule();
+}
+
+QJsonObject StartupPipeline::report() const
+{
+    QJsonArray tasks;
+    qint64 serialMs = 0;
+    qint64 totalMs = 0;
+    QString lastTask;
+    for (const QString &name : m_order) {
+        const Task &task = m_tasks[name];
+        if (task.startMs < 0) {
+            continue;
+        }
+        QJsonObject entry;
+        entry["name"] = name;
+        entry["affinity"] = affinityName(task.affinity);
+        entry["ready_ms"] = task.readyMs;
+        entry["start_ms"] = task.startMs;
+        entry["end_ms"] = task.endMs;
+        entry["wait_ms"] = task.startMs - task.readyMs;
+        entry["duration_ms"] = task.endMs >= 0 ? task.endMs - task.startMs : -1;
+        entry["status"] = task.state == State::Done ? "done" : task.state == State::Failed ? "failed" : "running";
+        tasks.append(entry);
+        if (task.endMs >= 0) {
+            serialMs += task.endMs - task.startMs;
+            if (task.endMs >= totalMs) {
+                totalMs = task.endMs;
+                lastTask = name;
+            }
+        }
+    }
+
+    // 关键路径：从最后完成的任务沿最晚完成的依赖回溯
+    QJsonArray criticalPath;
+    QString current = lastTask;
+    while (!current.isEmpty()) {
+        criticalPath.prepend(current);
+        QString next;
+        qint64 latest = -1;
+        for (const QString &dependency : m_tasks[current].dependencies) {
+            if (m_tasks[dependency].endMs > latest) {
+                latest = m_tasks[dependency].endMs;
+                next = dependency;
+            }
+        }
+        current = next;
+    }
+
+    QJsonObject result;
+    result["total_ms"] = totalMs;
+    result["serial_ms"] = serialMs;    // 各任务耗时之和，即完全串行时的下限
+    result["tasks"] = tasks;
+    result["critical_path"] = criticalPath;
+    if (!m_failedTask.isEmpty()) {
+        result["failed_task"] = m_failedTask;
+    }
+    return result;
+}
+
+QString StartupPipeline::reportTable() const
+{
+    const QJsonObject data = report();
+    QStringList lines;
+    lines << QString("%1 %2 %3 %4 %5")
+                 .arg("task", -16).arg("thread", -7).arg("start", 7).arg("wait", 6).arg("duration", 9);
+    for (const QJsonValue &value : data["tasks"].toArray()) {
+        const QJsonObject task = value.toObject();
+        lines << QString("%1 %2 %3 %4 %5")
+                     .arg(task["name"].toString(), -16)
+                     .arg(task["affinity"].toString(), -7)
+                     .arg(task["start_ms"].toInteger(), 7)
+                     .arg(task["wait_ms"].toInteger(), 6)
+                     .arg(task["duration_ms"].toInteger(), 9);
+    }
+    QStringList path;
+    for (const QJsonValue &value : data["critical_path"].toArray()) {
+        path << value.toString();
+    }
+    lines << QString("total %1 ms, serial sum %2 ms, critical path: %3")
+                 .arg(data["total_ms"].toInteger())
+                 .arg(data["serial_ms"].toInteger())
+                 .arg(path.join(" -> "));
+    return lines.join('\n');
+}
@@ -0,0 +1,96 @@
+#ifndef STARTUPPIPELINE_H
+#define STARTUPPIPELINE_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include <functional>
+
+class QThreadPool;
+
+/**
+ * @brief 启动任务图
+ *
+ * 每个任务声明依赖，依赖全部完成后立即调度：
+ * - MainThread：在主线程事件循环中执行（界面、GL、QObject单例）
+ * - Worker：在线程池中执行（文件读取、解析等纯计算）
+ * - Async：在主线程发起，由任务自己在网络回调等异步完成时调用done
+ *
+ * 任一任务失败时不再调度后续任务，发出failed；全部完成后发出finished。
+ * 每个任务记录排队、开始、结束时间，report() 输出分阶段耗时。
+ */
+class StartupPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Affinity {
+        MainThread,
+        Worker,
+        Async
+    };
+
+    using SyncTask = std::function<bool()>;
+    using AsyncTask = std::function<void(const std::function<void(bool)> &done)>;
+
+    explicit StartupPipeline(QObject *parent = nullptr);
+    ~StartupPipeline();
+
+    void addTask(const QString &name, const QStringList &dependencies, Affinity affinity, const SyncTask &task);
+    void addAsyncTask(const QString &name, const QStringList &dependencies, const AsyncTask &task);
+
+    // 在事件循环中开始调度，需在QApplication::exec之前调用
+    void start();
+
+    bool isFinished() const { return m_finished; }
+    QString failedTask() const { return m_failedTask; }
+
+    // 分阶段耗时（ms，相对start），未运行的任务不出现在结果中
+    QJsonObject report() const;
+    QString reportTable() const;
+
+signals:
+    void taskFinished(const QString &name, bool success, qint64 elapsedMs);
+    void finished(qint64 totalMs);
+    void failed(const QString &taskName);
+
+private:
+    enum class State {
+        Pending,
+        Running,
+        Done,
+        Failed
+    };
+
+    struct Task {
+        QString name;
+        QStringList dependencies;
+        Affinity affinity = Affinity::MainThread;
+        SyncTask syncTask;
+        AsyncTask asyncTask;
+        State state = State::Pending;
+        qint64 readyMs = -1;   // 依赖全部满足
+        qint64 startMs = -1;   // 实际开始执行
+        qint64 endMs = -1;
+    };
+
+    void schedule();
+    void runTask(const QString &name);
+    void completeTask(const QString &name, bool success);
+    bool validate();
+
+    QVector<QString> m_order;          // 注册顺序，决定同批次调度顺序
+    QHash<QString, Task> m_tasks;
+    QThreadPool *m_pool;
+    QElapsedTimer m_clock;
+    int m_remaining;
+    bool m_started;
+    bool m_finished;
+    QString m_failedTask;
+};
+
+#endif // STARTUPPIPELINE_H
@@ -5,12 +5,15 @@
 #include <QFile>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QJsonParseError>
 #include <QNetworkRequest>
 #include <QNetworkReply>
 #include <QTimer>
+#include <QEventLoop>
 #include <QDebug>
 #include <QUuid>
 #include <QSysInfo>
+#include <climits>
 
 SystemInitializer::SystemInitializer(QObject *parent)
     : QObject(parent)
@@ -19,6 +22,10 @@ SystemInitializer::SystemInitializer(QObject *parent)
     , m_currentReply(nullptr)
     , m_otaTimeoutTimer(nullptr)
     , m_currentStage(DEVICE_FINGERPRINT)
+    , m_running(false)
+    , m_revalidating(false)
+    , m_cacheTtlSec(0)
+    , m_cacheMaxStaleSec(0)
 {
     // 初始化网络管理器
     m_networkManager = new QNetworkAccessManager(this);
@@ -43,6 +50,14 @@ SystemInitializer::SystemInitializer(QObject *parent)
     m_deviceId = m_configManager->getConfig("SYSTEM_OPTIONS.DEVICE_ID").toString();
     m_otaUrl = m_configManager->getConfig("SYSTEM_OPTIONS.NETWORK.OTA_VERSION_URL").toString();
     m_activationUrl = m_configManager->getConfig("SYSTEM_OPTIONS.NETWORK.AUTHORIZATION_URL").toString();
+    m_cacheTtlSec = m_configManager->getConfig("SYSTEM_OPTIONS.NETWORK.OTA_CACHE_TTL").toInt();
+    if (m_cacheTtlSec <= 0) {
+        m_cacheTtlSec = 6 * 3600;
+    }
+    m_cacheMaxStaleSec = m_configManager->getConfig("SYSTEM_OPTIONS.NETWORK.OTA_CACHE_MAX_STALE").toInt();
+    if (m_cacheMaxStaleSec <= 0) {
+        m_cacheMaxStaleSec = 7 * 24 * 3600;
+    }
     
     // 初始化激活状态
     m_activationStatus["local_activated"] = m_deviceFingerprint->isActivated();
@@ -63,7 +78,70 @@ SystemInitializer::~SystemInitializer()
 
 QJsonObject SystemInitializer::runInitialization()
 {
+    QJsonObject result;
+    QEventLoop loop;
+    connect(this, &SystemInitializer::initializationFinished, &loop, [&result, &loop](const QJsonObject &finished) {
+        result = finished;
+        loop.quit();
+    });
+    startInitialization();
+    if (m_running) {
+        loop.exec();
+    }
+    return result;
+}
+
+void SystemInitializer::startInitialization()
+{
+    if (m_running) {
+        qWarning() << "System initialization already running";
+        return;
+    }
     qDebug() << "Starting system initialization...";
+    m_running = true;
+    
+    QJsonObject result;
+    result["success"] = false;
+    result["need_activation_ui"] = false;
+    result["status_message"] = "";
+    
+    // 阶段1：设备指纹
+    emit initializationProgress(1, "初始化设备指纹...");
+    if (!stage1DeviceFingerprint()) {
+        result["error"] = "设备指纹初始化失败";
+        m_running = false;
+        emit initializationCompleted(false, result["error"].toString());
+        emit initializationFinished(result);
+        return;
+    }
+    
+    // 阶段2：配置管理
+    emit initializationProgress(2, "初始化配置管理...");
+    if (!stage2ConfigManagement()) {
+        result["error"] = "配置管理初始化失败";
+        m_running = false;
+        emit initializationCompleted(false, result["error"].toString());
+        emit initializationFinished(result);
+        return;
+    }
+    
+    // 阶段3：OTA配置，缓存可用时立即完成，否则等请求结束（成功、失败或超时）后进入激活状态分析
+    emit initializationProgress(3, "获取服务器配置...");
+    if (startFromCache()) {
+        return;
+    }
+    if (!stage3OtaConfig()) {
+        qWarning() << "OTA配置获取失败，继续使用本地配置";
+        finishInitialization();
+    }
+}
+
+void SystemInitializer::finishInitialization()
+{
+    if (!m_running) {
+        return;
+    }
+    m_running = false;
     
     QJsonObject result;
     result["success"] = false;
@@ -72,27 +150,6 @@ QJsonObject SystemInitializer::runInitialization()
     result["error"] = "";
     
     try {
-        // 阶段1：设备指纹
-        emit initializationProgress(1, "初始化设备指纹...");
-        if (!stage1DeviceFingerprint()) {
-            result["error"] = "设备指纹初始化失败";
-            return result;
-        }
-        
-        // 阶段2：配置管理
-        emit initializationProgress(2, "初始化配置管理...");
-        if (!stage2ConfigManagement()) {
-            result["error"] = "配置管理初始化失败";
-            return result;
-        }
-        
-        // 阶段3：OTA配置
-        emit initializationProgress(3, "获取服务器配置...");
-        if (!stage3OtaConfig()) {
-            qWarning() << "OTA配置获取失败，继续使用本地配置";
-            // 不返回错误，继续执行激活状态分析
-        }
-        
         // 检查激活状态
         qDebug() << "Calling checkActivationStatus()...";
         checkActivationStatus();
@@ -121,7 +178,7 @@ QJsonObject SystemInitializer::runInitialization()
         emit initializationCompleted(false, result["error"].toString());
     }
     
-    return result;
+    emit initializationFinished(result);
 }
 
 bool SystemInitializer::stage1DeviceFingerprint()
@@ -180,26 +237,65 @@ bool SystemInitializer::stage3OtaConfig()
         return false;
     }
     
-    // 发送OTA配置请求
+    // 发送OTA配置请求，结果在onOtaConfigReplyFinished/onOtaConfigTimeout中处理
     sendOtaConfigRequest();
     
     // 启动超时定时器
     m_otaTimeoutTimer->start();
+    return true;
+}
+
+bool SystemInitializer::startFromCache()
+{
+    if (m_otaUrl.isEmpty() || !m_otaCache.load()) {
+        return false;
+    }
     
-    // 等待网络请求完成
-    QEventLoop loop;
-    connect(m_currentReply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    connect(m_otaTimeoutTimer, &QTimer::timeout, &loop, &QEventLoop::quit);
-    loop.exec();
-    
-    // 检查是否成功获取配置
-    if (m_currentReply && m_currentReply->error() == QNetworkReply::NoError) {
-        qDebug() << "OTA config request successful";
-        return true;
-    } else {
-        qWarning() << "OTA config request failed";
+    const QJsonObject cached = m_otaCache.response();
+    if (cached.contains("activation")) {
+        // 缓存时设备尚未激活，激活状态必须以服务器为准
+        qDebug() << "Cached OTA response requires activation, fetching from server";
+        return false;
+    }
+    
+    const qint64 age = m_otaCache.ageSeconds();
+    if (age >= m_cacheMaxStaleSec) {
+        qDebug() << "OTA cache too old (" << age << "s), fetching from server";
         return false;
     }
+    
+    qDebug() << "Using cached OTA config, age:" << age << "s, ttl:" << m_cacheTtlSec << "s";
+    applyOtaResponse(cached);
+    finishInitialization();
+    
+    if (age >= m_cacheTtlSec) {
+        startRevalidation();
+    } else {
+        // 长时间运行时到期再刷新
+        QTimer::singleShot(static_cast<int>(qMin<qint64>((m_cacheTtlSec - age) * 1000LL, INT_MAX)),
+                           this, &SystemInitializer::startRevalidation);
+    }
+    return true;
+}
+
+void SystemInitializer::startRevalidation()
+{
+    if (m_revalidating || m_running || m_otaUrl.isEmpty()) {
+        return;
+    }
+    qDebug() << "Revalidating OTA config in background";
+    m_revalidating = true;
+    sendOtaConfigRequest();
+    m_otaTimeoutTimer->start();
+}
+
+QJsonObject SystemInitializer::currentCredentials() const
+{
+    QJsonObject credentials;
+    credentials["url"] = m_configManager->getConfig("SYSTEM_OPTIONS.NETWORK.WEBSOCKET_URL").toString();
+    credentials["token"] = m_configManager->getConfig("SYSTEM_OPTIONS.NETWORK.WEBSOCKET_ACCESS_TOKEN").toString();
+    credentials["mqtt"] = QJsonObject::fromVariantMap(m_configManager->getConfig("SYSTEM_OPTIONS.NETWORK.MQTT_INFO").toMap());
+    return credentials;
 }
 
 void SystemInitializer::checkActivationStatus()
@@ -429,74 +525,110 @@ void SystemInitializer::onOtaConfigReplyFinished()
     
     m_otaTimeoutTimer->stop();
     
+    QJsonObject response;
+    bool fetched = false;
     if (m_currentReply->error() == QNetworkReply::NoError) {
-        QByteArray responseData = m_currentReply->readAll();
-        QJsonDocument doc = QJsonDocument::fromJson(responseData);
-        QJsonObject response = doc.object();
-        
-        qDebug() << "OTA config response received:" << response;
-        
-        // 处理服务器响应，更新配置
-        bool configUpdated = false;
-        
-        // 使用ConfigManager更新WebSocket配置
-        if (response.contains("websocket")) {
-            QJsonObject websocket = response["websocket"].toObject();
-            if (websocket.contains("url")) {
-                QString websocketUrl = websocket["url"].toString();
-                m_configManager->updateConfig("SYSTEM_OPTIONS.NETWORK.WEBSOCKET_URL", websocketUrl);
-                qDebug() << "WebSocket URL updated:" << websocketUrl;
-                configUpdated = true;
-            }
-            if (websocket.contains("token")) {
-                QString websocketToken = websocket["token"].toString();
-                m_configManager->updateConfig("SYSTEM_OPTIONS.NETWORK.WEBSOCKET_ACCESS_TOKEN", websocketToken);
-                qDebug() << "WebSocket Token updated:" << websocketToken;
-                configUpdated = true;
-            }
-        }
-        
-        // 使用ConfigManager更新MQTT配置 - 完全参照py-xiaozhi的MQTT配置结构
-        if (response.contains("mqtt")) {
-            QJsonObject mqtt = response["mqtt"].toObject();
-            // 直接使用服务器返回的完整MQTT配置
-            m_configManager->updateConfig("SYSTEM_OPTIONS.NETWORK.MQTT_INFO", mqtt);
-            qDebug() << "MQTT config updated:" << mqtt;
-            configUpdated = true;
-        }
-        
-        // 检查激活信息
-        if (response.contains("activation")) {
-            qDebug() << "检测到激活信息，设备需要激活";
-            m_activationStatus["server_activated"] = false;
-            // 保存激活数据供后续使用
-            m_config["activation_data"] = response["activation"];
+        QJsonParseError parseError;
+        QJsonDocument doc = QJsonDocument::fromJson(m_currentReply->readAll(), &parseError);
+        if (parseError.error == QJsonParseError::NoError && doc.isObject()) {
+            response = doc.object();
+            fetched = true;
+            qDebug() << "OTA config response received:" << response;
         } else {
-            qDebug() << "未检测到激活信息，设备可能已激活";
-            m_activationStatus["server_activated"] = true;
-        }
-        
-        // 配置已通过ConfigManager自动保存
-        if (configUpdated) {
-            qDebug() << "Configuration updated via ConfigManager";
+            qWarning() << "OTA config response is not valid JSON:" << parseError.errorString();
         }
-        
     } else {
         qWarning() << "OTA config request error:" << m_currentReply->errorString();
     }
     
     m_currentReply->deleteLater();
     m_currentReply = nullptr;
+    
+    if (m_revalidating) {
+        m_revalidating = false;
+        if (!fetched) {
+            // 后台刷新失败不影响当前连接，继续使用缓存
+            qWarning() << "OTA revalidation failed, keeping cached config";
+            return;
+        }
+        const QJsonObject before = currentCredentials();
+        applyOtaResponse(response);
+        m_otaCache.save(response);
+        const bool changed = currentCredentials() != before;
+        qDebug() << "OTA revalidation finished, credentials changed:" << changed;
+        emit otaConfigRevalidated(changed);
+        return;
+    }
+    
+    if (fetched) {
+        applyOtaResponse(response);
+        m_otaCache.save(response);
+    } else if (m_otaCache.isValid() || m_otaCache.load()) {
+        // 服务器不可用时退回最近一次成功的配置（即使已过期）
+        qWarning() << "OTA fetch failed, falling back to cached config, age:" << m_otaCache.ageSeconds() << "s";
+        applyOtaResponse(m_otaCache.response());
+    }
+    
+    finishInitialization();
+}
+
+void SystemInitializer::applyOtaResponse(const QJsonObject &response)
+{
+    // 处理服务器响应，更新配置
+    bool configUpdated = false;
+    
+    // 使用ConfigManager更新WebSocket配置
+    if (response.contains("websocket")) {
+        QJsonObject websocket = response["websocket"].toObject();
+        if (websocket.contains("url")) {
+            QString websocketUrl = websocket["url"].toString();
+            m_configManager->updateConfig("SYSTEM_OPTIONS.NETWORK.WEBSOCKET_URL", websocketUrl);
+            qDebug() << "WebSocket URL updated:" << websocketUrl;
+            configUpdated = true;
+        }
+        if (websocket.contains("token")) {
+            QString websocketToken = websocket["token"].toString();
+            m_configManager->updateConfig("SYSTEM_OPTIONS.NETWORK.WEBSOCKET_ACCESS_TOKEN", websocketToken);
+            qDebug() << "WebSocket Token updated:" << websocketToken;
+            configUpdated = true;
+        }
+    }
+    
+    // 使用ConfigManager更新MQTT配置 - 完全参照py-xiaozhi的MQTT配置结构
+    if (response.contains("mqtt")) {
+        QJsonObject mqtt = response["mqtt"].toObject();
+        // 直接使用服务器返回的完整MQTT配置
+        m_configManager->updateConfig("SYSTEM_OPTIONS.NETWORK.MQTT_INFO", mqtt);
+        qDebug() << "MQTT config updated:" << mqtt;
+        configUpdated = true;
+    }
+    
+    // 检查激活信息
+    if (response.contains("activation")) {
+        qDebug() << "检测到激活信息，设备需要激活";
+        m_activationStatus["server_activated"] = false;
+        // 保存激活数据供后续使用
+        m_config["activation_data"] = response["activation"];
+    } else {
+        qDebug() << "未检测到激活信息，设备可能已激活";
+        m_activationStatus["server_activated"] = true;
+        m_config.remove("activation_data");
+    }
+    
+    // 配置已通过ConfigManager自动保存
+    if (configUpdated) {
+        qDebug() << "Configuration updated via ConfigManager";
+    }
 }
 
 void SystemInitializer::onOtaConfigTimeout()
 {
     qWarning() << "OTA config request timed out";
     if (m_currentReply) {
+        // abort会同步触发finished，由onOtaConfigReplyFinished释放reply并结束初始化
         m_currentReply->abort();
-        m_currentReply->deleteLater();
-        m_currentReply = nullptr;
     }
+    finishInitialization();
 }
 
 void SystemInitializer::loadConfig()
@@ -8,6 +8,7 @@
 #include <QTimer>
 #include "DeviceFingerprint.h"
 #include "ConfigManager.h"
+#include "OtaConfigCache.h"
 
 class SystemInitializer : public QObject
 {
@@ -25,9 +26,13 @@ public:
     explicit SystemInitializer(QObject *parent = nullptr);
     ~SystemInitializer();
 
-    // 运行完整的初始化流程
+    // 运行完整的初始化流程（阻塞直到OTA请求结束）
     QJsonObject runInitialization();
     
+    // 异步运行初始化流程，结束时发出initializationFinished
+    void startInitialization();
+    bool isRunning() const { return m_running; }
+    
     // 获取激活状态信息
     QJsonObject getActivationStatus() const { return m_activationStatus; }
     
@@ -44,6 +49,9 @@ signals:
     void initializationProgress(int stage, const QString& message);
     void initializationCompleted(bool success, const QString& message);
     void activationStatusChanged(const QJsonObject& status);
+    void initializationFinished(const QJsonObject& result);
+    // 后台重新验证OTA配置完成；credentialsChanged表示连接地址/token/MQTT信息有变化
+    void otaConfigRevalidated(bool credentialsChanged);
 
 private slots:
     void onOtaConfigReplyFinished();
@@ -54,6 +62,11 @@ private:
     bool stage1DeviceFingerprint();
     bool stage2ConfigManagement();
     bool stage3OtaConfig();
+    bool startFromCache();
+    void startRevalidation();
+    void finishInitialization();
+    void applyOtaResponse(const QJsonObject& response);
+    QJsonObject currentCredentials() const;
     
     // 激活状态检查
     void checkActivationStatus();
@@ -77,6 +90,13 @@ private:
     
     // 状态管理
     InitializationStage m_currentStage;
+    bool m_running;
+    
+    // OTA响应缓存：TTL内直接使用，过期但未超过最长陈旧时间时先用缓存再后台刷新
+    OtaConfigCache m_otaCache;
+    bool m_revalidating;
+    int m_cacheTtlSec;
+    int m_cacheMaxStaleSec;
     QJsonObject m_activationStatus;
     QJsonObject m_config;
     
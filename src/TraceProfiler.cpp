@@ -0,0 +1,202 @@
+#include "TraceProfiler.h"
+#include <QCoreApplication>
+#include <QSaveFile>
+#include <QByteArray>
+#include <QDebug>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct TraceEvent {
+    const char *name;
+    const char *category;
+    int64_t startNs;
+    int64_t durationNs;
+    char phase;     // 'X' 完整事件，'i' 瞬时事件
+};
+
+// 只由所属线程写入；head在事件写完后才递增，导出线程据此判断哪些槽位可读
+struct ThreadBuffer {
+    explicit ThreadBuffer(uint32_t id)
+        : tid(id)
+        , events(new TraceEvent[TraceProfiler::kBufferCapacity])
+    {
+    }
+
+    const uint32_t tid;
+    std::string name;   // 受registryMutex保护
+    std::atomic<uint64_t> head{0};
+    std::unique_ptr<TraceEvent[]> events;
+};
+
+// 线程退出后缓冲区仍由注册表持有，导出时不丢失已结束线程的事件
+std::mutex registryMutex;
+std::vector<std::shared_ptr<ThreadBuffer>> registry;
+thread_local std::shared_ptr<ThreadBuffer> localBuffer;
+
+ThreadBuffer *currentBuffer()
+{
+    if (!localBuffer) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        localBuffer = std::make_shared<ThreadBuffer>(static_cast<uint32_t>(registry.size() + 1));
+        registry.push_back(localBuffer);
+    }
+    return localBuffer.get();
+}
+
+void append(const TraceEvent &event)
+{
+    ThreadBuffer *buffer = currentBuffer();
+    const uint64_t index = buffer->head.load(std::memory_order_relaxed);
+    buffer->events[index % TraceProfiler::kBufferCapacity] = event;
+    buffer->head.store(index + 1, std::memory_order_release);
+}
+
+void appendEscaped(QByteArray &out, const char *text)
+{
+    for (const char *p = text; *p; ++p) {
+        const char c = *p;
+        if (c == '"' || c == '\\') {
+            out.append('\\');
+            out.append(c);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out.append(' ');
+        } else {
+            out.append(c);
+        }
+    }
+}
+
+QByteArray microseconds(int64_t ns)
+{
+    return QByteArray::number(static_cast<double>(ns) / 1000.0, 'f', 3);
+}
+
+} // namespace
+
+TraceProfiler &TraceProfiler::instance()
+{
+    static TraceProfiler profiler;
+    return profiler;
+}
+
+int64_t TraceProfiler::nowNs()
+{
+    using Clock = std::chrono::steady_clock;
+    static const Clock::time_point epoch = Clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch).count();
+}
+
+void TraceProfiler::recordComplete(const char *name, const char *category, int64_t startNs, int64_t endNs)
+{
+    if (!isEnabled()) {
+        return;
+    }
+    append(TraceEvent{name, category, startNs, endNs - startNs, 'X'});
+}
+
+void TraceProfiler::recordInstant(const char *name, const char *category)
+{
+    if (!isEnabled()) {
+        return;
+    }
+    append(TraceEvent{name, category, nowNs(), 0, 'i'});
+}
+
+void TraceProfiler::setThreadName(const char *name)
+{
+    ThreadBuffer *buffer = currentBuffer();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    buffer->name = name;
+}
+
+const char *TraceProfiler::intern(const QString &name)
+{
+    static std::mutex internMutex;
+    static std::set<std::string> strings;
+    std::lock_guard<std::mutex> lock(internMutex);
+    return strings.insert(name.toStdString()).first->c_str();
+}
+
+bool TraceProfiler::writeChromeTrace(const QString &path) const
+{
+    const QString target = path.isEmpty() ? m_outputPath : path;
+    if (target.isEmpty()) {
+        qWarning() << "No trace output path configured";
+        return false;
+    }
+
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffers = registry;
+    }
+
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    QByteArray out;
+    out.reserve(1024 * 1024);
+    out.append("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    out.append("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":0,\"args\":{\"name\":\"HeartMindRobot\"}}");
+
+    std::vector<TraceEvent> snapshot;
+    snapshot.reserve(kBufferCapacity);
+    int eventCount = 0;
+    for (const auto &buffer : buffers) {
+        const QByteArray tid = QByteArray::number(buffer->tid);
+        std::string threadName;
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            threadName = buffer->name;
+        }
+        if (!threadName.empty()) {
+            out.append(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":" + tid + ",\"args\":{\"name\":\"");
+            appendEscaped(out, threadName.c_str());
+            out.append("\"}}");
+        }
+
+        // 先复制再检查head：复制期间被写线程覆盖的槽位（含正在写的下一个槽位）全部丢弃
+        const uint64_t head = buffer->head.load(std::memory_order_acquire);
+        const uint64_t first = head > static_cast<uint64_t>(kBufferCapacity) ? head - kBufferCapacity : 0;
+        snapshot.clear();
+        for (uint64_t i = first; i < head; ++i) {
+            snapshot.push_back(buffer->events[i % kBufferCapacity]);
+        }
+        const uint64_t headAfter = buffer->head.load(std::memory_order_acquire);
+        const uint64_t firstValid = headAfter >= static_cast<uint64_t>(kBufferCapacity) ? headAfter - kBufferCapacity + 1 : 0;
+
+        for (uint64_t i = first; i < head; ++i) {
+            if (i < firstValid) {
+                continue;
+            }
+            const TraceEvent &event = snapshot[i - first];
+            out.append(",\n{\"name\":\"");
+            appendEscaped(out, event.name);
+            out.append("\",\"cat\":\"");
+            appendEscaped(out, event.category);
+            out.append("\",\"ph\":\"");
+            out.append(event.phase);
+            out.append("\",\"ts\":" + microseconds(event.startNs));
+            if (event.phase == 'X') {
+                out.append(",\"dur\":" + microseconds(event.durationNs));
+            } else {
+                out.append(",\"s\":\"t\"");
+            }
+            out.append(",\"pid\":" + pid + ",\"tid\":" + tid + "}");
+            eventCount++;
+        }
+    }
+    out.append("\n]}\n");
+
+    QSaveFile file(target);
+    if (!file.open(QIODevice::WriteOnly) || file.write(out) != out.size() || !file.commit()) {
+        qWarning() << "Failed to write trace file:" << target;
+        return false;
+    }
+    qDebug() << "Trace written to" << target << "(" << eventCount << "events," << buffers.size() << "threads)";
+    return true;
+}
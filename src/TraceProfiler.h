@@ -0,0 +1,99 @@
+#ifndef TRACEPROFILER_H
+#define TRACEPROFILER_H
+
+#include <QString>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief 轻量级的作用域耗时跟踪，导出为Chrome trace-event JSON
+ *
+ * 每个线程首次记录时分配一个固定大小的环形缓冲区，记录只写本线程的缓冲区，
+ * 热路径上没有锁；缓冲区写满后覆盖最旧的事件。导出时读取所有线程的缓冲区，
+ * 生成的文件可以在 chrome://tracing 或 Perfetto 中打开。
+ *
+ * 运行时默认关闭（只有一次原子读取的开销）；未定义 CF_TRACE 时下面的宏展开为空，
+ * 跟踪代码整体从编译结果中移除。
+ *
+ * 事件名和分类只保存指针，必须是字符串字面量等生命周期覆盖整个进程的字符串。
+ */
+class TraceProfiler
+{
+public:
+    static constexpr int kBufferCapacity = 16384;   // 每线程保留的最近事件数
+
+    static TraceProfiler &instance();
+
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // 退出时和手动导出时写入的文件
+    void setOutputPath(const QString &path) { m_outputPath = path; }
+    QString outputPath() const { return m_outputPath; }
+
+    // 相对进程内首次调用的单调时间
+    static int64_t nowNs();
+
+    void recordComplete(const char *name, const char *category, int64_t startNs, int64_t endNs);
+    void recordInstant(const char *name, const char *category);
+    void setThreadName(const char *name);
+
+    // 运行时拼出的事件名（如启动任务名）复制一份常驻内存，返回可长期保存的指针
+    static const char *intern(const QString &name);
+
+    // 导出所有线程缓冲区中的事件；path为空时写入outputPath
+    bool writeChromeTrace(const QString &path = QString()) const;
+
+private:
+    TraceProfiler() = default;
+    TraceProfiler(const TraceProfiler &) = delete;
+    TraceProfiler &operator=(const TraceProfiler &) = delete;
+
+    std::atomic_bool m_enabled{false};
+    QString m_outputPath;
+};
+
+/**
+ * @brief 构造时记下开始时间，析构时记录一个完整事件
+ */
+class TraceScope
+{
+public:
+    TraceScope(const char *name, const char *category)
+        : m_name(name)
+        , m_category(category)
+        , m_startNs(TraceProfiler::instance().isEnabled() ? TraceProfiler::nowNs() : -1)
+    {
+    }
+
+    ~TraceScope()
+    {
+        if (m_startNs >= 0) {
+            TraceProfiler::instance().recordComplete(m_name, m_category, m_startNs, TraceProfiler::nowNs());
+        }
+    }
+
+private:
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+    const char *m_name;
+    const char *m_category;
+    int64_t m_startNs;
+};
+
+#ifdef CF_TRACE
+#define CF_TRACE_CONCAT_INNER(a, b) a##b
+#define CF_TRACE_CONCAT(a, b) CF_TRACE_CONCAT_INNER(a, b)
+#define CF_TRACE_SCOPE_CAT(name, category) TraceScope CF_TRACE_CONCAT(cfTraceScope_, __LINE__)(name, category)
+#define CF_TRACE_SCOPE(name) CF_TRACE_SCOPE_CAT(name, "app")
+#define CF_TRACE_INSTANT(name) TraceProfiler::instance().recordInstant(name, "app")
+#define CF_TRACE_THREAD_NAME(name) TraceProfiler::instance().setThreadName(name)
+#else
+#define CF_TRACE_SCOPE_CAT(name, category)
+#define CF_TRACE_SCOPE(name)
+#define CF_TRACE_INSTANT(name)
+#define CF_TRACE_THREAD_NAME(name)
+#endif
+
+#endif // TRACEPROFILER_H
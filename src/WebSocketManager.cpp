@@ -1,4 +1,6 @@
 #include "WebSocketManager.h"
+#include "MqttUdpTransport.h"
+#include "TraceProfiler.h"
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -7,6 +9,23 @@
 #include <QDebug>
 #include <QThread>
 #include <QMutexLocker>
+#include <QMetaEnum>
+#include <cmath>
+#include <algorithm>
+
+namespace {
+// 客户端WebSocket帧在线路上的字节数（帧头 + 4字节掩码 + 载荷）
+qint64 webSocketWireSize(qint64 payloadSize)
+{
+    qint64 header = 2 + 4;
+    if (payloadSize > 0xFFFF) {
+        header += 8;
+    } else if (payloadSize >= 126) {
+        header += 2;
+    }
+    return header + payloadSize;
+}
+}
 
 WebSocketManager::WebSocketManager(QObject *parent)
     : QObject(parent)
@@ -23,13 +42,35 @@ WebSocketManager::WebSocketManager(QObject *parent)
     , m_maxReconnectAttempts(999) // 几乎无限重连
     , m_currentState(DeviceState::DISCONNECTED)
     , m_protocolVersion("1")
+    , m_negotiatedVersion(1)
+    , m_rawFallback(false)
+    , m_txSequence(0)
+    , m_serverFrameDurationMs(60)
+    , m_haveRxSequence(false)
+    , m_rxSequenceValid(true)
+    , m_lastRxSequence(0)
+    , m_lastRxTimestamp(0)
+    , m_lastArrivalMs(-1)
+    , m_minTransitMs(0)
+    , m_haveTransit(false)
+    , m_transportType(TransportType::WebSocket)
+    , m_transport(nullptr)
+    , m_telemetry(new ConnectionTelemetry(this))
+    , m_mcpRuntime(new McpToolRuntime(&m_mcpRegistry, this))
 {
+    qRegisterMetaType<AudioFrame>("AudioFrame");
+    m_monotonicClock.start();
+    m_sessionClock.start();
+    connect(m_mcpRuntime, &McpToolRuntime::responseReady, this, &WebSocketManager::sendMcpResponse);
     initializeWebSocket();
 }
 
 WebSocketManager::~WebSocketManager()
 {
     disconnectFromServer();
+    // 先等工具调用结束，注册表随成员析构
+    delete m_mcpRuntime;
+    m_mcpRuntime = nullptr;
     if (m_webSocket) {
         m_webSocket->deleteLater();
     }
@@ -60,6 +101,9 @@ void WebSocketManager::initializeWebSocket()
     connect(m_webSocket, &QWebSocket::errorOccurred, 
             this, &WebSocketManager::onError);
     connect(m_webSocket, &QWebSocket::pong, this, &WebSocketManager::onPongReceived);
+    connect(m_webSocket, &QWebSocket::bytesWritten, this, [this](qint64 bytes) {
+        m_telemetry->onBytesWritten(bytes);
+    });
     
     // 初始化心跳定时器
     m_heartbeatTimer = new QTimer(this);
@@ -77,6 +121,8 @@ void WebSocketManager::initializeWebSocket()
             
             // 立即停止心跳，避免在关闭过程中再次触发
             stopHeartbeat();
+            m_telemetry->recordHeartbeatTimeout();
+            m_disconnectCause = "heartbeat_timeout";
             
             emit connectionError("心跳超时，连接可能已断开");
             
@@ -106,6 +152,14 @@ bool WebSocketManager::connectToServer(const QString &url, const QString &access
     m_serverUrl = QUrl(url);
     m_accessToken = accessToken;
     
+    m_telemetry->onConnectAttempt();
+    
+    if (m_transportType != TransportType::WebSocket) {
+        ensureTransport();
+        qDebug() << "Connecting via" << m_transport->name() << "transport";
+        return m_transport->open();
+    }
+    
     if (!m_serverUrl.isValid()) {
         qCritical() << "Invalid server URL:" << url;
         emit connectionError("Invalid server URL");
@@ -131,27 +185,39 @@ void WebSocketManager::disconnectFromServer()
     
     // 先停止心跳，再关闭连接
     stopHeartbeat();
+    if (m_connected) {
+        m_disconnectCause = "client_close";
+    }
     m_connected = false;
     setCurrentState(DeviceState::DISCONNECTED);
+    if (m_mcpRuntime) {
+        m_mcpRuntime->cancelAll();
+    }
     
     if (m_webSocket && m_webSocket->state() == QAbstractSocket::ConnectedState) {
         m_webSocket->close();
     }
+    if (m_transport) {
+        m_transport->close();
+    }
 }
 
 bool WebSocketManager::isConnected() const
 {
+    if (usesTransport()) {
+        return m_connected && m_transport->isOpen();
+    }
     return m_connected && m_webSocket && m_webSocket->state() == QAbstractSocket::ConnectedState;
 }
 
 void WebSocketManager::sendHello()
 {
     QJsonObject helloData;
-    helloData["version"] = 1;
+    helloData["version"] = m_protocolVersion.toInt();
     helloData["features"] = QJsonObject{
         {"mcp", true}
     };
-    helloData["transport"] = "websocket";
+    helloData["transport"] = usesTransport() ? m_transport->name() : QStringLiteral("websocket");
     helloData["audio_params"] = QJsonObject{
         {"format", "opus"},
         {"sample_rate", 16000},
@@ -226,10 +292,40 @@ void WebSocketManager::sendWakeWordDetected(const QString &text)
     sendMessage(message);
 }
 
-void WebSocketManager::sendAudioData(const QByteArray &audioData)
+void WebSocketManager::sendAudioData(const QByteArray &audioData, qint64 captureTimestampMs)
 {
+    if (usesTransport()) {
+        // UDP包头自带序号和时间戳，与协议版本无关
+        const quint32 timestamp = static_cast<quint32>(captureTimestampMs >= 0 ? captureTimestampMs
+                                                                               : m_sessionClock.elapsed());
+        if (m_transport->sendAudio(audioData, timestamp)) {
+            m_audioStats.framesSent++;
+            // UDP不经过控制通道的写缓冲，不计入积压
+            m_telemetry->recordOutbound(audioData.size(), 0, true);
+        }
+        return;
+    }
+    
     if (m_webSocket && m_webSocket->state() == QAbstractSocket::ConnectedState) {
-        m_webSocket->sendBinaryMessage(audioData);
+        qint64 frameSize = audioData.size();
+        if (m_negotiatedVersion == 1) {
+            m_webSocket->sendBinaryMessage(audioData);
+        } else {
+            // 未指定采集时间时使用会话内的相对时间
+            const quint32 timestamp = static_cast<quint32>(captureTimestampMs >= 0 ? captureTimestampMs
+                                                                                   : m_sessionClock.elapsed());
+            const QByteArray frame = BinaryAudioProtocol::pack(m_negotiatedVersion, audioData, m_txSequence, timestamp);
+            if (frame.isEmpty()) {
+                // 负载超出协议头可表示的长度（v3最大0xFFFF字节），丢弃该帧且不占用序号
+                qWarning() << "音频帧过大，无法按协议版本" << m_negotiatedVersion << "打包，已丢弃:" << audioData.size() << "字节";
+                return;
+            }
+            m_txSequence++;
+            frameSize = frame.size();
+            m_webSocket->sendBinaryMessage(frame);
+        }
+        m_audioStats.framesSent++;
+        m_telemetry->recordOutbound(frameSize, webSocketWireSize(frameSize), true);
     }
 }
 
@@ -245,6 +341,7 @@ void WebSocketManager::setCurrentState(DeviceState state)
         QMutexLocker locker(&m_stateMutex);
         if (m_currentState == state) return;
         m_currentState = state;
+        m_telemetry->onStateChanged(state);
     }
     
     qDebug() << "Device state changed to:" << static_cast<int>(state);
@@ -266,6 +363,100 @@ void WebSocketManager::setAccessToken(const QString &token)
     m_accessToken = token;
 }
 
+void WebSocketManager::setProtocolVersion(int version)
+{
+    if (!BinaryAudioProtocol::isSupportedVersion(version)) {
+        qWarning() << "Unsupported binary protocol version:" << version << ", using 1";
+        version = 1;
+    }
+    m_protocolVersion = QString::number(version);
+}
+
+int WebSocketManager::getProtocolVersion() const
+{
+    return m_protocolVersion.toInt();
+}
+
+int WebSocketManager::getNegotiatedProtocolVersion() const
+{
+    return m_rawFallback ? 1 : m_negotiatedVersion;
+}
+
+void WebSocketManager::setTransportType(TransportType type)
+{
+    if (m_transportType == type) {
+        return;
+    }
+    if (m_connected) {
+        qWarning() << "Transport type change takes effect on next connection";
+    }
+    m_transportType = type;
+    if (m_transport && !m_connected) {
+        m_transport->deleteLater();
+        m_transport = nullptr;
+    }
+}
+
+TransportType WebSocketManager::getTransportType() const
+{
+    return m_transportType;
+}
+
+void WebSocketManager::setMqttConfig(const QJsonObject &mqttInfo)
+{
+    if (m_mqttInfo == mqttInfo) {
+        return;
+    }
+    m_mqttInfo = mqttInfo;
+    // 凭据变化后重建传输
+    if (m_transport && !m_connected) {
+        m_transport->deleteLater();
+        m_transport = nullptr;
+    }
+}
+
+bool WebSocketManager::usesTransport() const
+{
+    return m_transportType != TransportType::WebSocket && m_transport != nullptr;
+}
+
+void WebSocketManager::ensureTransport()
+{
+    if (m_transport) {
+        return;
+    }
+    
+    m_transport = new MqttUdpTransport(MqttTransportConfig::fromJson(m_mqttInfo), this);
+    connect(m_transport, &ProtocolTransport::opened, this, &WebSocketManager::onConnected);
+    connect(m_transport, &ProtocolTransport::closed, this, &WebSocketManager::onTransportClosed);
+    connect(m_transport, &ProtocolTransport::textReceived, this, &WebSocketManager::onTextMessageReceived);
+    connect(m_transport, &ProtocolTransport::audioFrameReceived, this, &WebSocketManager::onTransportAudioFrame);
+    connect(m_transport, &ProtocolTransport::errorOccurred, this, &WebSocketManager::onTransportError);
+    connect(m_transport, &ProtocolTransport::rttMeasured, m_telemetry, &ConnectionTelemetry::recordRtt);
+}
+
+ConnectionStats WebSocketManager::getConnectionStats() const
+{
+    return m_telemetry->snapshot();
+}
+
+void WebSocketManager::setTelemetryDumpFile(const QString &path, int intervalSec)
+{
+    m_telemetry->setDumpFile(path, intervalSec);
+}
+
+AudioStreamStats WebSocketManager::getAudioStreamStats() const
+{
+    return m_audioStats;
+}
+
+void WebSocketManager::resetAudioStreamStats()
+{
+    m_audioStats = AudioStreamStats();
+    m_lastArrivalMs = -1;
+    m_haveTransit = false;
+}
+
 void WebSocketManager::startHeartbeat()
 {
     if (m_heartbeatTimer) {
@@ -293,15 +484,34 @@ void WebSocketManager::onConnected()
     m_sessionId = generateSessionId();
     setCurrentState(DeviceState::CONNECTING);
     
+    // 新会话先按请求的版本收发，服务端hello可覆盖
+    m_negotiatedVersion = m_protocolVersion.toInt();
+    m_rawFallback = false;
+    m_txSequence = 0;
+    m_sessionClock.restart();
+    resetAudioReceiveState();
+    
     // 重置重连计数
     m_reconnectAttempts = 0;
     stopReconnect();
     
+    m_disconnectCause.clear();
+    if (usesTransport()) {
+        ProtocolTransport *transport = m_transport;
+        m_telemetry->setBacklogProvider([transport]() { return transport->bytesToWrite(); });
+        m_telemetry->onConnected(transport->name());
+    } else {
+        m_telemetry->setBacklogProvider(nullptr);
+        m_telemetry->onConnected(QStringLiteral("websocket"));
+    }
+    
     // 发送hello消息
     sendHello();
     
-    // 开始心跳
-    startHeartbeat();
+    // 开始心跳（MQTT由自身的PINGREQ保活）
+    if (!usesTransport()) {
+        startHeartbeat();
+    }
     
     emit connected();
 }
@@ -310,9 +520,16 @@ void WebSocketManager::onDisconnected()
 {
     qDebug() << "WebSocket disconnected";
     qDebug() << "Disconnect reason - State:" << m_webSocket->state() << "Error:" << m_webSocket->errorString();
+    if (m_disconnectCause.isEmpty()) {
+        m_disconnectCause = QString("server_close/%1").arg(static_cast<int>(m_webSocket->closeCode()));
+    }
+    m_telemetry->onDisconnected(m_disconnectCause);
+    m_disconnectCause.clear();
     m_connected = false;
     setCurrentState(DeviceState::DISCONNECTED);
     stopHeartbeat();
+    // 会话内的工具调用随连接失效
+    m_mcpRuntime->cancelAll();
     
     // 不自动重连，等待下次发送消息时再重连
     qDebug() << "Connection closed, will reconnect on next message";
@@ -320,8 +537,44 @@ void WebSocketManager::onDisconnected()
     emit disconnected();
 }
 
+void WebSocketManager::onTransportClosed()
+{
+    qDebug() << "Transport" << m_transport->name() << "closed";
+    m_telemetry->onDisconnected(m_disconnectCause.isEmpty() ? QStringLiteral("server_close") : m_disconnectCause);
+    m_disconnectCause.clear();
+    m_connected = false;
+    setCurrentState(DeviceState::DISCONNECTED);
+    m_mcpRuntime->cancelAll();
+    emit disconnected();
+}
+
+void WebSocketManager::onTransportAudioFrame(const AudioFrame &frame)
+{
+    CF_TRACE_SCOPE_CAT("WebSocketManager::onTransportAudioFrame", "net");
+    AudioFrame localFrame = frame;
+    localFrame.receivedAtMs = m_monotonicClock.elapsed();
+    
+    updateAudioStreamStats(localFrame);
+    m_telemetry->recordInbound(localFrame.payload.size(), true);
+    m_telemetry->recordAudioArrival(localFrame.receivedAtMs, m_audioStats.jitterMs,
+                                    getCurrentState() == DeviceState::SPEAKING);
+    
+    emit audioFrameReceived(localFrame);
+    emit audioDataReceived(localFrame.payload);
+}
+
+void WebSocketManager::onTransportError(const QString &error)
+{
+    if (m_connected) {
+        m_disconnectCause = "transport_error";
+    }
+    emit connectionError(error);
+}
+
 void WebSocketManager::onTextMessageReceived(const QString &message)
 {
+    CF_TRACE_SCOPE_CAT("WebSocketManager::onTextMessageReceived", "net");
+    m_telemetry->recordInbound(message.toUtf8().size(), false);
     qDebug() << "========================================";
     qDebug() << "=== Raw WebSocket Text Message ===";
     qDebug() << message;
@@ -331,6 +584,7 @@ void WebSocketManager::onTextMessageReceived(const QString &message)
 
 void WebSocketManager::onBinaryMessageReceived(const QByteArray &data)
 {
+    CF_TRACE_SCOPE_CAT("WebSocketManager::onBinaryMessageReceived", "net");
     qDebug() << "Received binary message, size:" << data.size();
     processIncomingBinary(data);
 }
@@ -341,6 +595,10 @@ void WebSocketManager::onError(QAbstractSocket::SocketError error)
     qCritical() << "WebSocket error:" << error << errorString;
     qCritical() << "Error details - Code:" << static_cast<int>(error) << "String:" << errorString;
     qCritical() << "Connection state:" << m_webSocket->state();
+    if (m_disconnectCause.isEmpty()) {
+        m_disconnectCause = QString("socket_error/%1")
+            .arg(QMetaEnum::fromType<QAbstractSocket::SocketError>().valueToKey(error));
+    }
     emit connectionError(QString("WebSocket error: %1").arg(errorString));
 }
 
@@ -349,6 +607,7 @@ void WebSocketManager::onHeartbeatTimeout()
     if (m_webSocket && m_webSocket->state() == QAbstractSocket::ConnectedState) {
         // 使用WebSocket协议层的ping（与py-xiaozhi一致）
         m_webSocket->ping();
+        m_telemetry->recordOutbound(0, webSocketWireSize(0), false);
         
         // 启动pong超时检测
         m_pongReceived = false;
@@ -365,6 +624,7 @@ void WebSocketManager::onPongReceived(quint64 elapsedTime, const QByteArray &pay
     // WebSocket协议层的pong响应
     m_pongReceived = true;
     m_pongTimer->stop();
+    m_telemetry->recordRtt(static_cast<double>(elapsedTime));
     qDebug() << "✓ WebSocket pong received, RTT:" << elapsedTime << "ms";
 }
 
@@ -409,6 +669,9 @@ void WebSocketManager::processIncomingMessage(const QString &message)
     case MessageType::PONG:
         handlePongMessage(wsMessage.data);
         break;
+    case MessageType::GOODBYE:
+        handleGoodbyeMessage(wsMessage.data);
+        break;
     default:
         qDebug() << "Unknown message type received";
         break;
@@ -417,8 +680,96 @@ void WebSocketManager::processIncomingMessage(const QString &message)
 
 void WebSocketManager::processIncomingBinary(const QByteArray &data)
 {
-    // 处理音频数据
-    emit audioDataReceived(data);
+    AudioFrame frame;
+    frame.receivedAtMs = m_monotonicClock.elapsed();
+    
+    const int version = m_rawFallback ? 1 : m_negotiatedVersion;
+    if (!BinaryAudioProtocol::unpack(version, data, frame)) {
+        // 头部与协商版本不符，说明服务端实际发送的是原始Opus
+        qWarning() << "Binary frame does not match protocol version" << version << ", falling back to raw mode";
+        m_rawFallback = true;
+        BinaryAudioProtocol::unpack(1, data, frame);
+    }
+    
+    if (frame.hasSequence) {
+        if (version == 3 && m_haveRxSequence) {
+            frame.sequence = BinaryAudioProtocol::extendSequence8(static_cast<quint8>(frame.sequence), m_lastRxSequence);
+        }
+        // TCP不会产生重复帧，序号不递增说明服务端没有填写序号
+        if (m_rxSequenceValid && m_haveRxSequence && frame.sequence == m_lastRxSequence) {
+            qDebug() << "Server does not fill audio sequence numbers, playing in arrival order";
+            m_rxSequenceValid = false;
+        }
+        frame.hasSequence = m_rxSequenceValid;
+    }
+    
+    updateAudioStreamStats(frame);
+    m_telemetry->recordInbound(data.size(), true);
+    m_telemetry->recordAudioArrival(frame.receivedAtMs, m_audioStats.jitterMs,
+                                    getCurrentState() == DeviceState::SPEAKING);
+    
+    emit audioFrameReceived(frame);
+    emit audioDataReceived(frame.payload);
+}
+
+void WebSocketManager::updateAudioStreamStats(const AudioFrame &frame)
+{
+    m_audioStats.framesReceived++;
+    m_audioStats.bytesReceived += frame.payload.size();
+    
+    if (frame.hasSequence) {
+        if (m_haveRxSequence) {
+            const qint32 diff = static_cast<qint32>(frame.sequence - m_lastRxSequence);
+            if (diff > 1) {
+                m_audioStats.framesLost += diff - 1;
+            } else if (diff <= 0) {
+                // 迟到的帧补上了之前记为丢失的空洞
+                m_audioStats.framesReordered++;
+                if (m_audioStats.framesLost > 0) {
+                    m_audioStats.framesLost--;
+                }
+            }
+            if (diff > 0) {
+                m_lastRxSequence = frame.sequence;
+            }
+        } else {
+            m_lastRxSequence = frame.sequence;
+        }
+    }
+    if (frame.hasSequence || m_rxSequenceValid) {
+        m_haveRxSequence = true;
+    }
+    
+    // RFC3550到达间隔抖动：J += (|D| - J) / 16
+    if (m_lastArrivalMs >= 0) {
+        const double expectedGap = frame.hasTimestamp
+            ? static_cast<double>(static_cast<qint32>(frame.timestamp - m_lastRxTimestamp))
+            : static_cast<double>(m_serverFrameDurationMs);
+        const double d = static_cast<double>(frame.receivedAtMs - m_lastArrivalMs) - expectedGap;
+        m_audioStats.jitterMs += (std::fabs(d) - m_audioStats.jitterMs) / 16.0;
+    }
+    m_lastArrivalMs = frame.receivedAtMs;
+    
+    // 端到端时延：两端时钟偏差未知，以观测到的最小传输时延为基准
+    if (frame.hasTimestamp) {
+        const qint64 transit = frame.receivedAtMs - static_cast<qint64>(frame.timestamp);
+        if (!m_haveTransit || transit < m_minTransitMs) {
+            m_minTransitMs = transit;
+            m_haveTransit = true;
+        }
+        m_audioStats.transitMs = static_cast<double>(transit - m_minTransitMs);
+        m_audioStats.maxTransitMs = std::max(m_audioStats.maxTransitMs, m_audioStats.transitMs);
+        m_lastRxTimestamp = frame.timestamp;
+    }
+}
+
+void WebSocketManager::resetAudioReceiveState()
+{
+    m_haveRxSequence = false;
+    m_rxSequenceValid = true;
+    m_lastRxSequence = 0;
+    m_lastRxTimestamp = 0;
+    resetAudioStreamStats();
 }
 
 WebSocketMessage WebSocketManager::parseMessage(const QJsonObject &json)
@@ -434,6 +785,7 @@ WebSocketMessage WebSocketManager::parseMessage(const QJsonObject &json)
     else if (typeStr == "mcp") message.type = MessageType::MCP;
     else if (typeStr == "ping") message.type = MessageType::PING;
     else if (typeStr == "pong") message.type = MessageType::PONG;
+    else if (typeStr == "goodbye") message.type = MessageType::GOODBYE;
     else {
         qWarning() << "Unknown message type:" << typeStr;
         message.type = MessageType::HELLO; // 默认
@@ -448,7 +800,16 @@ WebSocketMessage WebSocketManager::parseMessage(const QJsonObject &json)
 
 void WebSocketManager::sendMessage(const WebSocketMessage &message)
 {
-    if (!m_webSocket || m_webSocket->state() != QAbstractSocket::ConnectedState) {
+    if (usesTransport()) {
+        if (!m_transport->isOpen()) {
+            qWarning() << "Cannot send message:" << m_transport->name() << "transport not open";
+            return;
+        }
+        // 服务端goodbye后音频通道已关闭，开始新一轮对话前重新hello
+        if (message.type == MessageType::LISTEN && !m_transport->isAudioChannelOpen()) {
+            sendHello();
+        }
+    } else if (!m_webSocket || m_webSocket->state() != QAbstractSocket::ConnectedState) {
         qWarning() << "Cannot send message: WebSocket not connected";
         return;
     }
@@ -466,6 +827,7 @@ void WebSocketManager::sendMessage(const WebSocketMessage &message)
         case MessageType::MCP: return "mcp";
         case MessageType::PING: return "ping";
         case MessageType::PONG: return "pong";
+        case MessageType::GOODBYE: return "goodbye";
         default: return "hello";
         }
     }();
@@ -491,7 +853,14 @@ void WebSocketManager::sendMessage(const WebSocketMessage &message)
         qDebug() << "========================================";
     }
     
-    m_webSocket->sendTextMessage(jsonString);
+    const qint64 payloadSize = jsonString.toUtf8().size();
+    if (usesTransport()) {
+        m_transport->sendText(jsonString);
+        m_telemetry->recordOutbound(payloadSize, 0, false);
+    } else {
+        m_webSocket->sendTextMessage(jsonString);
+        m_telemetry->recordOutbound(payloadSize, webSocketWireSize(payloadSize), false);
+    }
 }
 
 void WebSocketManager::handleHelloResponse(const QJsonObject &data)
@@ -504,6 +873,19 @@ void WebSocketManager::handleHelloResponse(const QJsonObject &data)
         qDebug() << "Updated session_id from server:" << m_sessionId;
     }
     
+    // 服务端可在hello中指定实际使用的二进制协议版本
+    if (data.contains("version")) {
+        const int serverVersion = data["version"].toInt();
+        if (BinaryAudioProtocol::isSupportedVersion(serverVersion) && serverVersion != m_negotiatedVersion) {
+            qDebug() << "Server selected binary protocol version" << serverVersion;
+            m_negotiatedVersion = serverVersion;
+        }
+    }
+    const QJsonObject audioParams = data["audio_params"].toObject();
+    if (audioParams.contains("frame_duration")) {
+        m_serverFrameDurationMs = audioParams["frame_duration"].toInt(m_serverFrameDurationMs);
+    }
+    
     setCurrentState(DeviceState::IDLE);
 }
 
@@ -524,6 +906,8 @@ void WebSocketManager::handleTTSMessage(const QJsonObject &data)
     }
     
     if (state == "start") {
+        // 每段TTS单独统计，避免句间停顿计入抖动
+        resetAudioStreamStats();
         setCurrentState(DeviceState::SPEAKING);
         return;  // start状态不发送文本消息
     } else if (state == "stop") {
@@ -606,8 +990,6 @@ void WebSocketManager::handlePongMessage(const QJsonObject &data)
 void WebSocketManager::handleMCPMessage(const QJsonObject &data)
 {
     // MCP (Model Context Protocol) 消息处理
-    qDebug() << "Received MCP message";
-    
     if (!data.contains("payload")) {
         qWarning() << "MCP message missing payload";
         return;
@@ -615,59 +997,34 @@ void WebSocketManager::handleMCPMessage(const QJsonObject &data)
     
     QJsonObject payload = data["payload"].toObject();
     QString method = payload["method"].toString();
-    int id = payload["id"].toInt();
+    QJsonValue id = payload["id"];
+    QJsonObject params = payload["params"].toObject();
     
     qDebug() << "MCP method:" << method << "id:" << id;
     
     // 处理不同的MCP方法
     if (method == "initialize") {
-        // 初始化响应
         QJsonObject result;
         result["protocolVersion"] = "2024-11-05";
-        result["capabilities"] = QJsonObject();
+        result["capabilities"] = QJsonObject{{"tools", QJsonObject()}};
         result["serverInfo"] = QJsonObject{
             {"name", "heart-mind-robot"},
             {"version", "1.0.0"}
         };
-        
-        QJsonObject response;
-        response["jsonrpc"] = "2.0";
-        response["id"] = id;
-        response["result"] = result;
-        
-        QJsonObject mcpResponse;
-        mcpResponse["payload"] = response;
-        
-        WebSocketMessage message;
-        message.type = MessageType::MCP;
-        message.data = mcpResponse;
-        message.sessionId = m_sessionId;
-        message.timestamp = "";  // MCP消息不需要timestamp
-        
-        sendMessage(message);
-        qDebug() << "Sent MCP initialize response";
+        sendMcpResponse(McpToolRuntime::makeResult(id, result));
     }
     else if (method == "tools/list") {
-        // 工具列表响应（返回空列表）
         QJsonObject result;
-        result["tools"] = QJsonArray();
-        
-        QJsonObject response;
-        response["jsonrpc"] = "2.0";
-        response["id"] = id;
-        response["result"] = result;
-        
-        QJsonObject mcpResponse;
-        mcpResponse["payload"] = response;
-        
-        WebSocketMessage message;
-        message.type = MessageType::MCP;
-        message.data = mcpResponse;
-        message.sessionId = m_sessionId;
-        message.timestamp = "";  // MCP消息不需要timestamp
-        
-        sendMessage(message);
-        qDebug() << "Sent MCP tools/list response (empty)";
+        result["tools"] = m_mcpRegistry.toolsListJson();
+        sendMcpResponse(McpToolRuntime::makeResult(id, result));
+        qDebug() << "Sent MCP tools/list response," << result["tools"].toArray().size() << "tools";
+    }
+    else if (method == "tools/call") {
+        // 工具在线程池中执行，不阻塞本线程上的音频收发
+        m_mcpRuntime->call(id, params["name"].toString(), params["arguments"].toObject());
+    }
+    else if (method == "notifications/cancelled") {
+        m_mcpRuntime->cancel(params["requestId"]);
     }
     else if (method.startsWith("notifications/")) {
         // 通知类消息，不需要响应
@@ -675,9 +1032,34 @@ void WebSocketManager::handleMCPMessage(const QJsonObject &data)
     }
     else {
         qWarning() << "Unknown MCP method:" << method;
+        if (!id.isUndefined() && !id.isNull()) {
+            sendMcpResponse(McpToolRuntime::makeError(id, -32601, QString("Method not found: %1").arg(method)));
+        }
     }
 }
 
+void WebSocketManager::sendMcpResponse(const QJsonObject &response)
+{
+    QJsonObject mcpResponse;
+    mcpResponse["payload"] = response;
+    
+    WebSocketMessage message;
+    message.type = MessageType::MCP;
+    message.data = mcpResponse;
+    message.sessionId = m_sessionId;
+    message.timestamp = "";  // MCP消息不需要timestamp
+    
+    sendMessage(message);
+}
+
+void WebSocketManager::handleGoodbyeMessage(const QJsonObject &data)
+{
+    Q_UNUSED(data)
+    // 音频通道由传输层关闭，控制通道保持连接
+    qDebug() << "Server ended audio session (goodbye)";
+    setCurrentState(DeviceState::IDLE);
+}
+
 QString WebSocketManager::generateSessionId()
 {
     return QUuid::createUuid().toString(QUuid::WithoutBraces);
@@ -701,6 +1083,7 @@ void WebSocketManager::attemptReconnect()
     }
     
     m_reconnectAttempts++;
+    m_telemetry->onConnectAttempt();
     qDebug() << "Attempting to reconnect... (attempt" << m_reconnectAttempts << ")";
     
     // 重新连接，使用完整的连接流程（包括设置请求头）
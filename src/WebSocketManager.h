@@ -13,6 +13,11 @@
 #include <QThread>
 #include <QMutex>
 #include <QQueue>
+#include <QElapsedTimer>
+#include "BinaryAudioProtocol.h"
+#include "ProtocolTransport.h"
+#include "ConnectionTelemetry.h"
+#include "McpToolRuntime.h"
 
 // 设备状态枚举
 enum class DeviceState {
@@ -34,7 +39,14 @@ enum class MessageType {
     IOT,
     MCP,      // Model Context Protocol
     PING,
-    PONG
+    PONG,
+    GOODBYE   // 服务端结束UDP音频会话（MQTT传输）
+};
+
+// 传输方式
+enum class TransportType {
+    WebSocket,  // 控制消息和音频都走WebSocket
+    MqttUdp     // MQTT控制通道 + AES-CTR加密的UDP音频
 };
 
 // 消息结构体
@@ -45,6 +57,18 @@ struct WebSocketMessage {
     QString timestamp;
 };
 
+// 下行音频流统计（每次TTS开始时清零）
+struct AudioStreamStats {
+    quint64 framesReceived = 0;
+    quint64 bytesReceived = 0;
+    quint64 framesLost = 0;        // 根据序号空洞推算
+    quint64 framesReordered = 0;
+    quint64 framesSent = 0;
+    double jitterMs = 0.0;         // RFC3550到达间隔抖动；无时间戳时以标称帧长为参照
+    double transitMs = 0.0;        // 当前帧相对最小传输时延的排队时延（仅v2有时间戳时有效）
+    double maxTransitMs = 0.0;
+};
+
 class WebSocketManager : public QObject
 {
     Q_OBJECT
@@ -64,7 +88,7 @@ public:
     void sendListenStop();
     void sendAbortSpeaking();
     void sendWakeWordDetected(const QString &text);
-    void sendAudioData(const QByteArray &audioData);
+    void sendAudioData(const QByteArray &audioData, qint64 captureTimestampMs = -1);
     
     // 状态管理
     DeviceState getCurrentState() const;
@@ -75,6 +99,27 @@ public:
     void setClientId(const QString &clientId);
     void setAccessToken(const QString &token);
     
+    // 二进制音频协议版本（1=原始Opus，2/3=带头部），下次连接时生效
+    void setProtocolVersion(int version);
+    int getProtocolVersion() const;
+    int getNegotiatedProtocolVersion() const;
+    
+    // 传输方式，下次连接时生效；MqttUdp需要先设置OTA返回的mqtt信息
+    void setTransportType(TransportType type);
+    TransportType getTransportType() const;
+    void setMqttConfig(const QJsonObject &mqttInfo);
+    
+    // 音频流统计
+    AudioStreamStats getAudioStreamStats() const;
+    void resetAudioStreamStats();
+    
+    // 连接健康遥测：RTT直方图、吞吐、写积压、重连原因、各状态停留时间
+    ConnectionStats getConnectionStats() const;
+    void setTelemetryDumpFile(const QString &path, int intervalSec);
+    
+    // MCP工具注册表，tools/call在工作线程池中异步执行
+    McpToolRegistry *mcpToolRegistry() { return &m_mcpRegistry; }
+    
     // 心跳管理
     void startHeartbeat();
     void stopHeartbeat();
@@ -97,6 +142,7 @@ signals:
     
     // 音频信号
     void audioDataReceived(const QByteArray &audioData);
+    void audioFrameReceived(const AudioFrame &frame);  // 带序号/时间戳的帧，供抖动缓冲使用
 
 private slots:
     void onConnected();
@@ -107,6 +153,9 @@ private slots:
     void onHeartbeatTimeout();
     void onPongReceived(quint64 elapsedTime, const QByteArray &payload);
     void onReconnectTimeout();
+    void onTransportClosed();
+    void onTransportAudioFrame(const AudioFrame &frame);
+    void onTransportError(const QString &error);
 
 private:
     // 连接管理
@@ -142,10 +191,41 @@ private:
     // 配置
     QString m_protocolVersion;
     
+    // 二进制音频协议
+    int m_negotiatedVersion;       // 本次会话实际使用的帧格式
+    bool m_rawFallback;            // 下行帧与协商版本不符时退回原始模式
+    quint32 m_txSequence;
+    QElapsedTimer m_sessionClock;  // 上行采集时间戳基准
+    QElapsedTimer m_monotonicClock;
+    int m_serverFrameDurationMs;
+    bool m_haveRxSequence;
+    bool m_rxSequenceValid;        // 服务端不填序号（恒为0）时置false
+    quint32 m_lastRxSequence;
+    quint32 m_lastRxTimestamp;
+    qint64 m_lastArrivalMs;
+    qint64 m_minTransitMs;
+    bool m_haveTransit;
+    AudioStreamStats m_audioStats;
+    
+    // 可替换传输（WebSocket直连时为空）
+    TransportType m_transportType;
+    ProtocolTransport *m_transport;
+    QJsonObject m_mqttInfo;
+    
+    // 连接遥测
+    ConnectionTelemetry *m_telemetry;
+    QString m_disconnectCause;     // 下一次断开归因，为空时按服务端关闭处理
+    
+    // MCP工具
+    McpToolRegistry m_mcpRegistry;
+    McpToolRuntime *m_mcpRuntime;
+    
     // 内部方法
     void initializeWebSocket();
     void processIncomingMessage(const QString &message);
     void processIncomingBinary(const QByteArray &data);
+    void updateAudioStreamStats(const AudioFrame &frame);
+    void resetAudioReceiveState();
     WebSocketMessage parseMessage(const QJsonObject &json);
     void sendMessage(const WebSocketMessage &message);
     void handleHelloResponse(const QJsonObject &data);
@@ -156,6 +236,10 @@ private:
     void handlePingMessage(const QJsonObject &data);
     void handlePongMessage(const QJsonObject &data);
     void handleMCPMessage(const QJsonObject &data);
+    void handleGoodbyeMessage(const QJsonObject &data);
+    void sendMcpResponse(const QJsonObject &response);
+    bool usesTransport() const;
+    void ensureTransport();
     void attemptReconnect();
     void startReconnect();
     void stopReconnect();
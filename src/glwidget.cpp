@@ -1,18 +1,30 @@
 ﻿#include <GL/glew.h> // glew must put first,and can not include QtOpenGL
 #include <QtGui>
 #include "LAppDelegate.hpp"
-#include "GlWidget.h"
+#include "LAppLive2DManager.hpp"
+#include "LAppPal.hpp"
+#include "glwidget.h"
+#include "FramePacer.h"
 #include <QApplication>
+#include <QElapsedTimer>
 #include "QtOpenGLWidgets/QOpenGLWidget"
 
 namespace {
-    constexpr int frame = 40;
-    constexpr int fps = 1000 / frame;
+    constexpr int activeFps = 60;   // 动作、拖动、口型进行中
+    constexpr int idleFps = 15;     // 只有待机动作和呼吸
 }
 
 GLWidget::GLWidget(QWidget *parent)
-        : QOpenGLWidget(parent) {
-    this->startTimer(fps);
+        : QOpenGLWidget(parent)
+        , m_framePacer(new FramePacer(this, this))
+        , m_resetFrameClock(false) {
+    m_framePacer->setActiveInterval(1000 / activeFps);
+    m_framePacer->setIdleInterval(1000 / idleFps);
+    connect(m_framePacer, &FramePacer::modeChanged, this, [this](FramePacer::Mode mode) {
+        if (mode == FramePacer::Mode::Paused) {
+            m_resetFrameClock = true;
+        }
+    });
 }
 
 GLWidget::~GLWidget() = default;
@@ -20,11 +32,24 @@ GLWidget::~GLWidget() = default;
 void GLWidget::initializeGL() {
     LAppDelegate::GetInstance()->Initialize(this);
     LAppDelegate::GetInstance()->resize(this->width(), this->height());
+    // 原生窗口此时已创建，开始按可见性和模型活动调度重绘
+    m_framePacer->start();
 }
 
 void GLWidget::paintGL() {
+    if (m_resetFrameClock) {
+        LAppPal::UpdateTime();
+        m_resetFrameClock = false;
+    }
 
+    QElapsedTimer timer;
+    timer.start();
     LAppDelegate::GetInstance()->update();
+    m_framePacer->frameRendered(LAppLive2DManager::GetInstance()->IsActive(), timer.nsecsElapsed() / 1000);
+}
+
+void GLWidget::notifyActivity() {
+    m_framePacer->notifyActivity();
 }
 
 void GLWidget::resizeGL(int width, int height) {
@@ -79,11 +104,6 @@ void GLWidget::mouseMoveEvent(QMouseEvent *event) {
 //    }
 }
 
-void GLWidget::timerEvent(QTimerEvent *event) {
-    Q_UNUSED(event)
-    this->update();
-}
-
 void GLWidget::closeEvent(QCloseEvent *e) {
     Q_UNUSED(e)
     QApplication::sendEvent(this->parent(), e);
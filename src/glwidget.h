@@ -4,7 +4,8 @@
 #include <GL/glew.h>
 #include "QtOpenGLWidgets/QOpenGLWidget"
 #include <QTimer>
-#include "ChatDialog.h"
+
+class FramePacer;
 // 这个窗口是ui中的“提升为”操作指定一个widget成为这个类的
 class GLWidget : public QOpenGLWidget
 {
@@ -13,6 +14,11 @@ public:
     explicit GLWidget(QWidget *parent = nullptr);
 
     ~GLWidget() override;
+
+    FramePacer *framePacer() const { return m_framePacer; }
+
+    // 模型开始活动时切回高帧率，任意线程可调用
+    void notifyActivity();
 protected:
     void initializeGL() override;
 
@@ -26,13 +32,15 @@ protected:
 
     void mouseMoveEvent(QMouseEvent *event) override;
 
-    void timerEvent(QTimerEvent *event) override;
-
     void closeEvent(QCloseEvent *e) override;
 
     void enterEvent(QEnterEvent *e) override;
 
     void leaveEvent(QEvent *e) override;
+
+private:
+    FramePacer *m_framePacer;
+    bool m_resetFrameClock;     // 暂停恢复后的第一帧不把暂停时长算进动画时间
 };
 
 #endif
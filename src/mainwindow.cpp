@@ -15,6 +15,7 @@
 #include "MouseEvent.h"
 #include "PlatformConfig.hpp" // 这个文件头不能放到mainwindow.h中，否则会报错
 #include <QThread>
+#include "TraceProfiler.h"
 
 namespace {
     int pos_x;
@@ -75,6 +76,11 @@ MainWindow::MainWindow(QWidget *parent, QApplication *mapp)
     m_menu->addMenu(m_change);
     m_menu->addMenu(m_move);
     m_menu->addMenu(m_dialog);
+    if (TraceProfiler::instance().isEnabled()) {
+        auto *a_trace = new QAction(QStringLiteral("导出性能跟踪"), this);
+        m_menu->addAction(a_trace);
+        connect(a_trace, &QAction::triggered, this, &MainWindow::action_export_trace);
+    }
     m_menu->addSeparator();
     m_menu->addAction(a_exit);
 
@@ -162,6 +168,15 @@ void MainWindow::action_exit() {
     QApplication::exit(0);
 }
 
+void MainWindow::action_export_trace() {
+    const QString path = TraceProfiler::instance().outputPath();
+    if (TraceProfiler::instance().writeChromeTrace()) {
+        m_systemTray->showMessage(QStringLiteral("性能跟踪"), QStringLiteral("已导出到 ") + path);
+    } else {
+        QMessageBox::warning(this, QStringLiteral("性能跟踪"), QStringLiteral("导出失败：") + path);
+    }
+}
+
 void MainWindow::action_set_top() {
     bool isTop = this->windowFlags() & Qt::WindowStaysOnTopHint;
     if (isTop) {
@@ -278,62 +293,57 @@ void MainWindow::action_change(bool checked) {
         return;
     }
 
-    if (resource_loader::get_instance().update_current_model(counter)) {
-        bool load_fail = true;
+    if (!resource_loader::get_instance().update_current_model(counter)) {
+        return;
+    }
+    auto *m = resource_loader::get_instance().get_current_model();
+    qDebug() << "Attempting to change scene to model:" << m->name;
+
+    // 新模型在后台加载并逐帧上传贴图，期间继续显示当前模型，就绪后一帧内替换，窗口不再隐藏
+    LAppLive2DManager::GetInstance()->ChangeSceneAsync(m->name, [this, counter](bool success) {
+        // 回调发生在绘制过程中，调整窗口放回事件循环
+        QMetaObject::invokeMethod(this, [this, counter, success]() { onModelChanged(counter, success); },
+                                  Qt::QueuedConnection);
+    });
+}
+
+void MainWindow::onModelChanged(int counter, bool success) {
+    if (success) {
         auto *m = resource_loader::get_instance().get_current_model();
-        qDebug() << "Attempting to change scene to model:" << m->name;
-        
-        // 在切换模型前，先隐藏窗口以避免显示残留内容
-        this->hide();
-        
-        // 强制刷新窗口以确保清理残留内容
-        this->update();
-        QApplication::processEvents();
-        
-        /// 将QString转化为char*
-        if (LAppLive2DManager::GetInstance()->ChangeScene(m->name)) {
-            this->resize(m->model_width, m->model_height);
-            load_fail = false;
-            qDebug() << "Model change successful, resizing to:" << m->model_width << "x" << m->model_height;
-        } else {
-            int _counter = 0;
-            for (auto &item: resource_loader::get_instance().get_model_list()) {
-                if (_counter != counter) {
-                    if (LAppLive2DManager::GetInstance()->ChangeScene(item.name)) {
-                        this->resize(item.model_width, item.model_height);
-                        load_fail = false;
-                        auto msgIcon = QSystemTrayIcon::MessageIcon(2);
-                        this->m_systemTray->showMessage(QStringLiteral("waring"),
-                                                        tr("load model fail,try load default model"), msgIcon, 5000);
-                        this->model_list[_counter]->setChecked(true);
-                        resource_loader::get_instance().update_current_model(_counter);
-                        break;
-                    }
-                }
-                _counter++;
+        this->resize(m->model_width, m->model_height);
+        qDebug() << "Model change successful, resizing to:" << m->model_width << "x" << m->model_height;
+        return;
+    }
+
+    // 加载失败时依次尝试其他模型
+    bool load_fail = true;
+    int _counter = 0;
+    for (auto &item: resource_loader::get_instance().get_model_list()) {
+        if (_counter != counter) {
+            if (LAppLive2DManager::GetInstance()->ChangeScene(item.name)) {
+                this->resize(item.model_width, item.model_height);
+                load_fail = false;
+                auto msgIcon = QSystemTrayIcon::MessageIcon(2);
+                this->m_systemTray->showMessage(QStringLiteral("waring"),
+                                                tr("load model fail,try load default model"), msgIcon, 5000);
+                this->model_list[_counter]->setChecked(true);
+                resource_loader::get_instance().update_current_model(_counter);
+                break;
             }
         }
-        if (load_fail) {
-            this->hide();
-            this->resize(640, 480);
-            int cxScreen, cyScreen;
-            cxScreen = QApplication::primaryScreen()->availableGeometry().width();
-            cyScreen = QApplication::primaryScreen()->availableGeometry().height();
-            this->move(cxScreen / 2 - 320, cyScreen / 2 - 240);
-            this->show();
-            QMessageBox::critical(this, tr("CF"), QStringLiteral("资源文件错误,程序终止"));
-            action_exit();
-        }
-        
-        // 模型切换完成后重新显示窗口
-        if (!load_fail) {
-            // 添加短暂延迟以确保渲染状态完全清理
-            QThread::msleep(50);
-            this->show();
-            qDebug() << "Window shown after model change";
-        }
+        _counter++;
+    }
+    if (load_fail) {
+        this->hide();
+        this->resize(640, 480);
+        int cxScreen, cyScreen;
+        cxScreen = QApplication::primaryScreen()->availableGeometry().width();
+        cyScreen = QApplication::primaryScreen()->availableGeometry().height();
+        this->move(cxScreen / 2 - 320, cyScreen / 2 - 240);
+        this->show();
+        QMessageBox::critical(this, tr("CF"), QStringLiteral("资源文件错误,程序终止"));
+        action_exit();
     }
-    this->show();
 }
 
 void MainWindow::action_dialog(bool checked) {
@@ -385,6 +395,17 @@ void MainWindow::showWebSocketChatDialog() {
     }
 }
 
+bool MainWindow::switchModel(const QString &name) {
+    for (auto *action: model_list) {
+        if (action->text() == name) {
+            // 走菜单同一路径，保证勾选状态与窗口尺寸一致
+            action->trigger();
+            return true;
+        }
+    }
+    return false;
+}
+
 void MainWindow::customEvent(QEvent *event)
 {
     // 简单的实现
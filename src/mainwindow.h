@@ -24,6 +24,8 @@ public:
     
     void setDeskPetIntegration(DeskPetIntegration *integration);
     void showWebSocketChatDialog();
+    // 按名字切换模型，等同于在托盘菜单中选择；名字不存在时返回false
+    bool switchModel(const QString &name);
 
 protected:
     void closeEvent(QCloseEvent *e) override;
@@ -45,10 +47,15 @@ private:
 
     void action_change(bool);
 
+    // 异步切换模型完成后调整窗口；失败时依次尝试其他模型
+    void onModelChanged(int counter, bool success);
+
     void action_set_top();
 
     void action_dialog(bool);
 
+    void action_export_trace();
+
     void mousePressEvent(QMouseEvent *event) override;
 
     void mouseReleaseEvent(QMouseEvent *event) override;
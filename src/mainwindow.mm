@@ -13,6 +13,7 @@
 #include "qaction.h"
 #include "qactiongroup.h"
 #include <QMenuBar>
+#include "TraceProfiler.h"
 #import "MouseEvent.h" // 这个文件头不能放到mainwindow.h中，否则会报错
 
 namespace {
@@ -106,6 +107,11 @@ MainWindow::MainWindow(QWidget *parent, QApplication *mapp)
     m_menu->addMenu(m_change);
     m_menu->addMenu(m_move);
     m_menu->addMenu(m_dialog);
+    if (TraceProfiler::instance().isEnabled()) {
+        auto *a_trace = new QAction(QStringLiteral("导出性能跟踪"), this);
+        m_menu->addAction(a_trace);
+        connect(a_trace, &QAction::triggered, this, &MainWindow::action_export_trace);
+    }
     m_menu->addSeparator();
     m_menu->addAction(a_exit);
 //显示系统托盘
@@ -237,6 +243,17 @@ void MainWindow::showWebSocketChatDialog() {
     }
 }
 
+bool MainWindow::switchModel(const QString &name) {
+    for (auto *action: model_list) {
+        if (action->text() == name) {
+            // 走菜单同一路径，保证勾选状态与窗口尺寸一致
+            action->trigger();
+            return true;
+        }
+    }
+    return false;
+}
+
 void MainWindow::action_change(bool checked) {
     int counter = 0;
     for (auto &i: model_list) {
@@ -246,43 +263,54 @@ void MainWindow::action_change(bool checked) {
         counter++;
     }
 
-    if (resource_loader::get_instance().update_current_model(counter)) {
-        bool load_fail = true;
+    if (!resource_loader::get_instance().update_current_model(counter)) {
+        return;
+    }
+    auto *m = resource_loader::get_instance().get_current_model();
+    // 新模型在后台加载并逐帧上传贴图，期间继续显示当前模型，就绪后一帧内替换
+    LAppLive2DManager::GetInstance()->ChangeSceneAsync(m->name, [this, counter](bool success) {
+        // 回调发生在绘制过程中，调整窗口放回事件循环
+        QMetaObject::invokeMethod(this, [this, counter, success]() { onModelChanged(counter, success); },
+                                  Qt::QueuedConnection);
+    });
+}
+
+void MainWindow::onModelChanged(int counter, bool success) {
+    if (success) {
         auto *m = resource_loader::get_instance().get_current_model();
-        /// 将QString转化为char*
-        if (LAppLive2DManager::GetInstance()->ChangeScene(m->name)) {
-            this->resize(m->model_width, m->model_height);
-            load_fail = false;
-        } else {
-            int _counter = 0;
-            for (auto &item: resource_loader::get_instance().get_model_list()) {
-                if (_counter != counter) {
-                    if (LAppLive2DManager::GetInstance()->ChangeScene(item.name)) {
-                        this->resize(item.model_width, item.model_height);
-                        load_fail = false;
-                        auto msgIcon = QSystemTrayIcon::MessageIcon(2);
-                        this->m_systemTray->showMessage(QStringLiteral("waring"),
-                                                        tr("load model fail,try load default model"), msgIcon, 5000);
-                        this->model_list[_counter]->setChecked(true);
-                        resource_loader::get_instance().update_current_model(_counter);
-                        break;
-                    }
-                }
-                _counter++;
+        this->resize(m->model_width, m->model_height);
+        return;
+    }
+
+    // 加载失败时依次尝试其他模型
+    bool load_fail = true;
+    int _counter = 0;
+    for (auto &item: resource_loader::get_instance().get_model_list()) {
+        if (_counter != counter) {
+            if (LAppLive2DManager::GetInstance()->ChangeScene(item.name)) {
+                this->resize(item.model_width, item.model_height);
+                load_fail = false;
+                auto msgIcon = QSystemTrayIcon::MessageIcon(2);
+                this->m_systemTray->showMessage(QStringLiteral("waring"),
+                                                tr("load model fail,try load default model"), msgIcon, 5000);
+                this->model_list[_counter]->setChecked(true);
+                resource_loader::get_instance().update_current_model(_counter);
+                break;
             }
         }
+        _counter++;
+    }
 
-        if (load_fail) {
-            this->hide();
-            this->resize(640, 480);
-            int cxScreen, cyScreen;
-            cxScreen = QApplication::primaryScreen()->availableGeometry().width();
-            cyScreen = QApplication::primaryScreen()->availableGeometry().height();
-            this->move(cxScreen / 2 - 320, cyScreen / 2 - 240);
-            this->show();
-            QMessageBox::critical(this, tr("CF"), QStringLiteral("资源文件错误,程序终止"));
-            action_exit();
-        }
+    if (load_fail) {
+        this->hide();
+        this->resize(640, 480);
+        int cxScreen, cyScreen;
+        cxScreen = QApplication::primaryScreen()->availableGeometry().width();
+        cyScreen = QApplication::primaryScreen()->availableGeometry().height();
+        this->move(cxScreen / 2 - 320, cyScreen / 2 - 240);
+        this->show();
+        QMessageBox::critical(this, tr("CF"), QStringLiteral("资源文件错误,程序终止"));
+        action_exit();
     }
 }
 
@@ -339,6 +367,15 @@ void MainWindow::customEvent(QEvent *e) {
     }
 }
 
+void MainWindow::action_export_trace() {
+    const QString path = TraceProfiler::instance().outputPath();
+    if (TraceProfiler::instance().writeChromeTrace()) {
+        m_systemTray->showMessage(QStringLiteral("性能跟踪"), QStringLiteral("已导出到 ") + path);
+    } else {
+        QMessageBox::warning(this, QStringLiteral("性能跟踪"), QStringLiteral("导出失败：") + path);
+    }
+}
+
 void MainWindow::action_set_top() {
     if (set_top->isChecked() != resource_loader::get_instance().is_top()) {
         if (set_top->isChecked()) {
@@ -34,19 +34,19 @@ CubismCdiJson::~CubismCdiJson()
 // キーが存在するかどうかのチェック
 csmBool CubismCdiJson::IsExistParameters() const
 {
-    Utils::Value& node = (_json->GetRoot()[Parameters]);
+    const Utils::CubismJsonNode node = (_json->GetRoot()[Parameters]);
     return !node.IsNull() && !node.IsError();
 }
 
 csmBool CubismCdiJson::IsExistParameterGroups() const
 {
-    Utils::Value& node = (_json->GetRoot()[ParameterGroups]);
+    const Utils::CubismJsonNode node = (_json->GetRoot()[ParameterGroups]);
     return !node.IsNull() && !node.IsError();
 }
 
 csmBool CubismCdiJson::IsExistParts() const
 {
-    Utils::Value& node = (_json->GetRoot()[Parts]);
+    const Utils::CubismJsonNode node = (_json->GetRoot()[Parts]);
     return !node.IsNull() && !node.IsError();
 }
 
@@ -8,7 +8,7 @@
 #pragma once
 
 #include "CubismJsonHolder.hpp"
-#include "Utils/CubismJson.hpp"
+#include "Utils/CubismJsonTape.hpp"
 
 //--------- LIVE2D NAMESPACE ------------
 namespace Live2D {  namespace Cubism {  namespace Framework {
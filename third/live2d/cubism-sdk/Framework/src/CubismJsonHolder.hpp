@@ -7,7 +7,7 @@
 
 #pragma once
 
-#include "Utils/CubismJson.hpp"
+#include "Utils/CubismJsonTape.hpp"
 
 //--------- LIVE2D NAMESPACE ------------
 namespace Live2D { namespace Cubism { namespace Framework {
@@ -39,7 +39,7 @@ namespace Live2D { namespace Cubism { namespace Framework {
         { }
 
         /**
-         * @brief CubismJsonの有効性チェック
+         * @brief CubismJsonTapeの有効性チェック
          *
          * @retval       true  -> Jsonファイルが正常に読み込めた
          * @retval       false -> Jsonファイルが読み込めなかった。もしくは、存在しない
@@ -51,15 +51,15 @@ namespace Live2D { namespace Cubism { namespace Framework {
 
     protected:
         /**
-         * @brief CubismJsonのインスタンスを生成する
+         * @brief CubismJsonTapeのインスタンスを生成する
          *
-         * Util:CubismJsonクラスのCreate関数を呼んで
-         * CubismJsonのインスタンスを生成する。
+         * Util:CubismJsonTapeクラスのCreate関数を呼んで
+         * CubismJsonTapeのインスタンスを生成する。
          *
          */
         void CreateCubismJson(const csmByte* buffer, csmSizeInt size)
         {
-            _json = Utils::CubismJson::Create(buffer, size);
+            _json = Utils::CubismJsonTape::Create(buffer, size);
 
             if (!IsValid())
             {
@@ -68,18 +68,18 @@ namespace Live2D { namespace Cubism { namespace Framework {
         };
 
         /**
-         * @brief CubismJsonのインスタンスを破棄する
+         * @brief CubismJsonTapeのインスタンスを破棄する
          *
-         * Util:CubismJsonクラスのDelete関数を呼んで
-         * CubismJsonのインスタンスを破棄する。
+         * Util:CubismJsonTapeクラスのDelete関数を呼んで
+         * CubismJsonTapeのインスタンスを破棄する。
          *
          */
         void DeleteCubismJson()
         {
-            Utils::CubismJson::Delete(_json);
+            Utils::CubismJsonTape::Delete(_json);
             _json = NULL;
         }
 
-        Utils::CubismJson* _json;   /// CubismJsonの実体
+        Utils::CubismJsonTape* _json;   /// CubismJsonTapeの実体
     };
 }}}
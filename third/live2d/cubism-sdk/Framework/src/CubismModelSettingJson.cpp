@@ -82,62 +82,62 @@ const csmChar* Val = "val";
 // キーが存在するかどうかのチェック
 csmBool CubismModelSettingJson::IsExistModelFile() const
 {
-    Utils::Value& node = (*_jsonValue[FrequentNode_Moc]);
+    const Utils::CubismJsonNode node = _jsonValue[FrequentNode_Moc];
     return !node.IsNull() && !node.IsError();
 }
 csmBool CubismModelSettingJson::IsExistTextureFiles() const
 {
-    Utils::Value& node = (*_jsonValue[FrequentNode_Textures]);
+    const Utils::CubismJsonNode node = _jsonValue[FrequentNode_Textures];
     return !node.IsNull() && !node.IsError();
 }
 csmBool CubismModelSettingJson::IsExistHitAreas() const
 {
-    Utils::Value& node = (*_jsonValue[FrequentNode_HitAreas]);
+    const Utils::CubismJsonNode node = _jsonValue[FrequentNode_HitAreas];
     return !node.IsNull() && !node.IsError();
 }
 csmBool CubismModelSettingJson::IsExistPhysicsFile() const
 {
-    Utils::Value& node = (*_jsonValue[FrequentNode_Physics]);
+    const Utils::CubismJsonNode node = _jsonValue[FrequentNode_Physics];
     return !node.IsNull() && !node.IsError();
 }
 csmBool CubismModelSettingJson::IsExistPoseFile() const
 {
-    Utils::Value& node = (*_jsonValue[FrequentNode_Pose]);
+    const Utils::CubismJsonNode node = _jsonValue[FrequentNode_Pose];
     return !node.IsNull() && !node.IsError();
 }
 csmBool CubismModelSettingJson::IsExistDisplayInfoFile() const
 {
-    Utils::Value& node = (*_jsonValue[FrequentNode_DisplayInfo]);
+    const Utils::CubismJsonNode node = _jsonValue[FrequentNode_DisplayInfo];
     return !node.IsNull() && !node.IsError();
 }
 csmBool CubismModelSettingJson::IsExistExpressionFile() const
 {
-    Utils::Value& node = (*_jsonValue[FrequentNode_Expressions]);
+    const Utils::CubismJsonNode node = _jsonValue[FrequentNode_Expressions];
     return !node.IsNull() && !node.IsError();
 }
 csmBool CubismModelSettingJson::IsExistMotionGroups() const
 {
-    Utils::Value& node = (*_jsonValue[FrequentNode_Motions]);
+    const Utils::CubismJsonNode node = _jsonValue[FrequentNode_Motions];
     return !node.IsNull() && !node.IsError();
 }
 csmBool CubismModelSettingJson::IsExistMotionGroupName(const csmChar* groupName) const
 {
-    Utils::Value& node = (*_jsonValue[FrequentNode_Motions])[groupName];
+    const Utils::CubismJsonNode node = _jsonValue[FrequentNode_Motions][groupName];
     return !node.IsNull() && !node.IsError();
 }
 csmBool CubismModelSettingJson::IsExistMotionSoundFile(const csmChar* groupName, csmInt32 index) const
 {
-    Utils::Value& node = (*_jsonValue[FrequentNode_Motions])[groupName][index][SoundPath];
+    const Utils::CubismJsonNode node = _jsonValue[FrequentNode_Motions][groupName][index][SoundPath];
     return !node.IsNull() && !node.IsError();
 }
 csmBool CubismModelSettingJson::IsExistMotionFadeIn(const csmChar* groupName, csmInt32 index) const
 {
-    Utils::Value& node = (*_jsonValue[FrequentNode_Motions])[groupName][index][FadeInTime];
+    const Utils::CubismJsonNode node = _jsonValue[FrequentNode_Motions][groupName][index][FadeInTime];
     return !node.IsNull() && !node.IsError();
 }
 csmBool CubismModelSettingJson::IsExistMotionFadeOut(const csmChar* groupName, csmInt32 index) const
 {
-    Utils::Value& node = (*_jsonValue[FrequentNode_Motions])[groupName][index][FadeOutTime];
+    const Utils::CubismJsonNode node = _jsonValue[FrequentNode_Motions][groupName][index][FadeOutTime];
     return !node.IsNull() && !node.IsError();
 }
 csmBool CubismModelSettingJson::IsExistUserDataFile() const { return !_json->GetRoot()[FileReferences][UserData].IsNull(); }
@@ -145,14 +145,14 @@ csmBool CubismModelSettingJson::IsExistUserDataFile() const { return !_json->Get
 
 csmBool CubismModelSettingJson::IsExistEyeBlinkParameters() const
 {
-    if (_jsonValue[FrequentNode_Groups]->IsNull() || _jsonValue[FrequentNode_Groups]->IsError())
+    if (_jsonValue[FrequentNode_Groups].IsNull() || _jsonValue[FrequentNode_Groups].IsError())
     {
         return false;
     }
 
-    for (csmInt32 i = 0; i < _jsonValue[FrequentNode_Groups]->GetSize(); ++i)
+    for (csmInt32 i = 0; i < _jsonValue[FrequentNode_Groups].GetSize(); ++i)
     {
-        if (strcmp((*_jsonValue[FrequentNode_Groups])[i][Name].GetRawString(), EyeBlink) == 0)
+        if (strcmp(_jsonValue[FrequentNode_Groups][i][Name].GetRawString(), EyeBlink) == 0)
         {
             return true;
         }
@@ -162,14 +162,14 @@ csmBool CubismModelSettingJson::IsExistEyeBlinkParameters() const
 
 csmBool CubismModelSettingJson::IsExistLipSyncParameters() const
 {
-    if (_jsonValue[FrequentNode_Groups]->IsNull() || _jsonValue[FrequentNode_Groups]->IsError())
+    if (_jsonValue[FrequentNode_Groups].IsNull() || _jsonValue[FrequentNode_Groups].IsError())
     {
         return false;
     }
 
-    for (csmInt32 i = 0; i < _jsonValue[FrequentNode_Groups]->GetSize(); ++i)
+    for (csmInt32 i = 0; i < _jsonValue[FrequentNode_Groups].GetSize(); ++i)
     {
-        if (strcmp((*_jsonValue[FrequentNode_Groups])[i][Name].GetRawString(), LipSync) == 0)
+        if (strcmp(_jsonValue[FrequentNode_Groups][i][Name].GetRawString(), LipSync) == 0)
         {
             return true;
         }
@@ -186,15 +186,15 @@ CubismModelSettingJson::CubismModelSettingJson(const csmByte* buffer, csmSizeInt
         _jsonValue.Clear();
 
         // 顺序应与枚举常量FrequentNode相匹配。
-        _jsonValue.PushBack(&(_json->GetRoot()[Groups]));
-        _jsonValue.PushBack(&(_json->GetRoot()[FileReferences][Moc]));
-        _jsonValue.PushBack(&(_json->GetRoot()[FileReferences][Motions]));
-        _jsonValue.PushBack(&(_json->GetRoot()[FileReferences][DisplayInfo]));
-        _jsonValue.PushBack(&(_json->GetRoot()[FileReferences][Expressions]));
-        _jsonValue.PushBack(&(_json->GetRoot()[FileReferences][Textures]));
-        _jsonValue.PushBack(&(_json->GetRoot()[FileReferences][Physics]));
-        _jsonValue.PushBack(&(_json->GetRoot()[FileReferences][Pose]));
-        _jsonValue.PushBack(&(_json->GetRoot()[HitAreas]));
+        _jsonValue.PushBack(_json->GetRoot()[Groups]);
+        _jsonValue.PushBack(_json->GetRoot()[FileReferences][Moc]);
+        _jsonValue.PushBack(_json->GetRoot()[FileReferences][Motions]);
+        _jsonValue.PushBack(_json->GetRoot()[FileReferences][DisplayInfo]);
+        _jsonValue.PushBack(_json->GetRoot()[FileReferences][Expressions]);
+        _jsonValue.PushBack(_json->GetRoot()[FileReferences][Textures]);
+        _jsonValue.PushBack(_json->GetRoot()[FileReferences][Physics]);
+        _jsonValue.PushBack(_json->GetRoot()[FileReferences][Pose]);
+        _jsonValue.PushBack(_json->GetRoot()[HitAreas]);
     }
 }
 
@@ -203,7 +203,7 @@ CubismModelSettingJson::~CubismModelSettingJson()
     DeleteCubismJson();
 }
 
-Utils::CubismJson* CubismModelSettingJson::GetJsonPointer() const
+Utils::CubismJsonTape* CubismModelSettingJson::GetJsonPointer() const
 {
     return _json;
 }
@@ -211,14 +211,14 @@ Utils::CubismJson* CubismModelSettingJson::GetJsonPointer() const
 const csmChar* CubismModelSettingJson::GetModelFileName()
 {
     if (!IsExistModelFile())return "";
-    return (*_jsonValue[FrequentNode_Moc]).GetRawString();
+    return _jsonValue[FrequentNode_Moc].GetRawString();
 }
 
 // テクスチャについて
 csmInt32 CubismModelSettingJson::GetTextureCount()
 {
     if (!IsExistTextureFiles())return 0;
-    return (*_jsonValue[FrequentNode_Textures]).GetSize();
+    return _jsonValue[FrequentNode_Textures].GetSize();
 }
 
 const csmChar* CubismModelSettingJson::GetTextureDirectory()
@@ -230,8 +230,8 @@ const csmChar* CubismModelSettingJson::GetTextureDirectory()
 
     csmVector<csmString> splitPathBuffer;
     csmVector<csmChar> charBuffer;
-    const csmChar* rawString = (*_jsonValue[FrequentNode_Textures])[0].GetRawString();
-    csmInt32 rawStringSize = (*_jsonValue[FrequentNode_Textures])[0].GetString().GetLength();
+    const csmChar* rawString = _jsonValue[FrequentNode_Textures][0].GetRawString();
+    csmInt32 rawStringSize = _jsonValue[FrequentNode_Textures][0].GetLength();
     for (csmInt32 i = 0; i < rawStringSize; i++)
     {
         // /を含んでいる場合splitする
@@ -264,59 +264,59 @@ const csmChar* CubismModelSettingJson::GetTextureDirectory()
 
 const csmChar* CubismModelSettingJson::GetTextureFileName(csmInt32 index)
 {
-    return (*_jsonValue[FrequentNode_Textures])[index].GetRawString();
+    return _jsonValue[FrequentNode_Textures][index].GetRawString();
 }
 
 // あたり判定について
 csmInt32 CubismModelSettingJson::GetHitAreasCount()
 {
     if (!IsExistHitAreas())return 0;
-    return (*_jsonValue[FrequentNode_HitAreas]).GetSize();
+    return _jsonValue[FrequentNode_HitAreas].GetSize();
 }
 
 CubismIdHandle CubismModelSettingJson::GetHitAreaId(csmInt32 index)
 {
-    return CubismFramework::GetIdManager()->GetId((*_jsonValue[FrequentNode_HitAreas])[index][Id].GetRawString());
+    return CubismFramework::GetIdManager()->GetId(_jsonValue[FrequentNode_HitAreas][index][Id].GetRawString());
 }
 
 const csmChar* CubismModelSettingJson::GetHitAreaName(csmInt32 index)
 {
-    return (*_jsonValue[FrequentNode_HitAreas])[index][Name].GetRawString();
+    return _jsonValue[FrequentNode_HitAreas][index][Name].GetRawString();
 }
 
 // 物理演算、表示名称、パーツ切り替え、表情ファイルについて
 const csmChar* CubismModelSettingJson::GetPhysicsFileName()
 {
     if (!IsExistPhysicsFile())return "";
-    return (*_jsonValue[FrequentNode_Physics]).GetRawString();
+    return _jsonValue[FrequentNode_Physics].GetRawString();
 }
 
 const csmChar* CubismModelSettingJson::GetPoseFileName()
 {
     if (!IsExistPoseFile())return "";
-    return (*_jsonValue[FrequentNode_Pose]).GetRawString();
+    return _jsonValue[FrequentNode_Pose].GetRawString();
 }
 
 const csmChar* CubismModelSettingJson::GetDisplayInfoFileName()
 {
     if (!IsExistDisplayInfoFile())return "";
-    return (*_jsonValue[FrequentNode_DisplayInfo]).GetRawString();
+    return _jsonValue[FrequentNode_DisplayInfo].GetRawString();
 }
 
 csmInt32 CubismModelSettingJson::GetExpressionCount()
 {
     if (!IsExistExpressionFile())return 0;
-    return (*_jsonValue[FrequentNode_Expressions]).GetSize();
+    return _jsonValue[FrequentNode_Expressions].GetSize();
 }
 
 const csmChar* CubismModelSettingJson::GetExpressionName(csmInt32 index)
 {
-    return (*_jsonValue[FrequentNode_Expressions])[index][Name].GetRawString();
+    return _jsonValue[FrequentNode_Expressions][index][Name].GetRawString();
 }
 
 const csmChar* CubismModelSettingJson::GetExpressionFileName(csmInt32 index)
 {
-    return (*_jsonValue[FrequentNode_Expressions])[index][FilePath].GetRawString();
+    return _jsonValue[FrequentNode_Expressions][index][FilePath].GetRawString();
 }
 
 // モーションについて
@@ -326,7 +326,7 @@ csmInt32 CubismModelSettingJson::GetMotionGroupCount()
     {
         return 0;
     }
-    return (*_jsonValue[FrequentNode_Motions]).GetKeys().GetSize();
+    return _jsonValue[FrequentNode_Motions].GetSize();
 }
 
 const csmChar* CubismModelSettingJson::GetMotionGroupName(csmInt32 index)
@@ -335,37 +335,37 @@ const csmChar* CubismModelSettingJson::GetMotionGroupName(csmInt32 index)
     {
         return NULL;
     }
-    return (*_jsonValue[FrequentNode_Motions]).GetKeys()[index].GetRawString();
+    return _jsonValue[FrequentNode_Motions].GetKey(index);
 }
 
 csmInt32 CubismModelSettingJson::GetMotionCount(const csmChar* groupName)
 {
     if (!IsExistMotionGroupName(groupName))return 0;
-    return (*_jsonValue[FrequentNode_Motions])[groupName].GetSize();
+    return _jsonValue[FrequentNode_Motions][groupName].GetSize();
 }
 
 const csmChar* CubismModelSettingJson::GetMotionFileName(const csmChar* groupName, csmInt32 index)
 {
     if (!IsExistMotionGroupName(groupName))return "";
-    return (*_jsonValue[FrequentNode_Motions])[groupName][index][FilePath].GetRawString();
+    return _jsonValue[FrequentNode_Motions][groupName][index][FilePath].GetRawString();
 }
 
 const csmChar* CubismModelSettingJson::GetMotionSoundFileName(const csmChar* groupName, csmInt32 index)
 {
     if (!IsExistMotionSoundFile(groupName, index))return "";
-    return (*_jsonValue[FrequentNode_Motions])[groupName][index][SoundPath].GetRawString();
+    return _jsonValue[FrequentNode_Motions][groupName][index][SoundPath].GetRawString();
 }
 
 csmFloat32 CubismModelSettingJson::GetMotionFadeInTimeValue(const csmChar* groupName, csmInt32 index)
 {
     if (!IsExistMotionFadeIn(groupName, index))return -1.0f;
-    return (*_jsonValue[FrequentNode_Motions])[groupName][index][FadeInTime].ToFloat();
+    return _jsonValue[FrequentNode_Motions][groupName][index][FadeInTime].ToFloat();
 }
 
 csmFloat32 CubismModelSettingJson::GetMotionFadeOutTimeValue(const csmChar* groupName, csmInt32 index)
 {
     if (!IsExistMotionFadeOut(groupName, index))return -1.0f;
-    return (*_jsonValue[FrequentNode_Motions])[groupName][index][FadeOutTime].ToFloat();
+    return _jsonValue[FrequentNode_Motions][groupName][index][FadeOutTime].ToFloat();
 }
 
 
@@ -380,16 +380,15 @@ const csmChar* CubismModelSettingJson::GetUserDataFile()
 
 csmBool CubismModelSettingJson::GetLayoutMap(csmMap<csmString, csmFloat32>& outLayoutMap)
 {
-    csmMap<csmString, Utils::Value*>* map = _json->GetRoot()[Layout].GetMap();
-    if (map == NULL)
+    const Utils::CubismJsonNode map = _json->GetRoot()[Layout];
+    if (!map.IsMap())
     {
         return false;
     }
-    csmMap<csmString, Utils::Value*>::const_iterator map_ite;
     csmBool ret = false;
-    for (map_ite = map->Begin(); map_ite != map->End(); ++map_ite)
+    for (csmInt32 i = 0; i < map.GetSize(); ++i)
     {
-        outLayoutMap[map_ite->First] = map_ite->Second->ToFloat();
+        outLayoutMap[map.GetKey(i)] = map.GetMember(i).ToFloat();
         ret = true;
     }
     return ret;
@@ -403,9 +402,9 @@ csmInt32 CubismModelSettingJson::GetEyeBlinkParameterCount()
     }
 
     csmInt32 num = 0;
-    for (csmInt32 i = 0; i < _jsonValue[FrequentNode_Groups]->GetSize(); i++)
+    for (csmInt32 i = 0; i < _jsonValue[FrequentNode_Groups].GetSize(); i++)
     {
-        Utils::Value& refI = (*_jsonValue[FrequentNode_Groups])[i];
+        const Utils::CubismJsonNode refI = _jsonValue[FrequentNode_Groups][i];
         if(refI.IsNull() || refI.IsError())
         {
             continue;
@@ -413,7 +412,7 @@ csmInt32 CubismModelSettingJson::GetEyeBlinkParameterCount()
 
         if (strcmp(refI[Name].GetRawString(), EyeBlink) == 0)
         {
-            num = refI[Ids].GetVector()->GetSize();
+            num = refI[Ids].GetSize();
             break;
         }
     }
@@ -428,9 +427,9 @@ CubismIdHandle CubismModelSettingJson::GetEyeBlinkParameterId(csmInt32 index)
         return NULL;
     }
 
-    for (csmInt32 i = 0; i < _jsonValue[FrequentNode_Groups]->GetSize(); i++)
+    for (csmInt32 i = 0; i < _jsonValue[FrequentNode_Groups].GetSize(); i++)
     {
-        Utils::Value& refI = (*_jsonValue[FrequentNode_Groups])[i];
+        const Utils::CubismJsonNode refI = _jsonValue[FrequentNode_Groups][i];
         if (refI.IsNull() || refI.IsError())
         {
             continue;
@@ -452,9 +451,9 @@ csmInt32 CubismModelSettingJson::GetLipSyncParameterCount()
     }
 
     csmInt32 num = 0;
-    for (csmInt32 i = 0; i < _jsonValue[FrequentNode_Groups]->GetSize(); i++)
+    for (csmInt32 i = 0; i < _jsonValue[FrequentNode_Groups].GetSize(); i++)
     {
-        Utils::Value& refI = (*_jsonValue[FrequentNode_Groups])[i];
+        const Utils::CubismJsonNode refI = _jsonValue[FrequentNode_Groups][i];
         if (refI.IsNull() || refI.IsError())
         {
             continue;
@@ -462,7 +461,7 @@ csmInt32 CubismModelSettingJson::GetLipSyncParameterCount()
 
         if (strcmp(refI[Name].GetRawString(), LipSync) == 0)
         {
-            num = refI[Ids].GetVector()->GetSize();
+            num = refI[Ids].GetSize();
             break;
         }
     }
@@ -477,9 +476,9 @@ CubismIdHandle CubismModelSettingJson::GetLipSyncParameterId(csmInt32 index)
         return NULL;
     }
 
-    for (csmInt32 i = 0; i < _jsonValue[FrequentNode_Groups]->GetSize(); i++)
+    for (csmInt32 i = 0; i < _jsonValue[FrequentNode_Groups].GetSize(); i++)
     {
-        Utils::Value& refI = (*_jsonValue[FrequentNode_Groups])[i];
+        const Utils::CubismJsonNode refI = _jsonValue[FrequentNode_Groups][i];
         if (refI.IsNull() || refI.IsError())
         {
             continue;
@@ -9,7 +9,7 @@
 
 #include "ICubismModelSetting.hpp"
 #include "CubismJsonHolder.hpp"
-#include "Utils/CubismJson.hpp"
+#include "Utils/CubismJsonTape.hpp"
 #include "Id/CubismId.hpp"
 
 namespace Live2D { namespace Cubism { namespace Framework {
@@ -44,11 +44,11 @@ public:
     virtual ~CubismModelSettingJson();
 
     /**
-     * @brief   CubismJsonオブジェクトのポインタを取得する
+     * @brief   CubismJsonTapeオブジェクトのポインタを取得する
      *
-     * @return  CubismJsonのポインタ
+     * @return  CubismJsonTapeのポインタ
      */
-    Utils::CubismJson* GetJsonPointer() const;
+    Utils::CubismJsonTape* GetJsonPointer() const;
 
     const csmChar* GetModelFileName();
 
@@ -244,6 +244,6 @@ private:
      */
     csmBool IsExistLipSyncParameters() const;
 
-    csmVector<Utils::Value*>    _jsonValue;  ///< モデルデータjsonの頻出ノード
+    csmVector<Utils::CubismJsonNode>    _jsonValue;  ///< モデルデータjsonの頻出ノード
 };
 }}}
@@ -71,8 +71,13 @@ CubismPose::~CubismPose()
 CubismPose* CubismPose::Create(const csmByte* pose3json, csmSizeInt size)
 {
     CubismPose*         ret = CSM_NEW CubismPose();
-    Utils::CubismJson*  json = Utils::CubismJson::Create(pose3json, size);
-    Utils::Value&       root = json->GetRoot();
+    Utils::CubismJsonTape*  json = Utils::CubismJsonTape::Create(pose3json, size);
+    if (json == NULL)
+    {
+        // 壊れたJSONはパーツグループの無いポーズとして扱う
+        return ret;
+    }
+    const Utils::CubismJsonNode root = json->GetRoot();
 
     // フェード時間の指定
     if (!root[FadeIn].IsNull())
@@ -86,18 +91,18 @@ CubismPose* CubismPose::Create(const csmByte* pose3json, csmSizeInt size)
     }
 
     // パーツグループ
-    Utils::Value&      poseListInfo = root[Groups];
+    const Utils::CubismJsonNode poseListInfo = root[Groups];
     const csmInt32     poseCount = poseListInfo.GetSize();
 
     for (csmInt32 poseIndex = 0; poseIndex < poseCount; ++poseIndex)
     {
-        Utils::Value&      idListInfo = poseListInfo[poseIndex];
+        const Utils::CubismJsonNode idListInfo = poseListInfo[poseIndex];
         const csmInt32    idCount = idListInfo.GetSize();
         csmInt32    groupCount = 0;
 
         for (csmInt32 groupIndex = 0; groupIndex < idCount; ++groupIndex)
         {
-            Utils::Value&   partInfo = idListInfo[groupIndex];
+            const Utils::CubismJsonNode partInfo = idListInfo[groupIndex];
             PartData        partData;
             const CubismIdHandle parameterId = CubismFramework::GetIdManager()->GetId(partInfo[Id].GetRawString());
 
@@ -106,13 +111,13 @@ CubismPose* CubismPose::Create(const csmByte* pose3json, csmSizeInt size)
             // リンクするパーツの設定
             if (!partInfo[Link].IsNull())
             {
-                Utils::Value&   linkListInfo = partInfo[Link];
+                const Utils::CubismJsonNode linkListInfo = partInfo[Link];
                 const csmInt32        linkCount = linkListInfo.GetSize();
 
                 for (csmInt32 linkIndex = 0; linkIndex < linkCount; ++linkIndex)
                 {
                     PartData             linkPart;
-                    const CubismIdHandle linkId = CubismFramework::GetIdManager()->GetId(linkListInfo[linkIndex].GetString());
+                    const CubismIdHandle linkId = CubismFramework::GetIdManager()->GetId(linkListInfo[linkIndex].GetRawString());
 
                     linkPart.PartId = linkId;
 
@@ -129,7 +134,7 @@ CubismPose* CubismPose::Create(const csmByte* pose3json, csmSizeInt size)
 
     }
 
-    Utils::CubismJson::Delete(json);
+    Utils::CubismJsonTape::Delete(json);
 
     return ret;
 }
@@ -8,7 +8,7 @@
 #pragma once
 
 #include "Model/CubismModel.hpp"
-#include "Utils/CubismJson.hpp"
+#include "Utils/CubismJsonTape.hpp"
 
 namespace Live2D { namespace Cubism { namespace Framework {
 /**
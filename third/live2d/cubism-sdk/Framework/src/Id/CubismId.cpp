@@ -11,13 +11,16 @@
 namespace Live2D { namespace Cubism { namespace Framework {
 
 CubismId::CubismId()
+    : _hash(0)
 { }
 
 CubismId::CubismId(const CubismId& c)
                         : _id(c._id)
+                        , _hash(c._hash)
 { }
 
 CubismId::CubismId(const csmChar* id)
+    : _hash(0)
 {
     _id = id;
 }
@@ -30,6 +33,7 @@ CubismId& CubismId::operator=(const CubismId& c)
     if (this != &c)
     {
         _id = c._id;
+        _hash = c._hash;
     }
 
     return *this;
@@ -60,6 +60,7 @@ private:
     csmBool operator!=(const CubismId& c) const;
 
     csmString _id;      ///< ID名
+    csmUint32 _hash;    ///< ID名のハッシュ値。CubismIdManagerの検索表で使う
 };
 
 typedef const CubismId* CubismIdHandle;
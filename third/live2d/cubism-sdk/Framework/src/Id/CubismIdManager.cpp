@@ -7,17 +7,44 @@
 
 #include "CubismIdManager.hpp"
 #include "CubismId.hpp"
+#include "CubismFramework.hpp"
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
+namespace {
+const csmInt32 IdBlockSize = 64;            ///< アリーナの1ブロックに格納するIDの個数
+const csmUint32 InitialTableSize = 256;     ///< 検索表の初期サイズ
+
+/**
+ * @brief ID名のハッシュ値(FNV-1a)
+ */
+csmUint32 HashIdName(const csmChar* id)
+{
+    csmUint32 hash = 2166136261u;
+    for (const csmUchar* p = reinterpret_cast<const csmUchar*>(id); *p != '\0'; ++p)
+    {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+}
+
 CubismIdManager::CubismIdManager()
+    : _blockUsed(IdBlockSize)
 { }
 
 CubismIdManager::~CubismIdManager()
 {
+    // IDはアリーナ上に構築しているので、デストラクタを呼んでからブロックごと解放する
     for (csmUint32 i = 0; i < _ids.GetSize(); ++i)
     {
-        CSM_DELETE_SELF(CubismId, _ids[i]);
+        _ids[i]->~CubismId();
+    }
+
+    for (csmUint32 i = 0; i < _blocks.GetSize(); ++i)
+    {
+        CSM_FREE(_blocks[i]);
     }
 }
 
@@ -58,16 +85,27 @@ csmBool CubismIdManager::IsExist(const csmChar* id) const
 
 const CubismId* CubismIdManager::RegisterId(const csmChar* id)
 {
+    const csmUint32 hash = HashIdName(id);
     CubismId* result = NULL;
 
-    if ((result = FindId(id)) != NULL)
+    if ((result = FindId(id, hash)) != NULL)
     {
         return result;
     }
 
-    result = CSM_NEW CubismId(id);
+    result = AllocateId(id, hash);
     _ids.PushBack(result);
 
+    // 負荷率を1/2以下に保つ
+    if (_ids.GetSize() * 2 > _table.GetSize())
+    {
+        GrowTable();
+    }
+    else
+    {
+        InsertToTable(result);
+    }
+
     return result;
 }
 
@@ -78,15 +116,76 @@ const CubismId* CubismIdManager::RegisterId(const csmString& id)
 
 CubismId* CubismIdManager::FindId(const csmChar* id) const
 {
-    for (csmUint32 i = 0; i < _ids.GetSize(); ++i)
+    return FindId(id, HashIdName(id));
+}
+
+CubismId* CubismIdManager::FindId(const csmChar* id, csmUint32 hash) const
+{
+    if (_table.GetSize() == 0)
+    {
+        return NULL;
+    }
+
+    const csmUint32 mask = _table.GetSize() - 1;
+    for (csmUint32 slot = hash & mask; ; slot = (slot + 1) & mask)
     {
-        if (_ids[i]->GetString() == id)
+        CubismId* entry = _table[slot];
+
+        if (entry == NULL)
         {
-            return _ids[i];
+            return NULL;
         }
+
+        if (entry->_hash == hash && entry->GetString() == id)
+        {
+            return entry;
+        }
+    }
+}
+
+CubismId* CubismIdManager::AllocateId(const csmChar* id, csmUint32 hash)
+{
+    if (_blockUsed >= IdBlockSize)
+    {
+        _blocks.PushBack(static_cast<CubismId*>(CSM_MALLOC(sizeof(CubismId) * IdBlockSize)));
+        _blockUsed = 0;
+    }
+
+    // ID名は63文字未満ならcsmStringの内部バッファに収まるため、ブロック内に格納される
+    CubismId* result = new (_blocks[_blocks.GetSize() - 1] + _blockUsed) CubismId(id);
+    result->_hash = hash;
+    ++_blockUsed;
+
+    return result;
+}
+
+void CubismIdManager::GrowTable()
+{
+    csmUint32 size = (_table.GetSize() < InitialTableSize) ? InitialTableSize : _table.GetSize();
+    while (_ids.GetSize() * 2 > size)
+    {
+        size <<= 1;
+    }
+
+    // 登録済みのIDを入れ直す。IDそのものは移動しないのでハンドルは変わらない
+    _table.Clear();
+    _table.Resize(static_cast<csmInt32>(size), NULL);
+
+    for (csmUint32 i = 0; i < _ids.GetSize(); ++i)
+    {
+        InsertToTable(_ids[i]);
     }
+}
 
-    return NULL;
+void CubismIdManager::InsertToTable(CubismId* id)
+{
+    const csmUint32 mask = _table.GetSize() - 1;
+    csmUint32 slot = id->_hash & mask;
+    while (_table[slot] != NULL)
+    {
+        slot = (slot + 1) & mask;
+    }
+    _table[slot] = id;
 }
 
 }}}
@@ -18,7 +18,11 @@ struct CubismId;
 /**
  * @brief ID名の管理
  *
- * ID名を管理する。
+ * ID名を管理する。<br>
+ * スレッドセーフではない。登録時に表を拡張すると探索中の表が解放されるため、
+ * GetId/IsExistは一度に一つのスレッドからだけ呼ぶこと。
+ * 取得済みのCubismIdHandleは表を拡張しても移動しないので、どのスレッドからも参照できる。<br>
+ * モーションや物理などのIDは読み込み時に解決し、毎フレームの更新では登録しない。
  */
 class CubismIdManager
 {
@@ -132,7 +136,47 @@ private:
      */
     CubismId* FindId(const csmChar* id) const;
 
-    csmVector<CubismId*> _ids;      ///< 登録されているIDのリスト
+    /**
+     * @brief ID名からIDを検索
+     *
+     * 計算済みのハッシュ値を使って検索表を引く。
+     *
+     * @param[in]   id      ID名
+     * @param[in]   hash    ID名のハッシュ値
+     * @return  登録されているID。なければNULL。
+     */
+    CubismId* FindId(const csmChar* id, csmUint32 hash) const;
+
+    /**
+     * @brief IDの領域の確保
+     *
+     * アリーナのブロックからIDを1つ取り出して構築する。
+     * ブロックは解放まで移動しないので、返したCubismIdHandleは常に有効。
+     *
+     * @param[in]   id      ID名
+     * @param[in]   hash    ID名のハッシュ値
+     * @return  構築したID
+     */
+    CubismId* AllocateId(const csmChar* id, csmUint32 hash);
+
+    /**
+     * @brief 検索表の拡張
+     *
+     * 登録数の2倍以上になるまで検索表を広げ、全てのIDを入れ直す。
+     */
+    void GrowTable();
+
+    /**
+     * @brief IDを検索表に追加
+     *
+     * @param[in]   id  追加するID
+     */
+    void InsertToTable(CubismId* id);
+
+    csmVector<CubismId*> _ids;      ///< 登録されているIDのリスト（登録順）
+    csmVector<CubismId*> _table;    ///< オープンアドレス法の検索表。要素数は2のべき乗、空きはNULL
+    csmVector<CubismId*> _blocks;   ///< IDを格納するアリーナのブロック
+    csmInt32 _blockUsed;            ///< 最後のブロックで使用済みのIDの個数
 };
 
 }}}
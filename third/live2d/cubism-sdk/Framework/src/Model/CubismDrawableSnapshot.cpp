@@ -0,0 +1,114 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismDrawableSnapshot.hpp"
+#include <string.h>
+#include "CubismModel.hpp"
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+CubismDrawableSnapshot::CubismDrawableSnapshot()
+{ }
+
+CubismDrawableSnapshot::~CubismDrawableSnapshot()
+{ }
+
+void CubismDrawableSnapshot::Capture(const CubismModel& model)
+{
+    // SetDrawableSnapshotの設定に関わらずモデル本体から読む
+    const Core::csmModel* coreModel = model.GetModel();
+    const csmInt32 drawableCount = Core::csmGetDrawableCount(coreModel);
+
+    // 頂点数は変わらないので、配置は初回だけ決める
+    if (static_cast<csmInt32>(_vertexOffsets.GetSize()) != drawableCount + 1)
+    {
+        const csmInt32* vertexCounts = Core::csmGetDrawableVertexCounts(coreModel);
+        _vertexOffsets.Resize(drawableCount + 1);
+        csmInt32 offset = 0;
+        for (csmInt32 i = 0; i < drawableCount; ++i)
+        {
+            _vertexOffsets[i] = offset;
+            offset += vertexCounts[i];
+        }
+        _vertexOffsets[drawableCount] = offset;
+
+        _vertexPositions.Resize(offset);
+        _renderOrders.Resize(drawableCount);
+        _opacities.Resize(drawableCount);
+        _dynamicFlags.Resize(drawableCount);
+        _multiplyColors.Resize(drawableCount);
+        _screenColors.Resize(drawableCount);
+    }
+
+    const Core::csmVector2** positions = Core::csmGetDrawableVertexPositions(coreModel);
+    for (csmInt32 i = 0; i < drawableCount; ++i)
+    {
+        const csmInt32 count = _vertexOffsets[i + 1] - _vertexOffsets[i];
+        if (count > 0)
+        {
+            memcpy(_vertexPositions.GetPtr() + _vertexOffsets[i], positions[i], sizeof(Core::csmVector2) * count);
+        }
+    }
+
+    if (drawableCount > 0)
+    {
+        memcpy(_renderOrders.GetPtr(), Core::csmGetDrawableRenderOrders(coreModel), sizeof(csmInt32) * drawableCount);
+        memcpy(_opacities.GetPtr(), Core::csmGetDrawableOpacities(coreModel), sizeof(csmFloat32) * drawableCount);
+        memcpy(_dynamicFlags.GetPtr(), Core::csmGetDrawableDynamicFlags(coreModel), sizeof(Core::csmFlags) * drawableCount);
+        memcpy(_multiplyColors.GetPtr(), Core::csmGetDrawableMultiplyColors(coreModel), sizeof(Core::csmVector4) * drawableCount);
+        memcpy(_screenColors.GetPtr(), Core::csmGetDrawableScreenColors(coreModel), sizeof(Core::csmVector4) * drawableCount);
+    }
+}
+
+void CubismDrawableSnapshot::MarkAllChanged()
+{
+    const Core::csmFlags changedFlags = Core::csmVisibilityDidChange | Core::csmOpacityDidChange
+                                      | Core::csmDrawOrderDidChange | Core::csmRenderOrderDidChange
+                                      | Core::csmVertexPositionsDidChange | Core::csmBlendColorDidChange;
+
+    for (csmUint32 i = 0; i < _dynamicFlags.GetSize(); ++i)
+    {
+        _dynamicFlags[i] |= changedFlags;
+    }
+}
+
+csmBool CubismDrawableSnapshot::IsCaptured() const
+{
+    return _vertexOffsets.GetSize() > 0;
+}
+
+const csmInt32* CubismDrawableSnapshot::GetRenderOrders() const
+{
+    return &_renderOrders[0];
+}
+
+const Core::csmVector2* CubismDrawableSnapshot::GetVertexPositions(csmInt32 drawableIndex) const
+{
+    return &_vertexPositions[_vertexOffsets[drawableIndex]];
+}
+
+csmFloat32 CubismDrawableSnapshot::GetOpacity(csmInt32 drawableIndex) const
+{
+    return _opacities[drawableIndex];
+}
+
+Core::csmFlags CubismDrawableSnapshot::GetDynamicFlags(csmInt32 drawableIndex) const
+{
+    return _dynamicFlags[drawableIndex];
+}
+
+Core::csmVector4 CubismDrawableSnapshot::GetMultiplyColor(csmInt32 drawableIndex) const
+{
+    return _multiplyColors[drawableIndex];
+}
+
+Core::csmVector4 CubismDrawableSnapshot::GetScreenColor(csmInt32 drawableIndex) const
+{
+    return _screenColors[drawableIndex];
+}
+
+}}}
@@ -0,0 +1,117 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+#include "Type/csmVector.hpp"
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+class CubismModel;
+
+/**
+ * @brief Drawableの動的データのスナップショット
+ *
+ * CubismModel::Update()後の頂点座標・不透明度・描画順・動的フラグ・乗算色・スクリーン色をコピーして保持する。<br>
+ * CubismModel::SetDrawableSnapshot()で設定すると、描画側はモデル本体の代わりにこの内容を読むため、
+ * 別スレッドで次のフレームのUpdate()を進めながら描画できる。<br>
+ * 静的なデータ（頂点インデックス、UV、マスク、テクスチャ番号など）はモデル本体から読む。
+ */
+class CubismDrawableSnapshot
+{
+public:
+    /**
+     * @brief コンストラクタ
+     */
+    CubismDrawableSnapshot();
+
+    /**
+     * @brief デストラクタ
+     */
+    virtual ~CubismDrawableSnapshot();
+
+    /**
+     * @brief モデルの現在の動的データをコピーする
+     *
+     * モデルのUpdate()と同じスレッドで呼ぶ。モデルに設定されているスナップショットではなく、常にモデル本体から読む。
+     *
+     * @param[in]   model   コピー元のモデル
+     */
+    void Capture(const CubismModel& model);
+
+    /**
+     * @brief すべてのDrawableの変化フラグを立てる
+     *
+     * 途中のスナップショットを読み飛ばした場合に呼ぶ。
+     * 読み飛ばした分の変化を失わないよう、描画側にすべて変化したものとして扱わせる。
+     */
+    void MarkAllChanged();
+
+    /**
+     * @brief 一度でもCaptureされたか
+     *
+     * @retval  true    Capture済み
+     * @retval  false   未Capture
+     */
+    csmBool IsCaptured() const;
+
+    /**
+     * @brief Drawableの描画順リストの取得
+     */
+    const csmInt32* GetRenderOrders() const;
+
+    /**
+     * @brief Drawableの頂点リストの取得
+     *
+     * @param[in]   drawableIndex   Drawableのインデックス
+     */
+    const Core::csmVector2* GetVertexPositions(csmInt32 drawableIndex) const;
+
+    /**
+     * @brief Drawableの不透明度の取得
+     *
+     * @param[in]   drawableIndex   Drawableのインデックス
+     */
+    csmFloat32 GetOpacity(csmInt32 drawableIndex) const;
+
+    /**
+     * @brief Drawableの動的フラグの取得
+     *
+     * @param[in]   drawableIndex   Drawableのインデックス
+     */
+    Core::csmFlags GetDynamicFlags(csmInt32 drawableIndex) const;
+
+    /**
+     * @brief Drawableの乗算色の取得
+     *
+     * @param[in]   drawableIndex   Drawableのインデックス
+     */
+    Core::csmVector4 GetMultiplyColor(csmInt32 drawableIndex) const;
+
+    /**
+     * @brief Drawableのスクリーン色の取得
+     *
+     * @param[in]   drawableIndex   Drawableのインデックス
+     */
+    Core::csmVector4 GetScreenColor(csmInt32 drawableIndex) const;
+
+private:
+    //Prevention of copy Constructor
+    CubismDrawableSnapshot(const CubismDrawableSnapshot&);
+    CubismDrawableSnapshot& operator=(const CubismDrawableSnapshot&);
+
+    csmVector<csmInt32>         _vertexOffsets;     ///< Drawableごとの_vertexPositions内の開始位置（要素数はDrawable数+1）
+    csmVector<Core::csmVector2> _vertexPositions;   ///< 全Drawableの頂点座標を詰めたもの
+    csmVector<csmInt32>         _renderOrders;      ///< 描画順
+    csmVector<csmFloat32>       _opacities;         ///< 不透明度
+    csmVector<Core::csmFlags>   _dynamicFlags;      ///< 動的フラグ
+    csmVector<Core::csmVector4> _multiplyColors;    ///< 乗算色
+    csmVector<Core::csmVector4> _screenColors;      ///< スクリーン色
+};
+
+}}}
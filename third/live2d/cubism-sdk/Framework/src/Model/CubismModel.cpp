@@ -6,6 +6,7 @@
  */
 
 #include "CubismModel.hpp"
+#include "CubismDrawableSnapshot.hpp"
 #include "Rendering/CubismRenderer.hpp"
 #include "Id/CubismId.hpp"
 #include "Id/CubismIdManager.hpp"
@@ -17,6 +18,17 @@ static csmInt32 IsBitSet(const csmUint8 byte, const csmUint8 mask)
     return ((byte & mask) == mask);
 }
 
+/**
+ * @brief IDハンドルのハッシュ値
+ *
+ * IDはCubismIdManagerで一意化されたポインタなので、アドレスそのものをキーにする。
+ */
+static csmUint32 HashIdHandle(CubismIdHandle id)
+{
+    const csmUint64 key = static_cast<csmUint64>(reinterpret_cast<csmSizeType>(id)) >> 3;
+    return static_cast<csmUint32>((key * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
 CubismModel::CubismModel(Core::csmModel* model)
     : _model(model)
     , _parameterValues(NULL)
@@ -26,6 +38,7 @@ CubismModel::CubismModel(Core::csmModel* model)
     , _isOverwrittenModelMultiplyColors(false)
     , _isOverwrittenModelScreenColors(false)
     , _isOverwrittenCullings(false)
+    , _drawableSnapshot(NULL)
 { }
 
 CubismModel::~CubismModel()
@@ -158,17 +171,10 @@ csmFloat32 CubismModel::GetParameterMinimumValue(csmUint32 parameterIndex) const
 
 csmInt32 CubismModel::GetParameterIndex(CubismIdHandle parameterId)
 {
-    csmInt32            parameterIndex;
-    const csmInt32      idCount = Core::csmGetParameterCount(_model);
+    csmInt32 parameterIndex = FindIdIndex(_parameterIndexTable, parameterId);
 
-
-    for (parameterIndex = 0; parameterIndex < idCount; ++parameterIndex)
+    if (parameterIndex >= 0)
     {
-        if (parameterId != _parameterIds[parameterIndex])
-        {
-            continue;
-        }
-
         return parameterIndex;
     }
 
@@ -330,15 +336,11 @@ const csmFloat32* CubismModel::GetDrawableVertices(csmInt32 drawableIndex) const
 
 csmInt32 CubismModel::GetPartIndex(CubismIdHandle partId)
 {
-    csmInt32            partIndex;
-    const csmInt32      idCount = Core::csmGetPartCount(_model);
+    csmInt32 partIndex = FindIdIndex(_partIndexTable, partId);
 
-    for (partIndex = 0; partIndex < idCount; ++partIndex)
+    if (partIndex >= 0)
     {
-        if (partId == _partIds[partIndex])
-        {
-            return partIndex;
-        }
+        return partIndex;
     }
 
     const csmInt32 partCount = Core::csmGetPartCount(_model);
@@ -389,6 +391,10 @@ void CubismModel::Initialize()
         }
     }
 
+    // ID→インデックスの検索表。毎フレームのID指定の操作を線形探索にしないため、ロード時に一度だけ作る
+    BuildIdIndexTable(_parameterIds, _parameterIndexTable);
+    BuildIdIndexTable(_partIds, _partIndexTable);
+
     {
         const csmChar** drawableIds = Core::csmGetDrawableIds(_model);
         const csmInt32  drawableCount = Core::csmGetDrawableCount(_model);
@@ -434,6 +440,64 @@ void CubismModel::Initialize()
     }
 }
 
+void CubismModel::BuildIdIndexTable(const csmVector<CubismIdHandle>& ids, csmVector<IdIndexEntry>& table)
+{
+    // 負荷率を1/2以下に保つ2のべき乗サイズ
+    csmUint32 capacity = 8;
+    while (capacity < ids.GetSize() * 2)
+    {
+        capacity <<= 1;
+    }
+
+    IdIndexEntry empty;
+    empty.Id = NULL;
+    empty.Index = -1;
+
+    table.Clear();
+    table.Resize(static_cast<csmInt32>(capacity), empty);
+
+    const csmUint32 mask = capacity - 1;
+    for (csmUint32 i = 0; i < ids.GetSize(); ++i)
+    {
+        csmUint32 slot = HashIdHandle(ids[i]) & mask;
+        while (table[slot].Id != NULL && table[slot].Id != ids[i])
+        {
+            slot = (slot + 1) & mask;
+        }
+
+        // 同じIDが重複していた場合は線形探索と同じく先頭のインデックスを残す
+        if (table[slot].Id == NULL)
+        {
+            table[slot].Id = ids[i];
+            table[slot].Index = static_cast<csmInt32>(i);
+        }
+    }
+}
+
+csmInt32 CubismModel::FindIdIndex(const csmVector<IdIndexEntry>& table, CubismIdHandle id)
+{
+    if (table.GetSize() == 0 || id == NULL)
+    {
+        return -1;
+    }
+
+    const csmUint32 mask = table.GetSize() - 1;
+    csmUint32 slot = HashIdHandle(id) & mask;
+    for (;;)
+    {
+        const IdIndexEntry& entry = table[slot];
+        if (entry.Id == id)
+        {
+            return entry.Index;
+        }
+        if (entry.Id == NULL)
+        {
+            return -1;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
 CubismIdHandle CubismModel::GetDrawableId(csmInt32 drawableIndex) const
 {
     const csmChar** parameterIds = Core::csmGetDrawableIds(_model);
@@ -448,6 +512,11 @@ csmInt32 CubismModel::GetPartCount() const
 
 const csmInt32* CubismModel::GetDrawableRenderOrders() const
 {
+    if (_drawableSnapshot != NULL)
+    {
+        return _drawableSnapshot->GetRenderOrders();
+    }
+
     const csmInt32* renderOrders = Core::csmGetDrawableRenderOrders(_model);
     return renderOrders;
 }
@@ -489,6 +558,11 @@ const csmUint16* CubismModel::GetDrawableVertexIndices(csmInt32 drawableIndex) c
 
 const Core::csmVector2* CubismModel::GetDrawableVertexPositions(csmInt32 drawableIndex) const
 {
+    if (_drawableSnapshot != NULL)
+    {
+        return _drawableSnapshot->GetVertexPositions(drawableIndex);
+    }
+
     const Core::csmVector2** verticesArray = Core::csmGetDrawableVertexPositions(_model);
     return verticesArray[drawableIndex];
 }
@@ -501,18 +575,33 @@ const Core::csmVector2* CubismModel::GetDrawableVertexUvs(csmInt32 drawableIndex
 
 csmFloat32 CubismModel::GetDrawableOpacity(csmInt32 drawableIndex) const
 {
+    if (_drawableSnapshot != NULL)
+    {
+        return _drawableSnapshot->GetOpacity(drawableIndex);
+    }
+
     const csmFloat32* opacities = Core::csmGetDrawableOpacities(_model);
     return opacities[drawableIndex];
 }
 
 Core::csmVector4 CubismModel::GetDrawableMultiplyColor(csmInt32 drawableIndex) const
 {
+    if (_drawableSnapshot != NULL)
+    {
+        return _drawableSnapshot->GetMultiplyColor(drawableIndex);
+    }
+
     const Core::csmVector4* multiplyColors = Core::csmGetDrawableMultiplyColors(_model);
     return multiplyColors[drawableIndex];
 }
 
 Core::csmVector4 CubismModel::GetDrawableScreenColor(csmInt32 drawableIndex) const
 {
+    if (_drawableSnapshot != NULL)
+    {
+        return _drawableSnapshot->GetScreenColor(drawableIndex);
+    }
+
     const Core::csmVector4* screenColors = Core::csmGetDrawableScreenColors(_model);
     return screenColors[drawableIndex];
 }
@@ -522,46 +611,49 @@ csmInt32 CubismModel::GetDrawableParentPartIndex(csmUint32 drawableIndex) const
     return Core::csmGetDrawableParentPartIndices(_model)[drawableIndex];
 }
 
+csmUint8 CubismModel::GetDrawableDynamicFlags(csmInt32 drawableIndex) const
+{
+    if (_drawableSnapshot != NULL)
+    {
+        return _drawableSnapshot->GetDynamicFlags(drawableIndex);
+    }
+
+    return Core::csmGetDrawableDynamicFlags(_model)[drawableIndex];
+}
+
 csmBool CubismModel::GetDrawableDynamicFlagIsVisible(csmInt32 drawableIndex) const
 {
-    const Core::csmFlags* dynamicFlags = Core::csmGetDrawableDynamicFlags(_model);
-    return IsBitSet(dynamicFlags[drawableIndex], Core::csmIsVisible)!=0 ? true : false;
+    return IsBitSet(GetDrawableDynamicFlags(drawableIndex), Core::csmIsVisible)!=0 ? true : false;
 }
 
 csmBool CubismModel::GetDrawableDynamicFlagVisibilityDidChange(csmInt32 drawableIndex) const
 {
-    const Core::csmFlags* dynamicFlags = Core::csmGetDrawableDynamicFlags(_model);
-    return IsBitSet(dynamicFlags[drawableIndex], Core::csmVisibilityDidChange)!=0 ? true : false;
+    return IsBitSet(GetDrawableDynamicFlags(drawableIndex), Core::csmVisibilityDidChange)!=0 ? true : false;
 }
 
 csmBool CubismModel::GetDrawableDynamicFlagOpacityDidChange(csmInt32 drawableIndex) const
 {
-    const Core::csmFlags* dynamicFlags = Core::csmGetDrawableDynamicFlags(_model);
-    return IsBitSet(dynamicFlags[drawableIndex], Core::csmOpacityDidChange) != 0 ? true : false;
+    return IsBitSet(GetDrawableDynamicFlags(drawableIndex), Core::csmOpacityDidChange) != 0 ? true : false;
 }
 
 csmBool CubismModel::GetDrawableDynamicFlagDrawOrderDidChange(csmInt32 drawableIndex) const
 {
-    const Core::csmFlags* dynamicFlags = Core::csmGetDrawableDynamicFlags(_model);
-    return IsBitSet(dynamicFlags[drawableIndex], Core::csmDrawOrderDidChange) != 0 ? true : false;
+    return IsBitSet(GetDrawableDynamicFlags(drawableIndex), Core::csmDrawOrderDidChange) != 0 ? true : false;
 }
 
 csmBool CubismModel::GetDrawableDynamicFlagRenderOrderDidChange(csmInt32 drawableIndex) const
 {
-    const Core::csmFlags* dynamicFlags = Core::csmGetDrawableDynamicFlags(_model);
-    return IsBitSet(dynamicFlags[drawableIndex], Core::csmRenderOrderDidChange) != 0 ? true : false;
+    return IsBitSet(GetDrawableDynamicFlags(drawableIndex), Core::csmRenderOrderDidChange) != 0 ? true : false;
 }
 
 csmBool CubismModel::GetDrawableDynamicFlagVertexPositionsDidChange(csmInt32 drawableIndex) const
 {
-    const Core::csmFlags* dynamicFlags = Core::csmGetDrawableDynamicFlags(_model);
-    return IsBitSet(dynamicFlags[drawableIndex], Core::csmVertexPositionsDidChange) != 0 ? true : false;
+    return IsBitSet(GetDrawableDynamicFlags(drawableIndex), Core::csmVertexPositionsDidChange) != 0 ? true : false;
 }
 
 csmBool CubismModel::GetDrawableDynamicFlagBlendColorDidChange(csmInt32 drawableIndex) const
 {
-    const Core::csmFlags* dynamicFlags = Core::csmGetDrawableDynamicFlags(_model);
-    return IsBitSet(dynamicFlags[drawableIndex], Core::csmBlendColorDidChange) != 0 ? true : false;
+    return IsBitSet(GetDrawableDynamicFlags(drawableIndex), Core::csmBlendColorDidChange) != 0 ? true : false;
 }
 
 Rendering::CubismRenderer::CubismBlendMode CubismModel::GetDrawableBlendMode(csmInt32 drawableIndex) const
@@ -756,6 +848,16 @@ Core::csmModel* CubismModel::GetModel() const
     return _model;
 }
 
+void CubismModel::SetDrawableSnapshot(const CubismDrawableSnapshot* snapshot)
+{
+    _drawableSnapshot = snapshot;
+}
+
+const CubismDrawableSnapshot* CubismModel::GetDrawableSnapshot() const
+{
+    return _drawableSnapshot;
+}
+
 csmBool CubismModel::IsUsingMasking() const
 {
     for (csmInt32 d = 0; d < Core::csmGetDrawableCount(_model); ++d)
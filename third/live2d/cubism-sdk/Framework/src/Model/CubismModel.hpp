@@ -16,6 +16,7 @@
 namespace Live2D { namespace Cubism { namespace Framework {
 
 class CubismMoc;
+class CubismDrawableSnapshot;
 
 /**
  * @brief モデル
@@ -774,6 +775,24 @@ public:
 
     Core::csmModel*     GetModel() const;
 
+    /**
+     * @brief Drawableの動的データの読み出し元を設定する
+     *
+     * 設定している間、頂点座標・不透明度・描画順・動的フラグ・乗算色・スクリーン色の取得関数は
+     * モデル本体ではなくスナップショットを返す。別スレッドでUpdate()を進めながら描画するときに使う。<br>
+     * スナップショットの寿命は呼び出し側で管理する。NULLを設定するとモデル本体から読む。
+     *
+     * @param[in]   snapshot    読み出し元のスナップショット。NULLで解除
+     */
+    void SetDrawableSnapshot(const CubismDrawableSnapshot* snapshot);
+
+    /**
+     * @brief Drawableの動的データの読み出し元を取得する
+     *
+     * @return  設定中のスナップショット。未設定ならNULL
+     */
+    const CubismDrawableSnapshot* GetDrawableSnapshot() const;
+
 private:
     /**
      * @brief コンストラクタ
@@ -802,6 +821,44 @@ private:
      */
     void Initialize();
 
+    /**
+     * @brief Drawableの動的フラグの取得
+     *
+     * スナップショットが設定されていればそちらから読む。
+     *
+     * @param[in]   drawableIndex   Drawableのインデックス
+     * @return  Drawableの動的フラグ
+     */
+    csmUint8 GetDrawableDynamicFlags(csmInt32 drawableIndex) const;
+
+    /**
+     * @brief ID→インデックス検索表の要素
+     */
+    struct IdIndexEntry
+    {
+        CubismIdHandle  Id;         ///< ID。NULLなら空き
+        csmInt32        Index;      ///< モデル内のインデックス
+    };
+
+    /**
+     * @brief ID→インデックス検索表の作成
+     *
+     * オープンアドレス法のハッシュ表を作る。
+     *
+     * @param[in]   ids     モデルが持つIDのリスト
+     * @param[out]  table   作成した検索表
+     */
+    static void BuildIdIndexTable(const csmVector<CubismIdHandle>& ids, csmVector<IdIndexEntry>& table);
+
+    /**
+     * @brief ID→インデックス検索表の検索
+     *
+     * @param[in]   table   検索表
+     * @param[in]   id      検索するID
+     * @return  モデル内のインデックス。無ければ-1
+     */
+    static csmInt32 FindIdIndex(const csmVector<IdIndexEntry>& table, CubismIdHandle id);
+
     csmMap<csmInt32, csmFloat32>        _notExistPartOpacities;             ///< 存在していないパーツの不透明度のリスト
     csmMap<CubismIdHandle, csmInt32>   _notExistPartId;                    ///< 存在していないパーツIDのリスト
 
@@ -821,12 +878,15 @@ private:
     csmVector<CubismIdHandle> _parameterIds;
     csmVector<CubismIdHandle> _partIds;
     csmVector<CubismIdHandle> _drawableIds;
+    csmVector<IdIndexEntry> _parameterIndexTable; ///< パラメータID→インデックスの検索表
+    csmVector<IdIndexEntry> _partIndexTable; ///< パーツID→インデックスの検索表
     csmVector<DrawableColorData> _userScreenColors; ///< 乗算色の配列
     csmVector<DrawableColorData> _userMultiplyColors; ///< スクリーン色の配列
     csmVector<DrawableCullingData> _userCullings; ///< カリング設定の配列
     csmBool _isOverwrittenModelMultiplyColors; ///< 乗算色を全て上書きするか？
     csmBool _isOverwrittenModelScreenColors; ///< スクリーン色を全て上書きするか？
     csmBool _isOverwrittenCullings; ///< モデルのカリング設定をすべて上書きするか？
+    const CubismDrawableSnapshot* _drawableSnapshot; ///< 動的データの読み出し元。NULLならモデル本体
 };
 
 }}}
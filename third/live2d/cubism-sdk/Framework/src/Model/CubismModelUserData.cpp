@@ -47,6 +47,13 @@ void CubismModelUserData::ParseUserData(const csmByte* buffer, const csmSizeInt
 {
     CubismModelUserDataJson* json = CSM_NEW CubismModelUserDataJson(buffer, size);
 
+    if (!json->IsValid())
+    {
+        // 壊れたJSONはユーザーデータの無いモデルとして扱う
+        CSM_DELETE(json);
+        return;
+    }
+
     const ModelUserDataType typeOfArtMesh = CubismFramework::GetIdManager()->GetId(ArtMesh);
 
     const csmUint32 nodeCount = json->GetUserDataCount();
@@ -8,7 +8,7 @@
 #pragma once
 
 #include "CubismJsonHolder.hpp"
-#include "Utils/CubismJson.hpp"
+#include "Utils/CubismJsonTape.hpp"
 #include "Model/CubismModel.hpp"
 #include "Id/CubismIdManager.hpp"
 
@@ -25,6 +25,7 @@ const csmFloat32 DefaultFadeTime = 1.0f;
 }
 
 CubismExpressionMotion::CubismExpressionMotion()
+    : _boundModel(NULL)
 { }
 
 CubismExpressionMotion::~CubismExpressionMotion()
@@ -34,8 +35,13 @@ CubismExpressionMotion* CubismExpressionMotion::Create(const csmByte* buffer, cs
 {
     CubismExpressionMotion* expression = CSM_NEW CubismExpressionMotion();
 
-    Utils::CubismJson* json = Utils::CubismJson::Create(buffer, size);
-    Utils::Value& root = json->GetRoot();
+    Utils::CubismJsonTape* json = Utils::CubismJsonTape::Create(buffer, size);
+    if (json == NULL)
+    {
+        // 壊れたJSONは何も変化させない表情として扱う
+        return expression;
+    }
+    const Utils::CubismJsonNode root = json->GetRoot();
 
     expression->SetFadeInTime(root[ExpressionKeyFadeIn].ToFloat(DefaultFadeTime));   // フェードイン
     expression->SetFadeOutTime(root[ExpressionKeyFadeOut].ToFloat(DefaultFadeTime)); // フェードアウト
@@ -46,22 +52,22 @@ CubismExpressionMotion* CubismExpressionMotion::Create(const csmByte* buffer, cs
 
     for (csmInt32 i = 0; i < parameterCount; ++i)
     {
-        Utils::Value& param = root[ExpressionKeyParameters][i];
+        const Utils::CubismJsonNode param = root[ExpressionKeyParameters][i];
         const CubismIdHandle parameterId = CubismFramework::GetIdManager()->GetId(param[ExpressionKeyId].GetRawString()); // パラメータID
         const csmFloat32 value = static_cast<csmFloat32>(param[ExpressionKeyValue].ToFloat());   // 値
 
         // 計算方法の設定
         ExpressionBlendType blendType;
 
-        if (param[ExpressionKeyBlend].IsNull() || param[ExpressionKeyBlend].GetString() == BlendValueAdd)
+        if (param[ExpressionKeyBlend].IsNull() || param[ExpressionKeyBlend].Equals(BlendValueAdd))
         {
             blendType = ExpressionBlendType_Add;
         }
-        else if (param[ExpressionKeyBlend].GetString() == BlendValueMultiply)
+        else if (param[ExpressionKeyBlend].Equals(BlendValueMultiply))
         {
             blendType = ExpressionBlendType_Multiply;
         }
-        else if (param[ExpressionKeyBlend].GetString() == BlendValueOverwrite)
+        else if (param[ExpressionKeyBlend].Equals(BlendValueOverwrite))
         {
             blendType = ExpressionBlendType_Overwrite;
         }
@@ -75,19 +81,30 @@ CubismExpressionMotion* CubismExpressionMotion::Create(const csmByte* buffer, cs
         ExpressionParameter item;
 
         item.ParameterId = parameterId;
+        item.ParameterIndex = -1;
         item.BlendType   = blendType;
         item.Value       = value;
 
         expression->_parameters.PushBack(item);
     }
 
-    Utils::CubismJson::Delete(json); // JSONデータは不要になったら削除する
+    Utils::CubismJsonTape::Delete(json); // JSONデータは不要になったら削除する
 
     return expression;
 }
 
 void CubismExpressionMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSeconds, csmFloat32 weight, CubismMotionQueueEntry* motionQueueEntry)
 {
+    // 対象モデルが変わった時だけパラメータのインデックスを解決し直す
+    if (_boundModel != model)
+    {
+        for (csmUint32 i = 0; i < _parameters.GetSize(); ++i)
+        {
+            _parameters[i].ParameterIndex = model->GetParameterIndex(_parameters[i].ParameterId);
+        }
+        _boundModel = model;
+    }
+
     for (csmUint32 i = 0; i < _parameters.GetSize(); ++i)
     {
         ExpressionParameter& parameter = _parameters[i];
@@ -95,15 +112,15 @@ void CubismExpressionMotion::DoUpdateParameters(CubismModel* model, csmFloat32 u
         switch (parameter.BlendType)
         {
         case ExpressionBlendType_Add: {
-            model->AddParameterValue(parameter.ParameterId, parameter.Value, weight);            // 相対変化 加算
+            model->AddParameterValue(parameter.ParameterIndex, parameter.Value, weight);         // 相対変化 加算
             break;
         }
         case ExpressionBlendType_Multiply: {
-            model->MultiplyParameterValue(parameter.ParameterId, parameter.Value, weight);       // 相対変化 乗算
+            model->MultiplyParameterValue(parameter.ParameterIndex, parameter.Value, weight);    // 相対変化 乗算
             break;
         }
         case ExpressionBlendType_Overwrite: {
-            model->SetParameterValue(parameter.ParameterId, parameter.Value, weight);            // 絶対変化 上書き
+            model->SetParameterValue(parameter.ParameterIndex, parameter.Value, weight);         // 絶対変化 上書き
             break;
         }
         default:
@@ -8,7 +8,7 @@
 #pragma once
 
 #include "ACubismMotion.hpp"
-#include "Utils/CubismJson.hpp"
+#include "Utils/CubismJsonTape.hpp"
 #include "Model/CubismModel.hpp"
 
 namespace Live2D { namespace Cubism { namespace Framework {
@@ -41,6 +41,7 @@ public:
     struct ExpressionParameter
     {
         CubismIdHandle      ParameterId;        ///< パラメータID
+        csmInt32            ParameterIndex;     ///< 対象モデルでのパラメータのインデックス
         ExpressionBlendType BlendType;          ///< パラメータの演算種類
         csmFloat32          Value;              ///< 値
     };
@@ -73,6 +74,7 @@ private:
     virtual ~CubismExpressionMotion();
 
     csmVector<ExpressionParameter> _parameters;         ///< 表情のパラメータ情報リスト
+    const CubismModel*             _boundModel;         ///< パラメータのインデックスを解決したモデル
 };
 
 }}}
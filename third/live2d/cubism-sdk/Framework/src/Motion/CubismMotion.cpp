@@ -7,6 +7,7 @@
 
 #include "CubismMotion.hpp"
 #include <float.h>
+#include <string.h>
 #include "CubismFramework.hpp"
 #include "CubismMotionInternal.hpp"
 #include "CubismMotionJson.hpp"
@@ -187,45 +188,206 @@ csmFloat32 InverseSteppedEvaluate(const CubismMotionPoint* points, const csmFloa
     return points[1].Value;
 }
 
-csmFloat32 EvaluateCurve(const CubismMotionData* motionData, const csmInt32 index, csmFloat32 time)
+/**
+ * 終点の時間が time を超える最初のセグメントを [begin, end) から二分探索する。無ければ end を返す
+ */
+csmInt32 FindSegment(const csmFloat32* endTimes, csmInt32 begin, csmInt32 end, const csmFloat32 time)
+{
+    while (begin < end)
+    {
+        const csmInt32 middle = begin + (end - begin) / 2;
+        if (endTimes[middle] > time)
+        {
+            end = middle;
+        }
+        else
+        {
+            begin = middle + 1;
+        }
+    }
+    return begin;
+}
+
+/**
+ * カーブの評価。cursor には前回評価したセグメントを渡し、今回評価したセグメントが返る
+ */
+csmFloat32 EvaluateCurve(const CubismMotionData* motionData, const csmInt32 index, csmFloat32 time, csmInt32& cursor)
 {
     // Find segment to evaluate.
     const CubismMotionCurve& curve = motionData->Curves[index];
+    const csmInt32 segmentCount = curve.SegmentCount;
 
-    csmInt32 target = -1;
-    const csmInt32 totalSegmentCount = curve.BaseSegmentIndex + curve.SegmentCount;
-    csmInt32 pointPosition = 0;
-    for (csmInt32 i = curve.BaseSegmentIndex; i < totalSegmentCount; ++i)
+    if (segmentCount <= 0)
     {
-        // Get first point of next segment.
-        pointPosition = motionData->Segments[i].BasePointIndex
-            + (motionData->Segments[i].SegmentType == CubismMotionSegmentType_Bezier
-                ? 3
-                : 1);
+        return motionData->Points[0].Value;
+    }
+
+    const csmFloat32* endTimes = &motionData->SegmentEndTimes[curve.BaseSegmentIndex];
+    csmInt32 target;
 
+    if (!curve.IsSegmentEndTimeSorted)
+    {
+        // 終点の時間が前後するカーブは先頭から順に探す
+        for (target = 0; target < segmentCount && !(endTimes[target] > time); ++target)
+        { }
+    }
+    else
+    {
+        // 再生中は時間が単調に進むので、ほとんどは前回と同じセグメントかその次になる
+        const csmInt32 last = (cursor < 0 || cursor >= segmentCount) ? 0 : cursor;
 
-        // Break if time lies within current segment.
-        if (motionData->Points[pointPosition].Time > time)
+        if (endTimes[last] > time)
         {
-            target = i;
-            break;
+            // 巻き戻った（ループ、シーク）場合は前方を二分探索
+            target = (last == 0 || endTimes[last - 1] <= time) ? last : FindSegment(endTimes, 0, last, time);
+        }
+        else if (last + 1 < segmentCount && endTimes[last + 1] > time)
+        {
+            target = last + 1;
+        }
+        else
+        {
+            target = FindSegment(endTimes, last + 1, segmentCount, time);
         }
     }
 
 
-    if (target == -1)
+    if (target >= segmentCount)
     {
+        // Past the last segment: hold the last point.
+        cursor = segmentCount - 1;
+
+        const CubismMotionSegment& lastSegment = motionData->Segments[curve.BaseSegmentIndex + segmentCount - 1];
+        const csmInt32 pointPosition = lastSegment.BasePointIndex
+            + (lastSegment.SegmentType == CubismMotionSegmentType_Bezier
+                ? 3
+                : 1);
+
         return motionData->Points[pointPosition].Value;
     }
 
+    cursor = target;
 
-    const CubismMotionSegment& segment = motionData->Segments[target];
+    const CubismMotionSegment& segment = motionData->Segments[curve.BaseSegmentIndex + target];
 
     return segment.Evaluate(&motionData->Points[segment.BasePointIndex], time);
 }
 
+/**
+ * バイナリ形式（すべてネイティブのバイトオーダー）:
+ *   MotionBinaryHeader | MotionBinaryCurve × CurveCount | MotionBinarySegment × SegmentCount
+ *   | CubismMotionPoint × PointCount | MotionBinaryEvent × EventCount | 文字列表（ID、イベント値）
+ */
+const csmUint32 MotionBinaryMagic = 0x31424D43;     // "CMB1"
+
+struct MotionBinaryHeader
+{
+    csmUint32 Magic;
+    csmUint32 Version;
+    csmFloat32 Duration;
+    csmFloat32 Fps;
+    csmFloat32 FadeInSeconds;
+    csmFloat32 FadeOutSeconds;
+    csmInt32 Loop;
+    csmInt32 CurveCount;
+    csmInt32 SegmentCount;
+    csmInt32 PointCount;
+    csmInt32 EventCount;
+    csmUint32 StringsSize;
+};
+
+struct MotionBinaryCurve
+{
+    csmInt32 Type;
+    csmUint32 IdOffset;
+    csmUint32 IdLength;
+    csmInt32 SegmentCount;
+    csmInt32 BaseSegmentIndex;
+    csmFloat32 FadeInTime;
+    csmFloat32 FadeOutTime;
+};
+
+struct MotionBinarySegment
+{
+    csmInt32 BasePointIndex;
+    csmInt32 SegmentType;
+    csmInt32 Evaluator;     ///< MotionBinaryEvaluator
+};
+
+struct MotionBinaryEvent
+{
+    csmFloat32 FireTime;
+    csmUint32 ValueOffset;
+    csmUint32 ValueLength;
+};
+
+/// 評価関数はポインタで保存できないので番号に置き換える
+enum MotionBinaryEvaluator
+{
+    MotionBinaryEvaluator_Linear = 0,
+    MotionBinaryEvaluator_Bezier,
+    MotionBinaryEvaluator_BezierCardano,
+    MotionBinaryEvaluator_Stepped,
+    MotionBinaryEvaluator_InverseStepped,
+    MotionBinaryEvaluator_Count
+};
+
+const csmMotionSegmentEvaluationFunction MotionBinaryEvaluators[MotionBinaryEvaluator_Count] =
+{
+    LinearEvaluate,
+    BezierEvaluate,
+    BezierEvaluateCardanoInterpretation,
+    SteppedEvaluate,
+    InverseSteppedEvaluate,
+};
+
+/// 評価関数が前提とするセグメントの種類。ベジェの評価関数は制御点を含む4点を読む
+const csmInt32 MotionBinaryEvaluatorSegmentTypes[MotionBinaryEvaluator_Count] =
+{
+    CubismMotionSegmentType_Linear,
+    CubismMotionSegmentType_Bezier,
+    CubismMotionSegmentType_Bezier,
+    CubismMotionSegmentType_Stepped,
+    CubismMotionSegmentType_InverseStepped,
+};
+
+/// セグメントが参照するポイント数（ベジェは始点と制御点2つと終点）
+csmInt32 GetSegmentPointCount(csmInt32 segmentType)
+{
+    return segmentType == CubismMotionSegmentType_Bezier ? 4 : 2;
+}
+
+/// セグメントの終点の時間を連続した配列に集め、カーブごとに昇順かどうかを調べる
+void BuildSegmentEndTimes(CubismMotionData* motionData)
+{
+    const csmInt32 segmentCount = static_cast<csmInt32>(motionData->Segments.GetSize());
+    motionData->SegmentEndTimes.UpdateSize(segmentCount, 0.0f, true);
+    for (csmInt32 i = 0; i < segmentCount; ++i)
+    {
+        const CubismMotionSegment& segment = motionData->Segments[i];
+        motionData->SegmentEndTimes[i] = motionData->Points[segment.BasePointIndex + GetSegmentPointCount(segment.SegmentType) - 1].Time;
+    }
+
+    for (csmInt32 c = 0; c < motionData->CurveCount; ++c)
+    {
+        CubismMotionCurve& curve = motionData->Curves[c];
+        curve.IsSegmentEndTimeSorted = true;
+        for (csmInt32 i = 1; i < curve.SegmentCount; ++i)
+        {
+            // NaN を含む場合も順に探す
+            if (!(motionData->SegmentEndTimes[curve.BaseSegmentIndex + i - 1] <= motionData->SegmentEndTimes[curve.BaseSegmentIndex + i]))
+            {
+                curve.IsSegmentEndTimeSorted = false;
+                break;
+            }
+        }
+    }
+}
+
 }
 
+const csmUint32 CubismMotion::BinaryFormatVersion = 1;
+
 CubismMotion::CubismMotion()
     : _sourceFrameRate(30.0f)
     , _loopDurationSeconds(-1.0f)
@@ -235,7 +397,12 @@ CubismMotion::CubismMotion()
     , _motionData(NULL)
     , _modelCurveIdEyeBlink(NULL)
     , _modelCurveIdLipSync(NULL)
-{ }
+    , _boundModel(NULL)
+{
+    // 読み込み時に解決しておき、更新中にIDを登録しない
+    _modelCurveIdEyeBlink = CubismFramework::GetIdManager()->GetId(EffectNameEyeBlink);
+    _modelCurveIdLipSync = CubismFramework::GetIdManager()->GetId(EffectNameLipSync);
+}
 
 CubismMotion::~CubismMotion()
 {
@@ -246,7 +413,11 @@ CubismMotion* CubismMotion::Create(const csmByte* buffer, csmSizeInt size, Finis
 {
     CubismMotion* ret = CSM_NEW CubismMotion();
 
-    ret->Parse(buffer, size);
+    if (!ret->Parse(buffer, size))
+    {
+        ACubismMotion::Delete(ret);
+        return NULL;
+    }
     ret->_sourceFrameRate = ret->_motionData->Fps;
     ret->_loopDurationSeconds = ret->_motionData->Duration;
     ret->_onFinishedMotion = onFinishedMotionHandler;
@@ -257,21 +428,148 @@ CubismMotion* CubismMotion::Create(const csmByte* buffer, csmSizeInt size, Finis
     return ret;
 }
 
+CubismMotion* CubismMotion::CreateFromBinary(const csmByte* buffer, csmSizeInt size, FinishedMotionCallback onFinishedMotionHandler)
+{
+    CubismMotion* ret = CSM_NEW CubismMotion();
+
+    if (!ret->ParseBinary(buffer, size))
+    {
+        ACubismMotion::Delete(ret);
+        return NULL;
+    }
+    ret->_sourceFrameRate = ret->_motionData->Fps;
+    ret->_loopDurationSeconds = ret->_motionData->Duration;
+    ret->_onFinishedMotion = onFinishedMotionHandler;
+
+    return ret;
+}
+
+void CubismMotion::SerializeBinary(csmVector<csmByte>& out) const
+{
+    const CubismMotionData* data = _motionData;
+    const csmInt32 segmentCount = static_cast<csmInt32>(data->Segments.GetSize());
+    const csmInt32 pointCount = static_cast<csmInt32>(data->Points.GetSize());
+
+    // 文字列表の大きさを先に求める
+    csmUint32 stringsSize = 0;
+    for (csmInt32 i = 0; i < data->CurveCount; ++i)
+    {
+        stringsSize += data->Curves[i].Id->GetString().GetLength();
+    }
+    for (csmInt32 i = 0; i < data->EventCount; ++i)
+    {
+        stringsSize += data->Events[i].Value.GetLength();
+    }
+
+    const csmSizeInt curvesOffset = sizeof(MotionBinaryHeader);
+    const csmSizeInt segmentsOffset = curvesOffset + sizeof(MotionBinaryCurve) * data->CurveCount;
+    const csmSizeInt pointsOffset = segmentsOffset + sizeof(MotionBinarySegment) * segmentCount;
+    const csmSizeInt eventsOffset = pointsOffset + sizeof(CubismMotionPoint) * pointCount;
+    const csmSizeInt stringsOffset = eventsOffset + sizeof(MotionBinaryEvent) * data->EventCount;
+    out.UpdateSize(static_cast<csmInt32>(stringsOffset + stringsSize), 0, false);
+    csmByte* base = out.GetPtr();
+
+    MotionBinaryHeader header;
+    memset(&header, 0, sizeof(header));
+    header.Magic = MotionBinaryMagic;
+    header.Version = BinaryFormatVersion;
+    header.Duration = data->Duration;
+    header.Fps = data->Fps;
+    header.FadeInSeconds = _fadeInSeconds;
+    header.FadeOutSeconds = _fadeOutSeconds;
+    header.Loop = data->Loop;
+    header.CurveCount = data->CurveCount;
+    header.SegmentCount = segmentCount;
+    header.PointCount = pointCount;
+    header.EventCount = data->EventCount;
+    header.StringsSize = stringsSize;
+    memcpy(base, &header, sizeof(header));
+
+    csmUint32 stringPosition = 0;
+    for (csmInt32 i = 0; i < data->CurveCount; ++i)
+    {
+        const CubismMotionCurve& curve = data->Curves[i];
+        const csmString& id = curve.Id->GetString();
+        MotionBinaryCurve record;
+        record.Type = curve.Type;
+        record.IdOffset = stringPosition;
+        record.IdLength = id.GetLength();
+        record.SegmentCount = curve.SegmentCount;
+        record.BaseSegmentIndex = curve.BaseSegmentIndex;
+        record.FadeInTime = curve.FadeInTime;
+        record.FadeOutTime = curve.FadeOutTime;
+        memcpy(base + curvesOffset + sizeof(record) * i, &record, sizeof(record));
+        memcpy(base + stringsOffset + stringPosition, id.GetRawString(), id.GetLength());
+        stringPosition += id.GetLength();
+    }
+
+    for (csmInt32 i = 0; i < segmentCount; ++i)
+    {
+        const CubismMotionSegment& segment = data->Segments[i];
+        MotionBinarySegment record;
+        record.BasePointIndex = segment.BasePointIndex;
+        record.SegmentType = segment.SegmentType;
+        record.Evaluator = MotionBinaryEvaluator_Linear;
+        for (csmInt32 j = 0; j < MotionBinaryEvaluator_Count; ++j)
+        {
+            if (MotionBinaryEvaluators[j] == segment.Evaluate)
+            {
+                record.Evaluator = j;
+                break;
+            }
+        }
+        memcpy(base + segmentsOffset + sizeof(record) * i, &record, sizeof(record));
+    }
+
+    if (pointCount > 0)
+    {
+        memcpy(base + pointsOffset, &data->Points[0], sizeof(CubismMotionPoint) * pointCount);
+    }
+
+    for (csmInt32 i = 0; i < data->EventCount; ++i)
+    {
+        const CubismMotionEvent& event = data->Events[i];
+        MotionBinaryEvent record;
+        record.FireTime = event.FireTime;
+        record.ValueOffset = stringPosition;
+        record.ValueLength = event.Value.GetLength();
+        memcpy(base + eventsOffset + sizeof(record) * i, &record, sizeof(record));
+        memcpy(base + stringsOffset + stringPosition, event.Value.GetRawString(), event.Value.GetLength());
+        stringPosition += event.Value.GetLength();
+    }
+}
+
 csmFloat32 CubismMotion::GetDuration()
 {
     return _isLoop ? -1.0f : _loopDurationSeconds;
 }
 
-void CubismMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSeconds, csmFloat32 fadeWeight, CubismMotionQueueEntry* motionQueueEntry)
+void CubismMotion::BindModel(CubismModel* model)
 {
-    if (_modelCurveIdEyeBlink == NULL)
+    if (_boundModel == model && _curveParameterIndices.GetSize() == static_cast<csmUint32>(_motionData->CurveCount))
+    {
+        return;
+    }
+
+    // モデルに無いIDも非存在パラメータとしてインデックスが割り当てられるので、一度解決すれば毎フレーム同じ値になる
+    _curveParameterIndices.Clear();
+    _curveParameterIndices.PrepareCapacity(_motionData->CurveCount);
+    for (csmInt32 c = 0; c < _motionData->CurveCount; ++c)
     {
-        _modelCurveIdEyeBlink = CubismFramework::GetIdManager()->GetId(EffectNameEyeBlink);
+        const CubismMotionCurve& curve = _motionData->Curves[c];
+        _curveParameterIndices.PushBack(curve.Type == CubismMotionCurveTarget_Model ? -1 : model->GetParameterIndex(curve.Id));
     }
 
-    if (_modelCurveIdLipSync == NULL)
+    _boundModel = model;
+}
+
+void CubismMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSeconds, csmFloat32 fadeWeight, CubismMotionQueueEntry* motionQueueEntry)
+{
+    BindModel(model);
+
+    if (_curveSegmentCursors.GetSize() != static_cast<csmUint32>(_motionData->CurveCount))
     {
-        _modelCurveIdLipSync = CubismFramework::GetIdManager()->GetId(EffectNameLipSync);
+        _curveSegmentCursors.UpdateSize(_motionData->CurveCount, 0, true);
     }
 
     csmFloat32 timeOffsetSeconds = userTimeSeconds - motionQueueEntry->GetStartTime();
@@ -327,7 +625,7 @@ void CubismMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSec
     for (c = 0; c < _motionData->CurveCount && curves[c].Type == CubismMotionCurveTarget_Model; ++c)
     {
         // Evaluate curve and call handler.
-        value = EvaluateCurve(_motionData, c, time);
+        value = EvaluateCurve(_motionData, c, time, _curveSegmentCursors[c]);
 
         if (curves[c].Id == _modelCurveIdEyeBlink)
         {
@@ -346,7 +644,7 @@ void CubismMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSec
         parameterMotionCurveCount++;
 
         // Find parameter index.
-        parameterIndex = model->GetParameterIndex(curves[c].Id);
+        parameterIndex = _curveParameterIndices[c];
 
         // Skip curve evaluation if no value in sink.
         if (parameterIndex == -1)
@@ -357,7 +655,7 @@ void CubismMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSec
         const csmFloat32 sourceValue = model->GetParameterValue(parameterIndex);
 
         // Evaluate curve and apply value.
-        value = EvaluateCurve(_motionData, c, time);
+        value = EvaluateCurve(_motionData, c, time, _curveSegmentCursors[c]);
 
         if (eyeBlinkValue != FLT_MAX)
         {
@@ -468,7 +766,7 @@ void CubismMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSec
     for (; c < _motionData->CurveCount && curves[c].Type == CubismMotionCurveTarget_PartOpacity; ++c)
     {
         // Find parameter index.
-        parameterIndex = model->GetParameterIndex(curves[c].Id);
+        parameterIndex = _curveParameterIndices[c];
 
         // Skip curve evaluation if no value in sink.
         if (parameterIndex == -1)
@@ -477,7 +775,7 @@ void CubismMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSec
         }
 
         // Evaluate curve and apply value.
-        value = EvaluateCurve(_motionData, c, time);
+        value = EvaluateCurve(_motionData, c, time, _curveSegmentCursors[c]);
 
         model->SetParameterValue(parameterIndex, value);
     }
@@ -507,12 +805,18 @@ void CubismMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSec
     _lastWeight = fadeWeight;
 }
 
-void CubismMotion::Parse(const csmByte* motionJson, const csmSizeInt size)
+csmBool CubismMotion::Parse(const csmByte* motionJson, const csmSizeInt size)
 {
     _motionData = CSM_NEW CubismMotionData;
 
     CubismMotionJson* json = CSM_NEW CubismMotionJson(motionJson, size);
 
+    if (!json->IsValid())
+    {
+        CSM_DELETE(json);
+        return false;
+    }
+
     _motionData->Duration = json->GetMotionDuration();
     _motionData->Loop = json->IsMotionLoop();
     _motionData->CurveCount = json->GetMotionCurveCount();
@@ -543,9 +847,21 @@ void CubismMotion::Parse(const csmByte* motionJson, const csmSizeInt size)
         _fadeOutSeconds = 1.0f;
     }
 
+    // 各要素はJSON上で1バイト以上を占めるので、Metaの総数が負またはファイルより大きければ壊れている
+    const csmInt32 totalSegmentCapacity = json->GetMotionTotalSegmentCount();
+    const csmInt32 totalPointCapacity = json->GetMotionTotalPointCount();
+    if (_motionData->CurveCount < 0 || _motionData->EventCount < 0 || totalSegmentCapacity < 0 || totalPointCapacity < 0 ||
+        static_cast<csmSizeInt>(_motionData->CurveCount) > size || static_cast<csmSizeInt>(_motionData->EventCount) > size ||
+        static_cast<csmSizeInt>(totalSegmentCapacity) > size || static_cast<csmSizeInt>(totalPointCapacity) > size)
+    {
+        CubismLogError("Invalid motion3.json: the counts in Meta are out of range.");
+        CSM_DELETE(json);
+        return false;
+    }
+
     _motionData->Curves.UpdateSize(_motionData->CurveCount, CubismMotionCurve(), true);
-    _motionData->Segments.UpdateSize(json->GetMotionTotalSegmentCount(), CubismMotionSegment(), true);
-    _motionData->Points.UpdateSize(json->GetMotionTotalPointCount(), CubismMotionPoint(), true);
+    _motionData->Segments.UpdateSize(totalSegmentCapacity, CubismMotionSegment(), true);
+    _motionData->Points.UpdateSize(totalPointCapacity, CubismMotionPoint(), true);
     _motionData->Events.UpdateSize(_motionData->EventCount, CubismMotionEvent(), true);
 
     csmInt32 totalPointCount = 0;
@@ -587,6 +903,18 @@ void CubismMotion::Parse(const csmByte* motionJson, const csmSizeInt size)
         // Segments
         for (csmInt32 segmentPosition = 0; segmentPosition < json->GetMotionCurveSegmentCount(curveCount);)
         {
+            // 種類が不明なセグメントや、Metaの総数を超えて書き込むデータは受け付けない
+            const csmInt32 firstPointCount = (segmentPosition == 0) ? 1 : 0;
+            const csmFloat32 segmentValue = json->GetMotionCurveSegment(curveCount, segmentPosition + firstPointCount * 2);
+            if (!(segmentValue >= CubismMotionSegmentType_Linear && segmentValue <= CubismMotionSegmentType_InverseStepped) ||
+                totalSegmentCount >= totalSegmentCapacity ||
+                totalPointCount + firstPointCount + GetSegmentPointCount(static_cast<csmInt32>(segmentValue)) - 1 > totalPointCapacity)
+            {
+                CubismLogError("Invalid motion3.json: the segments of curve %d do not match Meta.", curveCount);
+                CSM_DELETE(json);
+                return false;
+            }
+
             if (segmentPosition == 0)
             {
                 _motionData->Segments[totalSegmentCount].BasePointIndex = totalPointCount;
@@ -677,6 +1005,10 @@ void CubismMotion::Parse(const csmByte* motionJson, const csmSizeInt size)
         }
     }
 
+    // Metaの総数が実際より多い場合は、使われない末尾を落とす
+    _motionData->Segments.UpdateSize(totalSegmentCount, CubismMotionSegment(), true);
+    _motionData->Points.UpdateSize(totalPointCount, CubismMotionPoint(), true);
+
 
     for (csmInt32 userdatacount = 0; userdatacount < json->GetEventCount(); ++userdatacount)
     {
@@ -684,7 +1016,132 @@ void CubismMotion::Parse(const csmByte* motionJson, const csmSizeInt size)
         _motionData->Events[userdatacount].Value = json->GetEventValue(userdatacount);
     }
 
+    BuildSegmentEndTimes(_motionData);
+
     CSM_DELETE(json);
+    return true;
+}
+
+csmSizeInt CubismMotion::GetMemorySize() const
+{
+    csmSizeInt size = sizeof(CubismMotion);
+    if (_motionData == NULL)
+    {
+        return size;
+    }
+    size += sizeof(CubismMotionData);
+    size += sizeof(CubismMotionCurve) * _motionData->Curves.GetSize();
+    size += sizeof(CubismMotionSegment) * _motionData->Segments.GetSize();
+    size += sizeof(CubismMotionPoint) * _motionData->Points.GetSize();
+    size += sizeof(csmFloat32) * _motionData->SegmentEndTimes.GetSize();
+    for (csmUint32 i = 0; i < _motionData->Events.GetSize(); ++i)
+    {
+        size += sizeof(CubismMotionEvent) + _motionData->Events[i].Value.GetLength();
+    }
+    return size;
+}
+
+csmBool CubismMotion::ParseBinary(const csmByte* buffer, const csmSizeInt size)
+{
+    MotionBinaryHeader header;
+    if (buffer == NULL || size < sizeof(header))
+    {
+        return false;
+    }
+    memcpy(&header, buffer, sizeof(header));
+    if (header.Magic != MotionBinaryMagic || header.Version != BinaryFormatVersion
+        || header.CurveCount < 0 || header.CurveCount > 0x7FFF || header.SegmentCount < 0
+        || header.PointCount < 0 || header.EventCount < 0)
+    {
+        return false;
+    }
+
+    // 宣言された個数とサイズが一致しなければ壊れている
+    const csmSizeInt curvesOffset = sizeof(MotionBinaryHeader);
+    const csmSizeInt segmentsOffset = curvesOffset + sizeof(MotionBinaryCurve) * static_cast<csmSizeInt>(header.CurveCount);
+    const csmSizeInt pointsOffset = segmentsOffset + sizeof(MotionBinarySegment) * static_cast<csmSizeInt>(header.SegmentCount);
+    const csmSizeInt eventsOffset = pointsOffset + sizeof(CubismMotionPoint) * static_cast<csmSizeInt>(header.PointCount);
+    const csmSizeInt stringsOffset = eventsOffset + sizeof(MotionBinaryEvent) * static_cast<csmSizeInt>(header.EventCount);
+    if (static_cast<csmSizeInt>(header.SegmentCount) > size || static_cast<csmSizeInt>(header.PointCount) > size
+        || static_cast<csmSizeInt>(header.EventCount) > size
+        || stringsOffset > size || header.StringsSize != size - stringsOffset)
+    {
+        return false;
+    }
+    const csmChar* strings = reinterpret_cast<const csmChar*>(buffer + stringsOffset);
+
+    _motionData = CSM_NEW CubismMotionData;
+    _motionData->Duration = header.Duration;
+    _motionData->Loop = static_cast<csmInt16>(header.Loop);
+    _motionData->CurveCount = static_cast<csmInt16>(header.CurveCount);
+    _motionData->Fps = header.Fps;
+    _motionData->EventCount = header.EventCount;
+    _fadeInSeconds = header.FadeInSeconds;
+    _fadeOutSeconds = header.FadeOutSeconds;
+
+    _motionData->Curves.UpdateSize(header.CurveCount, CubismMotionCurve(), true);
+    _motionData->Segments.UpdateSize(header.SegmentCount, CubismMotionSegment(), true);
+    _motionData->Points.UpdateSize(header.PointCount, CubismMotionPoint(), true);
+    _motionData->Events.UpdateSize(header.EventCount, CubismMotionEvent(), true);
+
+    for (csmInt32 i = 0; i < header.CurveCount; ++i)
+    {
+        MotionBinaryCurve record;
+        memcpy(&record, buffer + curvesOffset + sizeof(record) * i, sizeof(record));
+        if (record.Type < CubismMotionCurveTarget_Model || record.Type > CubismMotionCurveTarget_PartOpacity
+            || record.IdOffset > header.StringsSize || record.IdLength > header.StringsSize - record.IdOffset
+            || record.BaseSegmentIndex < 0 || record.SegmentCount < 0
+            || record.SegmentCount > header.SegmentCount - record.BaseSegmentIndex)
+        {
+            return false;
+        }
+        CubismMotionCurve& curve = _motionData->Curves[i];
+        curve.Type = static_cast<CubismMotionCurveTarget>(record.Type);
+        curve.Id = CubismFramework::GetIdManager()->GetId(csmString(strings + record.IdOffset, static_cast<csmInt32>(record.IdLength)));
+        curve.SegmentCount = record.SegmentCount;
+        curve.BaseSegmentIndex = record.BaseSegmentIndex;
+        curve.FadeInTime = record.FadeInTime;
+        curve.FadeOutTime = record.FadeOutTime;
+    }
+
+    for (csmInt32 i = 0; i < header.SegmentCount; ++i)
+    {
+        MotionBinarySegment record;
+        memcpy(&record, buffer + segmentsOffset + sizeof(record) * i, sizeof(record));
+        if (record.Evaluator < 0 || record.Evaluator >= MotionBinaryEvaluator_Count
+            || record.SegmentType != MotionBinaryEvaluatorSegmentTypes[record.Evaluator]
+            || record.BasePointIndex < 0
+            || GetSegmentPointCount(record.SegmentType) > header.PointCount - record.BasePointIndex)
+        {
+            return false;
+        }
+        CubismMotionSegment& segment = _motionData->Segments[i];
+        segment.BasePointIndex = record.BasePointIndex;
+        segment.SegmentType = record.SegmentType;
+        segment.Evaluate = MotionBinaryEvaluators[record.Evaluator];
+    }
+
+    // ポイントはメモリ上の配置がそのままなので一括でコピーする
+    if (header.PointCount > 0)
+    {
+        memcpy(&_motionData->Points[0], buffer + pointsOffset, sizeof(CubismMotionPoint) * header.PointCount);
+    }
+
+    for (csmInt32 i = 0; i < header.EventCount; ++i)
+    {
+        MotionBinaryEvent record;
+        memcpy(&record, buffer + eventsOffset + sizeof(record) * i, sizeof(record));
+        if (record.ValueOffset > header.StringsSize || record.ValueLength > header.StringsSize - record.ValueOffset)
+        {
+            return false;
+        }
+        _motionData->Events[i].FireTime = record.FireTime;
+        _motionData->Events[i].Value = csmString(strings + record.ValueOffset, static_cast<csmInt32>(record.ValueLength));
+    }
+
+    BuildSegmentEndTimes(_motionData);
+
+    return true;
 }
 
 void CubismMotion::SetParameterFadeInTime(CubismIdHandle parameterId, csmFloat32 value)
@@ -33,10 +33,42 @@ public:
      * @param[in]   buffer                      正在读取motion3.json的缓冲区
      * @param[in]   size                        缓冲区大小
      * @param[in]   onFinishedMotionHandler     在运动播放结束时调用的回调函数。如果为空，则不调用。
-     * @return  作成されたインスタンス
+     * @return  作成されたインスタンス。JSONとして読めない場合はNULL
      */
     static CubismMotion* Create(const csmByte* buffer, csmSizeInt size, FinishedMotionCallback onFinishedMotionHandler = NULL);
 
+    /**
+     * @brief バイナリ形式からインスタンスを作成する
+     *
+     * SerializeBinaryで書き出したデータから、JSONをパースせずにインスタンスを作成する。
+     * 从SerializeBinary写出的数据直接构建，不解析JSON；点数据整块复制。
+     *
+     * @param[in]   buffer                      バイナリデータ
+     * @param[in]   size                        バッファのサイズ
+     * @param[in]   onFinishedMotionHandler     モーション再生終了時に呼び出されるコールバック関数
+     * @return  作成されたインスタンス。形式やバージョンが合わない、または壊れている場合はNULL
+     */
+    static CubismMotion* CreateFromBinary(const csmByte* buffer, csmSizeInt size, FinishedMotionCallback onFinishedMotionHandler = NULL);
+
+    /**
+     * @brief パース済みのモーションデータをバイナリ形式で書き出す
+     *
+     * カーブ・セグメント・ポイント・イベントとフェード時間を保存する。
+     * SetFadeInTime等で後から変更した値ではなく、Create直後の状態を書き出すこと。
+     *
+     * @param[out]  out     書き出し先
+     */
+    void SerializeBinary(csmVector<csmByte>& out) const;
+
+    /**
+     * @brief パース済みデータが使用しているおおよそのメモリ量を返す
+     *
+     * @return  バイト数
+     */
+    csmSizeInt GetMemorySize() const;
+
+    static const csmUint32 BinaryFormatVersion;     ///< バイナリ形式のバージョン。パース結果が変わる変更をしたら上げる
+
     /**
     * @brief 执行模型参数更新
     *
@@ -225,8 +257,25 @@ private:
      *
      * @param[in]   motionJson  motion3.jsonが読み込まれているバッファ
      * @param[in]   size        バッファのサイズ
+     * @return  JSONとして読めればtrue
+     */
+    csmBool Parse(const csmByte* motionJson, const csmSizeInt size);
+
+    /**
+     * @brief バイナリ形式の読み込み
+     *
+     * @return  データが正しければtrue
      */
-    void Parse(const csmByte* motionJson, const csmSizeInt size);
+    csmBool ParseBinary(const csmByte* buffer, const csmSizeInt size);
+
+    /**
+     * @brief モデルとの対応付け
+     *
+     * 各カーブの対象パラメータのインデックスを解決する。対象モデルが変わった時だけ解決し直す。
+     *
+     * @param[in]   model   対象のモデル
+     */
+    void BindModel(CubismModel* model);
 
     csmFloat32      _sourceFrameRate;                   ///< ロードしたファイルのFPS。記述が無ければデフォルト値15fpsとなる
     csmFloat32      _loopDurationSeconds;               ///< mtnファイルで定義される一連のモーションの長さ
@@ -241,6 +290,10 @@ private:
 
     CubismIdHandle _modelCurveIdEyeBlink;               ///< モデルが持つ自動まばたき用パラメータIDのハンドル。  モデルとモーションを対応付ける。
     CubismIdHandle _modelCurveIdLipSync;                ///< モデルが持つリップシンク用パラメータIDのハンドル。  モデルとモーションを対応付ける。
+
+    const CubismModel*  _boundModel;                    ///< カーブのインデックスを解決したモデル
+    csmVector<csmInt32> _curveParameterIndices;         ///< カーブごとの対象パラメータのインデックス
+    csmVector<csmInt32> _curveSegmentCursors;           ///< カーブごとに前回評価したセグメント。次のフレームの探索の起点にする
 };
 
 }}}
@@ -100,6 +100,7 @@ struct CubismMotionCurve
         , BaseSegmentIndex(0)
         , FadeInTime(0.0f)
         , FadeOutTime(0.0f)
+        , IsSegmentEndTimeSorted(true)
     { }
 
     CubismMotionCurveTarget Type;               ///< カーブの種類
@@ -108,6 +109,7 @@ struct CubismMotionCurve
     csmInt32 BaseSegmentIndex;                  ///< 最初のセグメントのインデックス
     csmFloat32 FadeInTime;                      ///< フェードインにかかる時間[秒]
     csmFloat32 FadeOutTime;                     ///< フェードアウトにかかる時間[秒]
+    csmBool IsSegmentEndTimeSorted;             ///< セグメントの終点の時間が昇順に並んでいるか。並んでいれば二分探索できる
 };
 
 /**
@@ -148,6 +150,7 @@ struct CubismMotionData
     csmVector<CubismMotionCurve> Curves;                ///< カーブのリスト
     csmVector<CubismMotionSegment> Segments;            ///< セグメントのリスト
     csmVector<CubismMotionPoint> Points;                ///< ポイントのリスト
+    csmVector<csmFloat32> SegmentEndTimes;              ///< セグメントごとの終点の時間。Segmentsと同じ並びで、評価するセグメントの探索に使う
     csmVector<CubismMotionEvent> Events;          ///< イベントのリスト
 };
 
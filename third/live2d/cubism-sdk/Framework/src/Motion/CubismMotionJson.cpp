@@ -136,7 +136,7 @@ csmFloat32 CubismMotionJson::GetMotionCurveFadeOutTime(csmInt32 curveIndex) cons
 
 csmInt32 CubismMotionJson::GetMotionCurveSegmentCount(csmInt32 curveIndex) const
 {
-    return static_cast<csmInt32>(_json->GetRoot()[Curves][curveIndex][Segments].GetVector()->GetSize());
+    return static_cast<csmInt32>(_json->GetRoot()[Curves][curveIndex][Segments].GetSize());
 }
 
 csmFloat32 CubismMotionJson::GetMotionCurveSegment(csmInt32 curveIndex, csmInt32 segmentIndex) const
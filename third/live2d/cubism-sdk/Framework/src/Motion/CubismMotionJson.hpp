@@ -9,7 +9,7 @@
 #pragma once
 
 #include "CubismJsonHolder.hpp"
-#include "Utils/CubismJson.hpp"
+#include "Utils/CubismJsonTape.hpp"
 #include "Id/CubismId.hpp"
 
 namespace Live2D { namespace Cubism { namespace Framework {
@@ -555,10 +555,24 @@ void CubismPhysics::Parse(const csmByte* physicsJson, csmSizeInt size)
 
     _physicsRig->Fps = json->GetFps();
 
+    // 各要素はJSON上で1バイト以上を占めるので、Metaの総数が負またはファイルより大きければ壊れている
+    const csmInt32 totalInputCount = json->GetTotalInputCount();
+    const csmInt32 totalOutputCount = json->GetTotalOutputCount();
+    const csmInt32 vertexCount = json->GetVertexCount();
+    if (_physicsRig->SubRigCount < 0 || totalInputCount < 0 || totalOutputCount < 0 || vertexCount < 0 ||
+        static_cast<csmSizeInt>(_physicsRig->SubRigCount) > size || static_cast<csmSizeInt>(totalInputCount) > size ||
+        static_cast<csmSizeInt>(totalOutputCount) > size || static_cast<csmSizeInt>(vertexCount) > size)
+    {
+        CubismLogError("Invalid physics3.json: the counts in Meta are out of range.");
+        _isJsonValid = false;
+        CSM_DELETE(json);
+        return;
+    }
+
     _physicsRig->Settings.UpdateSize(_physicsRig->SubRigCount, CubismPhysicsSubRig(), true);
-    _physicsRig->Inputs.UpdateSize(json->GetTotalInputCount(), CubismPhysicsInput(), true);
-    _physicsRig->Outputs.UpdateSize(json->GetTotalOutputCount(), CubismPhysicsOutput(), true);
-    _physicsRig->Particles.UpdateSize(json->GetVertexCount(), CubismPhysicsParticle(), true);
+    _physicsRig->Inputs.UpdateSize(totalInputCount, CubismPhysicsInput(), true);
+    _physicsRig->Outputs.UpdateSize(totalOutputCount, CubismPhysicsOutput(), true);
+    _physicsRig->Particles.UpdateSize(vertexCount, CubismPhysicsParticle(), true);
 
     _currentRigOutputs.Clear();
     _previousRigOutputs.Clear();
@@ -577,6 +591,19 @@ void CubismPhysics::Parse(const csmByte* physicsJson, csmSizeInt size)
         // Input
         _physicsRig->Settings[i].InputCount = json->GetInputCount(i);
         _physicsRig->Settings[i].BaseInputIndex = inputIndex;
+        _physicsRig->Settings[i].OutputCount = json->GetOutputCount(i);
+        _physicsRig->Settings[i].ParticleCount = json->GetParticleCount(i);
+
+        // Metaの総数を超えて書き込む設定は受け付けない
+        if (_physicsRig->Settings[i].InputCount < 0 || _physicsRig->Settings[i].InputCount > totalInputCount - inputIndex ||
+            _physicsRig->Settings[i].OutputCount < 0 || _physicsRig->Settings[i].OutputCount > totalOutputCount - outputIndex ||
+            _physicsRig->Settings[i].ParticleCount < 0 || _physicsRig->Settings[i].ParticleCount > vertexCount - particleIndex)
+        {
+            CubismLogError("Invalid physics3.json: the setting %d does not match Meta.", i);
+            _isJsonValid = false;
+            CSM_DELETE(json);
+            return;
+        }
         for (csmInt32 j = 0; j < _physicsRig->Settings[i].InputCount; ++j)
         {
             _physicsRig->Inputs[inputIndex + j].SourceParameterIndex = -1;
@@ -605,7 +632,6 @@ void CubismPhysics::Parse(const csmByte* physicsJson, csmSizeInt size)
         inputIndex += _physicsRig->Settings[i].InputCount;
 
         // Output
-        _physicsRig->Settings[i].OutputCount = json->GetOutputCount(i);
         _physicsRig->Settings[i].BaseOutputIndex = outputIndex;
 
         PhysicsOutput currentRigOutput;
@@ -649,7 +675,6 @@ void CubismPhysics::Parse(const csmByte* physicsJson, csmSizeInt size)
         outputIndex += _physicsRig->Settings[i].OutputCount;
 
         // Particle
-        _physicsRig->Settings[i].ParticleCount = json->GetParticleCount(i);
         _physicsRig->Settings[i].BaseParticleIndex = particleIndex;
         for (csmInt32 j = 0; j < _physicsRig->Settings[i].ParticleCount; ++j)
         {
@@ -8,7 +8,7 @@
 #pragma once
 
 #include "CubismJsonHolder.hpp"
-#include "Utils/CubismJson.hpp"
+#include "Utils/CubismJsonTape.hpp"
 #include "Math/CubismVector2.hpp"
 #include "Id/CubismId.hpp"
 
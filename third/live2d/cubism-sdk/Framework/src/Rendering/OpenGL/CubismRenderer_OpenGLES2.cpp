@@ -10,11 +10,20 @@
 #include "Type/csmVector.hpp"
 #include "Model/CubismModel.hpp"
 #include <float.h>
+#include <string.h>
 
 #ifdef CSM_TARGET_WIN_GL
 #include <Windows.h>
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CSM_VERTEX_BOUNDS_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CSM_VERTEX_BOUNDS_NEON
+#endif
+
 #define CSM_FRAGMENT_SHADER_FP_PRECISION_HIGH "highp"
 #define CSM_FRAGMENT_SHADER_FP_PRECISION_MID "mediump"
 #define CSM_FRAGMENT_SHADER_FP_PRECISION_LOW "lowp"
@@ -32,10 +41,110 @@ namespace {
 const csmInt32 ColorChannelCount = 4;   // 実験時に1チャンネルの場合は1、RGBだけの場合は3、アルファも含める場合は4
 const csmInt32 ClippingMaskMaxCountOnDefault = 36;  // 通常のフレームバッファ1枚あたりのマスク最大数
 const csmInt32 ClippingMaskMaxCountOnMultiRenderTexture = 32;   // フレームバッファが2枚以上ある場合のフレームバッファ1枚あたりのマスク最大数
+
+/**
+ * @brief   頂点座標(x, yの並び)を囲む矩形を求める<br>
+ *           SSE2/NEONでは1レジスタに2頂点を載せ、4頂点ずつ最小・最大を取る。
+ *           NaNの頂点は無視する（スカラー版の比較と同じ）。頂点がなければminXはFLT_MAXのまま。
+ */
+void CalcVertexBounds(const csmFloat32* vertices, csmInt32 vertexCount
+                      , csmFloat32& minX, csmFloat32& minY, csmFloat32& maxX, csmFloat32& maxY)
+{
+    minX = FLT_MAX;
+    minY = FLT_MAX;
+    maxX = -FLT_MAX;
+    maxY = -FLT_MAX;
+
+    csmInt32 i = 0;
+#if defined(CSM_VERTEX_BOUNDS_SSE2)
+    if (vertexCount >= 4)
+    {
+        // _mm_min_ps/_mm_max_psはどちらかがNaNなら第2引数を返すので、累積値を第2引数にする
+        __m128 min0 = _mm_set1_ps(FLT_MAX);
+        __m128 min1 = min0;
+        __m128 max0 = _mm_set1_ps(-FLT_MAX);
+        __m128 max1 = max0;
+        for (; i + 4 <= vertexCount; i += 4)
+        {
+            const __m128 v0 = _mm_loadu_ps(vertices + i * 2);
+            const __m128 v1 = _mm_loadu_ps(vertices + i * 2 + 4);
+            min0 = _mm_min_ps(v0, min0);
+            min1 = _mm_min_ps(v1, min1);
+            max0 = _mm_max_ps(v0, max0);
+            max1 = _mm_max_ps(v1, max1);
+        }
+        __m128 minXY = _mm_min_ps(min0, min1);
+        __m128 maxXY = _mm_max_ps(max0, max1);
+        minXY = _mm_min_ps(minXY, _mm_movehl_ps(minXY, minXY));
+        maxXY = _mm_max_ps(maxXY, _mm_movehl_ps(maxXY, maxXY));
+
+        csmFloat32 lanes[4];
+        _mm_storeu_ps(lanes, minXY);
+        minX = lanes[0];
+        minY = lanes[1];
+        _mm_storeu_ps(lanes, maxXY);
+        maxX = lanes[0];
+        maxY = lanes[1];
+    }
+#elif defined(CSM_VERTEX_BOUNDS_NEON)
+    if (vertexCount >= 4)
+    {
+        // vminq_f32はNaNを伝播するので、比較結果で選択してNaNを累積値に入れない
+        float32x4_t min0 = vdupq_n_f32(FLT_MAX);
+        float32x4_t min1 = min0;
+        float32x4_t max0 = vdupq_n_f32(-FLT_MAX);
+        float32x4_t max1 = max0;
+        for (; i + 4 <= vertexCount; i += 4)
+        {
+            const float32x4_t v0 = vld1q_f32(vertices + i * 2);
+            const float32x4_t v1 = vld1q_f32(vertices + i * 2 + 4);
+            min0 = vbslq_f32(vcltq_f32(v0, min0), v0, min0);
+            min1 = vbslq_f32(vcltq_f32(v1, min1), v1, min1);
+            max0 = vbslq_f32(vcgtq_f32(v0, max0), v0, max0);
+            max1 = vbslq_f32(vcgtq_f32(v1, max1), v1, max1);
+        }
+        const float32x4_t minXY = vminq_f32(min0, min1);
+        const float32x4_t maxXY = vmaxq_f32(max0, max1);
+        const float32x2_t minPair = vmin_f32(vget_low_f32(minXY), vget_high_f32(minXY));
+        const float32x2_t maxPair = vmax_f32(vget_low_f32(maxXY), vget_high_f32(maxXY));
+        minX = vget_lane_f32(minPair, 0);
+        minY = vget_lane_f32(minPair, 1);
+        maxX = vget_lane_f32(maxPair, 0);
+        maxY = vget_lane_f32(maxPair, 1);
+    }
+#endif
+
+    for (; i < vertexCount; ++i)
+    {
+        const csmFloat32 x = vertices[i * 2];
+        const csmFloat32 y = vertices[i * 2 + 1];
+        if (x < minX) minX = x;
+        if (x > maxX) maxX = x;
+        if (y < minY) minY = y;
+        if (y > maxY) maxY = y;
+    }
+}
+
+/**
+ * @brief   描画オブジェクト群の頂点座標の版の合計<br>
+ *           版は減らないので、どれかが変化すれば合計も変わる。
+ */
+csmUint32 SumPositionVersions(const CubismMeshBuffers_OpenGLES2& meshBuffers, const csmInt32* drawableIndices, csmInt32 count)
+{
+    csmUint32 sum = 0;
+    for (csmInt32 i = 0; i < count; ++i)
+    {
+        sum += meshBuffers.GetPositionVersion(drawableIndices[i]);
+    }
+    return sum;
+}
 }
 
 CubismClippingManager_OpenGLES2::CubismClippingManager_OpenGLES2() :
-                                                                   _clippingMaskBufferSize(256, 256)
+                                                                   _currentOffscreenFrame(NULL)
+                                                                   , _isMaskInvalidated(true)
+                                                                   , _layoutClipCount(-1)
+                                                                   , _clippingMaskBufferSize(256, 256)
 {
     CubismRenderer::CubismTextureColor* tmp;
     tmp = CSM_NEW CubismRenderer::CubismTextureColor();
@@ -100,6 +209,7 @@ void CubismClippingManager_OpenGLES2::Initialize(CubismModel& model, csmInt32 dr
     for (csmInt32 i = 0; i < _renderTextureCount; ++i)
     {
         _clearedFrameBufferFlags.PushBack(false);
+        _keptFrameBufferFlags.PushBack(false);
     }
 
     //クリッピングマスクを使う描画オブジェクトを全て登録する
@@ -161,6 +271,8 @@ CubismClippingContext* CubismClippingManager_OpenGLES2::FindSameClip(const csmIn
 
 void CubismClippingManager_OpenGLES2::SetupClippingContext(CubismModel& model, CubismRenderer_OpenGLES2* renderer, GLint lastFBO, GLint lastViewport[4])
 {
+    const CubismMeshBuffers_OpenGLES2& meshBuffers = renderer->_meshBuffers;
+
     // 全てのクリッピングを用意する
     // 同じクリップ（複数の場合はまとめて１つのクリップ）を使う場合は１度だけ設定する
     csmInt32 usingClipCount = 0;
@@ -169,8 +281,32 @@ void CubismClippingManager_OpenGLES2::SetupClippingContext(CubismModel& model, C
         // １つのクリッピングマスクに関して
         CubismClippingContext* cc = _clippingContextListForMask[clipIndex];
 
-        // このクリップを利用する描画オブジェクト群全体を囲む矩形を計算
-        CalcClippedDrawTotalBounds(model, cc);
+        // クリップされる描画オブジェクトの頂点が変わっていなければ矩形も変わらない
+        const csmUint32 clippedStamp = SumPositionVersions(meshBuffers, cc->_clippedDrawableIndexList->GetPtr(), cc->_clippedDrawableIndexList->GetSize());
+        if (_isMaskInvalidated || clippedStamp != cc->_clippedPositionStamp)
+        {
+            const csmRectF lastRect(cc->_allClippedDrawRect->X, cc->_allClippedDrawRect->Y, cc->_allClippedDrawRect->Width, cc->_allClippedDrawRect->Height);
+            const csmBool lastUsing = cc->_isUsing;
+
+            // このクリップを利用する描画オブジェクト群全体を囲む矩形を計算
+            CalcClippedDrawTotalBounds(model, cc);
+            cc->_clippedPositionStamp = clippedStamp;
+
+            if (cc->_isUsing != lastUsing
+                || cc->_allClippedDrawRect->X != lastRect.X || cc->_allClippedDrawRect->Y != lastRect.Y
+                || cc->_allClippedDrawRect->Width != lastRect.Width || cc->_allClippedDrawRect->Height != lastRect.Height)
+            {
+                cc->_isMaskDirty = true;
+            }
+        }
+
+        // マスク用の描画オブジェクトの頂点が変わっていれば描き直す
+        const csmUint32 maskStamp = SumPositionVersions(meshBuffers, cc->_clippingIdList, cc->_clippingIdCount);
+        if (_isMaskInvalidated || maskStamp != cc->_maskPositionStamp)
+        {
+            cc->_maskPositionStamp = maskStamp;
+            cc->_isMaskDirty = true;
+        }
 
         if (cc->_isUsing)
         {
@@ -181,30 +317,40 @@ void CubismClippingManager_OpenGLES2::SetupClippingContext(CubismModel& model, C
     // マスク作成処理
     if (usingClipCount > 0)
     {
+        // 各マスクのレイアウトを決定していく
+        // レイアウトはマスクの数だけで決まる。変わった場合はすべてのマスクの位置が変わるのでレンダーテクスチャごと描き直す
+        const csmInt32 layoutClipCount = renderer->IsUsingHighPrecisionMask() ? 0 : usingClipCount;
+        const csmBool isRelayout = _isMaskInvalidated || layoutClipCount != _layoutClipCount;
+        if (isRelayout)
+        {
+            SetupLayoutBounds(layoutClipCount);
+            _layoutClipCount = layoutClipCount;
+            for (csmUint32 clipIndex = 0; clipIndex < _clippingContextListForMask.GetSize(); clipIndex++)
+            {
+                _clippingContextListForMask[clipIndex]->_isMaskDirty = true;
+            }
+        }
+
         if (!renderer->IsUsingHighPrecisionMask())
         {
             // 生成したFrameBufferと同じサイズでビューポートを設定
             glViewport(0, 0, _clippingMaskBufferSize.X, _clippingMaskBufferSize.Y);
 
-            // 後の計算のためにインデックスの最初をセット
-            _currentOffscreenFrame = renderer->GetMaskBuffer(0);
-            // ----- マスク描画処理 -----
-            _currentOffscreenFrame->BeginDraw(lastFBO);
-
-            renderer->PreDraw(); // バッファをクリアする
+            // 描き直すマスクが最初に現れたレンダーテクスチャからBeginDrawする
+            _currentOffscreenFrame = NULL;
         }
 
-        // 各マスクのレイアウトを決定していく
-        SetupLayoutBounds(renderer->IsUsingHighPrecisionMask() ? 0 : usingClipCount);
-
         // サイズがレンダーテクスチャの枚数と合わない場合は合わせる
-        if (_clearedFrameBufferFlags.GetSize() != _renderTextureCount)
+        const csmUint32 renderTextureCount = static_cast<csmUint32>(_renderTextureCount);
+        if (_clearedFrameBufferFlags.GetSize() != renderTextureCount || _keptFrameBufferFlags.GetSize() != renderTextureCount)
         {
             _clearedFrameBufferFlags.Clear();
+            _keptFrameBufferFlags.Clear();
 
             for (csmInt32 i = 0; i < _renderTextureCount; ++i)
             {
                 _clearedFrameBufferFlags.PushBack(false);
+                _keptFrameBufferFlags.PushBack(false);
             }
         }
         else
@@ -213,6 +359,21 @@ void CubismClippingManager_OpenGLES2::SetupClippingContext(CubismModel& model, C
             for (csmInt32 i = 0; i < _renderTextureCount; ++i)
             {
                 _clearedFrameBufferFlags[i] = false;
+                _keptFrameBufferFlags[i] = false;
+            }
+        }
+
+        // 描き直さないマスクがあるレンダーテクスチャは、描き直すマスクの領域だけをクリアする
+        // すべて描き直す場合は従来どおり全体を一度でクリアする
+        if (!isRelayout)
+        {
+            for (csmUint32 clipIndex = 0; clipIndex < _clippingContextListForMask.GetSize(); clipIndex++)
+            {
+                const CubismClippingContext* cc = _clippingContextListForMask[clipIndex];
+                if (cc->_isUsing && !cc->_isMaskDirty)
+                {
+                    _keptFrameBufferFlags[cc->_bufferIndex] = true;
+                }
             }
         }
 
@@ -222,6 +383,13 @@ void CubismClippingManager_OpenGLES2::SetupClippingContext(CubismModel& model, C
         {
             // --- 実際に１つのマスクを描く ---
             CubismClippingContext* clipContext = _clippingContextListForMask[clipIndex];
+
+            // 矩形・レイアウト・頂点のどれも変わっていなければ、前回の行列とレンダーテクスチャの内容をそのまま使う
+            if (!clipContext->_isMaskDirty)
+            {
+                continue;
+            }
+
             csmRectF* allClippedDrawRect = clipContext->_allClippedDrawRect; //このマスクを使う、全ての描画オブジェクトの論理座標上の囲み矩形
             csmRectF* layoutBoundsOnTex01 = clipContext->_layoutBounds; //この中にマスクを収める
             const csmFloat32 MARGIN = 0.05f;
@@ -235,7 +403,10 @@ void CubismClippingManager_OpenGLES2::SetupClippingContext(CubismModel& model, C
             if (_currentOffscreenFrame != clipContextOffscreenFrame &&
                 !renderer->IsUsingHighPrecisionMask())
             {
-                _currentOffscreenFrame->EndDraw();
+                if (_currentOffscreenFrame != NULL)
+                {
+                    _currentOffscreenFrame->EndDraw();
+                }
                 _currentOffscreenFrame = clipContextOffscreenFrame;
                 // マスク用RenderTextureをactiveにセット
                 _currentOffscreenFrame->BeginDraw(lastFBO);
@@ -323,21 +494,12 @@ void CubismClippingManager_OpenGLES2::SetupClippingContext(CubismModel& model, C
 
             clipContext->_matrixForDraw.SetMatrix(_tmpMatrixForDraw.GetArray());
 
+            clipContext->_isMaskDirty = false;
+
             if (!renderer->IsUsingHighPrecisionMask())
             {
-                const csmInt32 clipDrawCount = clipContext->_clippingIdCount;
-                for (csmInt32 i = 0; i < clipDrawCount; i++)
+                if (!_keptFrameBufferFlags[clipContext->_bufferIndex])
                 {
-                    const csmInt32 clipDrawIndex = clipContext->_clippingIdList[i];
-
-                    // 頂点情報が更新されておらず、信頼性がない場合は描画をパスする
-                    if (!model.GetDrawableDynamicFlagVertexPositionsDidChange(clipDrawIndex))
-                    {
-                        continue;
-                    }
-
-                    renderer->IsCulling(model.GetDrawableCulling(clipDrawIndex) != 0);
-
                     // マスクがクリアされていないなら処理する
                     if (!_clearedFrameBufferFlags[clipContext->_bufferIndex])
                     {
@@ -347,21 +509,28 @@ void CubismClippingManager_OpenGLES2::SetupClippingContext(CubismModel& model, C
                         glClear(GL_COLOR_BUFFER_BIT);
                         _clearedFrameBufferFlags[clipContext->_bufferIndex] = true;
                     }
+                }
+                else
+                {
+                    // 同じレンダーテクスチャの他のマスクは前回の内容を残す
+                    ClearLayoutBounds(renderer->_stateCache, clipContext);
+                }
+
+                // マスクを描き直すときは、頂点が変化していない描画オブジェクトも含めてすべて描く
+                const csmInt32 clipDrawCount = clipContext->_clippingIdCount;
+                for (csmInt32 i = 0; i < clipDrawCount; i++)
+                {
+                    const csmInt32 clipDrawIndex = clipContext->_clippingIdList[i];
+
+                    renderer->IsCulling(model.GetDrawableCulling(clipDrawIndex) != 0);
 
                     // 今回専用の変換を適用して描く
                     // チャンネルも切り替える必要がある(A,R,G,B)
                     renderer->SetClippingContextBufferForMask(clipContext);
 
-                    renderer->DrawMeshOpenGL(
-                        model.GetDrawableTextureIndex(clipDrawIndex),
-                        model.GetDrawableVertexIndexCount(clipDrawIndex),
-                        model.GetDrawableVertexCount(clipDrawIndex),
-                        const_cast<csmUint16*>(model.GetDrawableVertexIndices(clipDrawIndex)),
-                        const_cast<csmFloat32*>(model.GetDrawableVertices(clipDrawIndex)),
-                        reinterpret_cast<csmFloat32*>(const_cast<Core::csmVector2*>(model.GetDrawableVertexUvs(clipDrawIndex))),
-                        model.GetMultiplyColor(clipDrawIndex),
-                        model.GetScreenColor(clipDrawIndex),
-                        model.GetDrawableOpacity(clipDrawIndex),
+                    renderer->DrawDrawableOpenGL(
+                        model,
+                        clipDrawIndex,
                         CubismRenderer::CubismBlendMode_Normal,   //クリッピングは通常描画を強制
                         false   // マスク生成時はクリッピングの反転使用は全く関係がない
                     );
@@ -372,13 +541,44 @@ void CubismClippingManager_OpenGLES2::SetupClippingContext(CubismModel& model, C
         if (!renderer->IsUsingHighPrecisionMask())
         {
             // --- 後処理 ---
-            _currentOffscreenFrame->EndDraw();
+            if (_currentOffscreenFrame != NULL)
+            {
+                _currentOffscreenFrame->EndDraw();
+            }
             renderer->SetClippingContextBufferForMask(NULL);
             glViewport(lastViewport[0], lastViewport[1], lastViewport[2], lastViewport[3]);
         }
     }
+
+    _isMaskInvalidated = false;
+}
+
+void CubismClippingManager_OpenGLES2::ClearLayoutBounds(CubismRendererStateCache_OpenGLES2& stateCache, const CubismClippingContext* clippingContext)
+{
+    // レイアウト領域を画素に丸める。隣の領域とは同じ境界に丸まるので重ならない
+    const csmRectF* bounds = clippingContext->_layoutBounds;
+    const GLint left = static_cast<GLint>(bounds->X * _clippingMaskBufferSize.X + 0.5f);
+    const GLint bottom = static_cast<GLint>(bounds->Y * _clippingMaskBufferSize.Y + 0.5f);
+    const GLint right = static_cast<GLint>(bounds->GetRight() * _clippingMaskBufferSize.X + 0.5f);
+    const GLint top = static_cast<GLint>(bounds->GetBottom() * _clippingMaskBufferSize.Y + 0.5f);
+
+    const CubismRenderer::CubismTextureColor* channel = _channelColors[clippingContext->_layoutChannelNo];
+
+    stateCache.SetEnabled(GL_SCISSOR_TEST, true);
+    glScissor(left, bottom, right - left, top - bottom);
+    stateCache.ColorMask(channel->R > 0.0f, channel->G > 0.0f, channel->B > 0.0f, channel->A > 0.0f);
+    glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    stateCache.ColorMask(1, 1, 1, 1);
+    stateCache.SetEnabled(GL_SCISSOR_TEST, false);
+}
+
+void CubismClippingManager_OpenGLES2::InvalidateMasks()
+{
+    _isMaskInvalidated = true;
 }
 
+
 void CubismClippingManager_OpenGLES2::CalcClippedDrawTotalBounds(CubismModel& model, CubismClippingContext* clippingContext)
 {
     // 被クリッピングマスク（マスクされる描画オブジェクト）の全体の矩形
@@ -394,22 +594,8 @@ void CubismClippingManager_OpenGLES2::CalcClippedDrawTotalBounds(CubismModel& mo
         // マスクを使用する描画オブジェクトの描画される矩形を求める
         const csmInt32 drawableIndex = (*clippingContext->_clippedDrawableIndexList)[clippedDrawableIndex];
 
-        const csmInt32 drawableVertexCount = model.GetDrawableVertexCount(drawableIndex);
-        csmFloat32* drawableVertexes = const_cast<csmFloat32*>(model.GetDrawableVertices(drawableIndex));
-
-        csmFloat32 minX = FLT_MAX, minY = FLT_MAX;
-        csmFloat32 maxX = -FLT_MAX, maxY = -FLT_MAX;
-
-        csmInt32 loop = drawableVertexCount * Constant::VertexStep;
-        for (csmInt32 pi = Constant::VertexOffset; pi < loop; pi += Constant::VertexStep)
-        {
-            csmFloat32 x = drawableVertexes[pi];
-            csmFloat32 y = drawableVertexes[pi + 1];
-            if (x < minX) minX = x;
-            if (x > maxX) maxX = x;
-            if (y < minY) minY = y;
-            if (y > maxY) maxY = y;
-        }
+        csmFloat32 minX, minY, maxX, maxY;
+        CalcVertexBounds(model.GetDrawableVertices(drawableIndex), model.GetDrawableVertexCount(drawableIndex), minX, minY, maxX, maxY);
 
         //
         if (minX == FLT_MAX) continue; //有効な点がひとつも取れなかったのでスキップする
@@ -641,6 +827,12 @@ CubismClippingContext::CubismClippingContext(CubismClippingManager_OpenGLES2* ma
     _layoutBounds = CSM_NEW csmRectF();
 
     _clippedDrawableIndexList = CSM_NEW csmVector<csmInt32>();
+
+    _isUsing = false;
+    _bufferIndex = 0;
+    _isMaskDirty = true;
+    _clippedPositionStamp = 0;
+    _maskPositionStamp = 0;
 }
 
 CubismClippingContext::~CubismClippingContext()
@@ -726,10 +918,14 @@ void CubismRendererProfile_OpenGLES2::Save()
     glGetIntegerv(GL_BLEND_SRC_ALPHA, &_lastBlending[2]);
     glGetIntegerv(GL_BLEND_DST_ALPHA, &_lastBlending[3]);
 
+    SaveFramebuffer();
+}
+
+void CubismRendererProfile_OpenGLES2::SaveFramebuffer()
+{
     // モデル描画直前のFBOとビューポートを保存
     glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_lastFBO);
     glGetIntegerv(GL_VIEWPORT, _lastViewport);
-
 }
 
 void CubismRendererProfile_OpenGLES2::Restore()
@@ -1538,8 +1734,7 @@ void CubismShader_OpenGLES2::GenerateShaders()
 }
 
 void CubismShader_OpenGLES2::SetupShaderProgram(CubismRenderer_OpenGLES2* renderer, GLuint textureId
-                                                , csmInt32 vertexCount, csmFloat32* vertexArray
-                                                , csmFloat32* uvArray, csmFloat32 opacity
+                                                , const CubismMeshBinding_OpenGLES2& mesh, csmFloat32 opacity
                                                 , CubismRenderer::CubismBlendMode colorBlendMode
                                                 , CubismRenderer::CubismTextureColor baseColor
                                                 , CubismRenderer::CubismTextureColor multiplyColor
@@ -1552,6 +1747,9 @@ void CubismShader_OpenGLES2::SetupShaderProgram(CubismRenderer_OpenGLES2* render
         GenerateShaders();
     }
 
+    // 前の描画と同じ値のステート・ユニフォームは発行しない
+    CubismRendererStateCache_OpenGLES2& state = renderer->_stateCache;
+
     // Blending
     csmInt32 SRC_COLOR;
     csmInt32 DST_COLOR;
@@ -1561,36 +1759,36 @@ void CubismShader_OpenGLES2::SetupShaderProgram(CubismRenderer_OpenGLES2* render
     if (renderer->GetClippingContextBufferForMask() != NULL) // マスク生成時
     {
         CubismShaderSet* shaderSet = _shaderSets[ShaderNames_SetupMask];
-        glUseProgram(shaderSet->ShaderProgram);
+        state.UseProgram(shaderSet->ShaderProgram);
 
         //テクスチャ設定
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, textureId);
-        glUniform1i(shaderSet->SamplerTexture0Location, 0);
+        state.ActiveTexture(GL_TEXTURE0);
+        state.BindTexture2D(textureId);
+        state.Uniform1i(shaderSet->SamplerTexture0Location, 0);
 
         // 頂点配列の設定
-        glEnableVertexAttribArray(shaderSet->AttributePositionLocation);
-        glVertexAttribPointer(shaderSet->AttributePositionLocation, 2, GL_FLOAT, GL_FALSE, sizeof(csmFloat32) * 2, vertexArray);
+        state.EnableVertexAttribArray(shaderSet->AttributePositionLocation);
+        state.VertexAttribPointer(shaderSet->AttributePositionLocation, mesh.PositionBuffer, mesh.Positions);
         // テクスチャ頂点の設定
-        glEnableVertexAttribArray(shaderSet->AttributeTexCoordLocation);
-        glVertexAttribPointer(shaderSet->AttributeTexCoordLocation, 2, GL_FLOAT, GL_FALSE, sizeof(csmFloat32) * 2, uvArray);
+        state.EnableVertexAttribArray(shaderSet->AttributeTexCoordLocation);
+        state.VertexAttribPointer(shaderSet->AttributeTexCoordLocation, mesh.UvBuffer, mesh.Uvs);
 
         // チャンネル
         const csmInt32 channelNo = renderer->GetClippingContextBufferForMask()->_layoutChannelNo;
         CubismRenderer::CubismTextureColor* colorChannel = renderer->GetClippingContextBufferForMask()->GetClippingManager()->GetChannelFlagAsColor(channelNo);
-        glUniform4f(shaderSet->UnifromChannelFlagLocation, colorChannel->R, colorChannel->G, colorChannel->B, colorChannel->A);
+        state.Uniform4f(shaderSet->UnifromChannelFlagLocation, colorChannel->R, colorChannel->G, colorChannel->B, colorChannel->A);
 
-        glUniformMatrix4fv(shaderSet->UniformClipMatrixLocation, 1, GL_FALSE, renderer->GetClippingContextBufferForMask()->_matrixForMask.GetArray());
+        state.UniformMatrix4fv(shaderSet->UniformClipMatrixLocation, renderer->GetClippingContextBufferForMask()->_matrixForMask.GetArray());
 
         csmRectF* rect = renderer->GetClippingContextBufferForMask()->_layoutBounds;
 
-        glUniform4f(shaderSet->UniformBaseColorLocation,
+        state.Uniform4f(shaderSet->UniformBaseColorLocation,
                     rect->X * 2.0f - 1.0f,
                     rect->Y * 2.0f - 1.0f,
                     rect->GetRight() * 2.0f - 1.0f,
                     rect->GetBottom() * 2.0f - 1.0f);
-        glUniform4f(shaderSet->UniformMultiplyColorLocation, multiplyColor.R, multiplyColor.G, multiplyColor.B, multiplyColor.A);
-        glUniform4f(shaderSet->UniformScreenColorLocation, screenColor.R, screenColor.G, screenColor.B, screenColor.A);
+        state.Uniform4f(shaderSet->UniformMultiplyColorLocation, multiplyColor.R, multiplyColor.G, multiplyColor.B, multiplyColor.A);
+        state.Uniform4f(shaderSet->UniformScreenColorLocation, screenColor.R, screenColor.G, screenColor.B, screenColor.A);
 
         SRC_COLOR = GL_ZERO;
         DST_COLOR = GL_ONE_MINUS_SRC_COLOR;
@@ -1631,48 +1829,48 @@ void CubismShader_OpenGLES2::SetupShaderProgram(CubismRenderer_OpenGLES2* render
             break;
         }
 
-        glUseProgram(shaderSet->ShaderProgram);
+        state.UseProgram(shaderSet->ShaderProgram);
 
         // 頂点配列の設定
-        glEnableVertexAttribArray(shaderSet->AttributePositionLocation);
-        glVertexAttribPointer(shaderSet->AttributePositionLocation, 2, GL_FLOAT, GL_FALSE, sizeof(csmFloat32) * 2, vertexArray);
+        state.EnableVertexAttribArray(shaderSet->AttributePositionLocation);
+        state.VertexAttribPointer(shaderSet->AttributePositionLocation, mesh.PositionBuffer, mesh.Positions);
         // テクスチャ頂点の設定
-        glEnableVertexAttribArray(shaderSet->AttributeTexCoordLocation);
-        glVertexAttribPointer(shaderSet->AttributeTexCoordLocation, 2, GL_FLOAT, GL_FALSE, sizeof(csmFloat32) * 2, uvArray);
+        state.EnableVertexAttribArray(shaderSet->AttributeTexCoordLocation);
+        state.VertexAttribPointer(shaderSet->AttributeTexCoordLocation, mesh.UvBuffer, mesh.Uvs);
 
         if (masked)
         {
-            glActiveTexture(GL_TEXTURE1);
+            state.ActiveTexture(GL_TEXTURE1);
 
             // frameBufferに書かれたテクスチャ
             GLuint tex = renderer->GetMaskBuffer(renderer->GetClippingContextBufferForDraw()->_bufferIndex)->GetColorBuffer();
 
-            glBindTexture(GL_TEXTURE_2D, tex);
-            glUniform1i(shaderSet->SamplerTexture1Location, 1);
+            state.BindTexture2D(tex);
+            state.Uniform1i(shaderSet->SamplerTexture1Location, 1);
 
             // View座標をClippingContextの座標に変換するための行列を設定
-            glUniformMatrix4fv(shaderSet->UniformClipMatrixLocation, 1, 0, renderer->GetClippingContextBufferForDraw()->_matrixForDraw.GetArray());
+            state.UniformMatrix4fv(shaderSet->UniformClipMatrixLocation, renderer->GetClippingContextBufferForDraw()->_matrixForDraw.GetArray());
 
             // 使用するカラーチャンネルを設定
             const csmInt32 channelNo = renderer->GetClippingContextBufferForDraw()->_layoutChannelNo;
             CubismRenderer::CubismTextureColor* colorChannel = renderer->GetClippingContextBufferForDraw()->GetClippingManager()->GetChannelFlagAsColor(channelNo);
-            glUniform4f(shaderSet->UnifromChannelFlagLocation, colorChannel->R, colorChannel->G, colorChannel->B, colorChannel->A);
+            state.Uniform4f(shaderSet->UnifromChannelFlagLocation, colorChannel->R, colorChannel->G, colorChannel->B, colorChannel->A);
         }
 
         //テクスチャ設定
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, textureId);
-        glUniform1i(shaderSet->SamplerTexture0Location, 0);
+        state.ActiveTexture(GL_TEXTURE0);
+        state.BindTexture2D(textureId);
+        state.Uniform1i(shaderSet->SamplerTexture0Location, 0);
 
         //座標変換
-        glUniformMatrix4fv(shaderSet->UniformMatrixLocation, 1, 0, matrix4x4.GetArray()); //
+        state.UniformMatrix4fv(shaderSet->UniformMatrixLocation, matrix4x4.GetArray());
 
-        glUniform4f(shaderSet->UniformBaseColorLocation, baseColor.R, baseColor.G, baseColor.B, baseColor.A);
-        glUniform4f(shaderSet->UniformMultiplyColorLocation, multiplyColor.R, multiplyColor.G, multiplyColor.B, multiplyColor.A);
-        glUniform4f(shaderSet->UniformScreenColorLocation, screenColor.R, screenColor.G, screenColor.B, screenColor.A);
+        state.Uniform4f(shaderSet->UniformBaseColorLocation, baseColor.R, baseColor.G, baseColor.B, baseColor.A);
+        state.Uniform4f(shaderSet->UniformMultiplyColorLocation, multiplyColor.R, multiplyColor.G, multiplyColor.B, multiplyColor.A);
+        state.Uniform4f(shaderSet->UniformScreenColorLocation, screenColor.R, screenColor.G, screenColor.B, screenColor.A);
     }
 
-    glBlendFuncSeparate(SRC_COLOR, DST_COLOR, SRC_ALPHA, DST_ALPHA);
+    state.BlendFuncSeparate(SRC_COLOR, DST_COLOR, SRC_ALPHA, DST_ALPHA);
 }
 
 csmBool CubismShader_OpenGLES2::CompileShaderSource(GLuint* outShader, GLenum shaderType, const csmChar* shaderSource)
@@ -1841,6 +2039,10 @@ void CubismRenderer_OpenGLES2::ReloadShader()
 namespace {
 PFNGLACTIVETEXTUREPROC glActiveTexture;
 PFNGLBINDBUFFERPROC glBindBuffer;
+PFNGLGENBUFFERSPROC glGenBuffers;
+PFNGLDELETEBUFFERSPROC glDeleteBuffers;
+PFNGLBUFFERDATAPROC glBufferData;
+PFNGLBUFFERSUBDATAPROC glBufferSubData;
 PFNGLUSEPROGRAMPROC glUseProgram;
 PFNGLUNIFORM1IPROC glUniform1i;
 PFNGLGETATTRIBLOCATIONPROC glGetAttribLocation;
@@ -1901,6 +2103,10 @@ void CubismRenderer_OpenGLES2::InitializeGlFunctions()
     else return;
 
     glBindBuffer = (PFNGLBINDBUFFERPROC)WinGlGetProcAddress("glBindBuffer");
+    glGenBuffers = (PFNGLGENBUFFERSPROC)WinGlGetProcAddress("glGenBuffers");
+    glDeleteBuffers = (PFNGLDELETEBUFFERSPROC)WinGlGetProcAddress("glDeleteBuffers");
+    glBufferData = (PFNGLBUFFERDATAPROC)WinGlGetProcAddress("glBufferData");
+    glBufferSubData = (PFNGLBUFFERSUBDATAPROC)WinGlGetProcAddress("glBufferSubData");
     glUseProgram = (PFNGLUSEPROGRAMPROC)WinGlGetProcAddress("glUseProgram");
 
     glUniform1i = (PFNGLUNIFORM1IPROC)WinGlGetProcAddress("glUniform1i");
@@ -1967,6 +2173,547 @@ void CubismRenderer_OpenGLES2::CheckGlError(const csmChar* message)
 
 #endif  //CSM_TARGET_WIN_GL
 
+/*********************************************************************************************************************
+*                                      CubismRendererStateCache_OpenGLES2
+********************************************************************************************************************/
+namespace {
+    /**
+     * @brief   覚える機能の番号を取得する。覚えない機能なら-1
+     */
+    csmInt32 GetCapabilityIndex(GLenum capability)
+    {
+        switch (capability)
+        {
+        case GL_BLEND:
+            return 0;
+        case GL_CULL_FACE:
+            return 1;
+        case GL_DEPTH_TEST:
+            return 2;
+        case GL_SCISSOR_TEST:
+            return 3;
+        case GL_STENCIL_TEST:
+            return 4;
+        default:
+            return -1;
+        }
+    }
+}
+
+CubismRendererStateCache_OpenGLES2::CubismRendererStateCache_OpenGLES2()
+{
+    Invalidate();
+}
+
+void CubismRendererStateCache_OpenGLES2::Invalidate()
+{
+    _program = UnknownValue;
+    _uniformProgramIndex = -1;
+    _activeTexture = UnknownValue;
+    for (csmInt32 i = 0; i < TextureUnitCount; ++i)
+    {
+        _textures[i] = UnknownValue;
+    }
+    _arrayBuffer = UnknownValue;
+    _elementArrayBuffer = UnknownValue;
+    for (csmInt32 i = 0; i < CapabilityCount; ++i)
+    {
+        _capabilities[i] = -1;
+    }
+    for (csmInt32 i = 0; i < VertexAttribCount; ++i)
+    {
+        _vertexAttribEnabled[i] = -1;
+        _vertexAttribBuffers[i] = UnknownValue;
+        _vertexAttribPointers[i] = NULL;
+    }
+    _frontFace = UnknownValue;
+    _colorMask = -1;
+    for (csmInt32 i = 0; i < 4; ++i)
+    {
+        _blendFunc[i] = UnknownValue;
+    }
+    for (csmInt32 i = 0; i < ProgramCount; ++i)
+    {
+        _uniformPrograms[i] = 0;
+    }
+}
+
+void CubismRendererStateCache_OpenGLES2::UseProgram(GLuint program)
+{
+    if (_program == program)
+    {
+        return;
+    }
+    glUseProgram(program);
+    _program = program;
+
+    // このプログラムのユニフォームを覚える位置を探す。初めてのプログラムなら空きを使う
+    _uniformProgramIndex = -1;
+    if (program == 0)
+    {
+        return;
+    }
+    for (csmInt32 i = 0; i < ProgramCount; ++i)
+    {
+        if (_uniformPrograms[i] == program)
+        {
+            _uniformProgramIndex = i;
+            return;
+        }
+        if (_uniformPrograms[i] == 0)
+        {
+            _uniformPrograms[i] = program;
+            for (csmInt32 j = 0; j < UniformLocationCount; ++j)
+            {
+                _isUniformValid[i][j] = false;
+            }
+            _uniformProgramIndex = i;
+            return;
+        }
+    }
+}
+
+void CubismRendererStateCache_OpenGLES2::ActiveTexture(GLenum textureUnit)
+{
+    if (_activeTexture == textureUnit)
+    {
+        return;
+    }
+    glActiveTexture(textureUnit);
+    _activeTexture = textureUnit;
+}
+
+void CubismRendererStateCache_OpenGLES2::BindTexture2D(GLuint texture)
+{
+    const GLenum unit = _activeTexture - GL_TEXTURE0;
+    if (_activeTexture != UnknownValue && unit < static_cast<GLenum>(TextureUnitCount))
+    {
+        if (_textures[unit] == texture)
+        {
+            return;
+        }
+        _textures[unit] = texture;
+    }
+    glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+void CubismRendererStateCache_OpenGLES2::BindArrayBuffer(GLuint buffer)
+{
+    if (_arrayBuffer == buffer)
+    {
+        return;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    _arrayBuffer = buffer;
+}
+
+void CubismRendererStateCache_OpenGLES2::BindElementArrayBuffer(GLuint buffer)
+{
+    if (_elementArrayBuffer == buffer)
+    {
+        return;
+    }
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer);
+    _elementArrayBuffer = buffer;
+}
+
+void CubismRendererStateCache_OpenGLES2::SetEnabled(GLenum capability, csmBool enabled)
+{
+    const csmInt32 index = GetCapabilityIndex(capability);
+    if (index >= 0)
+    {
+        if (_capabilities[index] == (enabled ? 1 : 0))
+        {
+            return;
+        }
+        _capabilities[index] = enabled ? 1 : 0;
+    }
+
+    if (enabled)
+    {
+        glEnable(capability);
+    }
+    else
+    {
+        glDisable(capability);
+    }
+}
+
+void CubismRendererStateCache_OpenGLES2::EnableVertexAttribArray(GLuint index)
+{
+    if (index < static_cast<GLuint>(VertexAttribCount))
+    {
+        if (_vertexAttribEnabled[index] == 1)
+        {
+            return;
+        }
+        _vertexAttribEnabled[index] = 1;
+    }
+    glEnableVertexAttribArray(index);
+}
+
+void CubismRendererStateCache_OpenGLES2::VertexAttribPointer(GLuint index, GLuint buffer, const void* pointer)
+{
+    // 頂点属性は設定時にバインドしていたバッファを参照し続けるので、バッファとオフセットの組で比べる
+    if (index < static_cast<GLuint>(VertexAttribCount))
+    {
+        if (_vertexAttribBuffers[index] == buffer && _vertexAttribPointers[index] == pointer)
+        {
+            return;
+        }
+        _vertexAttribBuffers[index] = buffer;
+        _vertexAttribPointers[index] = pointer;
+    }
+    BindArrayBuffer(buffer);
+    glVertexAttribPointer(index, 2, GL_FLOAT, GL_FALSE, sizeof(csmFloat32) * 2, pointer);
+}
+
+void CubismRendererStateCache_OpenGLES2::FrontFace(GLenum mode)
+{
+    if (_frontFace == mode)
+    {
+        return;
+    }
+    glFrontFace(mode);
+    _frontFace = mode;
+}
+
+void CubismRendererStateCache_OpenGLES2::ColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
+{
+    const csmInt32 mask = (red ? 1 : 0) | (green ? 2 : 0) | (blue ? 4 : 0) | (alpha ? 8 : 0);
+    if (_colorMask == mask)
+    {
+        return;
+    }
+    glColorMask(red, green, blue, alpha);
+    _colorMask = mask;
+}
+
+void CubismRendererStateCache_OpenGLES2::BlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
+{
+    if (_blendFunc[0] == srcRGB && _blendFunc[1] == dstRGB && _blendFunc[2] == srcAlpha && _blendFunc[3] == dstAlpha)
+    {
+        return;
+    }
+    glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+    _blendFunc[0] = srcRGB;
+    _blendFunc[1] = dstRGB;
+    _blendFunc[2] = srcAlpha;
+    _blendFunc[3] = dstAlpha;
+}
+
+csmBool CubismRendererStateCache_OpenGLES2::IsSameUniform(GLint location, const void* value, csmUint32 size)
+{
+    if (_uniformProgramIndex < 0 || location >= UniformLocationCount)
+    {
+        return false;
+    }
+
+    csmFloat32* cached = _uniformValues[_uniformProgramIndex][location];
+    csmBool& isValid = _isUniformValid[_uniformProgramIndex][location];
+    if (isValid && memcmp(cached, value, size) == 0)
+    {
+        return true;
+    }
+    memcpy(cached, value, size);
+    isValid = true;
+    return false;
+}
+
+void CubismRendererStateCache_OpenGLES2::Uniform1i(GLint location, GLint value)
+{
+    // シェーダにないユニフォーム（-1）への設定はOpenGLでも無視される
+    if (location < 0 || IsSameUniform(location, &value, sizeof(value)))
+    {
+        return;
+    }
+    glUniform1i(location, value);
+}
+
+void CubismRendererStateCache_OpenGLES2::Uniform4f(GLint location, csmFloat32 x, csmFloat32 y, csmFloat32 z, csmFloat32 w)
+{
+    const csmFloat32 value[4] = { x, y, z, w };
+    if (location < 0 || IsSameUniform(location, value, sizeof(value)))
+    {
+        return;
+    }
+    glUniform4f(location, x, y, z, w);
+}
+
+void CubismRendererStateCache_OpenGLES2::UniformMatrix4fv(GLint location, const csmFloat32* matrix)
+{
+    if (location < 0 || IsSameUniform(location, matrix, sizeof(csmFloat32) * 16))
+    {
+        return;
+    }
+    glUniformMatrix4fv(location, 1, GL_FALSE, matrix);
+}
+
+/*********************************************************************************************************************
+*                                      CubismMeshBuffers_OpenGLES2
+********************************************************************************************************************/
+namespace {
+    const csmUint32 PositionRegionAlignment = 256;  ///< UV・頂点座標の各領域の先頭をそろえる境界（バイト）
+
+    const void* BufferOffset(csmUint32 offset)
+    {
+        return reinterpret_cast<const void*>(static_cast<csmSizeType>(offset));
+    }
+}
+
+CubismMeshBuffers_OpenGLES2::CubismMeshBuffers_OpenGLES2()
+    : _indexBuffer(0)
+    , _vertexBuffer(0)
+    , _positionRegionSize(0)
+    , _regionCount(1)
+    , _currentRegion(0)
+    , _mappedPositions(NULL)
+    , _isIndexRebased(false)
+{
+#ifdef CSM_GL_BUFFER_STORAGE
+    for (csmInt32 i = 0; i < PositionRegionCount; ++i)
+    {
+        _regionFences[i] = NULL;
+    }
+#endif
+}
+
+CubismMeshBuffers_OpenGLES2::~CubismMeshBuffers_OpenGLES2()
+{
+    Release();
+}
+
+void CubismMeshBuffers_OpenGLES2::Initialize(const CubismModel& model)
+{
+    if (IsInitialized())
+    {
+        return;
+    }
+
+    const csmInt32 drawableCount = model.GetDrawableCount();
+    _indexOffsets.Resize(drawableCount, 0);
+    _vertexOffsets.Resize(drawableCount, 0);
+    _vertexSizes.Resize(drawableCount, 0);
+
+    // 描画オブジェクトを順に詰めて並べる
+    csmUint32 indexBytes = 0;
+    csmUint32 vertexBytes = 0;
+    for (csmInt32 i = 0; i < drawableCount; ++i)
+    {
+        _indexOffsets[i] = indexBytes;
+        _vertexOffsets[i] = vertexBytes;
+        _vertexSizes[i] = model.GetDrawableVertexCount(i) * sizeof(csmFloat32) * 2;
+        indexBytes += model.GetDrawableVertexIndexCount(i) * sizeof(csmUint16);
+        vertexBytes += _vertexSizes[i];
+    }
+    _positionRegionSize = (vertexBytes + PositionRegionAlignment - 1) / PositionRegionAlignment * PositionRegionAlignment;
+
+    csmVector<csmByte> staging;
+    staging.Resize((indexBytes > _positionRegionSize ? indexBytes : _positionRegionSize) + 1, 0);
+
+    // 頂点の総数が16bitに収まれば、インデックスに描画オブジェクトの先頭の頂点番号を足しておく。
+    // 頂点属性をバッファの先頭に向けたまま全描画オブジェクトを描けるので、描画ごとの設定が要らなくなる
+    _isIndexRebased = vertexBytes / (sizeof(csmFloat32) * 2) <= 0x10000;
+    for (csmInt32 i = 0; i < drawableCount; ++i)
+    {
+        const csmInt32 indexCount = model.GetDrawableVertexIndexCount(i);
+        csmUint16* indices = reinterpret_cast<csmUint16*>(staging.GetPtr() + _indexOffsets[i]);
+        memcpy(indices, model.GetDrawableVertexIndices(i), indexCount * sizeof(csmUint16));
+        if (_isIndexRebased)
+        {
+            const csmUint16 baseVertex = static_cast<csmUint16>(_vertexOffsets[i] / (sizeof(csmFloat32) * 2));
+            for (csmInt32 j = 0; j < indexCount; ++j)
+            {
+                indices[j] = static_cast<csmUint16>(indices[j] + baseVertex);
+            }
+        }
+    }
+    glGenBuffers(1, &_indexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, staging.GetPtr(), GL_STATIC_DRAW);
+
+    for (csmInt32 i = 0; i < drawableCount; ++i)
+    {
+        memcpy(staging.GetPtr() + _vertexOffsets[i], model.GetDrawableVertexUvs(i), _vertexSizes[i]);
+    }
+
+    // 初回はすべての描画オブジェクトを転送させる
+    _positionShadow.Resize(_positionRegionSize, 0);
+    for (csmInt32 i = 0; i < drawableCount; ++i)
+    {
+        memcpy(_positionShadow.GetPtr() + _vertexOffsets[i], model.GetDrawableVertices(i), _vertexSizes[i]);
+    }
+    _positionVersions.Resize(drawableCount, 1);
+    CreateVertexBuffer(staging.GetPtr(), drawableCount);
+}
+
+void CubismMeshBuffers_OpenGLES2::CreateVertexBuffer(const csmByte* uvs, csmInt32 drawableCount)
+{
+    glGenBuffers(1, &_vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+
+#ifdef CSM_GL_BUFFER_STORAGE
+    if (GLEW_ARB_buffer_storage)
+    {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        const GLsizeiptr size = static_cast<GLsizeiptr>(_positionRegionSize) * (1 + PositionRegionCount);
+        glBufferStorage(GL_ARRAY_BUFFER, size, NULL, flags);
+        csmByte* mapped = static_cast<csmByte*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+        if (mapped != NULL)
+        {
+            memcpy(mapped, uvs, _positionRegionSize);
+            _mappedPositions = mapped + _positionRegionSize;
+            _regionCount = PositionRegionCount;
+            _uploadedVersions.Resize(drawableCount * _regionCount, 0);
+            return;
+        }
+
+        // glBufferStorageで確保した領域は作り直せないので、バッファごと作り直す
+        CubismLogWarning("Failed to map the vertex buffer persistently. Fall back to glBufferSubData.");
+        glDeleteBuffers(1, &_vertexBuffer);
+        glGenBuffers(1, &_vertexBuffer);
+        glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+    }
+#endif
+
+    _regionCount = 1;
+    _uploadedVersions.Resize(drawableCount, 0);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(_positionRegionSize) * 2, NULL, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, _positionRegionSize, uvs);
+}
+
+void CubismMeshBuffers_OpenGLES2::UpdatePositions(const CubismModel& model)
+{
+    const csmInt32 drawableCount = model.GetDrawableCount();
+    for (csmInt32 i = 0; i < drawableCount; ++i)
+    {
+        if (!model.GetDrawableDynamicFlagVertexPositionsDidChange(i))
+        {
+            continue;
+        }
+
+        // フラグは内容が同じでも立つので、前回の座標と比べて実際に変わったときだけ版を進める
+        csmByte* shadow = _positionShadow.GetPtr() + _vertexOffsets[i];
+        const csmFloat32* positions = model.GetDrawableVertices(i);
+        if (memcmp(shadow, positions, _vertexSizes[i]) != 0)
+        {
+            memcpy(shadow, positions, _vertexSizes[i]);
+            ++_positionVersions[i];
+        }
+    }
+
+    csmUint32* uploadedVersions = _uploadedVersions.GetPtr() + _currentRegion * drawableCount;
+
+#ifdef CSM_GL_BUFFER_STORAGE
+    if (_mappedPositions != NULL)
+    {
+        // GPUがこの領域を読み終えるまで待つ。PositionRegionCountフレーム前の描画なので通常は待たない
+        if (_regionFences[_currentRegion] != NULL)
+        {
+            glClientWaitSync(_regionFences[_currentRegion], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+            glDeleteSync(_regionFences[_currentRegion]);
+            _regionFences[_currentRegion] = NULL;
+        }
+
+        csmByte* region = _mappedPositions + _currentRegion * _positionRegionSize;
+        for (csmInt32 i = 0; i < drawableCount; ++i)
+        {
+            if (uploadedVersions[i] != _positionVersions[i])
+            {
+                memcpy(region + _vertexOffsets[i], _positionShadow.GetPtr() + _vertexOffsets[i], _vertexSizes[i]);
+                uploadedVersions[i] = _positionVersions[i];
+            }
+        }
+        return;
+    }
+#endif
+
+    // 変化した描画オブジェクトの範囲をまとめ、写しから一度で転送する
+    csmUint32 dirtyBegin = _positionRegionSize;
+    csmUint32 dirtyEnd = 0;
+    for (csmInt32 i = 0; i < drawableCount; ++i)
+    {
+        if (uploadedVersions[i] == _positionVersions[i])
+        {
+            continue;
+        }
+        uploadedVersions[i] = _positionVersions[i];
+        if (_vertexOffsets[i] < dirtyBegin)
+        {
+            dirtyBegin = _vertexOffsets[i];
+        }
+        if (_vertexOffsets[i] + _vertexSizes[i] > dirtyEnd)
+        {
+            dirtyEnd = _vertexOffsets[i] + _vertexSizes[i];
+        }
+    }
+    if (dirtyBegin >= dirtyEnd)
+    {
+        return;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+    glBufferSubData(GL_ARRAY_BUFFER, _positionRegionSize + dirtyBegin, dirtyEnd - dirtyBegin, _positionShadow.GetPtr() + dirtyBegin);
+}
+
+void CubismMeshBuffers_OpenGLES2::EndFrame()
+{
+#ifdef CSM_GL_BUFFER_STORAGE
+    if (_mappedPositions != NULL)
+    {
+        _regionFences[_currentRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+#endif
+    _currentRegion = (_currentRegion + 1) % _regionCount;
+}
+
+void CubismMeshBuffers_OpenGLES2::GetBinding(csmInt32 drawableIndex, CubismMeshBinding_OpenGLES2& binding) const
+{
+    // インデックスが通し番号なら、頂点属性は描画オブジェクトによらず領域の先頭を指す
+    const csmUint32 vertexOffset = _isIndexRebased ? 0 : _vertexOffsets[drawableIndex];
+    binding.PositionBuffer = _vertexBuffer;
+    binding.Positions = BufferOffset((1 + _currentRegion) * _positionRegionSize + vertexOffset);
+    binding.UvBuffer = _vertexBuffer;
+    binding.Uvs = BufferOffset(vertexOffset);
+    binding.IndexBuffer = _indexBuffer;
+    binding.Indices = BufferOffset(_indexOffsets[drawableIndex]);
+}
+
+void CubismMeshBuffers_OpenGLES2::Release()
+{
+    if (!IsInitialized())
+    {
+        return;
+    }
+
+#ifdef CSM_GL_BUFFER_STORAGE
+    for (csmInt32 i = 0; i < PositionRegionCount; ++i)
+    {
+        if (_regionFences[i] != NULL)
+        {
+            glDeleteSync(_regionFences[i]);
+            _regionFences[i] = NULL;
+        }
+    }
+#endif
+
+    // 永続マップはバッファの破棄で解除される
+    glDeleteBuffers(1, &_vertexBuffer);
+    glDeleteBuffers(1, &_indexBuffer);
+    _vertexBuffer = 0;
+    _indexBuffer = 0;
+    _mappedPositions = NULL;
+    _isIndexRebased = false;
+    _regionCount = 1;
+    _currentRegion = 0;
+    _positionShadow.Clear();
+    _uploadedVersions.Clear();
+    _positionVersions.Clear();
+}
+
+/*********************************************************************************************************************
+*                                      CubismRenderer_OpenGLES2
+********************************************************************************************************************/
 CubismRenderer* CubismRenderer::Create()
 {
     return CSM_NEW CubismRenderer_OpenGLES2();
@@ -1980,6 +2727,7 @@ void CubismRenderer::StaticRelease()
 CubismRenderer_OpenGLES2::CubismRenderer_OpenGLES2() : _clippingManager(NULL)
                                                      , _clippingContextBufferForMask(NULL)
                                                      , _clippingContextBufferForDraw(NULL)
+                                                     , _isUsingProfileSaveRestore(true)
 {
     // テクスチャ対応マップの容量を確保しておく.
     _textures.PrepareCapacity(32, true);
@@ -2055,26 +2803,26 @@ void CubismRenderer_OpenGLES2::PreDraw()
     if (!s_isInitializeGlFunctionsSuccess) return;
 #endif
 
-    glDisable(GL_SCISSOR_TEST);
-    glDisable(GL_STENCIL_TEST);
-    glDisable(GL_DEPTH_TEST);
+    _stateCache.SetEnabled(GL_SCISSOR_TEST, false);
+    _stateCache.SetEnabled(GL_STENCIL_TEST, false);
+    _stateCache.SetEnabled(GL_DEPTH_TEST, false);
 
-    glEnable(GL_BLEND);
-    glColorMask(1, 1, 1, 1);
+    _stateCache.SetEnabled(GL_BLEND, true);
+    _stateCache.ColorMask(1, 1, 1, 1);
 
 #ifdef CSM_TARGET_IPHONE_ES2
     glBindVertexArrayOES(0);
 #endif
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0); //前にバッファがバインドされていたら破棄する必要がある
+    _stateCache.BindElementArrayBuffer(0);
+    _stateCache.BindArrayBuffer(0); //前にバッファがバインドされていたら破棄する必要がある
 
     //異方性フィルタリング。プラットフォームのOpenGLによっては未対応の場合があるので、未設定のときは設定しない
     if (GetAnisotropy() > 0.0f)
     {
         for (csmInt32 i = 0; i < _textures.GetSize(); i++)
         {
-            glBindTexture(GL_TEXTURE_2D, _textures[i]);
+            _stateCache.BindTexture2D(_textures[i]);
             glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, GetAnisotropy());
         }
     }
@@ -2083,6 +2831,18 @@ void CubismRenderer_OpenGLES2::PreDraw()
 
 void CubismRenderer_OpenGLES2::DoDrawModel()
 {
+#ifdef CSM_TARGET_WIN_GL
+    if (s_isFirstInitializeGlFunctions) InitializeGlFunctions();
+    if (!s_isInitializeGlFunctionsSuccess) return;
+#endif
+
+    // 頂点座標はフレームの最初に一度だけ転送し、マスク生成と描画の両方で参照する
+    _meshBuffers.Initialize(*GetModel());
+    _meshBuffers.UpdatePositions(*GetModel());
+
+    // 前のフレームの後にホストや他のモデルがステートを変えているかもしれないので、覚えている値を捨てる
+    _stateCache.Invalidate();
+
     //------------ 限幅掩模缓冲器预处理方式时 ------------
     if (_clippingManager != NULL)
     {
@@ -2096,6 +2856,8 @@ void CubismRenderer_OpenGLES2::DoDrawModel()
             {
                 _offscreenFrameBuffers[i].CreateOffscreenFrame(
                     static_cast<csmUint32>(_clippingManager->GetClippingMaskBufferSize().X), static_cast<csmUint32>(_clippingManager->GetClippingMaskBufferSize().Y));
+                _clippingManager->InvalidateMasks();
+                _stateCache.Invalidate();   // 作成時にテクスチャのバインドが変わる
             }
         }
 
@@ -2168,16 +2930,9 @@ void CubismRenderer_OpenGLES2::DoDrawModel()
                     // 还需要切换频道(A,R,G,B)
                     SetClippingContextBufferForMask(clipContext);
 
-                    DrawMeshOpenGL(
-                        GetModel()->GetDrawableTextureIndex(clipDrawIndex),
-                        GetModel()->GetDrawableVertexIndexCount(clipDrawIndex),
-                        GetModel()->GetDrawableVertexCount(clipDrawIndex),
-                        const_cast<csmUint16*>(GetModel()->GetDrawableVertexIndices(clipDrawIndex)),
-                        const_cast<csmFloat32*>(GetModel()->GetDrawableVertices(clipDrawIndex)),
-                        reinterpret_cast<csmFloat32*>(const_cast<Core::csmVector2*>(GetModel()->GetDrawableVertexUvs(clipDrawIndex))),
-                        GetModel()->GetMultiplyColor(clipDrawIndex),
-                        GetModel()->GetScreenColor(clipDrawIndex),
-                        GetModel()->GetDrawableOpacity(clipDrawIndex),
+                    DrawDrawableOpenGL(
+                        *GetModel(),
+                        clipDrawIndex,
                         CubismRenderer::CubismBlendMode_Normal,   //裁剪通常强制绘制
                         false // 生成遮罩时，与剪辑的反转使用完全没有关系
                     );
@@ -2199,16 +2954,9 @@ void CubismRenderer_OpenGLES2::DoDrawModel()
 
         IsCulling(GetModel()->GetDrawableCulling(drawableIndex) != 0);
 
-        DrawMeshOpenGL(
-            GetModel()->GetDrawableTextureIndex(drawableIndex),
-            GetModel()->GetDrawableVertexIndexCount(drawableIndex),
-            GetModel()->GetDrawableVertexCount(drawableIndex),
-            const_cast<csmUint16*>(GetModel()->GetDrawableVertexIndices(drawableIndex)),
-            const_cast<csmFloat32*>(GetModel()->GetDrawableVertices(drawableIndex)),
-            reinterpret_cast<csmFloat32*>(const_cast<Core::csmVector2*>(GetModel()->GetDrawableVertexUvs(drawableIndex))),
-            GetModel()->GetMultiplyColor(drawableIndex),
-            GetModel()->GetScreenColor(drawableIndex),
-            GetModel()->GetDrawableOpacity(drawableIndex),
+        DrawDrawableOpenGL(
+            *GetModel(),
+            drawableIndex,
             GetModel()->GetDrawableBlendMode(drawableIndex),
             GetModel()->GetDrawableInvertedMask(drawableIndex) // 使用翻转遮罩
         );
@@ -2216,6 +2964,7 @@ void CubismRenderer_OpenGLES2::DoDrawModel()
 
     PostDraw();
 
+    _meshBuffers.EndFrame();
 }
 
 void CubismRenderer_OpenGLES2::DrawMesh(csmInt32 textureNo, csmInt32 indexCount, csmInt32 vertexCount
@@ -2231,6 +2980,43 @@ void CubismRenderer_OpenGLES2::DrawMeshOpenGL(csmInt32 textureNo, csmInt32 index
                                         , const CubismTextureColor& multiplyColor, const CubismTextureColor& screenColor
                                         , csmFloat32 opacity, CubismBlendMode colorBlendMode, csmBool invertedMask)
 {
+    // クライアントメモリの頂点配列をそのまま参照する
+    CubismMeshBinding_OpenGLES2 mesh;
+    mesh.PositionBuffer = 0;
+    mesh.Positions = vertexArray;
+    mesh.UvBuffer = 0;
+    mesh.Uvs = uvArray;
+    mesh.IndexBuffer = 0;
+    mesh.Indices = indexArray;
+
+    // DrawModelの外から呼ばれた場合は現在のステートが分からない
+    _stateCache.Invalidate();
+    DrawMeshBinding(textureNo, indexCount, mesh, multiplyColor, screenColor, opacity, colorBlendMode, invertedMask);
+    _stateCache.UseProgram(0);
+}
+
+void CubismRenderer_OpenGLES2::DrawDrawableOpenGL(const CubismModel& model, csmInt32 drawableIndex
+                                        , CubismBlendMode colorBlendMode, csmBool invertedMask)
+{
+    CubismMeshBinding_OpenGLES2 mesh;
+    _meshBuffers.GetBinding(drawableIndex, mesh);
+
+    DrawMeshBinding(
+        model.GetDrawableTextureIndex(drawableIndex),
+        model.GetDrawableVertexIndexCount(drawableIndex),
+        mesh,
+        model.GetMultiplyColor(drawableIndex),
+        model.GetScreenColor(drawableIndex),
+        model.GetDrawableOpacity(drawableIndex),
+        colorBlendMode,
+        invertedMask
+    );
+}
+
+void CubismRenderer_OpenGLES2::DrawMeshBinding(csmInt32 textureNo, csmInt32 indexCount, const CubismMeshBinding_OpenGLES2& mesh
+                                        , const CubismTextureColor& multiplyColor, const CubismTextureColor& screenColor
+                                        , csmFloat32 opacity, CubismBlendMode colorBlendMode, csmBool invertedMask)
+{
 
 #ifdef CSM_TARGET_WIN_GL
     if (s_isFirstInitializeGlFunctions) return;  // WindowsプラットフォームではGL命令のバインドを済ませておく必要がある
@@ -2241,16 +3027,9 @@ void CubismRenderer_OpenGLES2::DrawMeshOpenGL(csmInt32 textureNo, csmInt32 index
 #endif
 
     // 裏面描画の有効・無効
-    if (IsCulling())
-    {
-        glEnable(GL_CULL_FACE);
-    }
-    else
-    {
-        glDisable(GL_CULL_FACE);
-    }
+    _stateCache.SetEnabled(GL_CULL_FACE, IsCulling());
 
-    glFrontFace(GL_CCW);    // Cubism SDK OpenGLはマスク・アートメッシュ共にCCWが表面
+    _stateCache.FrontFace(GL_CCW);    // Cubism SDK OpenGLはマスク・アートメッシュ共にCCWが表面
 
     CubismTextureColor modelColorRGBA = GetModelColor();
 
@@ -2279,32 +3058,58 @@ void CubismRenderer_OpenGLES2::DrawMeshOpenGL(csmInt32 textureNo, csmInt32 index
     }
 
     CubismShader_OpenGLES2::GetInstance()->SetupShaderProgram(
-        this, drawTextureId, vertexCount, vertexArray, uvArray
+        this, drawTextureId, mesh
         , opacity, colorBlendMode, modelColorRGBA, multiplyColor, screenColor, IsPremultipliedAlpha()
         , GetMvpMatrix(), invertedMask
     );
 
     // ポリゴンメッシュを描画する
-    glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_SHORT, indexArray);
+    _stateCache.BindElementArrayBuffer(mesh.IndexBuffer);
+    glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_SHORT, mesh.Indices);
 
     // 後処理
-    glUseProgram(0);
+    // シェーダプログラムは次の描画でも使うことが多いので外さない。描画後のステートはRestoreProfileが戻す
     SetClippingContextBufferForDraw(NULL);
     SetClippingContextBufferForMask(NULL);
 }
 
 void CubismRenderer_OpenGLES2::SaveProfile()
 {
+    if (!_isUsingProfileSaveRestore)
+    {
+        // 復帰しない場合も、マスクを描いた後に戻すフレームバッファとビューポートは必要
+        _rendererProfile.SaveFramebuffer();
+        return;
+    }
     _rendererProfile.Save();
 }
 
 void CubismRenderer_OpenGLES2::RestoreProfile()
 {
+    if (!_isUsingProfileSaveRestore)
+    {
+        return;
+    }
     _rendererProfile.Restore();
 }
 
+void CubismRenderer_OpenGLES2::UseProfileSaveRestore(csmBool enable)
+{
+    _isUsingProfileSaveRestore = enable;
+}
+
+csmBool CubismRenderer_OpenGLES2::IsUsingProfileSaveRestore() const
+{
+    return _isUsingProfileSaveRestore;
+}
+
 void CubismRenderer_OpenGLES2::BindTexture(csmUint32 modelTextureNo, GLuint glTextureNo)
 {
+    // マスクはテクスチャのアルファから作るので、差し替えたら描き直す
+    if (_clippingManager != NULL && _textures[modelTextureNo] != glTextureNo)
+    {
+        _clippingManager->InvalidateMasks();
+    }
     _textures[modelTextureNo] = glTextureNo;
 }
 
@@ -39,12 +39,17 @@
 #include <OpenGL/gl.h>
 #endif
 
+#if defined(CSM_TARGET_WIN_GL) || defined(CSM_TARGET_LINUX_GL) || (defined(CSM_TARGET_MAC_GL) && !defined(CSM_TARGET_COCOS))
+#define CSM_GL_BUFFER_STORAGE   ///< GLEW経由でGL_ARB_buffer_storage(永続マップ)を利用できる環境
+#endif
+
 //------------ LIVE2D NAMESPACE ------------
 namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
 
 //  前方宣言
 class CubismRenderer_OpenGLES2;
 class CubismClippingContext;
+class CubismRendererStateCache_OpenGLES2;
 
 /**
  * @brief  クリッピングマスクの処理を実行するクラス
@@ -72,6 +77,21 @@ private:
      */
     void CalcClippedDrawTotalBounds(CubismModel& model, CubismClippingContext* clippingContext);
 
+    /**
+     * @brief   マスクのレイアウト領域を1チャンネル分だけクリアする<br>
+     *           一部のマスクだけを描き直すときに、同じレンダーテクスチャの他のマスクを残すために使う。
+     *
+     * @param[in]   stateCache       ->  レンダラが設定したOpenGLのステート
+     * @param[in]   clippingContext  ->  クリッピングマスクのコンテキスト
+     */
+    void ClearLayoutBounds(CubismRendererStateCache_OpenGLES2& stateCache, const CubismClippingContext* clippingContext);
+
+    /**
+     * @brief   次のフレームですべてのマスクの矩形計算と描画をやり直させる<br>
+     *           マスクの描画結果に影響するがフレームごとの変化検出で捉えられない変更（テクスチャ、レンダーテクスチャの再作成）の後に呼ぶ。
+     */
+    void InvalidateMasks();
+
     /**
      * @brief    コンストラクタ
      */
@@ -156,6 +176,9 @@ private:
 
     CubismOffscreenFrame_OpenGLES2* _currentOffscreenFrame; /// オフスクリーンフレームのアドレス
     csmVector<csmBool> _clearedFrameBufferFlags; /// マスクのクリアフラグの配列
+    csmVector<csmBool> _keptFrameBufferFlags;    /// 前回のマスクを残すレンダーテクスチャのフラグの配列
+    csmBool _isMaskInvalidated;                 /// trueなら次のフレームで全マスクの矩形計算と描画をやり直す
+    csmInt32 _layoutClipCount;                  /// 前回レイアウトを決めたときのクリッピングコンテキスト数（未決定なら-1）
 
     csmVector<CubismRenderer::CubismTextureColor*>  _channelColors;
     csmVector<CubismClippingContext*>               _clippingContextListForMask;   ///< マスク用クリッピングコンテキストのリスト
@@ -217,6 +240,226 @@ public:
     CubismMatrix44 _matrixForDraw;                   ///< 描画オブジェクトの位置計算結果を保持する行列
     csmVector<csmInt32>* _clippedDrawableIndexList;  ///< このマスクにクリップされる描画オブジェクトのリスト
     csmInt32 _bufferIndex;                           ///< このマスクが割り当てられるレンダーテクスチャ（フレームバッファ）やカラーバッファのインデックス
+    csmBool _isMaskDirty;                            ///< マスクの矩形・レイアウト・頂点のいずれかが前回描いたときから変わっていればtrue
+    csmUint32 _clippedPositionStamp;                 ///< 前回矩形を計算したときの、クリップされる描画オブジェクトの頂点座標の版の合計
+    csmUint32 _maskPositionStamp;                    ///< 前回マスクを描いたときの、マスク用描画オブジェクトの頂点座標の版の合計
+};
+
+/**
+ * @brief   描画に使う頂点データの所在<br>
+ *           バッファ名が0のときポインタはクライアントメモリのアドレス、0以外のときはバッファ内のバイトオフセットを表す。
+ */
+struct CubismMeshBinding_OpenGLES2
+{
+    GLuint PositionBuffer;      ///< 頂点座標のバッファ
+    const void* Positions;      ///< 頂点座標の先頭
+    GLuint UvBuffer;            ///< UVのバッファ
+    const void* Uvs;            ///< UVの先頭
+    GLuint IndexBuffer;         ///< インデックスのバッファ
+    const void* Indices;        ///< インデックスの先頭
+};
+
+/**
+ * @brief   描画オブジェクトの頂点データをGPUのバッファに保持するクラス<br>
+ *           インデックスとUVはモデルの生存中に変わらないので、描画オブジェクトごとの領域を一度だけ確保・転送する。<br>
+ *           頂点座標はフレームの最初に、前回から変化した描画オブジェクトの分だけ書き込む。
+ *           Coreの変化フラグは内容が同じでも立つことがあるので、前回の座標と比較して実際に変わったものだけ版を進める。<br>
+ *           UVと頂点座標は同じ頂点バッファの別領域に置き、描画ごとのバッファの切り替えを発生させない。
+ *           頂点の総数が16bitのインデックスに収まる場合はインデックスを通し番号に書き換え、頂点属性の設定を共通にする。<br>
+ *           GL_ARB_buffer_storageが使える場合は永続マップした頂点座標の領域を複数持ち、フェンスで順番に使う。
+ *           使えない場合は変化した範囲をまとめてglBufferSubDataで転送する。
+ */
+class CubismMeshBuffers_OpenGLES2
+{
+    friend class CubismRenderer_OpenGLES2;
+
+private:
+    static const csmInt32 PositionRegionCount = 3;  ///< 永続マップ時の頂点座標の領域数（GPUが読み終えるまで前の領域に触れない）
+
+    CubismMeshBuffers_OpenGLES2();
+
+    ~CubismMeshBuffers_OpenGLES2();
+
+    /**
+     * @brief   バッファを作成し、インデックスとUVを転送する<br>
+     *           作成済みの場合は何もしない。GLコンテキストがカレントの状態で呼ぶこと。
+     *
+     * @param[in]   model   ->  モデルのインスタンス
+     */
+    void Initialize(const CubismModel& model);
+
+    /**
+     * @brief   頂点座標をこのフレームの領域へ書き込む<br>
+     *           GetDrawableDynamicFlagVertexPositionsDidChangeが立ち、前回と内容が異なる描画オブジェクトの版を進め、
+     *           この領域に古い座標が残っている描画オブジェクトだけを転送する。
+     *
+     * @param[in]   model   ->  モデルのインスタンス
+     */
+    void UpdatePositions(const CubismModel& model);
+
+    /**
+     * @brief   このフレームの描画命令をすべて発行した後に呼ぶ<br>
+     *           永続マップ時は使用中の領域にフェンスを置き、次の領域へ進む。
+     */
+    void EndFrame();
+
+    /**
+     * @brief   描画オブジェクトの頂点データの所在を取得する
+     *
+     * @param[in]   drawableIndex   ->  描画オブジェクトのインデックス
+     * @param[out]  binding         ->  頂点データの所在
+     */
+    void GetBinding(csmInt32 drawableIndex, CubismMeshBinding_OpenGLES2& binding) const;
+
+public:
+    /**
+     * @brief   描画オブジェクトの頂点座標の版を取得する<br>
+     *           頂点座標が実際に変化するたびに増える。マスクの変化検出に使う。
+     *
+     * @param[in]   drawableIndex   ->  描画オブジェクトのインデックス
+     */
+    csmUint32 GetPositionVersion(csmInt32 drawableIndex) const { return _positionVersions[drawableIndex]; }
+
+private:
+    /**
+     * @brief   バッファを破棄する
+     */
+    void Release();
+
+    /**
+     * @brief   バッファを作成済みかどうか
+     */
+    csmBool IsInitialized() const { return _indexBuffer != 0; }
+
+    /**
+     * @brief   頂点バッファを作成してUVを書き込む<br>
+     *           永続マップを試し、できなければglBufferSubData用のバッファを作る。
+     *
+     * @param[in]   uvs             ->  全描画オブジェクトのUV
+     * @param[in]   drawableCount   ->  描画オブジェクトの数
+     */
+    void CreateVertexBuffer(const csmByte* uvs, csmInt32 drawableCount);
+
+    GLuint _indexBuffer;                        ///< 全描画オブジェクトのインデックス（静的）
+    GLuint _vertexBuffer;                       ///< 先頭にUV（静的）、続けて頂点座標の領域（ストリーミング）
+    csmVector<csmUint32> _indexOffsets;         ///< 描画オブジェクトごとのインデックスの先頭（バイト）
+    csmVector<csmUint32> _vertexOffsets;        ///< 描画オブジェクトごとの頂点の先頭（バイト）。UVと頂点座標で共通
+    csmVector<csmUint32> _vertexSizes;          ///< 描画オブジェクトごとの頂点座標のサイズ（バイト）
+    csmUint32 _positionRegionSize;              ///< UVまたは頂点座標1領域分のサイズ（バイト）
+    csmInt32 _regionCount;                      ///< 頂点座標の領域数。glBufferSubData方式では1
+    csmInt32 _currentRegion;                    ///< このフレームで使う頂点座標の領域
+    csmVector<csmUint32> _positionVersions;     ///< 描画オブジェクトごとの頂点座標の版。変化するたびに進める
+    csmVector<csmUint32> _uploadedVersions;     ///< 領域×描画オブジェクトごとに書き込み済みの版
+    csmByte* _mappedPositions;                  ///< 永続マップした最初の頂点座標の領域。NULLならglBufferSubData方式
+    csmBool _isIndexRebased;                    ///< インデックスを頂点バッファ全体での通し番号に書き換えたか。trueなら全描画オブジェクトが同じ頂点属性の設定で描ける
+    csmVector<csmByte> _positionShadow;         ///< 最新の頂点座標の写し。変化の比較と転送元に使う
+#ifdef CSM_GL_BUFFER_STORAGE
+    GLsync _regionFences[PositionRegionCount];  ///< 領域ごとの、最後にその領域を読む描画命令のフェンス
+#endif
+};
+
+/**
+ * @brief   レンダラが設定するOpenGLのステートを覚えておき、値が変わらない呼び出しを省くクラス<br>
+ *           モデルの描画の最初に無効化するので、各ステートのフレームで最初の設定は必ずOpenGLに発行される。
+ *           描画中にここを通さずに覚えているステートを変更した場合はInvalidateを呼ぶこと。<br>
+ *           ユニフォームは同じシェーダプログラムを共有するシェーダセットがあるので、プログラムごとに覚える。
+ */
+class CubismRendererStateCache_OpenGLES2
+{
+    friend class CubismRenderer_OpenGLES2;
+    friend class CubismShader_OpenGLES2;
+    friend class CubismClippingManager_OpenGLES2;
+
+private:
+    static const GLuint UnknownValue = 0xFFFFFFFF;      ///< 値が分からないステートの印
+    static const csmInt32 CapabilityCount = 5;          ///< 覚える機能の数（GL_BLEND, GL_CULL_FACE, GL_DEPTH_TEST, GL_SCISSOR_TEST, GL_STENCIL_TEST）
+    static const csmInt32 TextureUnitCount = 2;         ///< 覚えるテクスチャユニットの数
+    static const csmInt32 VertexAttribCount = 8;        ///< 覚える頂点属性の数
+    static const csmInt32 ProgramCount = 8;             ///< ユニフォームを覚えるシェーダプログラムの数
+    static const csmInt32 UniformLocationCount = 16;    ///< シェーダプログラムごとに覚えるユニフォームのロケーションの数
+    static const csmInt32 UniformValueSize = 16;        ///< ユニフォーム1つ分の値の最大要素数（4x4行列）
+
+    CubismRendererStateCache_OpenGLES2();
+
+    /**
+     * @brief   覚えているステートをすべて不明にする<br>
+     *           以降の設定は値にかかわらずOpenGLに発行される。
+     */
+    void Invalidate();
+
+    void UseProgram(GLuint program);
+
+    void ActiveTexture(GLenum textureUnit);
+
+    /**
+     * @brief   アクティブなテクスチャユニットにGL_TEXTURE_2Dのテクスチャをバインドする
+     */
+    void BindTexture2D(GLuint texture);
+
+    void BindArrayBuffer(GLuint buffer);
+
+    void BindElementArrayBuffer(GLuint buffer);
+
+    /**
+     * @brief   glEnable/glDisableの代わり。覚える対象外の機能はそのまま発行する
+     */
+    void SetEnabled(GLenum capability, csmBool enabled);
+
+    void EnableVertexAttribArray(GLuint index);
+
+    /**
+     * @brief   float2要素の頂点属性を設定する<br>
+     *           bufferとpointerが前回と同じなら何もしない。異なる場合はbufferをバインドしてから設定する。
+     *
+     * @param[in]   index   ->  頂点属性のロケーション
+     * @param[in]   buffer  ->  頂点バッファ。0ならクライアントメモリ
+     * @param[in]   pointer ->  バッファ内のオフセット、またはクライアントメモリのアドレス
+     */
+    void VertexAttribPointer(GLuint index, GLuint buffer, const void* pointer);
+
+    void FrontFace(GLenum mode);
+
+    void ColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
+
+    void BlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha);
+
+    /**
+     * @brief   使用中のシェーダプログラムのユニフォームを設定する。値が前回と同じなら何もしない
+     */
+    void Uniform1i(GLint location, GLint value);
+
+    void Uniform4f(GLint location, csmFloat32 x, csmFloat32 y, csmFloat32 z, csmFloat32 w);
+
+    void UniformMatrix4fv(GLint location, const csmFloat32* matrix);
+
+    /**
+     * @brief   ユニフォームの値を前回と比べ、異なれば覚え直す
+     *
+     * @param[in]   location    ->  ユニフォームのロケーション
+     * @param[in]   value       ->  値
+     * @param[in]   size        ->  値のサイズ（バイト）
+     *
+     * @retval  true    ->  前回と同じ値なので発行しなくてよい
+     * @retval  false   ->  発行が必要
+     */
+    csmBool IsSameUniform(GLint location, const void* value, csmUint32 size);
+
+    GLuint _program;                                        ///< 使用中のシェーダプログラム
+    csmInt32 _uniformProgramIndex;                          ///< 使用中のシェーダプログラムのユニフォームを覚える位置。覚えない場合は-1
+    GLenum _activeTexture;                                  ///< アクティブなテクスチャユニット
+    GLuint _textures[TextureUnitCount];                     ///< テクスチャユニットごとのGL_TEXTURE_2D
+    GLuint _arrayBuffer;                                    ///< GL_ARRAY_BUFFER
+    GLuint _elementArrayBuffer;                             ///< GL_ELEMENT_ARRAY_BUFFER
+    csmInt32 _capabilities[CapabilityCount];                ///< 機能ごとの有効(1)・無効(0)・不明(-1)
+    csmInt32 _vertexAttribEnabled[VertexAttribCount];       ///< 頂点属性ごとの有効(1)・不明(-1)
+    GLuint _vertexAttribBuffers[VertexAttribCount];         ///< 頂点属性ごとに設定したバッファ
+    const void* _vertexAttribPointers[VertexAttribCount];   ///< 頂点属性ごとに設定したオフセット・アドレス
+    GLenum _frontFace;                                      ///< glFrontFace
+    csmInt32 _colorMask;                                    ///< glColorMaskのRGBAをビットで表したもの。不明なら-1
+    GLenum _blendFunc[4];                                   ///< glBlendFuncSeparate
+    GLuint _uniformPrograms[ProgramCount];                  ///< ユニフォームを覚えているシェーダプログラム。0なら空き
+    csmBool _isUniformValid[ProgramCount][UniformLocationCount];                        ///< ユニフォームの値を覚えているか
+    csmFloat32 _uniformValues[ProgramCount][UniformLocationCount][UniformValueSize];    ///< 最後に設定したユニフォームの値
 };
 
 /**
@@ -275,9 +518,7 @@ private:
      *
      * @param[in]   renderer              ->  レンダラのインスタンス
      * @param[in]   textureId             ->  GPUのテクスチャID
-     * @param[in]   vertexCount           ->  ポリゴンメッシュの頂点数
-     * @param[in]   vertexArray           ->  ポリゴンメッシュの頂点配列
-     * @param[in]   uvArray               ->  uv配列
+     * @param[in]   mesh                  ->  頂点座標とUVの所在
      * @param[in]   opacity               ->  不透明度
      * @param[in]   colorBlendMode        ->  カラーブレンディングのタイプ
      * @param[in]   baseColor             ->  ベースカラー
@@ -286,8 +527,7 @@ private:
      * @param[in]   invertedMask           ->  マスクを反転して使用するフラグ
      */
     void SetupShaderProgram(CubismRenderer_OpenGLES2* renderer, GLuint textureId
-                            , csmInt32 vertexCount, csmFloat32* vertexArray
-                            , csmFloat32* uvArray, csmFloat32 opacity
+                            , const CubismMeshBinding_OpenGLES2& mesh, csmFloat32 opacity
                             , CubismRenderer::CubismBlendMode colorBlendMode
                             , CubismRenderer::CubismTextureColor baseColor
                             , CubismRenderer::CubismTextureColor multiplyColor
@@ -390,6 +630,11 @@ private:
      */
     void Save();
 
+    /**
+     * @brief   モデル描画直前のフレームバッファとビューポートだけを保持する
+     */
+    void SaveFramebuffer();
+
     /**
      * @brief   保持したOpenGLES2のステートを復帰させる
      *
@@ -502,6 +747,23 @@ public:
      */
     CubismOffscreenFrame_OpenGLES2* GetMaskBuffer(csmInt32 index);
 
+    /**
+     * @brief  モデル描画の前後でOpenGLのステートを保存・復帰するかを設定する<br>
+     *         falseにすると描画後のステートはレンダラが最後に設定したままになる。
+     *         描画後のステートに依存しないことをホストが保証できる場合に使う。
+     *         falseでも描画直前のフレームバッファとビューポートは取得し、描画に必要なステートはレンダラが設定する。
+     *
+     * @param[in]  enable -> trueなら保存・復帰する（初期値）
+     */
+    void UseProfileSaveRestore(csmBool enable);
+
+    /**
+     * @brief  モデル描画の前後でOpenGLのステートを保存・復帰するか
+     *
+     * @return trueなら保存・復帰する
+     */
+    csmBool IsUsingProfileSaveRestore() const;
+
 protected:
     /**
      * @brief   コンストラクタ
@@ -546,6 +808,18 @@ protected:
                   , const CubismTextureColor& multiplyColor, const CubismTextureColor& screenColor
                   , csmFloat32 opacity, CubismBlendMode colorBlendMode, csmBool invertedMask);
 
+    /**
+     * @brief   モデルの描画オブジェクトを、レンダラが保持する頂点バッファから描画する。<br>
+     *           インデックスとUVは静的なバッファ、頂点座標はこのフレームで更新した領域を参照する。
+     *
+     * @param[in]   model           ->  モデルのインスタンス
+     * @param[in]   drawableIndex   ->  描画オブジェクトのインデックス
+     * @param[in]   colorBlendMode  ->  カラー合成タイプ
+     * @param[in]   invertedMask    ->  マスク使用時のマスクの反転使用
+     */
+    void DrawDrawableOpenGL(const CubismModel& model, csmInt32 drawableIndex
+                  , CubismBlendMode colorBlendMode, csmBool invertedMask);
+
 
 #ifdef CSM_TARGET_ANDROID_ES2
 public:
@@ -620,6 +894,22 @@ private:
      */
     CubismClippingContext* GetClippingContextBufferForDraw() const;
 
+    /**
+     * @brief   描画オブジェクトを描画する共通処理
+     *
+     * @param[in]   textureNo       ->  描画するテクスチャ番号
+     * @param[in]   indexCount      ->  描画オブジェクトのインデックス値
+     * @param[in]   mesh            ->  頂点データの所在
+     * @param[in]   multiplyColor   ->  乗算色
+     * @param[in]   screenColor     ->  スクリーン色
+     * @param[in]   opacity         ->  不透明度
+     * @param[in]   colorBlendMode  ->  カラー合成タイプ
+     * @param[in]   invertedMask    ->  マスク使用時のマスクの反転使用
+     */
+    void DrawMeshBinding(csmInt32 textureNo, csmInt32 indexCount, const CubismMeshBinding_OpenGLES2& mesh
+                  , const CubismTextureColor& multiplyColor, const CubismTextureColor& screenColor
+                  , csmFloat32 opacity, CubismBlendMode colorBlendMode, csmBool invertedMask);
+
 #ifdef CSM_TARGET_WIN_GL
     /**
      * @brief   Windows対応。OpenGL命令のバインドを行う。
@@ -645,6 +935,9 @@ private:
     CubismClippingContext*              _clippingContextBufferForDraw;  ///< 画面上描画するためのクリッピングコンテキスト
 
     csmVector<CubismOffscreenFrame_OpenGLES2>   _offscreenFrameBuffers;          ///< マスク描画用のフレームバッファ
+    CubismMeshBuffers_OpenGLES2         _meshBuffers;                   ///< 描画オブジェクトの頂点バッファ
+    CubismRendererStateCache_OpenGLES2  _stateCache;                    ///< 設定済みのOpenGLのステート
+    csmBool                             _isUsingProfileSaveRestore;     ///< 描画の前後でステートを保存・復帰するか
 };
 
 }}}}
@@ -0,0 +1,776 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismJsonTape.hpp"
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+#include "CubismDebug.hpp"
+
+//------------ LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework { namespace Utils {
+
+namespace {
+const csmInt32 MaxExactDigits = 19;                 ///< csmUint64に収まる有効桁数
+const csmUint64 MaxExactMantissa = 1ULL << 53;      ///< doubleで正確に表せる仮数の上限
+
+// doubleで正確に表せる10のべき乗
+const double ExactPowersOfTen[] =
+{
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+const csmInt32 MaxExactPower = 22;
+
+inline csmBool IsWhitespace(csmChar c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline csmBool IsDigit(csmChar c)
+{
+    return c >= '0' && c <= '9';
+}
+
+csmInt32 HexValue(csmChar c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// \uXXXX の4桁を読む。終端文字で必ず止まるので入力の外は読まない
+csmBool ReadHex4(const csmChar* text, csmUint32& value)
+{
+    value = 0;
+    for (csmInt32 i = 0; i < 4; ++i)
+    {
+        const csmInt32 digit = HexValue(text[i]);
+        if (digit < 0)
+        {
+            return false;
+        }
+        value = (value << 4) | static_cast<csmUint32>(digit);
+    }
+    return true;
+}
+
+csmInt32 EncodeUtf8(csmUint32 codePoint, csmChar* out)
+{
+    if (codePoint < 0x80)
+    {
+        out[0] = static_cast<csmChar>(codePoint);
+        return 1;
+    }
+    if (codePoint < 0x800)
+    {
+        out[0] = static_cast<csmChar>(0xC0 | (codePoint >> 6));
+        out[1] = static_cast<csmChar>(0x80 | (codePoint & 0x3F));
+        return 2;
+    }
+    if (codePoint < 0x10000)
+    {
+        out[0] = static_cast<csmChar>(0xE0 | (codePoint >> 12));
+        out[1] = static_cast<csmChar>(0x80 | ((codePoint >> 6) & 0x3F));
+        out[2] = static_cast<csmChar>(0x80 | (codePoint & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<csmChar>(0xF0 | (codePoint >> 18));
+    out[1] = static_cast<csmChar>(0x80 | ((codePoint >> 12) & 0x3F));
+    out[2] = static_cast<csmChar>(0x80 | ((codePoint >> 6) & 0x3F));
+    out[3] = static_cast<csmChar>(0x80 | (codePoint & 0x3F));
+    return 4;
+}
+
+// doubleからfloatへの丸めで二重丸めが起きうるか。
+// doubleの仮数の下位29ビットがfloatの丸めの中間点付近なら、strtofで正しく丸め直す
+csmBool IsNearFloatHalfway(double value)
+{
+    csmUint64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    const csmUint64 lowBits = bits & ((1ULL << 29) - 1);
+    const csmUint64 halfway = 1ULL << 28;
+    return lowBits + 1 >= halfway && lowBits <= halfway + 1;
+}
+}
+
+//------------ CubismJsonNode ------------
+
+CubismJsonNode::CubismJsonNode()
+    : _tape(NULL)
+    , _index(-1)
+{ }
+
+CubismJsonNode::CubismJsonNode(const CubismJsonTape* tape, csmInt32 index)
+    : _tape(tape)
+    , _index(index)
+{ }
+
+csmBool CubismJsonNode::IsNull() const
+{
+    return _index < 0 || _tape->_nodes[_index].Type == CubismJsonTape::NodeType_Null;
+}
+
+csmBool CubismJsonNode::IsError() const
+{
+    return _index < 0;
+}
+
+csmBool CubismJsonNode::IsBool() const
+{
+    return _index >= 0 && (_tape->_nodes[_index].Type == CubismJsonTape::NodeType_True || _tape->_nodes[_index].Type == CubismJsonTape::NodeType_False);
+}
+
+csmBool CubismJsonNode::IsFloat() const
+{
+    return _index >= 0 && _tape->_nodes[_index].Type == CubismJsonTape::NodeType_Number;
+}
+
+csmBool CubismJsonNode::IsString() const
+{
+    return _index >= 0 && _tape->_nodes[_index].Type == CubismJsonTape::NodeType_String;
+}
+
+csmBool CubismJsonNode::IsArray() const
+{
+    return _index >= 0 && _tape->_nodes[_index].Type == CubismJsonTape::NodeType_Array;
+}
+
+csmBool CubismJsonNode::IsMap() const
+{
+    return _index >= 0 && _tape->_nodes[_index].Type == CubismJsonTape::NodeType_Object;
+}
+
+csmInt32 CubismJsonNode::ToInt(csmInt32 defaultValue) const
+{
+    return IsFloat() ? static_cast<csmInt32>(_tape->_nodes[_index].Number) : defaultValue;
+}
+
+csmFloat32 CubismJsonNode::ToFloat(csmFloat32 defaultValue) const
+{
+    return IsFloat() ? _tape->_nodes[_index].Number : defaultValue;
+}
+
+csmBool CubismJsonNode::ToBoolean(csmBool defaultValue) const
+{
+    if (!IsBool())
+    {
+        return defaultValue;
+    }
+    return _tape->_nodes[_index].Type == CubismJsonTape::NodeType_True;
+}
+
+const csmChar* CubismJsonNode::GetRawString(const csmChar* defaultValue) const
+{
+    return IsString() ? _tape->_text + _tape->_nodes[_index].Offset : defaultValue;
+}
+
+csmInt32 CubismJsonNode::GetLength() const
+{
+    return IsString() ? _tape->_nodes[_index].Size : 0;
+}
+
+csmBool CubismJsonNode::Equals(const csmChar* value) const
+{
+    return IsString() && strcmp(_tape->_text + _tape->_nodes[_index].Offset, value) == 0;
+}
+
+csmInt32 CubismJsonNode::GetSize() const
+{
+    return (IsArray() || IsMap()) ? _tape->_nodes[_index].Size : 0;
+}
+
+CubismJsonNode CubismJsonNode::operator[](csmInt32 index) const
+{
+    if (!IsArray() || index < 0 || index >= _tape->_nodes[_index].Size)
+    {
+        return CubismJsonNode(_tape, -1);
+    }
+
+    const CubismJsonTape::Node& node = _tape->_nodes[_index];
+    if (node.Flat)
+    {
+        return CubismJsonNode(_tape, _index + 1 + index);
+    }
+    return CubismJsonNode(_tape, _tape->_elements[node.Offset + index]);
+}
+
+CubismJsonNode CubismJsonNode::operator[](const csmChar* key) const
+{
+    if (!IsMap())
+    {
+        return CubismJsonNode(_tape, -1);
+    }
+
+    // キーと値が交互に並ぶので、一致しなければ値の部分木を飛ばして次のキーへ
+    csmInt32 position = _index + 1;
+    for (csmInt32 i = 0; i < _tape->_nodes[_index].Size; ++i)
+    {
+        if (strcmp(_tape->_text + _tape->_nodes[position].Offset, key) == 0)
+        {
+            return CubismJsonNode(_tape, position + 1);
+        }
+        position = _tape->_nodes[position + 1].Next;
+    }
+    return CubismJsonNode(_tape, -1);
+}
+
+const csmChar* CubismJsonNode::GetKey(csmInt32 index) const
+{
+    if (!IsMap() || index < 0 || index >= _tape->_nodes[_index].Size)
+    {
+        return NULL;
+    }
+
+    csmInt32 position = _index + 1;
+    for (csmInt32 i = 0; i < index; ++i)
+    {
+        position = _tape->_nodes[position + 1].Next;
+    }
+    return _tape->_text + _tape->_nodes[position].Offset;
+}
+
+CubismJsonNode CubismJsonNode::GetMember(csmInt32 index) const
+{
+    if (!IsMap() || index < 0 || index >= _tape->_nodes[_index].Size)
+    {
+        return CubismJsonNode(_tape, -1);
+    }
+
+    csmInt32 position = _index + 1;
+    for (csmInt32 i = 0; i < index; ++i)
+    {
+        position = _tape->_nodes[position + 1].Next;
+    }
+    return CubismJsonNode(_tape, position + 1);
+}
+
+//------------ CubismJsonTape ------------
+
+CubismJsonTape::CubismJsonTape()
+    : _text(NULL)
+    , _length(0)
+    , _error(NULL)
+{ }
+
+CubismJsonTape::~CubismJsonTape()
+{
+    if (_text)
+    {
+        CSM_FREE(_text);
+    }
+}
+
+CubismJsonTape* CubismJsonTape::Create(const csmByte* buffer, csmSizeInt size)
+{
+    CubismJsonTape* tape = CSM_NEW CubismJsonTape();
+
+    if (!tape->Parse(buffer, size))
+    {
+        Delete(tape);
+        return NULL;
+    }
+    return tape;
+}
+
+void CubismJsonTape::Delete(CubismJsonTape* instance)
+{
+    CSM_DELETE_SELF(CubismJsonTape, instance);
+}
+
+CubismJsonNode CubismJsonTape::GetRoot() const
+{
+    return CubismJsonNode(this, _nodes.GetSize() > 0 ? 0 : -1);
+}
+
+csmInt32 CubismJsonTape::AddNode(NodeType type)
+{
+    const csmInt32 index = static_cast<csmInt32>(_nodes.GetSize());
+    Node node;
+    node.Type = static_cast<csmUint8>(type);
+    node.Flat = 0;
+    node.Next = index + 1;
+    node.Size = 0;
+    node.Offset = 0;
+    _nodes.PushBack(node);
+    return index;
+}
+
+void CubismJsonTape::CloseScope(const Scope& scope)
+{
+    Node& node = _nodes[scope.Node];
+    node.Next = static_cast<csmInt32>(_nodes.GetSize());
+    node.Size = scope.Count;
+
+    if (node.Type != NodeType_Array)
+    {
+        return;
+    }
+
+    node.Flat = scope.Flat ? 1 : 0;
+    if (!scope.Flat)
+    {
+        // 要素の大きさが揃わないので位置表を作る
+        node.Offset = static_cast<csmInt32>(_elements.GetSize());
+        csmInt32 position = scope.Node + 1;
+        for (csmInt32 i = 0; i < scope.Count; ++i)
+        {
+            _elements.PushBack(position);
+            position = _nodes[position].Next;
+        }
+    }
+}
+
+csmBool CubismJsonTape::SetError(const csmChar* message, csmInt32 position)
+{
+    csmInt32 line = 1;
+    for (csmInt32 i = 0; i < position && i < _length; ++i)
+    {
+        if (_text[i] == '\n')
+        {
+            ++line;
+        }
+    }
+
+    _error = message;
+    CubismLogWarning("[CubismJsonTape] Json parse error : %s @line %d", message, line);
+    return false;
+}
+
+csmBool CubismJsonTape::ParseString(csmInt32& position, csmInt32& length)
+{
+    const csmInt32 start = position;
+    csmInt32 read = position;
+
+    // エスケープが無ければ閉じ '"' を終端文字にするだけ
+    for (;;)
+    {
+        const csmUchar c = static_cast<csmUchar>(_text[read]);
+        if (c == '"')
+        {
+            _text[read] = '\0';
+            length = read - start;
+            position = read + 1;
+            return true;
+        }
+        if (c == '\\')
+        {
+            break;
+        }
+        if (c < 0x20)
+        {
+            return SetError(read >= _length ? "unterminated string" : "control character in string", read);
+        }
+        ++read;
+    }
+
+    // エスケープを展開しながら前に詰める。展開後は元より短くなるので追い越さない
+    csmInt32 write = read;
+    for (;;)
+    {
+        const csmUchar c = static_cast<csmUchar>(_text[read]);
+        if (c == '"')
+        {
+            _text[write] = '\0';
+            length = write - start;
+            position = read + 1;
+            return true;
+        }
+        if (c < 0x20)
+        {
+            return SetError(read >= _length ? "unterminated string" : "control character in string", read);
+        }
+        if (c != '\\')
+        {
+            _text[write++] = static_cast<csmChar>(c);
+            ++read;
+            continue;
+        }
+
+        const csmChar escape = _text[read + 1];
+        read += 2;
+        switch (escape)
+        {
+        case '"':  _text[write++] = '"';  break;
+        case '\\': _text[write++] = '\\'; break;
+        case '/':  _text[write++] = '/';  break;
+        case 'b':  _text[write++] = '\b'; break;
+        case 'f':  _text[write++] = '\f'; break;
+        case 'n':  _text[write++] = '\n'; break;
+        case 'r':  _text[write++] = '\r'; break;
+        case 't':  _text[write++] = '\t'; break;
+        case 'u': {
+            csmUint32 codePoint;
+            if (!ReadHex4(_text + read, codePoint))
+            {
+                return SetError("invalid unicode escape", read);
+            }
+            read += 4;
+
+            if (codePoint >= 0xD800 && codePoint <= 0xDBFF)
+            {
+                // サロゲートペア
+                csmUint32 low;
+                if (_text[read] != '\\' || _text[read + 1] != 'u' || !ReadHex4(_text + read + 2, low) || low < 0xDC00 || low > 0xDFFF)
+                {
+                    return SetError("invalid surrogate pair", read);
+                }
+                read += 6;
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+            }
+            else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF)
+            {
+                return SetError("invalid surrogate pair", read);
+            }
+
+            write += EncodeUtf8(codePoint, _text + write);
+            break;
+        }
+        default:
+            return SetError("invalid escape", read - 1);
+        }
+    }
+}
+
+csmBool CubismJsonTape::ParseNumber(csmInt32& position, csmFloat32& value)
+{
+    csmInt32 p = position;
+    const csmBool negative = (_text[p] == '-');
+    if (negative)
+    {
+        ++p;
+    }
+
+    if (!IsDigit(_text[p]))
+    {
+        return SetError("invalid number", p);
+    }
+
+    // 有効桁を19桁までcsmUint64に積み、小数点と指数は10進の指数にまとめる
+    csmUint64 mantissa = 0;
+    csmInt32 digits = 0;
+    csmInt32 exponent = 0;
+    csmBool truncated = false;
+
+    if (_text[p] == '0')
+    {
+        ++p;
+    }
+    else
+    {
+        for (; IsDigit(_text[p]); ++p)
+        {
+            if (digits < MaxExactDigits)
+            {
+                mantissa = mantissa * 10 + static_cast<csmUint64>(_text[p] - '0');
+                ++digits;
+            }
+            else
+            {
+                truncated = true;
+                ++exponent;
+            }
+        }
+    }
+
+    if (_text[p] == '.')
+    {
+        ++p;
+        if (!IsDigit(_text[p]))
+        {
+            return SetError("invalid number", p);
+        }
+        for (; IsDigit(_text[p]); ++p)
+        {
+            if (mantissa == 0 && _text[p] == '0')
+            {
+                --exponent; // 先頭の0は有効桁に数えない
+            }
+            else if (digits < MaxExactDigits)
+            {
+                mantissa = mantissa * 10 + static_cast<csmUint64>(_text[p] - '0');
+                ++digits;
+                --exponent;
+            }
+            else
+            {
+                truncated = true;
+            }
+        }
+    }
+
+    if (_text[p] == 'e' || _text[p] == 'E')
+    {
+        ++p;
+        const csmBool negativeExponent = (_text[p] == '-');
+        if (_text[p] == '-' || _text[p] == '+')
+        {
+            ++p;
+        }
+        if (!IsDigit(_text[p]))
+        {
+            return SetError("invalid number", p);
+        }
+        csmInt32 explicitExponent = 0;
+        for (; IsDigit(_text[p]); ++p)
+        {
+            if (explicitExponent < 100000)
+            {
+                explicitExponent = explicitExponent * 10 + (_text[p] - '0');
+            }
+        }
+        exponent += negativeExponent ? -explicitExponent : explicitExponent;
+    }
+
+    if (mantissa == 0)
+    {
+        value = negative ? -0.0f : 0.0f;
+        position = p;
+        return true;
+    }
+
+    // 仮数と10のべき乗がどちらもdoubleで正確なら、1回の演算で正しく丸めたdoubleが得られる
+    if (!truncated && mantissa <= MaxExactMantissa && exponent >= -MaxExactPower && exponent <= MaxExactPower)
+    {
+        double result = static_cast<double>(mantissa);
+        result = (exponent < 0) ? result / ExactPowersOfTen[-exponent] : result * ExactPowersOfTen[exponent];
+
+        if (result >= FLT_MIN && result <= FLT_MAX && !IsNearFloatHalfway(result))
+        {
+            value = static_cast<csmFloat32>(negative ? -result : result);
+            position = p;
+            return true;
+        }
+    }
+
+    // それ以外はstrtofに任せる。数値の直後を一時的に終端してバッファの外を読ませない
+    const csmChar saved = _text[p];
+    _text[p] = '\0';
+    value = strtof(_text + position, NULL);
+    _text[p] = saved;
+
+    position = p;
+    return true;
+}
+
+csmBool CubismJsonTape::Parse(const csmByte* buffer, csmSizeInt size)
+{
+    if (size >= 0x7FFFFFFFu)
+    {
+        return SetError("document too large", 0);
+    }
+
+    // 末尾に終端文字を置くので、走査は常に終端文字で止まる
+    _length = static_cast<csmInt32>(size);
+    _text = static_cast<csmChar*>(CSM_MALLOC(size + 1));
+    if (size > 0)
+    {
+        memcpy(_text, buffer, size);
+    }
+    _text[size] = '\0';
+    _nodes.PrepareCapacity(_length / 6 + 16);
+
+    enum
+    {
+        Expect_Value,       ///< 値
+        Expect_Key,         ///< オブジェクトのキーまたは '}'
+        Expect_Separator,   ///< ',' または閉じ括弧
+    } state = Expect_Value;
+
+    csmVector<Scope> scopes;
+    csmInt32 depth = 0;
+    csmInt32 p = 0;
+
+    // UTF-8 BOM
+    if (_length >= 3 && static_cast<csmUchar>(_text[0]) == 0xEF && static_cast<csmUchar>(_text[1]) == 0xBB && static_cast<csmUchar>(_text[2]) == 0xBF)
+    {
+        p = 3;
+    }
+
+    for (;;)
+    {
+        while (IsWhitespace(_text[p]))
+        {
+            ++p;
+        }
+
+        if (state == Expect_Separator)
+        {
+            if (depth == 0)
+            {
+                if (p != _length)
+                {
+                    return SetError("unexpected character after document", p);
+                }
+                return true;
+            }
+
+            Scope& scope = scopes[depth - 1];
+            scope.Count++;
+
+            const csmBool isObject = (_nodes[scope.Node].Type == NodeType_Object);
+            if (_text[p] == ',')
+            {
+                ++p;
+                state = isObject ? Expect_Key : Expect_Value;
+            }
+            else if (_text[p] == (isObject ? '}' : ']'))
+            {
+                ++p;
+                CloseScope(scope);
+                --depth;
+                // 閉じた配列・オブジェクトは親の要素として次の周回で数える
+                state = Expect_Separator;
+            }
+            else
+            {
+                return SetError(isObject ? "expected ',' or '}'" : "expected ',' or ']'", p);
+            }
+            continue;
+        }
+
+        if (state == Expect_Key)
+        {
+            if (_text[p] == '}')
+            {
+                // 空のオブジェクト、または末尾の余分な ','
+                ++p;
+                CloseScope(scopes[depth - 1]);
+                --depth;
+                state = Expect_Separator;
+                continue;
+            }
+            if (_text[p] != '"')
+            {
+                return SetError("expected key", p);
+            }
+
+            ++p;
+            const csmInt32 keyOffset = p;
+            csmInt32 keyLength;
+            if (!ParseString(p, keyLength))
+            {
+                return false;
+            }
+            const csmInt32 keyNode = AddNode(NodeType_Key);
+            _nodes[keyNode].Offset = keyOffset;
+            _nodes[keyNode].Size = keyLength;
+
+            while (IsWhitespace(_text[p]))
+            {
+                ++p;
+            }
+            if (_text[p] != ':')
+            {
+                return SetError("expected ':'", p);
+            }
+            ++p;
+            state = Expect_Value;
+            continue;
+        }
+
+        // Expect_Value
+        const csmChar c = _text[p];
+        switch (c)
+        {
+        case '{':
+        case '[': {
+            const csmInt32 node = AddNode(c == '{' ? NodeType_Object : NodeType_Array);
+            if (depth > 0 && _nodes[scopes[depth - 1].Node].Type == NodeType_Array)
+            {
+                scopes[depth - 1].Flat = false;
+            }
+
+            Scope scope;
+            scope.Node = node;
+            scope.Count = 0;
+            scope.Flat = true;
+            if (depth < static_cast<csmInt32>(scopes.GetSize()))
+            {
+                scopes[depth] = scope;
+            }
+            else
+            {
+                scopes.PushBack(scope);
+            }
+            ++depth;
+            ++p;
+            state = (c == '{') ? Expect_Key : Expect_Value;
+            continue;
+        }
+        case ']': {
+            // 空の配列、または末尾の余分な ','
+            if (depth == 0 || _nodes[scopes[depth - 1].Node].Type != NodeType_Array)
+            {
+                return SetError("unexpected ']'", p);
+            }
+            ++p;
+            CloseScope(scopes[depth - 1]);
+            --depth;
+            state = Expect_Separator;
+            continue;
+        }
+        case '"': {
+            ++p;
+            const csmInt32 offset = p;
+            csmInt32 length;
+            if (!ParseString(p, length))
+            {
+                return false;
+            }
+            const csmInt32 node = AddNode(NodeType_String);
+            _nodes[node].Offset = offset;
+            _nodes[node].Size = length;
+            break;
+        }
+        case 't':
+            if (strncmp(_text + p, "true", 4) != 0)
+            {
+                return SetError("invalid literal", p);
+            }
+            AddNode(NodeType_True);
+            p += 4;
+            break;
+        case 'f':
+            if (strncmp(_text + p, "false", 5) != 0)
+            {
+                return SetError("invalid literal", p);
+            }
+            AddNode(NodeType_False);
+            p += 5;
+            break;
+        case 'n':
+            if (strncmp(_text + p, "null", 4) != 0)
+            {
+                return SetError("invalid literal", p);
+            }
+            AddNode(NodeType_Null);
+            p += 4;
+            break;
+        case '-':
+        case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9': {
+            csmFloat32 number;
+            if (!ParseNumber(p, number))
+            {
+                return false;
+            }
+            const csmInt32 node = AddNode(NodeType_Number);
+            _nodes[node].Number = number;
+            break;
+        }
+        default:
+            return SetError(p >= _length ? "unexpected end of document" : "unexpected character", p);
+        }
+
+        state = Expect_Separator;
+    }
+}
+
+}}}}
+//------------ LIVE2D NAMESPACE ------------
@@ -0,0 +1,287 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+#include "Type/csmVector.hpp"
+
+//------------ LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework { namespace Utils {
+
+class CubismJsonTape;
+
+/**
+ * @brief テープ上のJSON要素への参照
+ *
+ * CubismJsonTapeの要素を指す軽量な値。コピーして使う。<br>
+ * 存在しないキーや範囲外のインデックスを辿った場合は無効な参照になり、
+ * そこからさらに辿っても無効な参照が返るだけで、共有の状態は書き換えない。<br>
+ * 参照はCubismJsonTapeを破棄するまで有効。
+ */
+class CubismJsonNode
+{
+    friend class CubismJsonTape;
+
+public:
+    /**
+     * @brief コンストラクタ
+     *
+     * 無効な参照を作る。
+     */
+    CubismJsonNode();
+
+    /**
+     * @brief 要素がnullか、存在しないか
+     */
+    csmBool IsNull() const;
+
+    /**
+     * @brief 要素が存在しないか
+     *
+     * 存在しないキー、範囲外のインデックス、型の合わない辿り方をした場合にtrue。
+     */
+    csmBool IsError() const;
+
+    csmBool IsBool() const;     ///< 真偽値か
+    csmBool IsFloat() const;    ///< 数値か
+    csmBool IsString() const;   ///< 文字列か
+    csmBool IsArray() const;    ///< 配列か
+    csmBool IsMap() const;      ///< オブジェクトか
+
+    /**
+     * @brief 数値を整数で取得
+     *
+     * @param[in]   defaultValue    数値でない場合に返す値
+     */
+    csmInt32 ToInt(csmInt32 defaultValue = 0) const;
+
+    /**
+     * @brief 数値を取得
+     *
+     * @param[in]   defaultValue    数値でない場合に返す値
+     */
+    csmFloat32 ToFloat(csmFloat32 defaultValue = 0.0f) const;
+
+    /**
+     * @brief 真偽値を取得
+     *
+     * @param[in]   defaultValue    真偽値でない場合に返す値
+     */
+    csmBool ToBoolean(csmBool defaultValue = false) const;
+
+    /**
+     * @brief 文字列を取得
+     *
+     * エスケープを展開した終端付きの文字列を返す。文字列はCubismJsonTapeが所有する。
+     *
+     * @param[in]   defaultValue    文字列でない場合に返す値
+     */
+    const csmChar* GetRawString(const csmChar* defaultValue = "") const;
+
+    /**
+     * @brief 文字列のバイト数を取得
+     *
+     * @return  文字列のバイト数。文字列でない場合は0
+     */
+    csmInt32 GetLength() const;
+
+    /**
+     * @brief 文字列の比較
+     *
+     * @param[in]   value   比較する文字列
+     * @return  文字列で内容が一致すればtrue
+     */
+    csmBool Equals(const csmChar* value) const;
+
+    /**
+     * @brief 要素数の取得
+     *
+     * @return  配列なら要素数、オブジェクトならメンバ数、それ以外は0
+     */
+    csmInt32 GetSize() const;
+
+    /**
+     * @brief 配列の要素の取得
+     *
+     * @param[in]   index   インデックス
+     */
+    CubismJsonNode operator[](csmInt32 index) const;
+
+    /**
+     * @brief オブジェクトのメンバの取得
+     *
+     * @param[in]   key     キー
+     */
+    CubismJsonNode operator[](const csmChar* key) const;
+
+    /**
+     * @brief オブジェクトのメンバのキーの取得
+     *
+     * @param[in]   index   ドキュメント中の順番
+     * @return  キー。範囲外ならNULL
+     */
+    const csmChar* GetKey(csmInt32 index) const;
+
+    /**
+     * @brief オブジェクトのメンバの値の取得
+     *
+     * @param[in]   index   ドキュメント中の順番
+     */
+    CubismJsonNode GetMember(csmInt32 index) const;
+
+private:
+    CubismJsonNode(const CubismJsonTape* tape, csmInt32 index);
+
+    const CubismJsonTape*   _tape;      ///< 要素を持つテープ
+    csmInt32                _index;     ///< テープ上の位置。無効なら-1
+};
+
+/**
+ * @brief テープ形式のJSONパーサ
+ *
+ * 入力を一度だけコピーし、その上で1パスで構文を検証しながら要素を平坦な配列（テープ）に並べる。<br>
+ * 文字列はコピーした領域の中でエスケープを展開して終端文字を書き込み（in-situ）、要素は位置だけを持つ。
+ * 要素ごとのヒープ確保や文字列のコピーはしない。<br>
+ * 各要素は部分木の次の位置を持つので、オブジェクトのメンバ探索は値を飛ばしながら進み、
+ * 配列の要素はインデックスから直接引ける。<br>
+ * 再帰しないので深い入れ子でもスタックを消費しない。CubismJsonとの互換のため、
+ * 先頭のUTF-8 BOMと配列・オブジェクト末尾の余分な ',' は受け付ける。
+ */
+class CubismJsonTape
+{
+    friend class CubismJsonNode;
+
+public:
+    /**
+     * @brief 要素の種類
+     */
+    enum NodeType
+    {
+        NodeType_Null = 0,      ///< null
+        NodeType_False,         ///< false
+        NodeType_True,          ///< true
+        NodeType_Number,        ///< 数値
+        NodeType_String,        ///< 文字列
+        NodeType_Key,           ///< オブジェクトのキー。直後に値が続く
+        NodeType_Array,         ///< 配列
+        NodeType_Object,        ///< オブジェクト
+    };
+
+    /**
+     * @brief バッファからJSONをパースする
+     *
+     * @param[in]   buffer  JSONのバッファ。パース後は参照しない
+     * @param[in]   size    バッファのサイズ
+     * @return  パースしたドキュメント。構文エラーの場合はNULL
+     */
+    static CubismJsonTape* Create(const csmByte* buffer, csmSizeInt size);
+
+    /**
+     * @brief ドキュメントの破棄
+     *
+     * @param[in]   instance    破棄するドキュメント
+     */
+    static void Delete(CubismJsonTape* instance);
+
+    /**
+     * @brief ルート要素の取得
+     */
+    CubismJsonNode GetRoot() const;
+
+    /**
+     * @brief テープ上の要素数の取得
+     */
+    csmInt32 GetNodeCount() const { return static_cast<csmInt32>(_nodes.GetSize()); }
+
+private:
+    /**
+     * @brief テープ上の要素
+     */
+    struct Node
+    {
+        csmUint8    Type;       ///< NodeType
+        csmUint8    Flat;       ///< 配列の要素が全てスカラーなら1。要素はNode+1+indexにある
+        csmInt32    Next;       ///< 部分木の次の位置
+        csmInt32    Size;       ///< 文字列のバイト数、配列の要素数、オブジェクトのメンバ数
+        union
+        {
+            csmFloat32  Number;     ///< 数値
+            csmInt32    Offset;     ///< 文字列の位置、または配列の要素表の先頭
+        };
+    };
+
+    /**
+     * @brief 入れ子の途中の配列・オブジェクト
+     */
+    struct Scope
+    {
+        csmInt32    Node;       ///< 配列・オブジェクトの要素の位置
+        csmInt32    Count;      ///< ここまでの要素数
+        csmBool     Flat;       ///< ここまでの要素が全てスカラーか
+    };
+
+    CubismJsonTape();
+    ~CubismJsonTape();
+
+    // Prevention of copy Constructor
+    CubismJsonTape(const CubismJsonTape&);
+    CubismJsonTape& operator=(const CubismJsonTape&);
+
+    /**
+     * @brief パース
+     *
+     * @return  構文が正しければtrue
+     */
+    csmBool Parse(const csmByte* buffer, csmSizeInt size);
+
+    /**
+     * @brief 文字列をその場で展開する
+     *
+     * @param[in,out]   position    開始の '"' の次の位置。終了時は閉じ '"' の次の位置
+     * @param[out]      length      展開後のバイト数
+     * @return  成功したらtrue
+     */
+    csmBool ParseString(csmInt32& position, csmInt32& length);
+
+    /**
+     * @brief 数値の読み取り
+     *
+     * @param[in,out]   position    数値の先頭。終了時は数値の次の位置
+     * @param[out]      value       値
+     * @return  JSONの数値の書式であればtrue
+     */
+    csmBool ParseNumber(csmInt32& position, csmFloat32& value);
+
+    /**
+     * @brief 配列・オブジェクトを閉じる
+     */
+    void CloseScope(const Scope& scope);
+
+    /**
+     * @brief 要素の追加
+     */
+    csmInt32 AddNode(NodeType type);
+
+    /**
+     * @brief エラーの記録
+     *
+     * @param[in]   message     エラー内容
+     * @param[in]   position    エラー位置
+     * @return  常にfalse
+     */
+    csmBool SetError(const csmChar* message, csmInt32 position);
+
+    csmChar*            _text;      ///< 入力のコピー。文字列はこの中で展開して終端する
+    csmInt32            _length;    ///< 入力のバイト数
+    csmVector<Node>     _nodes;     ///< テープ
+    csmVector<csmInt32> _elements;  ///< スカラー以外を含む配列の要素の位置表
+    const csmChar*      _error;     ///< パースエラーの内容
+};
+
+}}}}
+//------------ LIVE2D NAMESPACE ------------
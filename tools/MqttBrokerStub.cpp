@@ -0,0 +1,284 @@
+#include "MqttBrokerStub.h"
+#include "MqttClient.h"
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QJsonDocument>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QUuid>
+#include <QDebug>
+
+namespace {
+
+QByteArray randomBytes(int size)
+{
+    QByteArray bytes(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i) {
+        bytes[i] = static_cast<char>(QRandomGenerator::global()->bounded(256));
+    }
+    return bytes;
+}
+
+} // namespace
+
+MqttBrokerStub::MqttBrokerStub(const MqttBrokerOptions &options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+    , m_server(new QTcpServer(this))
+{
+    connect(m_server, &QTcpServer::newConnection, this, &MqttBrokerStub::onNewConnection);
+}
+
+MqttBrokerStub::~MqttBrokerStub()
+{
+    stop();
+}
+
+bool MqttBrokerStub::start()
+{
+    if (m_server->isListening()) {
+        return true;
+    }
+    if (!m_server->listen(m_options.bindAddress, m_options.port)) {
+        qCritical() << "MQTT broker stub failed to listen on port" << m_options.port << m_server->errorString();
+        return false;
+    }
+    qInfo() << "MQTT broker stub listening on" << m_options.bindAddress.toString() << m_server->serverPort()
+            << "server topic:" << m_options.serverTopic
+            << "udp:" << m_options.udpServer << m_options.udpPort;
+    return true;
+}
+
+void MqttBrokerStub::stop()
+{
+    const auto sockets = m_clients.keys();
+    for (QTcpSocket *socket : sockets) {
+        socket->abort();
+    }
+    qDeleteAll(m_clients);
+    m_clients.clear();
+    if (m_server->isListening()) {
+        m_server->close();
+    }
+}
+
+quint16 MqttBrokerStub::serverPort() const
+{
+    return m_server->serverPort();
+}
+
+QString MqttBrokerStub::statsSummary() const
+{
+    return QString("mqtt clients=%1 connected=%2 disconnected=%3 | publish in=%4 routed=%5 | hello replies=%6 pings=%7")
+        .arg(m_clients.size())
+        .arg(m_stats.clientsConnected)
+        .arg(m_stats.clientsDisconnected)
+        .arg(m_stats.publishesIn)
+        .arg(m_stats.publishesRouted)
+        .arg(m_stats.helloReplies)
+        .arg(m_stats.pings);
+}
+
+QJsonObject MqttBrokerStub::mqttInfoFor(const QString &clientId) const
+{
+    QJsonObject info;
+    info["endpoint"] = QString("%1:%2").arg(m_options.bindAddress.toString()).arg(m_server->serverPort());
+    info["client_id"] = clientId;
+    info["username"] = "";
+    info["password"] = "";
+    info["publish_topic"] = m_options.serverTopic;
+    info["subscribe_topic"] = QString("devices/p2p/%1").arg(clientId);
+    return info;
+}
+
+bool MqttBrokerStub::topicMatches(const QString &filter, const QString &topic)
+{
+    if (filter == topic) {
+        return true;
+    }
+
+    const QStringList filterLevels = filter.split('/');
+    const QStringList topicLevels = topic.split('/');
+    for (int i = 0; i < filterLevels.size(); ++i) {
+        if (filterLevels[i] == "#") {
+            return true;
+        }
+        if (i >= topicLevels.size()) {
+            return false;
+        }
+        if (filterLevels[i] != "+" && filterLevels[i] != topicLevels[i]) {
+            return false;
+        }
+    }
+    return filterLevels.size() == topicLevels.size();
+}
+
+void MqttBrokerStub::onNewConnection()
+{
+    while (m_server->hasPendingConnections()) {
+        QTcpSocket *socket = m_server->nextPendingConnection();
+        Client *client = new Client;
+        client->socket = socket;
+        m_clients.insert(socket, client);
+        connect(socket, &QTcpSocket::readyRead, this, &MqttBrokerStub::onReadyRead);
+        connect(socket, &QTcpSocket::disconnected, this, &MqttBrokerStub::onDisconnected);
+    }
+}
+
+void MqttBrokerStub::onReadyRead()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    Client *client = m_clients.value(socket, nullptr);
+    if (!client) {
+        return;
+    }
+
+    client->buffer.append(socket->readAll());
+
+    MqttPacket::Packet packet;
+    bool malformed = false;
+    while (MqttPacket::takePacket(client->buffer, packet, &malformed)) {
+        switch (packet.type) {
+        case MqttPacket::Connect: {
+            // 可变头：协议名 + 级别 + 标志 + 保活，之后是client id
+            int offset = 0;
+            QString protocolName;
+            if (!MqttPacket::readString(packet.body, offset, protocolName) || offset + 4 > packet.body.size()) {
+                socket->abort();
+                return;
+            }
+            offset += 4;
+            MqttPacket::readString(packet.body, offset, client->clientId);
+            client->connected = true;
+            m_stats.clientsConnected++;
+            qInfo() << "MQTT client connected:" << client->clientId;
+
+            QByteArray ack;
+            ack.append(static_cast<char>(0x00));
+            ack.append(static_cast<char>(0x00));
+            socket->write(MqttPacket::encode(MqttPacket::ConnAck, 0, ack));
+            break;
+        }
+        case MqttPacket::Subscribe: {
+            if (packet.body.size() < 2) {
+                break;
+            }
+            QByteArray ack = packet.body.left(2); // packet id
+            int offset = 2;
+            QString filter;
+            while (MqttPacket::readString(packet.body, offset, filter) && offset < packet.body.size()) {
+                offset += 1; // 请求的QoS，桩只支持QoS0
+                client->subscriptions.insert(filter);
+                ack.append(static_cast<char>(0x00));
+            }
+            socket->write(MqttPacket::encode(MqttPacket::SubAck, 0, ack));
+            break;
+        }
+        case MqttPacket::Publish: {
+            QString topic;
+            QByteArray payload;
+            if (MqttPacket::parsePublish(packet, topic, payload)) {
+                handlePublish(client, topic, payload);
+            }
+            break;
+        }
+        case MqttPacket::PingReq:
+            m_stats.pings++;
+            socket->write(MqttPacket::encode(MqttPacket::PingResp, 0, QByteArray()));
+            break;
+        case MqttPacket::Disconnect:
+            socket->disconnectFromHost();
+            return;
+        default:
+            qDebug() << "MQTT broker stub ignoring packet type" << packet.type;
+            break;
+        }
+    }
+
+    if (malformed) {
+        qWarning() << "Malformed MQTT packet from" << client->clientId;
+        socket->abort();
+    }
+}
+
+void MqttBrokerStub::onDisconnected()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    Client *client = m_clients.take(socket);
+    if (!client) {
+        return;
+    }
+    qInfo() << "MQTT client disconnected:" << client->clientId;
+    m_stats.clientsDisconnected++;
+    delete client;
+    socket->deleteLater();
+}
+
+void MqttBrokerStub::handlePublish(Client *client, const QString &topic, const QByteArray &payload)
+{
+    m_stats.publishesIn++;
+
+    if (m_options.respondAsServer && topic == m_options.serverTopic) {
+        const QJsonObject json = QJsonDocument::fromJson(payload).object();
+        if (json["type"].toString() == "hello") {
+            replyHello(client, json);
+        }
+        return;
+    }
+
+    for (Client *other : std::as_const(m_clients)) {
+        for (const QString &filter : std::as_const(other->subscriptions)) {
+            if (topicMatches(filter, topic)) {
+                deliver(other, topic, payload);
+                m_stats.publishesRouted++;
+                break;
+            }
+        }
+    }
+}
+
+void MqttBrokerStub::replyHello(Client *client, const QJsonObject &hello)
+{
+    // nonce：|type 0x01|flags|len|ssrc|timestamp|sequence|，客户端只改写后三段
+    QByteArray nonce(16, '\0');
+    nonce[0] = 0x01;
+    const QByteArray ssrc = randomBytes(4);
+    for (int i = 0; i < 4; ++i) {
+        nonce[4 + i] = ssrc.at(i);
+    }
+
+    QJsonObject udp;
+    udp["server"] = m_options.udpServer;
+    udp["port"] = m_options.udpPort;
+    udp["key"] = QString::fromLatin1(randomBytes(16).toHex());
+    udp["nonce"] = QString::fromLatin1(nonce.toHex());
+
+    QJsonObject reply;
+    reply["type"] = "hello";
+    reply["transport"] = "udp";
+    reply["session_id"] = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    reply["udp"] = udp;
+    // 回显服务原样返回上行音频，下行参数与客户端上行一致
+    reply["audio_params"] = hello["audio_params"].toObject();
+
+    deliver(client, replyTopicFor(client), QJsonDocument(reply).toJson(QJsonDocument::Compact));
+    m_stats.helloReplies++;
+}
+
+void MqttBrokerStub::deliver(Client *client, const QString &topic, const QByteArray &payload)
+{
+    if (client->socket && client->connected) {
+        client->socket->write(MqttPacket::encodePublish(topic, payload));
+    }
+}
+
+QString MqttBrokerStub::replyTopicFor(const Client *client) const
+{
+    // 优先使用客户端订阅的具体主题（不含通配符）
+    for (const QString &filter : client->subscriptions) {
+        if (!filter.contains('+') && !filter.contains('#')) {
+            return filter;
+        }
+    }
+    return QString("devices/p2p/%1").arg(client->clientId);
+}
@@ -0,0 +1,85 @@
+#ifndef MQTTBROKERSTUB_H
+#define MQTTBROKERSTUB_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QHostAddress>
+#include <QByteArray>
+#include <QJsonObject>
+
+class QTcpServer;
+class QTcpSocket;
+
+// MQTT broker桩配置
+struct MqttBrokerOptions {
+    QHostAddress bindAddress = QHostAddress::LocalHost;
+    quint16 port = 1883;
+    QString serverTopic = QStringLiteral("device-server");  // 客户端上行JSON的主题（publish_topic）
+    bool respondAsServer = true;   // 代替小智服务端回复hello，下发UDP参数
+    QString udpServer = QStringLiteral("127.0.0.1");
+    quint16 udpPort = 8884;
+};
+
+struct MqttBrokerStats {
+    quint64 clientsConnected = 0;
+    quint64 clientsDisconnected = 0;
+    quint64 publishesIn = 0;
+    quint64 publishesRouted = 0;
+    quint64 helloReplies = 0;
+    quint64 pings = 0;
+};
+
+/**
+ * @brief 进程内最小MQTT 3.1.1 broker桩
+ *
+ * 支持 CONNECT / SUBSCRIBE(含+/#通配) / QoS0 PUBLISH 转发 / PINGREQ / DISCONNECT。
+ * respondAsServer开启时，发布到serverTopic的hello由桩直接回复，
+ * 携带随机AES密钥与nonce，UDP地址指向本地回显服务。
+ */
+class MqttBrokerStub : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MqttBrokerStub(const MqttBrokerOptions &options, QObject *parent = nullptr);
+    ~MqttBrokerStub();
+
+    bool start();
+    void stop();
+
+    quint16 serverPort() const;
+    const MqttBrokerStats &stats() const { return m_stats; }
+    QString statsSummary() const;
+
+    // 供客户端写入 SYSTEM_OPTIONS.NETWORK.MQTT_INFO 的示例配置
+    QJsonObject mqttInfoFor(const QString &clientId) const;
+
+    static bool topicMatches(const QString &filter, const QString &topic);
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void onDisconnected();
+
+private:
+    struct Client {
+        QTcpSocket *socket = nullptr;
+        QByteArray buffer;
+        QString clientId;
+        QSet<QString> subscriptions;
+        bool connected = false;
+    };
+
+    void handlePublish(Client *client, const QString &topic, const QByteArray &payload);
+    void replyHello(Client *client, const QJsonObject &hello);
+    void deliver(Client *client, const QString &topic, const QByteArray &payload);
+    QString replyTopicFor(const Client *client) const;
+
+    MqttBrokerOptions m_options;
+    QTcpServer *m_server;
+    QHash<QTcpSocket *, Client *> m_clients;
+    MqttBrokerStats m_stats;
+};
+
+#endif // MQTTBROKERSTUB_H
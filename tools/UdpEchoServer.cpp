@@ -0,0 +1,90 @@
+#include "UdpEchoServer.h"
+#include <QUdpSocket>
+#include <QNetworkDatagram>
+#include <QTimer>
+#include <QDebug>
+
+UdpEchoServer::UdpEchoServer(const UdpEchoOptions &options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+    , m_socket(new QUdpSocket(this))
+    , m_random(options.seed ? options.seed : QRandomGenerator::global()->generate())
+{
+    connect(m_socket, &QUdpSocket::readyRead, this, &UdpEchoServer::onReadyRead);
+}
+
+UdpEchoServer::~UdpEchoServer()
+{
+    stop();
+}
+
+bool UdpEchoServer::start()
+{
+    if (m_socket->state() == QAbstractSocket::BoundState) {
+        return true;
+    }
+    if (!m_socket->bind(m_options.bindAddress, m_options.port)) {
+        qCritical() << "UDP echo server failed to bind" << m_options.bindAddress << m_options.port
+                    << m_socket->errorString();
+        return false;
+    }
+    qInfo() << "UDP echo server listening on" << m_options.bindAddress.toString() << m_socket->localPort()
+            << "loss:" << m_options.lossRate << "delay:" << m_options.delayMs << "ms jitter:" << m_options.jitterMs << "ms";
+    return true;
+}
+
+void UdpEchoServer::stop()
+{
+    if (m_socket->state() != QAbstractSocket::UnconnectedState) {
+        m_socket->close();
+    }
+}
+
+quint16 UdpEchoServer::serverPort() const
+{
+    return m_socket->localPort();
+}
+
+QString UdpEchoServer::statsSummary() const
+{
+    return QString("udp in=%1 packets/%2 B, echoed=%3, dropped=%4")
+        .arg(m_stats.packetsIn)
+        .arg(m_stats.bytesIn)
+        .arg(m_stats.packetsEchoed)
+        .arg(m_stats.packetsDropped);
+}
+
+void UdpEchoServer::onReadyRead()
+{
+    while (m_socket->hasPendingDatagrams()) {
+        const QNetworkDatagram datagram = m_socket->receiveDatagram();
+        m_stats.packetsIn++;
+        m_stats.bytesIn += datagram.data().size();
+
+        if (m_options.lossRate > 0.0 && m_random.generateDouble() < m_options.lossRate) {
+            m_stats.packetsDropped++;
+            continue;
+        }
+
+        const QByteArray data = datagram.data();
+        const QHostAddress sender = datagram.senderAddress();
+        const quint16 senderPort = static_cast<quint16>(datagram.senderPort());
+
+        int delay = m_options.delayMs;
+        if (m_options.jitterMs > 0) {
+            delay += m_random.bounded(m_options.jitterMs + 1);
+        }
+
+        if (delay <= 0) {
+            m_socket->writeDatagram(data, sender, senderPort);
+            m_stats.packetsEchoed++;
+            continue;
+        }
+
+        // 以this为上下文，服务停止销毁后回调自动失效
+        QTimer::singleShot(delay, this, [this, data, sender, senderPort]() {
+            m_socket->writeDatagram(data, sender, senderPort);
+            m_stats.packetsEchoed++;
+        });
+    }
+}
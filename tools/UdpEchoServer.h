@@ -0,0 +1,58 @@
+#ifndef UDPECHOSERVER_H
+#define UDPECHOSERVER_H
+
+#include <QObject>
+#include <QHostAddress>
+#include <QRandomGenerator>
+
+class QUdpSocket;
+
+// UDP回显配置
+struct UdpEchoOptions {
+    QHostAddress bindAddress = QHostAddress::LocalHost;
+    quint16 port = 8884;
+    double lossRate = 0.0;   // 丢弃概率 [0, 1)
+    int delayMs = 0;         // 固定单向时延
+    int jitterMs = 0;        // 附加随机时延上限（会造成乱序）
+    quint32 seed = 0;        // 0表示随机种子
+};
+
+struct UdpEchoStats {
+    quint64 packetsIn = 0;
+    quint64 bytesIn = 0;
+    quint64 packetsEchoed = 0;
+    quint64 packetsDropped = 0;
+};
+
+/**
+ * @brief 本地UDP回显服务，模拟小智的UDP音频服务器
+ *
+ * 原样回送收到的加密音频包（nonce头未改动，客户端可用同一密钥解密），
+ * 按配置注入丢包、时延和抖动，用于离线测试MQTT+UDP传输的丢包与延迟行为。
+ */
+class UdpEchoServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit UdpEchoServer(const UdpEchoOptions &options, QObject *parent = nullptr);
+    ~UdpEchoServer();
+
+    bool start();
+    void stop();
+
+    quint16 serverPort() const;
+    const UdpEchoStats &stats() const { return m_stats; }
+    QString statsSummary() const;
+
+private slots:
+    void onReadyRead();
+
+private:
+    UdpEchoOptions m_options;
+    QUdpSocket *m_socket;
+    QRandomGenerator m_random;
+    UdpEchoStats m_stats;
+};
+
+#endif // UDPECHOSERVER_H
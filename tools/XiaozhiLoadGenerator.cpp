@@ -0,0 +1,440 @@
+#include "XiaozhiLoadGenerator.h"
+#include "OpusDecoder.h"
+#include <QTimer>
+#include <QUuid>
+#include <QJsonArray>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_MACOS)
+#include <mach/mach.h>
+#elif defined(Q_OS_LINUX)
+#include <QFile>
+#include <unistd.h>
+#endif
+
+// ---------------------------------------------------------------------------
+// LatencySeries
+// ---------------------------------------------------------------------------
+
+double LatencySeries::percentile(double p) const
+{
+    if (m_values.isEmpty()) {
+        return 0.0;
+    }
+    QVector<double> sorted = m_values;
+    std::sort(sorted.begin(), sorted.end());
+    // 最近秩法
+    const int rank = static_cast<int>(std::ceil(p / 100.0 * sorted.size()));
+    return sorted[std::min(std::max(rank, 1), static_cast<int>(sorted.size())) - 1];
+}
+
+double LatencySeries::mean() const
+{
+    if (m_values.isEmpty()) {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (double v : m_values) {
+        sum += v;
+    }
+    return sum / m_values.size();
+}
+
+double LatencySeries::max() const
+{
+    if (m_values.isEmpty()) {
+        return 0.0;
+    }
+    return *std::max_element(m_values.begin(), m_values.end());
+}
+
+QJsonObject LatencySeries::toJson() const
+{
+    return QJsonObject{
+        {"count", count()},
+        {"mean", mean()},
+        {"p50", percentile(50)},
+        {"p90", percentile(90)},
+        {"p99", percentile(99)},
+        {"max", max()}
+    };
+}
+
+// ---------------------------------------------------------------------------
+// LoadClient
+// ---------------------------------------------------------------------------
+
+LoadClient::LoadClient(int index, const LoadGeneratorOptions &options, LoadMetrics *metrics, QObject *parent)
+    : QObject(parent)
+    , m_index(index)
+    , m_options(options)
+    , m_metrics(metrics)
+    , m_manager(new WebSocketManager(this))
+    , m_decoder(nullptr)
+    , m_roundTimer(new QTimer(this))
+    , m_phase(Phase::Connecting)
+    , m_round(0)
+    , m_lastFrameNs(0)
+    , m_gotAudio(false)
+{
+    m_manager->setDeviceId(QString("loadgen-%1").arg(index));
+    m_manager->setClientId(QUuid::createUuid().toString(QUuid::WithoutBraces));
+    m_manager->setProtocolVersion(m_options.protocolVersion);
+
+    if (m_options.decode) {
+        m_decoder = new OpusDecoder(this);
+        m_decoder->initialize(m_options.decodeSampleRate, 1);
+    }
+
+    m_roundTimer->setSingleShot(true);
+    connect(m_roundTimer, &QTimer::timeout, this, &LoadClient::onRoundTimeout);
+
+    connect(m_manager, &WebSocketManager::connected, this, &LoadClient::onConnected);
+    connect(m_manager, &WebSocketManager::stateChanged, this, &LoadClient::onStateChanged);
+    connect(m_manager, &WebSocketManager::sttMessageReceived, this, &LoadClient::onSttReceived);
+    connect(m_manager, &WebSocketManager::audioDataReceived, this, &LoadClient::onAudioReceived);
+    connect(m_manager, &WebSocketManager::connectionError, this, &LoadClient::onConnectionError);
+}
+
+LoadClient::~LoadClient()
+{
+}
+
+void LoadClient::start()
+{
+    m_phase = Phase::Connecting;
+    m_stageClock.start();
+    if (!m_manager->connectToServer(m_options.url, m_options.accessToken)) {
+        m_metrics->connectionErrors++;
+        finish();
+    }
+}
+
+void LoadClient::onConnected()
+{
+    m_metrics->connectMs.add(m_stageClock.nsecsElapsed() / 1e6);
+    m_phase = Phase::Handshake;
+    m_stageClock.restart();
+}
+
+void LoadClient::onStateChanged(DeviceState state)
+{
+    if (m_phase == Phase::Finished) {
+        return;
+    }
+
+    if (state == DeviceState::DISCONNECTED && m_phase != Phase::Connecting) {
+        qWarning() << "Load client" << m_index << "disconnected unexpectedly in round" << m_round;
+        m_metrics->connectionErrors++;
+        finish();
+        return;
+    }
+
+    if (state == DeviceState::SPEAKING && m_phase == Phase::WaitingResponse) {
+        m_phase = Phase::Speaking;
+        return;
+    }
+
+    if (state != DeviceState::IDLE) {
+        return;
+    }
+
+    if (m_phase == Phase::Handshake) {
+        m_metrics->helloMs.add(m_stageClock.nsecsElapsed() / 1e6);
+        emit ready(m_index);
+        beginRound();
+    } else if (m_phase == Phase::Speaking) {
+        endRound(false);
+    }
+}
+
+void LoadClient::onSttReceived(const QString &text)
+{
+    Q_UNUSED(text)
+    if (m_phase == Phase::WaitingResponse) {
+        m_metrics->sttMs.add(m_stageClock.nsecsElapsed() / 1e6);
+    }
+}
+
+void LoadClient::onAudioReceived(const QByteArray &data)
+{
+    m_metrics->framesReceived++;
+    m_metrics->bytesReceived += data.size();
+
+    if (!m_gotAudio) {
+        m_gotAudio = true;
+        m_metrics->firstAudioMs.add(m_stageClock.nsecsElapsed() / 1e6);
+        m_firstAudioClock.start();
+        m_lastFrameNs = 0;
+    } else {
+        const qint64 now = m_firstAudioClock.nsecsElapsed();
+        m_metrics->frameGapMs.add((now - m_lastFrameNs) / 1e6);
+        m_lastFrameNs = now;
+    }
+
+    if (m_decoder) {
+        QElapsedTimer decodeClock;
+        decodeClock.start();
+        const QByteArray pcm = m_decoder->decode(data);
+        m_metrics->decodeUs.add(decodeClock.nsecsElapsed() / 1e3);
+        if (pcm.isEmpty()) {
+            m_metrics->decodeErrors++;
+        }
+    }
+}
+
+void LoadClient::onConnectionError(const QString &error)
+{
+    if (m_phase == Phase::Connecting) {
+        qWarning() << "Load client" << m_index << "failed to connect:" << error;
+        m_metrics->connectionErrors++;
+        finish();
+    }
+}
+
+void LoadClient::onRoundTimeout()
+{
+    qWarning() << "Load client" << m_index << "round" << m_round << "timed out";
+    endRound(true);
+}
+
+void LoadClient::beginRound()
+{
+    if (m_round >= m_options.rounds) {
+        finish();
+        return;
+    }
+
+    m_round++;
+    m_phase = Phase::WaitingResponse;
+    m_gotAudio = false;
+    m_stageClock.restart();
+    m_roundTimer->start(m_options.roundTimeoutMs);
+    m_manager->sendWakeWordDetected(QStringLiteral("你好小智"));
+}
+
+void LoadClient::endRound(bool timedOut)
+{
+    m_roundTimer->stop();
+    if (timedOut) {
+        m_metrics->roundTimeouts++;
+        m_manager->sendAbortSpeaking();
+    } else {
+        m_metrics->roundsCompleted++;
+        if (m_gotAudio) {
+            m_metrics->ttsStreamMs.add(m_firstAudioClock.nsecsElapsed() / 1e6);
+            const AudioStreamStats streamStats = m_manager->getAudioStreamStats();
+            m_metrics->jitterMs.add(streamStats.jitterMs);
+            m_metrics->framesLost += streamStats.framesLost;
+        }
+    }
+
+    m_phase = Phase::Resting;
+    QTimer::singleShot(m_options.roundIntervalMs, this, [this]() {
+        if (m_phase == Phase::Resting) {
+            beginRound();
+        }
+    });
+}
+
+void LoadClient::finish()
+{
+    if (m_phase == Phase::Finished) {
+        return;
+    }
+    m_phase = Phase::Finished;
+    m_roundTimer->stop();
+    m_manager->disconnectFromServer();
+    emit finished(m_index);
+}
+
+// ---------------------------------------------------------------------------
+// XiaozhiLoadGenerator
+// ---------------------------------------------------------------------------
+
+XiaozhiLoadGenerator::XiaozhiLoadGenerator(const LoadGeneratorOptions &options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+    , m_baselineRss(0)
+    , m_connectedRss(0)
+    , m_peakRss(0)
+    , m_readyClients(0)
+    , m_finishedClients(0)
+{
+}
+
+XiaozhiLoadGenerator::~XiaozhiLoadGenerator()
+{
+    qDeleteAll(m_clients);
+}
+
+void XiaozhiLoadGenerator::start()
+{
+    m_baselineRss = currentRssBytes();
+    m_peakRss = m_baselineRss;
+    m_wallClock.start();
+
+    qInfo() << "Starting" << m_options.clients << "clients x" << m_options.rounds << "rounds against" << m_options.url;
+
+    for (int i = 0; i < m_options.clients; ++i) {
+        LoadClient *client = new LoadClient(i, m_options, &m_metrics);
+        connect(client, &LoadClient::ready, this, &XiaozhiLoadGenerator::onClientReady);
+        connect(client, &LoadClient::finished, this, &XiaozhiLoadGenerator::onClientFinished);
+        m_clients.append(client);
+        QTimer::singleShot(i * m_options.rampUpMs, client, &LoadClient::start);
+    }
+
+    if (m_clients.isEmpty()) {
+        emit finished();
+    }
+}
+
+void XiaozhiLoadGenerator::onClientReady(int index)
+{
+    Q_UNUSED(index)
+    m_readyClients++;
+    m_peakRss = std::max(m_peakRss, currentRssBytes());
+    if (m_readyClients == m_clients.size()) {
+        m_connectedRss = currentRssBytes();
+        qInfo() << "All" << m_readyClients << "clients connected after" << m_wallClock.elapsed() << "ms";
+    }
+}
+
+void XiaozhiLoadGenerator::onClientFinished(int index)
+{
+    Q_UNUSED(index)
+    m_finishedClients++;
+    m_peakRss = std::max(m_peakRss, currentRssBytes());
+    if (m_finishedClients == m_clients.size()) {
+        emit finished();
+    }
+}
+
+qint64 XiaozhiLoadGenerator::currentRssBytes()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<qint64>(counters.WorkingSetSize);
+    }
+    return 0;
+#elif defined(Q_OS_MACOS)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS) {
+        return static_cast<qint64>(info.resident_size);
+    }
+    return 0;
+#elif defined(Q_OS_LINUX)
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    if (fields.size() < 2) {
+        return 0;
+    }
+    return fields[1].toLongLong() * sysconf(_SC_PAGESIZE);
+#else
+    return 0;
+#endif
+}
+
+QJsonObject XiaozhiLoadGenerator::reportJson() const
+{
+    const double seconds = std::max<qint64>(m_wallClock.elapsed(), 1) / 1000.0;
+    const int clients = std::max(1, static_cast<int>(m_clients.size()));
+    const qint64 sessionRss = m_connectedRss > 0 ? m_connectedRss : m_peakRss;
+
+    QJsonObject stages{
+        {"connect_ms", m_metrics.connectMs.toJson()},
+        {"hello_ms", m_metrics.helloMs.toJson()},
+        {"stt_ms", m_metrics.sttMs.toJson()},
+        {"first_audio_ms", m_metrics.firstAudioMs.toJson()},
+        {"tts_stream_ms", m_metrics.ttsStreamMs.toJson()},
+        {"frame_gap_ms", m_metrics.frameGapMs.toJson()},
+        {"decode_us", m_metrics.decodeUs.toJson()},
+        {"jitter_ms", m_metrics.jitterMs.toJson()}
+    };
+
+    QJsonObject throughput{
+        {"wall_seconds", seconds},
+        {"rounds_per_second", m_metrics.roundsCompleted / seconds},
+        {"frames_per_second", m_metrics.framesReceived / seconds},
+        {"kbit_per_second", m_metrics.bytesReceived * 8.0 / 1000.0 / seconds}
+    };
+
+    QJsonObject memory{
+        {"baseline_rss_bytes", m_baselineRss},
+        {"connected_rss_bytes", m_connectedRss},
+        {"peak_rss_bytes", m_peakRss},
+        {"per_session_bytes", static_cast<double>(std::max<qint64>(sessionRss - m_baselineRss, 0)) / clients}
+    };
+
+    return QJsonObject{
+        {"clients", m_options.clients},
+        {"rounds", m_options.rounds},
+        {"rounds_completed", static_cast<qint64>(m_metrics.roundsCompleted)},
+        {"round_timeouts", static_cast<qint64>(m_metrics.roundTimeouts)},
+        {"connection_errors", static_cast<qint64>(m_metrics.connectionErrors)},
+        {"frames_received", static_cast<qint64>(m_metrics.framesReceived)},
+        {"bytes_received", static_cast<qint64>(m_metrics.bytesReceived)},
+        {"decode_errors", static_cast<qint64>(m_metrics.decodeErrors)},
+        {"frames_lost", static_cast<qint64>(m_metrics.framesLost)},
+        {"protocol_version", m_options.protocolVersion},
+        {"stages", stages},
+        {"throughput", throughput},
+        {"memory", memory}
+    };
+}
+
+QString XiaozhiLoadGenerator::report() const
+{
+    const QJsonObject json = reportJson();
+    const QJsonObject throughput = json["throughput"].toObject();
+    const QJsonObject memory = json["memory"].toObject();
+
+    QString text;
+    text += QString("clients=%1 rounds=%2 completed=%3 timeouts=%4 connection_errors=%5\n")
+                .arg(m_options.clients).arg(m_options.rounds)
+                .arg(m_metrics.roundsCompleted).arg(m_metrics.roundTimeouts).arg(m_metrics.connectionErrors);
+    text += QString("throughput: %1 rounds/s, %2 frames/s, %3 kbit/s over %4 s (decode errors: %5, lost: %6)\n")
+                .arg(throughput["rounds_per_second"].toDouble(), 0, 'f', 2)
+                .arg(throughput["frames_per_second"].toDouble(), 0, 'f', 1)
+                .arg(throughput["kbit_per_second"].toDouble(), 0, 'f', 1)
+                .arg(throughput["wall_seconds"].toDouble(), 0, 'f', 2)
+                .arg(m_metrics.decodeErrors)
+                .arg(m_metrics.framesLost);
+
+    auto line = [](const char *name, const LatencySeries &series) {
+        return QString("  %1 n=%2 mean=%3 p50=%4 p90=%5 p99=%6 max=%7\n")
+            .arg(QString::fromLatin1(name), -16)
+            .arg(series.count(), 6)
+            .arg(series.mean(), 9, 'f', 2)
+            .arg(series.percentile(50), 9, 'f', 2)
+            .arg(series.percentile(90), 9, 'f', 2)
+            .arg(series.percentile(99), 9, 'f', 2)
+            .arg(series.max(), 9, 'f', 2);
+    };
+    text += "stage latencies:\n";
+    text += line("connect_ms", m_metrics.connectMs);
+    text += line("hello_ms", m_metrics.helloMs);
+    text += line("stt_ms", m_metrics.sttMs);
+    text += line("first_audio_ms", m_metrics.firstAudioMs);
+    text += line("tts_stream_ms", m_metrics.ttsStreamMs);
+    text += line("frame_gap_ms", m_metrics.frameGapMs);
+    text += line("decode_us", m_metrics.decodeUs);
+    text += line("jitter_ms", m_metrics.jitterMs);
+
+    text += QString("memory: baseline=%1 KiB connected=%2 KiB peak=%3 KiB per_session=%4 KiB\n")
+                .arg(memory["baseline_rss_bytes"].toDouble() / 1024.0, 0, 'f', 0)
+                .arg(memory["connected_rss_bytes"].toDouble() / 1024.0, 0, 'f', 0)
+                .arg(memory["peak_rss_bytes"].toDouble() / 1024.0, 0, 'f', 0)
+                .arg(memory["per_session_bytes"].toDouble() / 1024.0, 0, 'f', 1);
+    return text;
+}
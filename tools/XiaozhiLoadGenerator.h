@@ -0,0 +1,156 @@
+#ifndef XIAOZHILOADGENERATOR_H
+#define XIAOZHILOADGENERATOR_H
+
+#include <QObject>
+#include <QVector>
+#include <QList>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include "WebSocketManager.h"
+
+class OpusDecoder;
+class QTimer;
+
+// 压测配置
+struct LoadGeneratorOptions {
+    QString url = QStringLiteral("ws://127.0.0.1:8765/xiaozhi/v1/");
+    QString accessToken = QStringLiteral("test-token");
+    int clients = 10;             // 并发客户端（管线）数量
+    int rounds = 5;               // 每个客户端的对话轮数
+    int rampUpMs = 20;            // 相邻客户端启动间隔
+    int roundIntervalMs = 300;    // 一轮结束后到下一轮唤醒的间隔
+    int roundTimeoutMs = 30000;   // 单轮超时
+    bool decode = true;           // 是否在管线中解码下行Opus
+    int protocolVersion = 1;      // 二进制帧版本（1原始/2/3）
+    int decodeSampleRate = 24000;
+};
+
+// 延迟样本序列，结束时统一排序求分位数
+class LatencySeries
+{
+public:
+    void add(double value) { m_values.append(value); }
+    int count() const { return m_values.size(); }
+    double percentile(double p) const;
+    double mean() const;
+    double max() const;
+    QJsonObject toJson() const;
+
+private:
+    QVector<double> m_values;
+};
+
+// 所有客户端共享的汇总指标（单线程事件循环内更新，无需加锁）
+struct LoadMetrics {
+    LatencySeries connectMs;       // connectToServer -> connected
+    LatencySeries helloMs;         // connected -> hello响应(IDLE)
+    LatencySeries sttMs;           // 唤醒 -> stt
+    LatencySeries firstAudioMs;    // 唤醒 -> 第一帧TTS音频
+    LatencySeries ttsStreamMs;     // 第一帧音频 -> tts stop
+    LatencySeries frameGapMs;      // 下行音频帧到达间隔
+    LatencySeries decodeUs;        // 单帧解码耗时
+    LatencySeries jitterMs;        // 每轮结束时WebSocketManager统计的到达抖动
+    quint64 framesLost = 0;        // 按序号推算的丢帧（v2/v3）
+    quint64 framesReceived = 0;
+    quint64 bytesReceived = 0;
+    quint64 decodeErrors = 0;
+    quint64 roundsCompleted = 0;
+    quint64 roundTimeouts = 0;
+    quint64 connectionErrors = 0;
+};
+
+/**
+ * @brief 单个客户端管线：WebSocketManager + OpusDecoder
+ *
+ * 依次执行 连接 -> hello -> 唤醒 -> 接收stt/tts音频 -> 回到IDLE，
+ * 循环指定轮数后发出finished。
+ */
+class LoadClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    LoadClient(int index, const LoadGeneratorOptions &options, LoadMetrics *metrics, QObject *parent = nullptr);
+    ~LoadClient();
+
+    void start();
+    bool isFinished() const { return m_phase == Phase::Finished; }
+
+signals:
+    void ready(int index);
+    void finished(int index);
+
+private slots:
+    void onConnected();
+    void onStateChanged(DeviceState state);
+    void onSttReceived(const QString &text);
+    void onAudioReceived(const QByteArray &data);
+    void onConnectionError(const QString &error);
+    void onRoundTimeout();
+
+private:
+    enum class Phase {
+        Connecting,
+        Handshake,
+        WaitingResponse,
+        Speaking,
+        Resting,
+        Finished
+    };
+
+    void beginRound();
+    void endRound(bool timedOut);
+    void finish();
+
+    int m_index;
+    LoadGeneratorOptions m_options;
+    LoadMetrics *m_metrics;
+    WebSocketManager *m_manager;
+    OpusDecoder *m_decoder;
+    QTimer *m_roundTimer;
+    Phase m_phase;
+    int m_round;
+    QElapsedTimer m_stageClock;
+    QElapsedTimer m_firstAudioClock;
+    qint64 m_lastFrameNs;
+    bool m_gotAudio;
+};
+
+/**
+ * @brief 多客户端压测器，在一个进程内启动N条客户端管线并输出统计报告
+ */
+class XiaozhiLoadGenerator : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit XiaozhiLoadGenerator(const LoadGeneratorOptions &options, QObject *parent = nullptr);
+    ~XiaozhiLoadGenerator();
+
+    void start();
+    QString report() const;
+    QJsonObject reportJson() const;
+
+    // 当前进程常驻内存（字节），不支持的平台返回0
+    static qint64 currentRssBytes();
+
+signals:
+    void finished();
+
+private slots:
+    void onClientReady(int index);
+    void onClientFinished(int index);
+
+private:
+    LoadGeneratorOptions m_options;
+    LoadMetrics m_metrics;
+    QList<LoadClient *> m_clients;
+    QElapsedTimer m_wallClock;
+    qint64 m_baselineRss;
+    qint64 m_connectedRss;
+    qint64 m_peakRss;
+    int m_readyClients;
+    int m_finishedClients;
+};
+
+#endif // XIAOZHILOADGENERATOR_H
@@ -0,0 +1,467 @@
+#include "XiaozhiMockServer.h"
+#include "OpusEncoder.hpp"
+#include "BinaryAudioProtocol.h"
+#include <QWebSocketServer>
+#include <QHostAddress>
+#include <QWebSocket>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QFile>
+#include <QTimer>
+#include <QUuid>
+#include <QDebug>
+#include <QtMath>
+#include <algorithm>
+
+namespace {
+// 所有会话共享的流代号，保证旧的定时回调不会误发到新会话
+quint32 g_nextStreamGeneration = 1;
+}
+
+XiaozhiMockServer::XiaozhiMockServer(const MockServerOptions &options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+    , m_server(new QWebSocketServer(QStringLiteral("xiaozhi-mock"), QWebSocketServer::NonSecureMode, this))
+    , m_random(options.seed ? options.seed : QRandomGenerator::global()->generate())
+{
+    connect(m_server, &QWebSocketServer::newConnection, this, &XiaozhiMockServer::onNewConnection);
+    m_pcm = loadOrSynthesizePcm();
+}
+
+XiaozhiMockServer::~XiaozhiMockServer()
+{
+    stop();
+}
+
+bool XiaozhiMockServer::start()
+{
+    if (m_server->isListening()) {
+        return true;
+    }
+    if (!m_server->listen(QHostAddress::Any, m_options.port)) {
+        qCritical() << "Mock server failed to listen on port" << m_options.port << m_server->errorString();
+        return false;
+    }
+    qInfo() << "Xiaozhi mock server listening on ws://127.0.0.1:" << m_server->serverPort()
+            << "pacing:" << m_options.pacing << "loss:" << m_options.lossRate
+            << "jitter:" << m_options.jitterMs << "ms";
+    return true;
+}
+
+void XiaozhiMockServer::stop()
+{
+    const auto sockets = m_sessions.keys();
+    for (QWebSocket *socket : sockets) {
+        socket->close();
+    }
+    qDeleteAll(m_sessions);
+    m_sessions.clear();
+    if (m_server->isListening()) {
+        m_server->close();
+    }
+}
+
+quint16 XiaozhiMockServer::serverPort() const
+{
+    return m_server->serverPort();
+}
+
+QString XiaozhiMockServer::statsSummary() const
+{
+    const double mcpAvg = m_stats.mcpResponses ? m_stats.mcpRttTotalMs / m_stats.mcpResponses : 0.0;
+    return QString("sessions open=%1 opened=%2 closed=%3 rejected=%4 | text in=%5 out=%6 | "
+                   "audio in=%7 frames/%8 B, out=%9 frames/%10 B, dropped=%11 | "
+                   "tts streams=%12 aborted=%13 | mcp responses=%14 avg rtt=%15 ms")
+        .arg(m_sessions.size())
+        .arg(m_stats.sessionsOpened)
+        .arg(m_stats.sessionsClosed)
+        .arg(m_stats.rejectedSessions)
+        .arg(m_stats.textMessagesIn)
+        .arg(m_stats.textMessagesOut)
+        .arg(m_stats.audioFramesIn)
+        .arg(m_stats.audioBytesIn)
+        .arg(m_stats.audioFramesOut)
+        .arg(m_stats.audioBytesOut)
+        .arg(m_stats.audioFramesDropped)
+        .arg(m_stats.ttsStreamsStarted)
+        .arg(m_stats.ttsStreamsAborted)
+        .arg(m_stats.mcpResponses)
+        .arg(mcpAvg, 0, 'f', 2);
+}
+
+void XiaozhiMockServer::onNewConnection()
+{
+    while (m_server->hasPendingConnections()) {
+        QWebSocket *socket = m_server->nextPendingConnection();
+
+        // 校验访问令牌（与真实服务一致，使用Bearer头）
+        if (!m_options.expectedToken.isEmpty()) {
+            const QByteArray auth = socket->request().rawHeader("Authorization");
+            if (auth != QByteArray("Bearer ") + m_options.expectedToken.toUtf8()) {
+                qWarning() << "Mock server rejected connection with bad token from" << socket->peerAddress();
+                m_stats.rejectedSessions++;
+                socket->close(QWebSocketProtocol::CloseCodePolicyViolated, QStringLiteral("unauthorized"));
+                socket->deleteLater();
+                continue;
+            }
+        }
+
+        Session *session = new Session;
+        session->socket = socket;
+        session->sessionId = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        session->clock.start();
+        session->protocolVersion = m_options.protocolVersion > 0
+            ? m_options.protocolVersion
+            : socket->request().rawHeader("Protocol-Version").toInt();
+        if (!BinaryAudioProtocol::isSupportedVersion(session->protocolVersion)) {
+            session->protocolVersion = 1;
+        }
+        m_sessions.insert(socket, session);
+        m_stats.sessionsOpened++;
+
+        connect(socket, &QWebSocket::textMessageReceived, this, &XiaozhiMockServer::onTextMessage);
+        connect(socket, &QWebSocket::binaryMessageReceived, this, &XiaozhiMockServer::onBinaryMessage);
+        connect(socket, &QWebSocket::disconnected, this, &XiaozhiMockServer::onSocketDisconnected);
+
+        emit sessionOpened(session->sessionId);
+    }
+}
+
+XiaozhiMockServer::Session *XiaozhiMockServer::sessionFor(QObject *sender) const
+{
+    return m_sessions.value(qobject_cast<QWebSocket *>(sender), nullptr);
+}
+
+void XiaozhiMockServer::onSocketDisconnected()
+{
+    QWebSocket *socket = qobject_cast<QWebSocket *>(sender());
+    Session *session = m_sessions.take(socket);
+    if (session) {
+        m_stats.sessionsClosed++;
+        emit sessionClosed(session->sessionId);
+        delete session;
+    }
+    if (socket) {
+        socket->deleteLater();
+    }
+}
+
+void XiaozhiMockServer::onTextMessage(const QString &message)
+{
+    Session *session = sessionFor(sender());
+    if (!session) {
+        return;
+    }
+    m_stats.textMessagesIn++;
+
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8(), &error);
+    if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+        qWarning() << "Mock server got invalid JSON:" << error.errorString();
+        return;
+    }
+
+    const QJsonObject json = doc.object();
+    const QString type = json["type"].toString();
+    if (type == "hello") {
+        handleHello(session, json);
+    } else if (type == "listen") {
+        handleListen(session, json);
+    } else if (type == "abort") {
+        handleAbort(session);
+    } else if (type == "mcp") {
+        handleMcp(session, json);
+    } else if (type == "ping") {
+        sendJson(session, QJsonObject{{"type", "pong"}, {"session_id", session->sessionId}});
+    } else if (type == "iot" || type == "pong") {
+        // 忽略
+    } else {
+        qWarning() << "Mock server got unknown message type:" << type;
+    }
+}
+
+void XiaozhiMockServer::onBinaryMessage(const QByteArray &data)
+{
+    Session *session = sessionFor(sender());
+    if (!session) {
+        return;
+    }
+    m_stats.audioFramesIn++;
+    m_stats.audioBytesIn += data.size();
+    if (session->listening) {
+        session->listenFrames++;
+    }
+}
+
+void XiaozhiMockServer::sendJson(Session *session, const QJsonObject &json)
+{
+    session->socket->sendTextMessage(QString::fromUtf8(QJsonDocument(json).toJson(QJsonDocument::Compact)));
+    m_stats.textMessagesOut++;
+}
+
+void XiaozhiMockServer::handleHello(Session *session, const QJsonObject &json)
+{
+    const QJsonObject clientAudio = json["audio_params"].toObject();
+    int frameDuration = m_options.frameDurationMs > 0 ? m_options.frameDurationMs
+                                                      : clientAudio["frame_duration"].toInt(60);
+    // Opus只接受这些帧长
+    if (frameDuration != 10 && frameDuration != 20 && frameDuration != 40 && frameDuration != 60) {
+        qWarning() << "Mock server: unsupported frame_duration" << frameDuration << ", using 60";
+        frameDuration = 60;
+    }
+    session->frameDurationMs = frameDuration;
+    session->helloDone = true;
+
+    QJsonObject reply;
+    reply["type"] = "hello";
+    reply["transport"] = "websocket";
+    reply["session_id"] = session->sessionId;
+    reply["audio_params"] = QJsonObject{
+        {"format", "opus"},
+        {"sample_rate", m_options.sampleRate},
+        {"channels", 1},
+        {"frame_duration", frameDuration}
+    };
+    sendJson(session, reply);
+
+    const bool clientMcp = json["features"].toObject()["mcp"].toBool();
+    if (m_options.sendMcpInitialize && clientMcp) {
+        sendMcpRequest(session, "initialize", QJsonObject{
+            {"protocolVersion", "2024-11-05"},
+            {"capabilities", QJsonObject()},
+            {"clientInfo", QJsonObject{{"name", "xiaozhi-mock"}, {"version", "1.0.0"}}}
+        });
+    }
+}
+
+void XiaozhiMockServer::handleListen(Session *session, const QJsonObject &json)
+{
+    const QString state = json["state"].toString();
+    if (state == "detect") {
+        const QString text = json["text"].toString();
+        respond(session, text.isEmpty() ? m_options.sttText : text);
+    } else if (state == "start") {
+        session->listening = true;
+        session->listenFrames = 0;
+    } else if (state == "stop") {
+        session->listening = false;
+        respond(session, QString("%1 (%2 frames)").arg(m_options.sttText).arg(session->listenFrames));
+    }
+}
+
+void XiaozhiMockServer::handleAbort(Session *session)
+{
+    if (session->nextFrame < session->frameDueMs.size()) {
+        m_stats.ttsStreamsAborted++;
+        finishTtsStream(session);
+    } else {
+        // 还在"思考"阶段，直接取消挂起的回复
+        session->streamGeneration = g_nextStreamGeneration++;
+    }
+}
+
+void XiaozhiMockServer::sendMcpRequest(Session *session, const QString &method, const QJsonObject &params)
+{
+    const int id = session->nextMcpId++;
+    QJsonObject payload{
+        {"jsonrpc", "2.0"},
+        {"method", method},
+        {"params", params},
+        {"id", id}
+    };
+    session->pendingMcp.insert(id, session->clock.elapsed());
+    sendJson(session, QJsonObject{
+        {"type", "mcp"},
+        {"session_id", session->sessionId},
+        {"payload", payload}
+    });
+}
+
+void XiaozhiMockServer::handleMcp(Session *session, const QJsonObject &json)
+{
+    const QJsonObject payload = json["payload"].toObject();
+    if (!payload.contains("id") || payload.contains("method")) {
+        return;
+    }
+    const int id = payload["id"].toInt();
+    if (!session->pendingMcp.contains(id)) {
+        return;
+    }
+    const qint64 sentAt = session->pendingMcp.take(id);
+    m_stats.mcpResponses++;
+    m_stats.mcpRttTotalMs += session->clock.elapsed() - sentAt;
+
+    // initialize完成后继续拉取工具列表，模拟真实服务端的握手顺序
+    if (id == 1) {
+        sendMcpRequest(session, "tools/list", QJsonObject{{"cursor", ""}});
+    }
+}
+
+void XiaozhiMockServer::respond(Session *session, const QString &sttText)
+{
+    QWebSocket *socket = session->socket;
+    const quint32 generation = g_nextStreamGeneration++;
+    session->streamGeneration = generation;
+
+    sendJson(session, QJsonObject{{"type", "stt"}, {"text", sttText}, {"session_id", session->sessionId}});
+
+    QTimer::singleShot(m_options.responseDelayMs, this, [this, socket, generation]() {
+        Session *session = m_sessions.value(socket, nullptr);
+        if (!session || session->streamGeneration != generation) {
+            return;
+        }
+        sendJson(session, QJsonObject{
+            {"type", "llm"},
+            {"text", "😊"},
+            {"emotion", m_options.emotion},
+            {"session_id", session->sessionId}
+        });
+        startTtsStream(session);
+    });
+}
+
+void XiaozhiMockServer::startTtsStream(Session *session)
+{
+    const QVector<QByteArray> &frames = framesFor(session->frameDurationMs);
+    m_stats.ttsStreamsStarted++;
+
+    sendJson(session, QJsonObject{
+        {"type", "tts"},
+        {"state", "start"},
+        {"sample_rate", m_options.sampleRate},
+        {"session_id", session->sessionId}
+    });
+    sendJson(session, QJsonObject{
+        {"type", "tts"},
+        {"state", "sentence_start"},
+        {"text", m_options.replyText},
+        {"emotion", m_options.emotion},
+        {"session_id", session->sessionId}
+    });
+
+    // 预先计算每帧的发送时间：基准节奏 + 随机抖动，且保持单调（TCP不会乱序）
+    session->frameDueMs.resize(frames.size());
+    const double step = session->frameDurationMs * m_options.pacing;
+    qint64 previous = 0;
+    for (int i = 0; i < frames.size(); ++i) {
+        qint64 due = static_cast<qint64>(i * step);
+        if (m_options.jitterMs > 0) {
+            due += m_random.bounded(m_options.jitterMs + 1);
+        }
+        previous = std::max(previous, due);
+        session->frameDueMs[i] = previous;
+    }
+    session->nextFrame = 0;
+    session->streamClock.start();
+    session->streamBaseMs = session->clock.elapsed();
+    sendNextFrame(session, session->streamGeneration);
+}
+
+void XiaozhiMockServer::sendNextFrame(Session *session, quint32 generation)
+{
+    const QVector<QByteArray> &frames = framesFor(session->frameDurationMs);
+    const qint64 now = session->streamClock.elapsed();
+
+    // 发送所有已经到期的帧
+    while (session->nextFrame < frames.size() && session->frameDueMs[session->nextFrame] <= now) {
+        // 时间戳取该帧的标称采集时刻，不含抖动
+        const int index = session->nextFrame++;
+        const quint32 sequence = session->txSequence++;
+        const quint32 timestamp = static_cast<quint32>(session->streamBaseMs + index * session->frameDurationMs);
+        if (m_options.lossRate > 0.0 && m_random.generateDouble() < m_options.lossRate) {
+            m_stats.audioFramesDropped++;
+            continue;
+        }
+        const QByteArray frame = BinaryAudioProtocol::pack(session->protocolVersion, frames[index], sequence, timestamp);
+        session->socket->sendBinaryMessage(frame);
+        m_stats.audioFramesOut++;
+        m_stats.audioBytesOut += frame.size();
+    }
+
+    if (session->nextFrame >= frames.size()) {
+        finishTtsStream(session);
+        return;
+    }
+
+    QWebSocket *socket = session->socket;
+    const qint64 wait = session->frameDueMs[session->nextFrame] - now;
+    QTimer::singleShot(static_cast<int>(std::max<qint64>(wait, 0)), Qt::PreciseTimer, this,
+                       [this, socket, generation]() {
+        Session *session = m_sessions.value(socket, nullptr);
+        if (session && session->streamGeneration == generation) {
+            sendNextFrame(session, generation);
+        }
+    });
+}
+
+void XiaozhiMockServer::finishTtsStream(Session *session)
+{
+    // 使挂起的发送回调失效
+    session->streamGeneration = g_nextStreamGeneration++;
+    session->frameDueMs.clear();
+    session->nextFrame = 0;
+
+    sendJson(session, QJsonObject{
+        {"type", "tts"},
+        {"state", "sentence_end"},
+        {"text", m_options.replyText},
+        {"session_id", session->sessionId}
+    });
+    sendJson(session, QJsonObject{{"type", "tts"}, {"state", "stop"}, {"session_id", session->sessionId}});
+}
+
+const QVector<QByteArray> &XiaozhiMockServer::framesFor(int frameDurationMs)
+{
+    auto it = m_encodedFrames.find(frameDurationMs);
+    if (it != m_encodedFrames.end()) {
+        return it.value();
+    }
+
+    // 每种帧长只编码一次，所有会话共享
+    QVector<QByteArray> frames;
+    OpusEncoder encoder;
+    if (encoder.initialize(m_options.sampleRate, 1, OPUS_APPLICATION_AUDIO)) {
+        const int frameSize = OpusEncoder::getFrameSizeForDuration(m_options.sampleRate, frameDurationMs);
+        const int totalSamples = m_pcm.size() / static_cast<int>(sizeof(int16_t));
+        const int16_t *samples = reinterpret_cast<const int16_t *>(m_pcm.constData());
+        QVector<int16_t> frameBuffer(frameSize);
+        for (int offset = 0; offset < totalSamples; offset += frameSize) {
+            const int count = std::min(frameSize, totalSamples - offset);
+            std::fill(frameBuffer.begin(), frameBuffer.end(), 0);
+            std::copy(samples + offset, samples + offset + count, frameBuffer.begin());
+            const QByteArray packet = encoder.encode(frameBuffer.constData(), frameSize);
+            if (!packet.isEmpty()) {
+                frames.append(packet);
+            }
+        }
+    } else {
+        qCritical() << "Mock server failed to initialize Opus encoder";
+    }
+
+    qInfo() << "Mock server encoded" << frames.size() << "TTS frames of" << frameDurationMs << "ms";
+    return m_encodedFrames.insert(frameDurationMs, frames).value();
+}
+
+QByteArray XiaozhiMockServer::loadOrSynthesizePcm() const
+{
+    if (!m_options.ttsPcmFile.isEmpty()) {
+        QFile file(m_options.ttsPcmFile);
+        if (file.open(QIODevice::ReadOnly)) {
+            return file.readAll();
+        }
+        qWarning() << "Mock server cannot open TTS PCM file" << m_options.ttsPcmFile << ", using synthetic tone";
+    }
+
+    // 合成一段带音节包络的语音样音，使口型同步有明显的开合
+    const int totalSamples = m_options.sampleRate * m_options.ttsDurationMs / 1000;
+    QByteArray pcm(totalSamples * static_cast<int>(sizeof(int16_t)), 0);
+    int16_t *out = reinterpret_cast<int16_t *>(pcm.data());
+    for (int i = 0; i < totalSamples; ++i) {
+        const double t = static_cast<double>(i) / m_options.sampleRate;
+        const double envelope = qAbs(qSin(2.0 * M_PI * 4.0 * t));
+        const double voice = 0.6 * qSin(2.0 * M_PI * 220.0 * t) + 0.3 * qSin(2.0 * M_PI * 440.0 * t)
+                           + 0.1 * qSin(2.0 * M_PI * 880.0 * t);
+        out[i] = static_cast<int16_t>(voice * envelope * 12000.0);
+    }
+    return pcm;
+}
@@ -0,0 +1,131 @@
+#ifndef XIAOZHIMOCKSERVER_H
+#define XIAOZHIMOCKSERVER_H
+
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include <QByteArray>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+
+class QWebSocketServer;
+class QWebSocket;
+class QTimer;
+
+// 本地小智协议模拟服务器配置
+struct MockServerOptions {
+    quint16 port = 8765;
+    QString expectedToken;          // 为空时不校验Authorization
+    int sampleRate = 24000;         // TTS下行采样率
+    int frameDurationMs = 0;        // 0表示沿用客户端hello中的frame_duration
+    int protocolVersion = 0;        // 二进制帧版本，0表示沿用客户端Protocol-Version头
+    double pacing = 1.0;            // 1.0为实时节奏，0为尽快发送
+    double lossRate = 0.0;          // 下行音频帧丢弃概率 [0, 1)
+    int jitterMs = 0;               // 每帧附加的随机延迟上限
+    int ttsDurationMs = 2000;       // 合成音的时长
+    QString ttsPcmFile;             // 可选：16-bit单声道PCM文件，采样率同sampleRate
+    int responseDelayMs = 200;      // 模拟LLM思考时间
+    QString sttText = QStringLiteral("你好");
+    QString replyText = QStringLiteral("你好呀，我是模拟服务器");
+    QString emotion = QStringLiteral("happy");
+    bool sendMcpInitialize = true;  // hello之后主动发起MCP initialize/tools/list
+    quint32 seed = 0;               // 0表示随机种子
+};
+
+// 服务器侧累计统计
+struct MockServerStats {
+    quint64 sessionsOpened = 0;
+    quint64 sessionsClosed = 0;
+    quint64 rejectedSessions = 0;
+    quint64 textMessagesIn = 0;
+    quint64 textMessagesOut = 0;
+    quint64 audioFramesIn = 0;
+    quint64 audioBytesIn = 0;
+    quint64 audioFramesOut = 0;
+    quint64 audioBytesOut = 0;
+    quint64 audioFramesDropped = 0;
+    quint64 ttsStreamsStarted = 0;
+    quint64 ttsStreamsAborted = 0;
+    quint64 mcpResponses = 0;
+    double mcpRttTotalMs = 0.0;
+};
+
+/**
+ * @brief 基于QWebSocketServer的小智协议模拟服务器
+ *
+ * 支持 hello / listen / abort / stt / llm / tts / mcp 消息，
+ * 按可配置的节奏、丢包率和抖动下发预先编码好的Opus TTS音频，
+ * 用于在没有真实后端的情况下压测 WebSocketManager / DeskPetController。
+ */
+class XiaozhiMockServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit XiaozhiMockServer(const MockServerOptions &options, QObject *parent = nullptr);
+    ~XiaozhiMockServer();
+
+    bool start();
+    void stop();
+
+    quint16 serverPort() const;
+    int sessionCount() const { return m_sessions.size(); }
+    const MockServerStats &stats() const { return m_stats; }
+    QString statsSummary() const;
+
+signals:
+    void sessionOpened(const QString &sessionId);
+    void sessionClosed(const QString &sessionId);
+
+private slots:
+    void onNewConnection();
+    void onTextMessage(const QString &message);
+    void onBinaryMessage(const QByteArray &data);
+    void onSocketDisconnected();
+
+private:
+    struct Session {
+        QWebSocket *socket = nullptr;
+        QString sessionId;
+        bool helloDone = false;
+        bool listening = false;
+        int listenFrames = 0;
+        int frameDurationMs = 60;
+        int protocolVersion = 1;
+        quint32 txSequence = 0;         // 丢弃的帧也占用序号，便于客户端统计丢包
+        qint64 streamBaseMs = 0;        // 当前TTS流起点（相对会话时钟），用作帧时间戳基准
+        quint32 streamGeneration = 0;   // abort或新一轮TTS时递增，使旧的发送回调失效
+        QVector<qint64> frameDueMs;     // 当前TTS流每帧的计划发送时间
+        int nextFrame = 0;
+        QElapsedTimer streamClock;
+        int nextMcpId = 1;
+        QHash<int, qint64> pendingMcp;  // id -> 发送时刻
+        QElapsedTimer clock;
+    };
+
+    Session *sessionFor(QObject *sender) const;
+    void sendJson(Session *session, const QJsonObject &json);
+    void handleHello(Session *session, const QJsonObject &json);
+    void handleListen(Session *session, const QJsonObject &json);
+    void handleAbort(Session *session);
+    void handleMcp(Session *session, const QJsonObject &json);
+    void sendMcpRequest(Session *session, const QString &method, const QJsonObject &params);
+    void respond(Session *session, const QString &sttText);
+    void startTtsStream(Session *session);
+    void sendNextFrame(Session *session, quint32 generation);
+    void finishTtsStream(Session *session);
+
+    const QVector<QByteArray> &framesFor(int frameDurationMs);
+    QByteArray loadOrSynthesizePcm() const;
+
+    MockServerOptions m_options;
+    QWebSocketServer *m_server;
+    QHash<QWebSocket *, Session *> m_sessions;
+    QHash<int, QVector<QByteArray>> m_encodedFrames; // frame_duration -> 预编码Opus帧
+    QByteArray m_pcm;
+    QRandomGenerator m_random;
+    MockServerStats m_stats;
+};
+
+#endif // XIAOZHIMOCKSERVER_H
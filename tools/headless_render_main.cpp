@@ -0,0 +1,347 @@
+#include <GL/glew.h> // glew必须在其他GL头文件之前
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include "LAppDelegate.hpp"
+#include "LAppLive2DManager.hpp"
+#include "LAppPal.hpp"
+#include "ResourceLoader.hpp"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QTextStream>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+// EGL surfaceless 上下文：不需要窗口系统和显示器，Mesa 的 llvmpipe 也可以使用
+struct HeadlessContext {
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLContext context = EGL_NO_CONTEXT;
+
+    bool create()
+    {
+        auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (getPlatformDisplay) {
+            display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        }
+        if (display == EGL_NO_DISPLAY) {
+            display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        }
+        EGLint major = 0;
+        EGLint minor = 0;
+        if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+            fprintf(stderr, "eglInitialize failed: 0x%x\n", eglGetError());
+            return false;
+        }
+        if (!eglBindAPI(EGL_OPENGL_API)) {
+            fprintf(stderr, "Desktop OpenGL is not available through EGL\n");
+            return false;
+        }
+
+        // 只渲染到FBO，不需要和任何surface兼容的config
+        const EGLint configAttribs[] = {
+            EGL_SURFACE_TYPE, 0,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_NONE
+        };
+        EGLConfig config = nullptr;
+        EGLint configCount = 0;
+        if (!eglChooseConfig(display, configAttribs, &config, 1, &configCount) || configCount == 0) {
+            config = nullptr;   // EGL_KHR_no_config_context
+        }
+        context = eglCreateContext(display, config, EGL_NO_CONTEXT, nullptr);
+        if (context == EGL_NO_CONTEXT) {
+            fprintf(stderr, "eglCreateContext failed: 0x%x\n", eglGetError());
+            return false;
+        }
+        if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+            fprintf(stderr, "eglMakeCurrent without surface failed: 0x%x\n", eglGetError());
+            return false;
+        }
+        return true;
+    }
+
+    void destroy()
+    {
+        if (display == EGL_NO_DISPLAY) {
+            return;
+        }
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (context != EGL_NO_CONTEXT) {
+            eglDestroyContext(display, context);
+        }
+        eglTerminate(display);
+        display = EGL_NO_DISPLAY;
+        context = EGL_NO_CONTEXT;
+    }
+};
+
+// 代替窗口默认帧缓冲的渲染目标
+struct RenderTarget {
+    GLuint framebuffer = 0;
+    GLuint color = 0;
+    GLuint depth = 0;
+    int width = 0;
+    int height = 0;
+
+    bool create(int w, int h)
+    {
+        release();
+        width = w;
+        height = h;
+        glGenRenderbuffers(1, &color);
+        glBindRenderbuffer(GL_RENDERBUFFER, color);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, w, h);
+        glGenRenderbuffers(1, &depth);
+        glBindRenderbuffer(GL_RENDERBUFFER, depth);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, w, h);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth);
+        glViewport(0, 0, w, h);
+        return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    }
+
+    void release()
+    {
+        if (framebuffer != 0) {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glDeleteFramebuffers(1, &framebuffer);
+            glDeleteRenderbuffers(1, &color);
+            glDeleteRenderbuffers(1, &depth);
+        }
+        framebuffer = color = depth = 0;
+    }
+
+    bool savePng(const QString &path) const
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        QImage image(width, height, QImage::Format_RGBA8888);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, image.bits());
+        // GL的原点在左下角
+        return image.mirrored().save(path, "PNG");
+    }
+};
+
+struct FrameSample {
+    double updateMs;
+    double drawMs;
+    double frameMs;     // 含清屏和等待GPU完成（glFinish）
+};
+
+double percentile(std::vector<double> values, double p)
+{
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    const size_t index = std::min(values.size() - 1, static_cast<size_t>(p * (values.size() - 1) + 0.5));
+    return values[index];
+}
+
+double mean(const std::vector<double> &values)
+{
+    double sum = 0.0;
+    for (double v : values) {
+        sum += v;
+    }
+    return values.empty() ? 0.0 : sum / values.size();
+}
+
+} // namespace
+
+// 无头渲染基准：在EGL surfaceless上下文中按固定dt驱动 LAppLive2DManager::OnUpdate，
+// 统计每个模型每帧的更新/绘制耗时，可选输出PNG帧用于截图对比
+//   HeadlessRenderBench --frames 600 --fps 60
+//   HeadlessRenderBench --models Haru --frames 120 --output frames --png-interval 10
+// 没有GPU的构建机上用 Mesa 的 llvmpipe（EGL_PLATFORM=surfaceless LIBGL_ALWAYS_SOFTWARE=1）
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("HeadlessRenderBench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Live2D 无头渲染基准");
+    parser.addHelpOption();
+    QCommandLineOption framesOption("frames", "每个模型统计的帧数", "n", "300");
+    QCommandLineOption warmupOption("warmup", "统计前先跑的帧数", "n", "30");
+    QCommandLineOption fpsOption("fps", "模拟帧率，每帧时间固定为 1/fps 秒", "fps", "60");
+    QCommandLineOption sizeOption("size", "渲染尺寸，默认使用配置中各模型的窗口尺寸", "WxH");
+    QCommandLineOption modelsOption("models", "只渲染这些模型（逗号分隔），默认配置中的全部模型", "names");
+    QCommandLineOption outputOption("output", "PNG帧输出目录（<目录>/<模型>/frame_0000.png）", "dir");
+    QCommandLineOption intervalOption("png-interval", "每隔n帧输出一张PNG", "n", "1");
+    QCommandLineOption csvOption("csv", "逐帧耗时写入CSV文件", "file");
+    QCommandLineOption seedOption("seed", "随机动作和眨眼的随机种子", "n", "1");
+    QCommandLineOption simThreadOption("sim-thread", "和应用一样在模拟线程更新模型（画面晚一帧）。默认在每帧内同步更新");
+    parser.addOptions({framesOption, warmupOption, fpsOption, sizeOption, modelsOption,
+                       outputOption, intervalOption, csvOption, seedOption, simThreadOption});
+    parser.process(app);
+
+    const int frames = std::max(1, parser.value(framesOption).toInt());
+    const int warmup = std::max(0, parser.value(warmupOption).toInt());
+    const double fps = std::max(1.0, parser.value(fpsOption).toDouble());
+    const int pngInterval = std::max(1, parser.value(intervalOption).toInt());
+    const unsigned int seed = parser.value(seedOption).toUInt();
+    const QString outputDir = parser.value(outputOption);
+    int fixedWidth = 0;
+    int fixedHeight = 0;
+    if (parser.isSet(sizeOption)) {
+        const QStringList size = parser.value(sizeOption).split('x');
+        fixedWidth = size.value(0).toInt();
+        fixedHeight = size.value(1).toInt();
+        if (fixedWidth <= 0 || fixedHeight <= 0) {
+            fprintf(stderr, "Invalid --size %s\n", qPrintable(parser.value(sizeOption)));
+            return 1;
+        }
+    }
+
+    if (!resource_loader::get_instance().initialize()) {
+        fprintf(stderr, "Cannot load config/config.json\n");
+        return 1;
+    }
+    QVector<resource_loader::model> models;
+    const QStringList wanted = parser.value(modelsOption).split(',', Qt::SkipEmptyParts);
+    for (const auto &model : resource_loader::get_instance().get_model_list()) {
+        if (wanted.isEmpty() || wanted.contains(model.name)) {
+            models.push_back(model);
+        }
+    }
+    if (models.isEmpty()) {
+        fprintf(stderr, "No models to render\n");
+        return 1;
+    }
+
+    QFile csvFile;
+    QTextStream csv;
+    if (parser.isSet(csvOption)) {
+        csvFile.setFileName(parser.value(csvOption));
+        if (!csvFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            fprintf(stderr, "Cannot write %s\n", qPrintable(csvFile.fileName()));
+            return 1;
+        }
+        csv.setDevice(&csvFile);
+        csv << "model,frame,update_ms,draw_ms,frame_ms\n";
+    }
+
+    HeadlessContext context;
+    if (!context.create()) {
+        context.destroy();
+        return 1;
+    }
+    fprintf(stdout, "GL: %s / %s\n", reinterpret_cast<const char *>(glGetString(GL_RENDERER)),
+            reinterpret_cast<const char *>(glGetString(GL_VERSION)));
+
+    RenderTarget target;
+    const int firstWidth = fixedWidth > 0 ? fixedWidth : models.first().model_width;
+    const int firstHeight = fixedHeight > 0 ? fixedHeight : models.first().model_height;
+    if (!target.create(firstWidth, firstHeight)) {
+        fprintf(stderr, "Cannot create %dx%d framebuffer\n", firstWidth, firstHeight);
+        context.destroy();
+        return 1;
+    }
+
+    // 动画只由固定dt推进，同一参数的多次运行得到相同的帧
+    LAppPal::SetFixedDeltaTime(1.0 / fps);
+    LAppDelegate *delegate = LAppDelegate::GetInstance();
+    if (!delegate->InitializeOffscreen(firstWidth, firstHeight)) {
+        target.release();
+        context.destroy();
+        return 1;
+    }
+    LAppLive2DManager *manager = LAppLive2DManager::GetInstance();
+    const bool simThread = parser.isSet(simThreadOption);
+    manager->SetSimulationThreaded(simThread);
+
+    fprintf(stdout, "frames=%d warmup=%d dt=%.4f s\n", frames, warmup, 1.0 / fps);
+    fprintf(stdout, "%-12s %9s %9s %9s %9s %9s %9s %9s\n", "model", "size",
+            "upd_avg", "upd_p95", "draw_avg", "draw_p95", "frame_avg", "frame_p95");
+
+    int failures = 0;
+    for (const auto &model : std::as_const(models)) {
+        const int width = fixedWidth > 0 ? fixedWidth : model.model_width;
+        const int height = fixedHeight > 0 ? fixedHeight : model.model_height;
+        if (width != target.width || height != target.height) {
+            if (!target.create(width, height)) {
+                fprintf(stderr, "Cannot create %dx%d framebuffer for %s\n", width, height, qPrintable(model.name));
+                failures++;
+                continue;
+            }
+            delegate->resize(width, height);
+        }
+
+        srand(seed);
+        if (!manager->ChangeScene(model.name)) {
+            fprintf(stderr, "Failed to load %s\n", qPrintable(model.name));
+            failures++;
+            continue;
+        }
+
+        QDir frameDir;
+        if (!outputDir.isEmpty()) {
+            frameDir.setPath(QDir(outputDir).filePath(model.name));
+            frameDir.mkpath(".");
+        }
+
+        std::vector<FrameSample> samples;
+        samples.reserve(frames);
+        for (int frame = -warmup; frame < frames; frame++) {
+            QElapsedTimer timer;
+            timer.start();
+            delegate->update();
+            glFinish();
+            const double frameMs = timer.nsecsElapsed() / 1e6;
+            if (frame < 0) {
+                continue;
+            }
+
+            samples.push_back({manager->GetLastUpdateNs() / 1e6, manager->GetLastDrawNs() / 1e6, frameMs});
+            if (csv.device()) {
+                csv << model.name << ',' << frame << ',' << samples.back().updateMs << ','
+                    << samples.back().drawMs << ',' << frameMs << '\n';
+            }
+            if (!outputDir.isEmpty() && frame % pngInterval == 0) {
+                const QString path = frameDir.filePath(QString("frame_%1.png").arg(frame, 4, 10, QChar('0')));
+                if (!target.savePng(path)) {
+                    fprintf(stderr, "Cannot write %s\n", qPrintable(path));
+                    failures++;
+                    break;
+                }
+            }
+        }
+
+        std::vector<double> updateMs;
+        std::vector<double> drawMs;
+        std::vector<double> frameMs;
+        for (const FrameSample &sample : samples) {
+            updateMs.push_back(sample.updateMs);
+            drawMs.push_back(sample.drawMs);
+            frameMs.push_back(sample.frameMs);
+        }
+        fprintf(stdout, "%-12s %9s %9.3f %9.3f %9.3f %9.3f %9.3f %9.3f\n", qPrintable(model.name.left(12)),
+                qPrintable(QString("%1x%2").arg(width).arg(height)),
+                mean(updateMs), percentile(updateMs, 0.95), mean(drawMs), percentile(drawMs, 0.95),
+                mean(frameMs), percentile(frameMs, 0.95));
+    }
+    if (simThread) {
+        fprintf(stdout, "(ms; update runs on the simulation thread, frame = latch + draw + clear + glFinish)\n");
+    } else {
+        fprintf(stdout, "(ms; frame = update + draw + clear + glFinish)\n");
+    }
+
+    // 模型和贴图要在上下文有效时释放
+    delegate->Release();
+    LAppDelegate::ReleaseInstance();
+    target.release();
+    context.destroy();
+    return failures == 0 ? 0 : 1;
+}
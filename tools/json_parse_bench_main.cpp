@@ -0,0 +1,350 @@
+#include "LAppAllocator.hpp"
+#include <CubismCdiJson.hpp>
+#include <CubismFramework.hpp>
+#include <CubismModelSettingJson.hpp>
+#include <Effect/CubismPose.hpp>
+#include <Model/CubismModelUserData.hpp>
+#include <Motion/CubismExpressionMotion.hpp>
+#include <Motion/CubismMotion.hpp>
+#include <Physics/CubismPhysics.hpp>
+#include <Utils/CubismJson.hpp>
+#include <Utils/CubismJsonTape.hpp>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Csm;
+
+namespace {
+
+struct JsonFile {
+    QString path;
+    std::vector<csmByte> bytes;
+};
+
+void printCubismMessage(const char *message)
+{
+    fprintf(stderr, "%s", message);
+}
+
+std::vector<JsonFile> collectJsonFiles(const QString &root)
+{
+    std::vector<JsonFile> files;
+    QDirIterator it(root, QStringList() << "*.json", QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        QFile file(it.next());
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        const QByteArray data = file.readAll();
+        JsonFile entry;
+        entry.path = file.fileName();
+        entry.bytes.assign(data.constData(), data.constData() + data.size());
+        files.push_back(entry);
+    }
+    return files;
+}
+
+bool sameFloat(csmFloat32 a, csmFloat32 b)
+{
+    return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+// 新旧解析结果逐节点比较：类型、字符串内容、数值的二进制表示和容器结构都必须一致
+bool sameTree(Utils::Value &expected, const Utils::CubismJsonNode actual)
+{
+    if (expected.IsNull()) {
+        return actual.IsNull() && !actual.IsError();
+    }
+    if (expected.IsBool()) {
+        return actual.IsBool() && expected.ToBoolean() == actual.ToBoolean();
+    }
+    if (expected.IsFloat()) {
+        return actual.IsFloat() && sameFloat(expected.ToFloat(), actual.ToFloat());
+    }
+    if (expected.IsString()) {
+        return actual.IsString() && strcmp(expected.GetRawString(), actual.GetRawString()) == 0;
+    }
+    if (expected.IsArray()) {
+        if (!actual.IsArray() || expected.GetSize() != actual.GetSize()) {
+            return false;
+        }
+        for (csmInt32 i = 0; i < actual.GetSize(); i++) {
+            if (!sameTree(expected[i], actual[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (expected.IsMap()) {
+        if (!actual.IsMap() || static_cast<csmInt32>(expected.GetKeys().GetSize()) != actual.GetSize()) {
+            return false;
+        }
+        for (csmInt32 i = 0; i < actual.GetSize(); i++) {
+            if (!sameTree(expected[actual.GetKey(i)], actual.GetMember(i))) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+// 遍历全部节点并读取值，让越界读写在 ASan 下暴露出来
+csmInt32 walk(const Utils::CubismJsonNode node)
+{
+    csmInt32 count = 1;
+    if (node.IsArray()) {
+        for (csmInt32 i = 0; i < node.GetSize(); i++) {
+            count += walk(node[i]);
+        }
+    } else if (node.IsMap()) {
+        for (csmInt32 i = 0; i < node.GetSize(); i++) {
+            const csmChar *key = node.GetKey(i);
+            count += static_cast<csmInt32>(strlen(key) > 0) + walk(node.GetMember(i));
+            count += static_cast<csmInt32>(node[key].IsError());
+        }
+    } else if (node.IsString()) {
+        count += static_cast<csmInt32>(strlen(node.GetRawString()) == static_cast<size_t>(node.GetLength()));
+    } else if (node.IsFloat()) {
+        count += static_cast<csmInt32>(node.ToFloat() == node.ToFloat());
+    }
+    return count;
+}
+
+// 按原文件的后缀交给应用实际使用的加载入口，返回是否被接受。读取各个访问器，让越界访问在 ASan 下暴露出来
+bool loadAsModelFile(const QString &path, const std::vector<csmByte> &input)
+{
+    const csmByte *data = input.data();
+    const csmSizeInt size = static_cast<csmSizeInt>(input.size());
+
+    if (path.endsWith(".motion3.json")) {
+        CubismMotion *motion = CubismMotion::Create(data, size);
+        if (motion == NULL) {
+            return false;
+        }
+        // 缓存写出的二进制也要能原样读回
+        csmVector<csmByte> binary;
+        motion->SerializeBinary(binary);
+        ACubismMotion::Delete(CubismMotion::CreateFromBinary(binary.GetPtr(), binary.GetSize()));
+        ACubismMotion::Delete(motion);
+        return true;
+    }
+    if (path.endsWith(".exp3.json")) {
+        ACubismMotion::Delete(CubismExpressionMotion::Create(data, size));
+        return true;
+    }
+    if (path.endsWith(".pose3.json")) {
+        CubismPose::Delete(CubismPose::Create(data, size));
+        return true;
+    }
+    if (path.endsWith(".physics3.json")) {
+        CubismPhysics *physics = CubismPhysics::Create(data, size);
+        if (physics == NULL) {
+            return false;
+        }
+        CubismPhysics::Delete(physics);
+        return true;
+    }
+    if (path.endsWith(".userdata3.json")) {
+        // 读不出的用户数据按空数据处理，因此总是返回实例
+        CubismModelUserData::Delete(CubismModelUserData::Create(data, size));
+        return true;
+    }
+    if (path.endsWith(".cdi3.json")) {
+        CubismCdiJson cdi(data, size);
+        if (!cdi.IsValid()) {
+            return false;
+        }
+        csmSizeInt length = 0;
+        for (csmInt32 i = 0; i < cdi.GetParametersCount(); i++) {
+            length += strlen(cdi.GetParametersId(i)) + strlen(cdi.GetParametersGroupId(i)) + strlen(cdi.GetParametersName(i));
+        }
+        for (csmInt32 i = 0; i < cdi.GetParameterGroupsCount(); i++) {
+            length += strlen(cdi.GetParameterGroupsId(i)) + strlen(cdi.GetParameterGroupsGroupId(i)) + strlen(cdi.GetParameterGroupsName(i));
+        }
+        for (csmInt32 i = 0; i < cdi.GetPartsCount(); i++) {
+            length += strlen(cdi.GetPartsId(i)) + strlen(cdi.GetPartsName(i));
+        }
+        return length > 0;
+    }
+    if (path.endsWith(".model3.json")) {
+        // 与 LAppAssetLoader 一样，读不出 JSON 的设置文件在使用前就被丢弃
+        CubismModelSettingJson setting(data, size);
+        if (setting.GetJsonPointer() == NULL) {
+            return false;
+        }
+        csmSizeInt length = strlen(setting.GetModelFileName()) + strlen(setting.GetPhysicsFileName())
+                            + strlen(setting.GetPoseFileName()) + strlen(setting.GetDisplayInfoFileName())
+                            + strlen(setting.GetUserDataFile());
+        for (csmInt32 i = 0; i < setting.GetTextureCount(); i++) {
+            length += strlen(setting.GetTextureFileName(i));
+        }
+        for (csmInt32 i = 0; i < setting.GetExpressionCount(); i++) {
+            length += strlen(setting.GetExpressionName(i)) + strlen(setting.GetExpressionFileName(i));
+        }
+        for (csmInt32 g = 0; g < setting.GetMotionGroupCount(); g++) {
+            const csmChar *group = setting.GetMotionGroupName(g);
+            for (csmInt32 i = 0; i < setting.GetMotionCount(group); i++) {
+                length += strlen(setting.GetMotionFileName(group, i)) + strlen(setting.GetMotionSoundFileName(group, i));
+            }
+        }
+        for (csmInt32 i = 0; i < setting.GetHitAreasCount(); i++) {
+            length += strlen(setting.GetHitAreaName(i)) + (setting.GetHitAreaId(i) != NULL);
+        }
+        for (csmInt32 i = 0; i < setting.GetEyeBlinkParameterCount(); i++) {
+            length += setting.GetEyeBlinkParameterId(i) != NULL;
+        }
+        for (csmInt32 i = 0; i < setting.GetLipSyncParameterCount(); i++) {
+            length += setting.GetLipSyncParameterId(i) != NULL;
+        }
+        return length > 0;
+    }
+    return false;
+}
+
+// 变异：随机改写、删除、插入字节或截断，改写时偏向 JSON 的结构字符
+std::vector<csmByte> mutate(const std::vector<csmByte> &source, std::mt19937 &rng)
+{
+    static const char structural[] = "{}[]\",:\\-+.eE0123456789tfnu \n";
+    std::vector<csmByte> out = source;
+    const int mutations = 1 + static_cast<int>(rng() % 4);
+    for (int m = 0; m < mutations && !out.empty(); m++) {
+        const size_t position = rng() % out.size();
+        switch (rng() % 4) {
+        case 0:
+            out[position] = (rng() % 2) ? static_cast<csmByte>(structural[rng() % (sizeof(structural) - 1)])
+                                        : static_cast<csmByte>(rng() & 0xFF);
+            break;
+        case 1:
+            out.erase(out.begin() + position, out.begin() + std::min(out.size(), position + 1 + rng() % 16));
+            break;
+        case 2: {
+            const size_t count = 1 + rng() % 16;
+            for (size_t i = 0; i < count; i++) {
+                out.insert(out.begin() + position, static_cast<csmByte>(structural[rng() % (sizeof(structural) - 1)]));
+            }
+            break;
+        }
+        default:
+            out.resize(position);
+            break;
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+// JSON 解析基准：用旧的 CubismJson 和新的 CubismJsonTape 分别解析 models 下全部 .json，
+// 校验两者结果逐节点一致后报告吞吐量；--fuzz 对这些文件做随机变异，用 CubismJsonTape 解析并遍历结果，
+// 再按原文件后缀交给 CubismMotion::Create、CubismPhysics::Create 等实际加载入口，建议配合 -fsanitize=address,undefined 编译运行
+//   JsonParseBench --rounds 20 models
+//   JsonParseBench --fuzz 100000 --seed 1 models
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("JsonParseBench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Cubism JSON 解析基准与变异测试");
+    parser.addHelpOption();
+    QCommandLineOption roundsOption("rounds", "计时轮数，取最快一轮", "n", "20");
+    QCommandLineOption fuzzOption("fuzz", "变异测试次数，0 表示只跑基准", "n", "0");
+    QCommandLineOption seedOption("seed", "变异测试随机种子", "n", "1");
+    parser.addOption(roundsOption);
+    parser.addOption(fuzzOption);
+    parser.addOption(seedOption);
+    parser.addPositionalArgument("root", "搜索 .json 的目录", "[root]");
+    parser.process(app);
+
+    const int rounds = std::max(1, parser.value(roundsOption).toInt());
+    const int fuzzCount = std::max(0, parser.value(fuzzOption).toInt());
+    const QString root = parser.positionalArguments().value(0, "models");
+
+    const std::vector<JsonFile> files = collectJsonFiles(root);
+    if (files.empty()) {
+        fprintf(stderr, "No .json files under %s\n", qPrintable(root));
+        return 1;
+    }
+
+    LAppAllocator allocator;
+    CubismFramework::Option option;
+    option.LogFunction = printCubismMessage;
+    // 变异输入的语法错误会逐条告警，变异测试时只保留错误级别
+    option.LoggingLevel = fuzzCount > 0 ? CubismFramework::Option::LogLevel_Error
+                                        : CubismFramework::Option::LogLevel_Warning;
+    CubismFramework::StartUp(&allocator, &option);
+    CubismFramework::Initialize();
+
+    int result = 0;
+    if (fuzzCount > 0) {
+        std::mt19937 rng(static_cast<unsigned int>(parser.value(seedOption).toInt()));
+        int accepted = 0;
+        int loaded = 0;
+        long long nodes = 0;
+        for (int i = 0; i < fuzzCount; i++) {
+            const JsonFile &source = files[rng() % files.size()];
+            const std::vector<csmByte> input = mutate(source.bytes, rng);
+            Utils::CubismJsonTape *tape = Utils::CubismJsonTape::Create(input.data(), input.size());
+            if (tape != NULL) {
+                accepted++;
+                nodes += walk(tape->GetRoot());
+                Utils::CubismJsonTape::Delete(tape);
+            }
+            loaded += static_cast<int>(loadAsModelFile(source.path, input));
+        }
+        fprintf(stdout, "fuzz=%d accepted=%d rejected=%d walked=%lld loaded=%d\n",
+                fuzzCount, accepted, fuzzCount - accepted, nodes, loaded);
+    } else {
+        size_t totalBytes = 0;
+        for (const JsonFile &file : files) {
+            totalBytes += file.bytes.size();
+
+            Utils::CubismJson *json = Utils::CubismJson::Create(file.bytes.data(), file.bytes.size());
+            Utils::CubismJsonTape *tape = Utils::CubismJsonTape::Create(file.bytes.data(), file.bytes.size());
+            if (json == NULL || tape == NULL || !sameTree(json->GetRoot(), tape->GetRoot())) {
+                fprintf(stderr, "Mismatch: %s\n", qPrintable(file.path));
+                result = 1;
+            }
+            Utils::CubismJson::Delete(json);
+            Utils::CubismJsonTape::Delete(tape);
+        }
+
+        qint64 bestJson = -1;
+        qint64 bestTape = -1;
+        QElapsedTimer timer;
+        for (int r = 0; r < rounds; r++) {
+            timer.start();
+            for (const JsonFile &file : files) {
+                Utils::CubismJson::Delete(Utils::CubismJson::Create(file.bytes.data(), file.bytes.size()));
+            }
+            const qint64 jsonNs = timer.nsecsElapsed();
+            timer.restart();
+            for (const JsonFile &file : files) {
+                Utils::CubismJsonTape::Delete(Utils::CubismJsonTape::Create(file.bytes.data(), file.bytes.size()));
+            }
+            const qint64 tapeNs = timer.nsecsElapsed();
+            bestJson = (bestJson < 0) ? jsonNs : std::min(bestJson, jsonNs);
+            bestTape = (bestTape < 0) ? tapeNs : std::min(bestTape, tapeNs);
+        }
+
+        const double megabytes = totalBytes / (1024.0 * 1024.0);
+        fprintf(stdout, "files=%d bytes=%zu rounds=%d trees=%s\n",
+                static_cast<int>(files.size()), totalBytes, rounds, result == 0 ? "identical" : "MISMATCH");
+        fprintf(stdout, "CubismJson     %.3f ms  %.1f MB/s\n", bestJson / 1e6, megabytes / (bestJson / 1e9));
+        fprintf(stdout, "CubismJsonTape %.3f ms  %.1f MB/s\n", bestTape / 1e6, megabytes / (bestTape / 1e9));
+    }
+
+    CubismFramework::Dispose();
+    CubismFramework::CleanUp();
+    return result;
+}
@@ -0,0 +1,109 @@
+#include "XiaozhiLoadGenerator.h"
+#include "XiaozhiMockServer.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QJsonDocument>
+#include <QFile>
+#include <QScopedPointer>
+#include <QDebug>
+#include <cstdio>
+
+namespace {
+bool g_verbose = false;
+
+// WebSocketManager/OpusDecoder的调试日志非常多，压测时默认只保留警告以上
+void loadGeneratorMessageHandler(QtMsgType type, const QMessageLogContext &context, const QString &message)
+{
+    Q_UNUSED(context)
+    if (type == QtDebugMsg && !g_verbose) {
+        return;
+    }
+    fprintf(stderr, "%s\n", qPrintable(message));
+}
+}
+
+// 多客户端压测器
+// 示例: XiaozhiLoadGenerator --clients 50 --rounds 10 --embedded-server --loss 0.01
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("XiaozhiLoadGenerator");
+    app.setApplicationVersion("1.0.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("小智协议多客户端压测器");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption urlOption("url", "服务器地址", "url", "ws://127.0.0.1:8765/xiaozhi/v1/");
+    QCommandLineOption tokenOption("token", "访问令牌", "token", "test-token");
+    QCommandLineOption clientsOption("clients", "并发客户端数量", "n", "10");
+    QCommandLineOption roundsOption("rounds", "每个客户端的对话轮数", "n", "5");
+    QCommandLineOption rampOption("ramp-ms", "客户端启动间隔(ms)", "ms", "20");
+    QCommandLineOption intervalOption("interval-ms", "轮次间隔(ms)", "ms", "300");
+    QCommandLineOption timeoutOption("timeout-ms", "单轮超时(ms)", "ms", "30000");
+    QCommandLineOption noDecodeOption("no-decode", "不解码下行Opus");
+    QCommandLineOption protocolOption("protocol", "二进制帧版本(1/2/3)", "version", "1");
+    QCommandLineOption jsonOption("json", "把报告写入JSON文件", "file");
+    QCommandLineOption verboseOption("verbose", "输出调试日志");
+    QCommandLineOption embeddedOption("embedded-server", "在同一进程内启动模拟服务器（端口自动分配）");
+    QCommandLineOption pacingOption("pacing", "内置服务器下发节奏倍率", "factor", "1.0");
+    QCommandLineOption lossOption("loss", "内置服务器丢帧概率", "rate", "0");
+    QCommandLineOption jitterOption("jitter", "内置服务器最大抖动(ms)", "ms", "0");
+    parser.addOptions({urlOption, tokenOption, clientsOption, roundsOption, rampOption, intervalOption,
+                       timeoutOption, noDecodeOption, protocolOption, jsonOption, verboseOption, embeddedOption,
+                       pacingOption, lossOption, jitterOption});
+    parser.process(app);
+
+    g_verbose = parser.isSet(verboseOption);
+    qInstallMessageHandler(loadGeneratorMessageHandler);
+
+    LoadGeneratorOptions options;
+    options.url = parser.value(urlOption);
+    options.accessToken = parser.value(tokenOption);
+    options.clients = parser.value(clientsOption).toInt();
+    options.rounds = parser.value(roundsOption).toInt();
+    options.rampUpMs = parser.value(rampOption).toInt();
+    options.roundIntervalMs = parser.value(intervalOption).toInt();
+    options.roundTimeoutMs = parser.value(timeoutOption).toInt();
+    options.decode = !parser.isSet(noDecodeOption);
+    options.protocolVersion = parser.value(protocolOption).toInt();
+
+    // 内置服务器与客户端共用一个事件循环，结果包含服务端开销，适合做回归而非绝对性能基准
+    QScopedPointer<XiaozhiMockServer> server;
+    if (parser.isSet(embeddedOption)) {
+        MockServerOptions serverOptions;
+        serverOptions.port = 0;
+        serverOptions.pacing = parser.value(pacingOption).toDouble();
+        serverOptions.lossRate = parser.value(lossOption).toDouble();
+        serverOptions.jitterMs = parser.value(jitterOption).toInt();
+        server.reset(new XiaozhiMockServer(serverOptions));
+        if (!server->start()) {
+            return 1;
+        }
+        options.url = QString("ws://127.0.0.1:%1/xiaozhi/v1/").arg(server->serverPort());
+    }
+
+    XiaozhiLoadGenerator generator(options);
+    QObject::connect(&generator, &XiaozhiLoadGenerator::finished, &app, [&]() {
+        fprintf(stdout, "%s", qPrintable(generator.report()));
+        if (server) {
+            fprintf(stdout, "server: %s\n", qPrintable(server->statsSummary()));
+        }
+        fflush(stdout);
+
+        const QString jsonPath = parser.value(jsonOption);
+        if (!jsonPath.isEmpty()) {
+            QFile file(jsonPath);
+            if (file.open(QIODevice::WriteOnly)) {
+                file.write(QJsonDocument(generator.reportJson()).toJson());
+            } else {
+                qWarning() << "Cannot write report to" << jsonPath;
+            }
+        }
+        app.quit();
+    });
+    generator.start();
+
+    return app.exec();
+}
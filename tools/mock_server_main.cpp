@@ -0,0 +1,69 @@
+#include "XiaozhiMockServer.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTimer>
+#include <QDebug>
+
+// 本地小智协议模拟服务器
+// 示例: XiaozhiMockServer --port 8765 --loss 0.02 --jitter 30
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("XiaozhiMockServer");
+    app.setApplicationVersion("1.0.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("小智协议本地模拟服务器（用于压测和回归）");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption portOption("port", "监听端口", "port", "8765");
+    QCommandLineOption tokenOption("token", "要求的访问令牌（为空不校验）", "token");
+    QCommandLineOption frameOption("frame-ms", "TTS帧长(10/20/40/60)，0表示沿用客户端hello", "ms", "0");
+    QCommandLineOption protocolOption("protocol", "二进制帧版本(1/2/3)，0表示沿用客户端Protocol-Version", "version", "0");
+    QCommandLineOption pacingOption("pacing", "下发节奏倍率，1为实时，0为尽快发送", "factor", "1.0");
+    QCommandLineOption lossOption("loss", "下行音频帧丢弃概率(0-1)", "rate", "0");
+    QCommandLineOption jitterOption("jitter", "每帧最大随机延迟(ms)", "ms", "0");
+    QCommandLineOption durationOption("tts-ms", "合成TTS音频时长(ms)", "ms", "2000");
+    QCommandLineOption pcmOption("tts-pcm", "使用16-bit单声道24kHz PCM文件作为TTS音频", "file");
+    QCommandLineOption delayOption("think-ms", "stt到tts之间的模拟思考时间(ms)", "ms", "200");
+    QCommandLineOption emotionOption("emotion", "llm消息中的情绪", "emotion", "happy");
+    QCommandLineOption noMcpOption("no-mcp", "不主动发起MCP initialize/tools/list");
+    QCommandLineOption seedOption("seed", "随机种子（复现丢包/抖动）", "seed", "0");
+    QCommandLineOption statsOption("stats-interval", "统计输出间隔(秒)，0关闭", "seconds", "5");
+    parser.addOptions({portOption, tokenOption, frameOption, protocolOption, pacingOption, lossOption, jitterOption,
+                       durationOption, pcmOption, delayOption, emotionOption, noMcpOption, seedOption,
+                       statsOption});
+    parser.process(app);
+
+    MockServerOptions options;
+    options.port = static_cast<quint16>(parser.value(portOption).toUInt());
+    options.expectedToken = parser.value(tokenOption);
+    options.frameDurationMs = parser.value(frameOption).toInt();
+    options.protocolVersion = parser.value(protocolOption).toInt();
+    options.pacing = parser.value(pacingOption).toDouble();
+    options.lossRate = parser.value(lossOption).toDouble();
+    options.jitterMs = parser.value(jitterOption).toInt();
+    options.ttsDurationMs = parser.value(durationOption).toInt();
+    options.ttsPcmFile = parser.value(pcmOption);
+    options.responseDelayMs = parser.value(delayOption).toInt();
+    options.emotion = parser.value(emotionOption);
+    options.sendMcpInitialize = !parser.isSet(noMcpOption);
+    options.seed = parser.value(seedOption).toUInt();
+
+    XiaozhiMockServer server(options);
+    if (!server.start()) {
+        return 1;
+    }
+
+    const int statsInterval = parser.value(statsOption).toInt();
+    QTimer statsTimer;
+    if (statsInterval > 0) {
+        QObject::connect(&statsTimer, &QTimer::timeout, [&server]() {
+            qInfo().noquote() << server.statsSummary();
+        });
+        statsTimer.start(statsInterval * 1000);
+    }
+
+    return app.exec();
+}
@@ -0,0 +1,303 @@
+#include "LAppModelBundle.hpp"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDebug>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#define STBI_NO_STDIO
+#define STBI_ONLY_PNG
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+namespace {
+
+struct PackOptions {
+    bool compress = false;          // File段用zlib压缩
+    bool compressTextures = false;  // Texture段用zlib压缩（体积小但加载时要解压）
+    bool premultiply = false;       // 与编译时的 PREMULTIPLIED_ALPHA_ENABLE 一致
+    bool keepPng = false;           // 同时保留原始PNG，alpha模式不匹配时可回退解码
+    bool mips = true;
+};
+
+struct PendingEntry {
+    LAppModelBundle::Entry entry;
+    QByteArray path;
+    QByteArray data;    // 已按codec编码的内容
+};
+
+// 与 LAppTextureManager::Premultiply 相同的计算
+void premultiply(unsigned char *pixels, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        unsigned char *p = pixels + i * 4;
+        const unsigned alpha = p[3];
+        p[0] = static_cast<unsigned char>(p[0] * (alpha + 1) >> 8);
+        p[1] = static_cast<unsigned char>(p[1] * (alpha + 1) >> 8);
+        p[2] = static_cast<unsigned char>(p[2] * (alpha + 1) >> 8);
+    }
+}
+
+// 2x2盒式滤波逐级缩小到1x1，各级连续存放
+QByteArray buildMipChain(const unsigned char *pixels, int width, int height, bool mips, uint32_t *levels)
+{
+    QByteArray chain(reinterpret_cast<const char *>(pixels), width * height * 4);
+    *levels = 1;
+    int w = width;
+    int h = height;
+    qsizetype levelOffset = 0;
+    while (mips && (w > 1 || h > 1)) {
+        const int nw = std::max(1, w / 2);
+        const int nh = std::max(1, h / 2);
+        QByteArray next(nw * nh * 4, Qt::Uninitialized);
+        const unsigned char *src = reinterpret_cast<const unsigned char *>(chain.constData()) + levelOffset;
+        unsigned char *dst = reinterpret_cast<unsigned char *>(next.data());
+        for (int y = 0; y < nh; y++) {
+            const int y0 = std::min(y * 2, h - 1);
+            const int y1 = std::min(y * 2 + 1, h - 1);
+            for (int x = 0; x < nw; x++) {
+                const int x0 = std::min(x * 2, w - 1);
+                const int x1 = std::min(x * 2 + 1, w - 1);
+                for (int c = 0; c < 4; c++) {
+                    const int sum = src[(y0 * w + x0) * 4 + c] + src[(y0 * w + x1) * 4 + c]
+                                    + src[(y1 * w + x0) * 4 + c] + src[(y1 * w + x1) * 4 + c];
+                    dst[(y * nw + x) * 4 + c] = static_cast<unsigned char>((sum + 2) / 4);
+                }
+            }
+        }
+        levelOffset = chain.size();
+        chain.append(next);
+        w = nw;
+        h = nh;
+        (*levels)++;
+    }
+    return chain;
+}
+
+PendingEntry makeEntry(const QString &path, LAppModelBundle::EntryType type, const QByteArray &raw, bool compress)
+{
+    PendingEntry pending;
+    memset(&pending.entry, 0, sizeof(pending.entry));
+    pending.entry.type = static_cast<uint16_t>(type);
+    pending.entry.rawSize = static_cast<uint64_t>(raw.size());
+    pending.path = path.toUtf8();
+    pending.data = raw;
+    pending.entry.codec = LAppModelBundle::Codec_None;
+    if (compress) {
+        // 压缩后不变小的段按原样存放，加载时可以直接映射
+        const QByteArray packed = qCompress(raw, 9);
+        if (packed.size() < raw.size()) {
+            pending.data = packed;
+            pending.entry.codec = LAppModelBundle::Codec_Zlib;
+        }
+    }
+    pending.entry.storedSize = static_cast<uint64_t>(pending.data.size());
+    return pending;
+}
+
+bool collectEntries(const QString &modelDir, const QString &bundlePath, const PackOptions &options, std::vector<PendingEntry> *entries)
+{
+    const QDir root(modelDir);
+    QStringList files;
+    QDirIterator it(modelDir, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString file = it.next();
+        if (QFileInfo(file).absoluteFilePath() != QFileInfo(bundlePath).absoluteFilePath() && !file.endsWith(".bundle")) {
+            files << root.relativeFilePath(file);
+        }
+    }
+    files.sort();
+
+    for (const QString &relative : std::as_const(files)) {
+        QFile file(root.filePath(relative));
+        if (!file.open(QIODevice::ReadOnly)) {
+            fprintf(stderr, "Cannot read %s\n", qPrintable(file.fileName()));
+            return false;
+        }
+        const QByteArray content = file.readAll();
+
+        if (!relative.endsWith(".png", Qt::CaseInsensitive)) {
+            entries->push_back(makeEntry(relative, LAppModelBundle::EntryType_File, content, options.compress));
+            continue;
+        }
+
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+        unsigned char *pixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc *>(content.constData()),
+                                                      static_cast<int>(content.size()), &width, &height, &channels, STBI_rgb_alpha);
+        if (pixels == nullptr) {
+            fprintf(stderr, "Cannot decode %s, storing as file\n", qPrintable(relative));
+            entries->push_back(makeEntry(relative, LAppModelBundle::EntryType_File, content, options.compress));
+            continue;
+        }
+        if (options.premultiply) {
+            premultiply(pixels, static_cast<size_t>(width) * height);
+        }
+        uint32_t levels = 1;
+        const QByteArray chain = buildMipChain(pixels, width, height, options.mips, &levels);
+        stbi_image_free(pixels);
+
+        PendingEntry texture = makeEntry(relative, LAppModelBundle::EntryType_Texture, chain, options.compressTextures);
+        texture.entry.width = static_cast<uint32_t>(width);
+        texture.entry.height = static_cast<uint32_t>(height);
+        texture.entry.mipLevels = levels;
+        texture.entry.flags = options.premultiply ? LAppModelBundle::TextureFlag_Premultiplied : 0;
+        entries->push_back(texture);
+        if (options.keepPng) {
+            // PNG本身已压缩，不再压缩
+            entries->push_back(makeEntry(relative, LAppModelBundle::EntryType_File, content, false));
+        }
+    }
+    return true;
+}
+
+uint64_t alignUp(uint64_t value)
+{
+    const uint64_t alignment = LAppModelBundle::SectionAlignment;
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+bool writeBundle(const QString &bundlePath, std::vector<PendingEntry> &entries)
+{
+    QByteArray strings;
+    for (PendingEntry &pending : entries) {
+        pending.entry.pathOffset = static_cast<uint32_t>(strings.size());
+        pending.entry.pathLength = static_cast<uint32_t>(pending.path.size());
+        strings.append(pending.path);
+    }
+
+    LAppModelBundle::Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LAppModelBundle::Magic, sizeof(header.magic));
+    header.version = LAppModelBundle::Version;
+    header.entryCount = static_cast<uint32_t>(entries.size());
+    header.indexOffset = sizeof(LAppModelBundle::Header);
+    header.stringsOffset = header.indexOffset + entries.size() * sizeof(LAppModelBundle::Entry);
+    header.stringsSize = static_cast<uint64_t>(strings.size());
+
+    uint64_t offset = alignUp(header.stringsOffset + header.stringsSize);
+    for (PendingEntry &pending : entries) {
+        pending.entry.offset = offset;
+        offset = alignUp(offset + pending.entry.storedSize);
+    }
+
+    QByteArray out;
+    out.reserve(static_cast<qsizetype>(offset));
+    out.append(reinterpret_cast<const char *>(&header), sizeof(header));
+    for (const PendingEntry &pending : entries) {
+        out.append(reinterpret_cast<const char *>(&pending.entry), sizeof(pending.entry));
+    }
+    out.append(strings);
+    for (const PendingEntry &pending : entries) {
+        out.append(QByteArray(static_cast<qsizetype>(pending.entry.offset) - out.size(), '\0'));
+        out.append(pending.data);
+    }
+
+    QSaveFile file(bundlePath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(out) != out.size() || !file.commit()) {
+        fprintf(stderr, "Cannot write %s\n", qPrintable(bundlePath));
+        return false;
+    }
+    return true;
+}
+
+// 写完后用应用中的读取代码重新打开，逐段比对
+bool verifyBundle(const QString &bundlePath, const std::vector<PendingEntry> &entries)
+{
+    const std::shared_ptr<LAppModelBundle> bundle = LAppModelBundle::Open(bundlePath.toUtf8().toStdString());
+    if (!bundle || bundle->GetEntryCount() != entries.size()) {
+        return false;
+    }
+    for (const PendingEntry &pending : entries) {
+        const LAppModelBundle::Entry *entry = bundle->Find(pending.path.toStdString(),
+                                                           static_cast<LAppModelBundle::EntryType>(pending.entry.type));
+        const std::shared_ptr<LAppFileView> section = entry ? bundle->ReadSection(*entry) : nullptr;
+        if (!section || section->GetSize() != pending.entry.rawSize) {
+            return false;
+        }
+        const QByteArray raw = pending.entry.codec == LAppModelBundle::Codec_Zlib ? qUncompress(pending.data) : pending.data;
+        if (memcmp(section->GetData(), raw.constData(), raw.size()) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+// 模型打包工具：把模型目录打包成单个 <模型名>.bundle，放在 model3.json 旁边即可被优先加载
+// 示例: ModelBundlePacker ../models/live2d/Haru --compress
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("ModelBundlePacker");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Live2D 模型打包工具");
+    parser.addHelpOption();
+    QCommandLineOption outputOption({"o", "output"}, "输出文件（默认 <模型目录>/<模型名>.bundle）", "file");
+    QCommandLineOption compressOption("compress", "用zlib压缩JSON/moc3/动作等文件段");
+    QCommandLineOption compressTexturesOption("compress-textures", "用zlib压缩贴图段（加载时需要解压）");
+    QCommandLineOption premultiplyOption("premultiply", "贴图预乘alpha（对应 PREMULTIPLIED_ALPHA_ENABLE 构建）");
+    QCommandLineOption keepPngOption("keep-png", "同时保留原始PNG");
+    QCommandLineOption noMipsOption("no-mips", "不预生成mipmap");
+    parser.addOptions({outputOption, compressOption, compressTexturesOption, premultiplyOption, keepPngOption, noMipsOption});
+    parser.addPositionalArgument("model-dir", "包含 *.model3.json 的模型目录");
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 1) {
+        parser.showHelp(1);
+    }
+    const QString modelDir = args.first();
+    const QStringList settings = QDir(modelDir).entryList({"*.model3.json"}, QDir::Files);
+    if (settings.size() != 1) {
+        fprintf(stderr, "Expected exactly one *.model3.json in %s\n", qPrintable(modelDir));
+        return 1;
+    }
+
+    PackOptions options;
+    options.compress = parser.isSet(compressOption);
+    options.compressTextures = parser.isSet(compressTexturesOption);
+    options.premultiply = parser.isSet(premultiplyOption);
+    options.keepPng = parser.isSet(keepPngOption);
+    options.mips = !parser.isSet(noMipsOption);
+
+    const QString bundlePath = parser.isSet(outputOption)
+                                   ? parser.value(outputOption)
+                                   : QString::fromStdString(LAppModelBundle::GetBundlePath(
+                                         QDir(modelDir).absolutePath().toUtf8().toStdString() + "/", settings.first().toUtf8().toStdString()));
+
+    std::vector<PendingEntry> entries;
+    if (!collectEntries(modelDir, bundlePath, options, &entries) || !writeBundle(bundlePath, entries)) {
+        return 1;
+    }
+    if (!verifyBundle(bundlePath, entries)) {
+        fprintf(stderr, "Verification of %s failed\n", qPrintable(bundlePath));
+        return 1;
+    }
+
+    uint64_t raw = 0;
+    uint64_t stored = 0;
+    for (const PendingEntry &pending : entries) {
+        fprintf(stdout, "%-8s %-5s %10llu %10llu  %s\n",
+                pending.entry.type == LAppModelBundle::EntryType_Texture ? "texture" : "file",
+                pending.entry.codec == LAppModelBundle::Codec_Zlib ? "zlib" : "raw",
+                static_cast<unsigned long long>(pending.entry.rawSize),
+                static_cast<unsigned long long>(pending.entry.storedSize), pending.path.constData());
+        raw += pending.entry.rawSize;
+        stored += pending.entry.storedSize;
+    }
+    fprintf(stdout, "%d entries, %llu bytes raw, %llu bytes stored -> %s (%lld bytes)\n",
+            static_cast<int>(entries.size()), static_cast<unsigned long long>(raw), static_cast<unsigned long long>(stored),
+            qPrintable(bundlePath), static_cast<long long>(QFileInfo(bundlePath).size()));
+    return 0;
+}
@@ -0,0 +1,161 @@
+#include "LAppFileView.hpp"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QDebug>
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_MACOS)
+#include <mach/mach.h>
+#elif defined(Q_OS_LINUX)
+#include <QFile>
+#include <unistd.h>
+#endif
+
+namespace {
+
+struct MemorySample {
+    qint64 rss = 0;
+    qint64 privateBytes = 0;    // 不含文件映射等可随时丢弃的共享页，仅Linux可区分
+};
+
+MemorySample sampleMemory()
+{
+    MemorySample sample;
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS_EX counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS *>(&counters), sizeof(counters))) {
+        sample.rss = static_cast<qint64>(counters.WorkingSetSize);
+        sample.privateBytes = static_cast<qint64>(counters.PrivateUsage);
+    }
+#elif defined(Q_OS_MACOS)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS) {
+        sample.rss = static_cast<qint64>(info.resident_size);
+        sample.privateBytes = sample.rss;
+    }
+#elif defined(Q_OS_LINUX)
+    QFile statm("/proc/self/statm");
+    if (statm.open(QIODevice::ReadOnly)) {
+        const QList<QByteArray> fields = statm.readAll().split(' ');
+        if (fields.size() >= 3) {
+            const qint64 page = sysconf(_SC_PAGESIZE);
+            sample.rss = fields[1].toLongLong() * page;
+            sample.privateBytes = (fields[1].toLongLong() - fields[2].toLongLong()) * page;
+        }
+    }
+#endif
+    return sample;
+}
+
+// 模拟解析：逐页读取内容，让映射的页真正被换入
+quint64 touch(const LAppFileView &view)
+{
+    quint64 sum = 0;
+    const Csm::csmByte *data = view.GetData();
+    for (Csm::csmSizeInt i = 0; i < view.GetSize(); i += 4096) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+} // namespace
+
+// 模型文件加载基准：比较内存映射与整块读取的加载耗时和内存峰值
+// 两种模式请分别运行（RSS峰值按进程统计）:
+//   ModelLoadBench --mode map  --iterations 20 models/live2d
+//   ModelLoadBench --mode read --iterations 20 models/live2d
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("ModelLoadBench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Live2D 模型文件加载基准");
+    parser.addHelpOption();
+    QCommandLineOption modeOption("mode", "map（内存映射，默认）或 read（整块读取）", "mode", "map");
+    QCommandLineOption iterationsOption("iterations", "每个模型加载次数", "n", "10");
+    parser.addOptions({modeOption, iterationsOption});
+    parser.addPositionalArgument("root", "模型根目录（其下每个子目录为一个模型）", "[root]");
+    parser.process(app);
+
+    const bool mapping = parser.value(modeOption) != "read";
+    const int iterations = std::max(1, parser.value(iterationsOption).toInt());
+    const QString root = parser.positionalArguments().value(0, "models/live2d");
+    LAppFileView::SetMappingEnabled(mapping);
+
+    QStringList modelDirs;
+    QDirIterator dirs(root, QDir::Dirs | QDir::NoDotAndDotDot);
+    while (dirs.hasNext()) {
+        modelDirs << dirs.next();
+    }
+    modelDirs.sort();
+    if (modelDirs.isEmpty()) {
+        fprintf(stderr, "No model directories under %s\n", qPrintable(root));
+        return 1;
+    }
+
+    const MemorySample baseline = sampleMemory();
+    MemorySample peak = baseline;
+    quint64 checksum = 0;
+    fprintf(stdout, "mode=%s iterations=%d\n", mapping ? "map" : "read", iterations);
+    fprintf(stdout, "%-24s %6s %10s %10s %10s %8s\n", "model", "files", "bytes", "avg_ms", "min_ms", "mapped");
+
+    for (const QString &modelDir : std::as_const(modelDirs)) {
+        QStringList files;
+        QDirIterator it(modelDir, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            files << it.next();
+        }
+
+        qint64 bytes = 0;
+        int mappedCount = 0;
+        double totalMs = 0.0;
+        double minMs = 1e9;
+        for (int i = 0; i < iterations; i++) {
+            QElapsedTimer timer;
+            timer.start();
+            // 与 LAppAssetLoader 一致：模型的全部文件同时保持打开，直到模型构建完成
+            std::vector<std::shared_ptr<LAppFileView>> views;
+            views.reserve(files.size());
+            for (const QString &path : std::as_const(files)) {
+                std::shared_ptr<LAppFileView> view = LAppFileView::Open(path.toUtf8().toStdString());
+                if (view) {
+                    checksum += touch(*view);
+                    views.push_back(view);
+                }
+            }
+            const double ms = timer.nsecsElapsed() / 1e6;
+            totalMs += ms;
+            minMs = std::min(minMs, ms);
+
+            const MemorySample sample = sampleMemory();
+            peak.rss = std::max(peak.rss, sample.rss);
+            peak.privateBytes = std::max(peak.privateBytes, sample.privateBytes);
+            if (i == 0) {
+                for (const auto &view : views) {
+                    bytes += view->GetSize();
+                    mappedCount += view->IsMapped() ? 1 : 0;
+                }
+            }
+        }
+        fprintf(stdout, "%-24s %6d %10lld %10.2f %10.2f %8d\n", qPrintable(QFileInfo(modelDir).fileName()),
+                static_cast<int>(files.size()), static_cast<long long>(bytes), totalMs / iterations, minMs, mappedCount);
+    }
+
+    fprintf(stdout, "rss: baseline %.0f KiB, peak %.0f KiB (+%.0f KiB)\n",
+            baseline.rss / 1024.0, peak.rss / 1024.0, (peak.rss - baseline.rss) / 1024.0);
+    fprintf(stdout, "private: baseline %.0f KiB, peak %.0f KiB (+%.0f KiB)\n",
+            baseline.privateBytes / 1024.0, peak.privateBytes / 1024.0, (peak.privateBytes - baseline.privateBytes) / 1024.0);
+    fprintf(stdout, "checksum %llu\n", static_cast<unsigned long long>(checksum));
+    return 0;
+}
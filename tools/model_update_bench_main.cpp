@@ -0,0 +1,291 @@
+#include "LAppAllocator.hpp"
+#include "LAppFileView.hpp"
+#include <CubismFramework.hpp>
+#include <CubismModelSettingJson.hpp>
+#include <Effect/CubismBreath.hpp>
+#include <Effect/CubismEyeBlink.hpp>
+#include <Effect/CubismPose.hpp>
+#include <Id/CubismIdManager.hpp>
+#include <Model/CubismMoc.hpp>
+#include <Model/CubismModel.hpp>
+#include <Motion/CubismExpressionMotion.hpp>
+#include <Motion/CubismMotion.hpp>
+#include <Motion/CubismMotionManager.hpp>
+#include <Physics/CubismPhysics.hpp>
+#include <CubismDefaultParameterId.hpp>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+using namespace Csm;
+using namespace Live2D::Cubism::Framework::DefaultParameterId;
+
+namespace {
+
+void printCubismMessage(const char *message)
+{
+    fprintf(stderr, "%s", message);
+}
+
+std::shared_ptr<LAppFileView> openFile(const QDir &dir, const csmChar *name)
+{
+    if (name == NULL || name[0] == '\0') {
+        return nullptr;
+    }
+    return LAppFileView::Open(dir.filePath(QString::fromUtf8(name)).toUtf8().toStdString());
+}
+
+// 与 LAppModel 持有的对象相同，但不创建渲染器和纹理
+struct BenchModel {
+    CubismModelSettingJson *setting = nullptr;
+    CubismMoc *moc = nullptr;
+    CubismModel *model = nullptr;
+    CubismMotionManager motionManager;
+    CubismMotionManager expressionManager;
+    std::vector<CubismMotion *> motions;
+    std::vector<ACubismMotion *> expressions;
+    CubismPhysics *physics = nullptr;
+    CubismPose *pose = nullptr;
+    CubismEyeBlink *eyeBlink = nullptr;
+    CubismBreath *breath = nullptr;
+    csmVector<CubismIdHandle> lipSyncIds;
+    CubismIdHandle dragIds[6] = {};
+
+    ~BenchModel()
+    {
+        for (CubismMotion *motion : motions) {
+            ACubismMotion::Delete(motion);
+        }
+        for (ACubismMotion *expression : expressions) {
+            ACubismMotion::Delete(expression);
+        }
+        if (physics) CubismPhysics::Delete(physics);
+        if (pose) CubismPose::Delete(pose);
+        if (eyeBlink) CubismEyeBlink::Delete(eyeBlink);
+        if (breath) CubismBreath::Delete(breath);
+        if (model) moc->DeleteModel(model);
+        if (moc) CubismMoc::Delete(moc);
+        delete setting;
+    }
+};
+
+bool loadModel(const QString &model3Path, BenchModel &bench)
+{
+    const QDir dir = QFileInfo(model3Path).absoluteDir();
+    std::shared_ptr<LAppFileView> settingFile = LAppFileView::Open(model3Path.toUtf8().toStdString());
+    if (!settingFile) {
+        return false;
+    }
+    bench.setting = new CubismModelSettingJson(settingFile->GetData(), settingFile->GetSize());
+
+    std::shared_ptr<LAppFileView> mocFile = openFile(dir, bench.setting->GetModelFileName());
+    if (!mocFile) {
+        return false;
+    }
+    bench.moc = CubismMoc::Create(mocFile->GetData(), mocFile->GetSize());
+    if (!bench.moc) {
+        return false;
+    }
+    bench.model = bench.moc->CreateModel();
+
+    if (std::shared_ptr<LAppFileView> file = openFile(dir, bench.setting->GetPhysicsFileName())) {
+        bench.physics = CubismPhysics::Create(file->GetData(), file->GetSize());
+    }
+    if (std::shared_ptr<LAppFileView> file = openFile(dir, bench.setting->GetPoseFileName())) {
+        bench.pose = CubismPose::Create(file->GetData(), file->GetSize());
+    }
+    if (bench.setting->GetEyeBlinkParameterCount() > 0) {
+        bench.eyeBlink = CubismEyeBlink::Create(bench.setting);
+    }
+
+    CubismIdManager *ids = CubismFramework::GetIdManager();
+    csmVector<CubismBreath::BreathParameterData> breathParameters;
+    breathParameters.PushBack(CubismBreath::BreathParameterData(ids->GetId(ParamAngleX), 0.0f, 15.0f, 6.5345f, 0.5f));
+    breathParameters.PushBack(CubismBreath::BreathParameterData(ids->GetId(ParamAngleY), 0.0f, 8.0f, 3.5345f, 0.5f));
+    breathParameters.PushBack(CubismBreath::BreathParameterData(ids->GetId(ParamAngleZ), 0.0f, 10.0f, 5.5345f, 0.5f));
+    breathParameters.PushBack(CubismBreath::BreathParameterData(ids->GetId(ParamBodyAngleX), 0.0f, 4.0f, 15.5345f, 0.5f));
+    breathParameters.PushBack(CubismBreath::BreathParameterData(ids->GetId(ParamBreath), 0.5f, 0.5f, 3.2345f, 0.5f));
+    bench.breath = CubismBreath::Create();
+    bench.breath->SetParameters(breathParameters);
+
+    const csmChar *dragNames[6] = {ParamAngleX, ParamAngleY, ParamAngleZ, ParamBodyAngleX, ParamEyeBallX, ParamEyeBallY};
+    for (int i = 0; i < 6; i++) {
+        bench.dragIds[i] = ids->GetId(dragNames[i]);
+    }
+    for (csmInt32 i = 0; i < bench.setting->GetLipSyncParameterCount(); i++) {
+        bench.lipSyncIds.PushBack(bench.setting->GetLipSyncParameterId(i));
+    }
+
+    for (csmInt32 i = 0; i < bench.setting->GetExpressionCount(); i++) {
+        if (std::shared_ptr<LAppFileView> file = openFile(dir, bench.setting->GetExpressionFileName(i))) {
+            bench.expressions.push_back(CubismExpressionMotion::Create(file->GetData(), file->GetSize()));
+        }
+    }
+
+    csmVector<CubismIdHandle> eyeBlinkIds;
+    for (csmInt32 i = 0; i < bench.setting->GetEyeBlinkParameterCount(); i++) {
+        eyeBlinkIds.PushBack(bench.setting->GetEyeBlinkParameterId(i));
+    }
+    for (csmInt32 g = 0; g < bench.setting->GetMotionGroupCount(); g++) {
+        const csmChar *group = bench.setting->GetMotionGroupName(g);
+        for (csmInt32 i = 0; i < bench.setting->GetMotionCount(group); i++) {
+            std::shared_ptr<LAppFileView> file = openFile(dir, bench.setting->GetMotionFileName(group, i));
+            if (!file) {
+                continue;
+            }
+            CubismMotion *motion = CubismMotion::Create(file->GetData(), file->GetSize());
+            if (motion) {
+                motion->SetEffectIds(eyeBlinkIds, bench.lipSyncIds);
+                bench.motions.push_back(motion);
+            }
+        }
+    }
+
+    bench.model->SaveParameters();
+    return !bench.motions.empty();
+}
+
+// 与 LAppModel::Update(dt) 相同的参数写入顺序；返回参数阶段与 Core 更新阶段各自的耗时(ns)
+void updateFrame(BenchModel &bench, int frame, float dt, qint64 &parameterNs, qint64 &coreNs)
+{
+    CubismModel *model = bench.model;
+    QElapsedTimer timer;
+    timer.start();
+
+    model->LoadParameters();
+    if (bench.motionManager.IsFinished()) {
+        CubismMotion *motion = bench.motions[static_cast<size_t>(frame) % bench.motions.size()];
+        bench.motionManager.StartMotionPriority(motion, false, 1);
+    }
+    const csmBool motionUpdated = bench.motionManager.UpdateMotion(model, dt);
+    model->SaveParameters();
+
+    if (!motionUpdated && bench.eyeBlink) {
+        bench.eyeBlink->UpdateParameters(model, dt);
+    }
+    if (!bench.expressions.empty() && frame % 120 == 0) {
+        ACubismMotion *expression = bench.expressions[static_cast<size_t>(frame / 120) % bench.expressions.size()];
+        bench.expressionManager.StartMotionPriority(expression, false, 3);
+    }
+    bench.expressionManager.UpdateMotion(model, dt);
+
+    const float dragX = sinf(frame * 0.02f);
+    const float dragY = cosf(frame * 0.03f);
+    model->AddParameterValue(bench.dragIds[0], dragX, 30.0f);
+    model->AddParameterValue(bench.dragIds[1], dragY, 30.0f);
+    model->AddParameterValue(bench.dragIds[2], dragX, dragY * -30.0f);
+    model->AddParameterValue(bench.dragIds[3], dragX, 10.0f);
+    model->AddParameterValue(bench.dragIds[4], dragX, 1.0f);
+    model->AddParameterValue(bench.dragIds[5], dragY, 1.0f);
+
+    bench.breath->UpdateParameters(model, dt);
+    if (bench.physics) {
+        bench.physics->Evaluate(model, dt);
+    }
+    const float lipSyncValue = 0.5f + 0.5f * sinf(frame * 0.3f);
+    for (csmUint32 i = 0; i < bench.lipSyncIds.GetSize(); i++) {
+        model->AddParameterValue(bench.lipSyncIds[i], lipSyncValue, 0.8f);
+    }
+    if (bench.pose) {
+        bench.pose->UpdateParameters(model, dt);
+    }
+    parameterNs += timer.nsecsElapsed();
+
+    timer.restart();
+    model->Update();
+    coreNs += timer.nsecsElapsed();
+}
+
+} // namespace
+
+// 模型逐帧更新基准：按 LAppModel::Update 的顺序驱动动作、表情、拖拽、呼吸、物理、口型和姿势，
+// 分别统计参数写入阶段和 Core 更新阶段的耗时，并单独测量按ID查找参数索引的开销
+//   ModelUpdateBench --frames 3000 models/live2d/Haru/Haru.model3.json
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("ModelUpdateBench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Live2D 模型逐帧更新基准");
+    parser.addHelpOption();
+    QCommandLineOption framesOption("frames", "更新帧数", "n", "3000");
+    parser.addOption(framesOption);
+    parser.addPositionalArgument("model3", "model3.json 路径", "[model3]");
+    parser.process(app);
+
+    const int frames = std::max(1, parser.value(framesOption).toInt());
+    const QString model3 = parser.positionalArguments().value(0, "models/live2d/Haru/Haru.model3.json");
+
+    LAppAllocator allocator;
+    CubismFramework::Option option;
+    option.LogFunction = printCubismMessage;
+    option.LoggingLevel = CubismFramework::Option::LogLevel_Warning;
+    CubismFramework::StartUp(&allocator, &option);
+    CubismFramework::Initialize();
+
+    int result = 0;
+    {
+        BenchModel bench;
+        if (!loadModel(model3, bench)) {
+            fprintf(stderr, "Failed to load %s\n", qPrintable(model3));
+            result = 1;
+        } else {
+            const float dt = 1.0f / 60.0f;
+            qint64 parameterNs = 0;
+            qint64 coreNs = 0;
+            // 预热：让动作、表情和物理完成首次绑定
+            for (int f = 0; f < 60; f++) {
+                updateFrame(bench, f, dt, parameterNs, coreNs);
+            }
+            parameterNs = 0;
+            coreNs = 0;
+            for (int f = 0; f < frames; f++) {
+                updateFrame(bench, f, dt, parameterNs, coreNs);
+            }
+
+            // 按ID查找：模型中全部参数ID各查一次
+            const csmInt32 parameterCount = bench.model->GetParameterCount();
+            const csmChar **parameterNames = Live2D::Cubism::Core::csmGetParameterIds(bench.model->GetModel());
+            std::vector<CubismIdHandle> parameterIds;
+            for (csmInt32 i = 0; i < parameterCount; i++) {
+                parameterIds.push_back(CubismFramework::GetIdManager()->GetId(parameterNames[i]));
+            }
+            const int rounds = 2000;
+            csmInt32 checksum = 0;
+            QElapsedTimer timer;
+            timer.start();
+            for (int r = 0; r < rounds; r++) {
+                for (CubismIdHandle id : parameterIds) {
+                    checksum += bench.model->GetParameterIndex(id);
+                }
+            }
+            const double lookupNs = static_cast<double>(timer.nsecsElapsed()) / (rounds * std::max(1, parameterCount));
+
+            fprintf(stdout, "model=%s parameters=%d parts=%d motions=%d expressions=%d frames=%d\n",
+                    qPrintable(QFileInfo(model3).fileName()), parameterCount, bench.model->GetPartCount(),
+                    static_cast<int>(bench.motions.size()), static_cast<int>(bench.expressions.size()), frames);
+            fprintf(stdout, "parameters_us=%.2f core_update_us=%.2f total_us=%.2f per frame\n",
+                    parameterNs / 1e3 / frames, coreNs / 1e3 / frames, (parameterNs + coreNs) / 1e3 / frames);
+            fprintf(stdout, "id_lookup_ns=%.1f (checksum %d)\n", lookupNs, checksum);
+
+            // 最终参数值，用于比较不同实现的结果是否一致
+            double parameterSum = 0.0;
+            for (csmInt32 i = 0; i < parameterCount; i++) {
+                parameterSum += bench.model->GetParameterValue(i) * (i + 1);
+            }
+            fprintf(stdout, "parameter_checksum=%.6f\n", parameterSum);
+        }
+    }
+
+    CubismFramework::Dispose();
+    CubismFramework::CleanUp();
+    return result;
+}
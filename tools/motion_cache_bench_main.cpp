@@ -0,0 +1,148 @@
+#include "LAppAllocator.hpp"
+#include "LAppFileView.hpp"
+#include "LAppMotionCache.hpp"
+#include <CubismFramework.hpp>
+#include <Motion/CubismMotion.hpp>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QDebug>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+using namespace Csm;
+
+namespace {
+
+void printCubismMessage(const char *message)
+{
+    fprintf(stderr, "%s", message);
+}
+
+// 解析结果与缓存结果序列化后逐字节比较，确认两条路径得到同样的曲线
+bool sameMotion(CubismMotion *a, CubismMotion *b)
+{
+    csmVector<csmByte> left;
+    csmVector<csmByte> right;
+    a->SerializeBinary(left);
+    b->SerializeBinary(right);
+    return left.GetSize() == right.GetSize()
+        && memcmp(left.GetPtr(), right.GetPtr(), left.GetSize()) == 0;
+}
+
+} // namespace
+
+// 动作二进制缓存基准：比较 motion3.json 解析与缓存命中（映射+拷贝）的耗时
+//   MotionCacheBench --iterations 50 models/live2d
+// 缓存写入临时目录，不影响应用自身的缓存
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("MotionCacheBench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Live2D 动作二进制缓存基准");
+    parser.addHelpOption();
+    QCommandLineOption iterationsOption("iterations", "每个动作加载次数", "n", "20");
+    parser.addOption(iterationsOption);
+    parser.addPositionalArgument("root", "模型根目录，递归查找其中的 *.motion3.json", "[root]");
+    parser.process(app);
+
+    const int iterations = std::max(1, parser.value(iterationsOption).toInt());
+    const QString root = parser.positionalArguments().value(0, "models/live2d");
+
+    QStringList files;
+    QDirIterator it(root, {"*.motion3.json"}, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        files << it.next();
+    }
+    files.sort();
+    if (files.isEmpty()) {
+        fprintf(stderr, "No motion3.json files under %s\n", qPrintable(root));
+        return 1;
+    }
+
+    QTemporaryDir cacheDir;
+    if (!cacheDir.isValid()) {
+        fprintf(stderr, "Cannot create temporary cache directory\n");
+        return 1;
+    }
+    LAppMotionCache::SetCacheDirectory(cacheDir.path().toUtf8().toStdString());
+
+    LAppAllocator allocator;
+    CubismFramework::Option option;
+    option.LogFunction = printCubismMessage;
+    option.LoggingLevel = CubismFramework::Option::LogLevel_Warning;
+    CubismFramework::StartUp(&allocator, &option);
+    CubismFramework::Initialize();
+
+    fprintf(stdout, "iterations=%d motions=%d\n", iterations, static_cast<int>(files.size()));
+    fprintf(stdout, "%-40s %8s %8s %10s %10s %8s\n", "motion", "json", "cache", "parse_us", "hit_us", "speedup");
+
+    double parseTotalUs = 0.0;
+    double hitTotalUs = 0.0;
+    int failures = 0;
+    for (const QString &path : std::as_const(files)) {
+        std::shared_ptr<LAppFileView> json = LAppFileView::Open(path.toUtf8().toStdString());
+        if (!json) {
+            fprintf(stderr, "Failed to open %s\n", qPrintable(path));
+            failures++;
+            continue;
+        }
+
+        // 解析路径：与未启用缓存时的 LoadMotion 相同
+        double parseUs = 1e12;
+        LAppMotionCache::SetEnabled(false);
+        for (int i = 0; i < iterations; i++) {
+            QElapsedTimer timer;
+            timer.start();
+            CubismMotion *motion = LAppMotionCache::CreateMotion(json->GetData(), json->GetSize());
+            parseUs = std::min(parseUs, timer.nsecsElapsed() / 1e3);
+            ACubismMotion::Delete(motion);
+        }
+
+        // 首次加载写入缓存，之后每次都是命中（含内容哈希、打开映射和反序列化）
+        LAppMotionCache::SetEnabled(true);
+        CubismMotion *reference = LAppMotionCache::CreateMotion(json->GetData(), json->GetSize());
+        double hitUs = 1e12;
+        bool identical = reference != NULL;
+        const uint32_t hitsBefore = LAppMotionCache::GetHitCount();
+        for (int i = 0; i < iterations && identical; i++) {
+            QElapsedTimer timer;
+            timer.start();
+            CubismMotion *motion = LAppMotionCache::CreateMotion(json->GetData(), json->GetSize());
+            hitUs = std::min(hitUs, timer.nsecsElapsed() / 1e3);
+            identical = motion != NULL && sameMotion(reference, motion);
+            ACubismMotion::Delete(motion);
+        }
+        identical = identical && LAppMotionCache::GetHitCount() - hitsBefore == static_cast<uint32_t>(iterations);
+        if (reference) {
+            ACubismMotion::Delete(reference);
+        }
+        if (!identical) {
+            fprintf(stderr, "Cache mismatch for %s\n", qPrintable(path));
+            failures++;
+            continue;
+        }
+
+        const QFileInfo cacheFile(QString::fromStdString(LAppMotionCache::GetCachePath(json->GetData(), json->GetSize())));
+        const QString name = QDir(root).relativeFilePath(path);
+        fprintf(stdout, "%-40s %8lld %8lld %10.1f %10.1f %7.1fx\n", qPrintable(name.right(40)),
+                static_cast<long long>(json->GetSize()), static_cast<long long>(cacheFile.size()),
+                parseUs, hitUs, parseUs / hitUs);
+        parseTotalUs += parseUs;
+        hitTotalUs += hitUs;
+    }
+
+    fprintf(stdout, "total: parse %.2f ms, cache hit %.2f ms (%.1fx)\n",
+            parseTotalUs / 1e3, hitTotalUs / 1e3, hitTotalUs > 0.0 ? parseTotalUs / hitTotalUs : 0.0);
+
+    CubismFramework::Dispose();
+    CubismFramework::CleanUp();
+    return failures == 0 ? 0 : 1;
+}
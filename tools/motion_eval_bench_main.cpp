@@ -0,0 +1,194 @@
+#include "LAppAllocator.hpp"
+#include "LAppFileView.hpp"
+#include <CubismFramework.hpp>
+#include <CubismModelSettingJson.hpp>
+#include <Model/CubismMoc.hpp>
+#include <Model/CubismModel.hpp>
+#include <Motion/CubismMotion.hpp>
+#include <Motion/CubismMotionManager.hpp>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Csm;
+
+namespace {
+
+struct MotionCase {
+    std::string name;
+    CubismMotion *motion = nullptr;
+};
+
+void printCubismMessage(const char *message)
+{
+    fprintf(stderr, "%s", message);
+}
+
+void appendFloat(std::string &out, float value)
+{
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.4f,", value);
+    out += buffer;
+}
+
+// 为模型的每个参数生成一条由 segmentCount 段贝塞尔组成的循环曲线，模拟关键帧很密的长待机动作
+std::string buildDenseMotionJson(CubismModel *model, int segmentCount)
+{
+    const float keyInterval = 1.0f / 30.0f;
+    const float duration = segmentCount * keyInterval;
+    const csmInt32 parameterCount = model->GetParameterCount();
+    const csmChar **parameterIds = Live2D::Cubism::Core::csmGetParameterIds(model->GetModel());
+
+    std::string json = "{\"Version\":3,\"Meta\":{";
+    json += "\"Duration\":" + std::to_string(duration) + ",\"Fps\":30.0,\"Loop\":true,\"AreBeziersRestricted\":false,";
+    json += "\"CurveCount\":" + std::to_string(parameterCount) + ",";
+    json += "\"TotalSegmentCount\":" + std::to_string(parameterCount * segmentCount) + ",";
+    json += "\"TotalPointCount\":" + std::to_string(parameterCount * (segmentCount * 3 + 1)) + ",";
+    json += "\"UserDataCount\":0,\"TotalUserDataSize\":0},\"Curves\":[";
+
+    for (csmInt32 p = 0; p < parameterCount; p++) {
+        const float minimum = model->GetParameterMinimumValue(p);
+        const float maximum = model->GetParameterMaximumValue(p);
+        auto valueAt = [&](int key) {
+            return minimum + (maximum - minimum) * (0.5f + 0.5f * std::sin(key * 0.21f + p));
+        };
+
+        json += std::string(p == 0 ? "" : ",") + "{\"Target\":\"Parameter\",\"Id\":\"" + parameterIds[p] + "\",\"Segments\":[";
+        std::string segments;
+        appendFloat(segments, 0.0f);
+        appendFloat(segments, valueAt(0));
+        for (int s = 0; s < segmentCount; s++) {
+            const float t0 = s * keyInterval;
+            const float v0 = valueAt(s);
+            const float v1 = valueAt(s + 1);
+            segments += "1,";
+            appendFloat(segments, t0 + keyInterval / 3.0f);
+            appendFloat(segments, v0);
+            appendFloat(segments, t0 + keyInterval * 2.0f / 3.0f);
+            appendFloat(segments, v1);
+            appendFloat(segments, (s + 1) * keyInterval);
+            appendFloat(segments, v1);
+        }
+        segments.pop_back();
+        json += segments + "]}";
+    }
+    json += "]}";
+    return json;
+}
+
+} // namespace
+
+// 动作曲线求值基准：依次循环播放模型自带的动作和一条关键帧很密的合成动作，只计 CubismMotionManager::UpdateMotion
+// 的耗时（不含 Core 更新），并输出每帧参数值累加的校验和，用于比较实现前后结果是否一致
+//   MotionEvalBench --frames 3000 --segments 2000 models/live2d/Haru/Haru.model3.json
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("MotionEvalBench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Live2D 动作曲线求值基准");
+    parser.addHelpOption();
+    QCommandLineOption framesOption("frames", "每个动作的更新帧数", "n", "3000");
+    QCommandLineOption segmentsOption("segments", "合成动作每条曲线的段数", "n", "2000");
+    parser.addOption(framesOption);
+    parser.addOption(segmentsOption);
+    parser.addPositionalArgument("model3", "model3.json 路径", "[model3]");
+    parser.process(app);
+
+    const int frames = std::max(1, parser.value(framesOption).toInt());
+    const int segmentCount = std::max(1, parser.value(segmentsOption).toInt());
+    const QString model3 = parser.positionalArguments().value(0, "models/live2d/Haru/Haru.model3.json");
+
+    LAppAllocator allocator;
+    CubismFramework::Option option;
+    option.LogFunction = printCubismMessage;
+    option.LoggingLevel = CubismFramework::Option::LogLevel_Warning;
+    CubismFramework::StartUp(&allocator, &option);
+    CubismFramework::Initialize();
+
+    int result = 0;
+    {
+        const QDir dir = QFileInfo(model3).absoluteDir();
+        std::shared_ptr<LAppFileView> settingFile = LAppFileView::Open(model3.toUtf8().toStdString());
+        CubismModelSettingJson *setting = settingFile ? new CubismModelSettingJson(settingFile->GetData(), settingFile->GetSize()) : nullptr;
+        std::shared_ptr<LAppFileView> mocFile;
+        if (setting) {
+            mocFile = LAppFileView::Open(dir.filePath(QString::fromUtf8(setting->GetModelFileName())).toUtf8().toStdString());
+        }
+        CubismMoc *moc = mocFile ? CubismMoc::Create(mocFile->GetData(), mocFile->GetSize()) : nullptr;
+
+        if (!moc) {
+            fprintf(stderr, "Failed to load %s\n", qPrintable(model3));
+            result = 1;
+        } else {
+            CubismModel *model = moc->CreateModel();
+
+            std::vector<MotionCase> cases;
+            for (csmInt32 g = 0; g < setting->GetMotionGroupCount(); g++) {
+                const csmChar *group = setting->GetMotionGroupName(g);
+                for (csmInt32 i = 0; i < setting->GetMotionCount(group); i++) {
+                    const csmChar *fileName = setting->GetMotionFileName(group, i);
+                    std::shared_ptr<LAppFileView> file = LAppFileView::Open(dir.filePath(QString::fromUtf8(fileName)).toUtf8().toStdString());
+                    if (!file) {
+                        continue;
+                    }
+                    MotionCase entry;
+                    entry.name = fileName;
+                    entry.motion = CubismMotion::Create(file->GetData(), file->GetSize());
+                    if (entry.motion) {
+                        cases.push_back(entry);
+                    }
+                }
+            }
+
+            const std::string dense = buildDenseMotionJson(model, segmentCount);
+            MotionCase denseCase;
+            denseCase.name = "dense(" + std::to_string(segmentCount) + " segments/curve)";
+            denseCase.motion = CubismMotion::Create(reinterpret_cast<const csmByte *>(dense.data()), dense.size());
+            cases.push_back(denseCase);
+
+            const float dt = 1.0f / 60.0f;
+            const csmInt32 parameterCount = model->GetParameterCount();
+            double checksum = 0.0;
+            for (MotionCase &entry : cases) {
+                entry.motion->IsLoop(true);
+
+                CubismMotionManager manager;
+                manager.StartMotionPriority(entry.motion, false, 1);
+                qint64 evalNs = 0;
+                QElapsedTimer timer;
+                for (int f = 0; f < frames; f++) {
+                    timer.start();
+                    manager.UpdateMotion(model, dt);
+                    evalNs += timer.nsecsElapsed();
+
+                    for (csmInt32 i = 0; i < parameterCount; i++) {
+                        checksum += model->GetParameterValue(i) * (i + 1);
+                    }
+                }
+                fprintf(stdout, "motion=%s eval_us=%.2f per frame\n", entry.name.c_str(), evalNs / 1e3 / frames);
+            }
+            fprintf(stdout, "frames=%d parameter_checksum=%.6f\n", frames, checksum);
+
+            for (MotionCase &entry : cases) {
+                ACubismMotion::Delete(entry.motion);
+            }
+            moc->DeleteModel(model);
+            CubismMoc::Delete(moc);
+        }
+        delete setting;
+    }
+
+    CubismFramework::Dispose();
+    CubismFramework::CleanUp();
+    return result;
+}
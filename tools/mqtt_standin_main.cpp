@@ -0,0 +1,78 @@
+#include "MqttBrokerStub.h"
+#include "UdpEchoServer.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QJsonDocument>
+#include <QTimer>
+#include <QDebug>
+
+// 本地MQTT broker桩 + UDP回显服务，离线测试MQTT+UDP传输
+// 示例: XiaozhiMqttStandIn --mqtt-port 1883 --udp-port 8884 --loss 0.05 --delay 40 --jitter 20
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("XiaozhiMqttStandIn");
+    app.setApplicationVersion("1.0.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("小智MQTT+UDP传输本地替身（broker桩 + UDP回显）");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption bindOption("bind", "监听地址", "address", "127.0.0.1");
+    QCommandLineOption mqttPortOption("mqtt-port", "MQTT监听端口", "port", "1883");
+    QCommandLineOption udpPortOption("udp-port", "UDP回显端口", "port", "8884");
+    QCommandLineOption topicOption("server-topic", "客户端上行主题(publish_topic)", "topic", "device-server");
+    QCommandLineOption noRespondOption("no-respond", "只做broker转发，不代替服务端回复hello");
+    QCommandLineOption lossOption("loss", "UDP回显丢包概率(0-1)", "rate", "0");
+    QCommandLineOption delayOption("delay", "UDP回显固定时延(ms)", "ms", "0");
+    QCommandLineOption jitterOption("jitter", "UDP回显随机时延上限(ms)", "ms", "0");
+    QCommandLineOption seedOption("seed", "随机种子（复现丢包/抖动）", "seed", "0");
+    QCommandLineOption clientIdOption("client-id", "打印MQTT_INFO示例时使用的client_id", "id", "standin-client");
+    QCommandLineOption statsOption("stats-interval", "统计输出间隔(秒)，0关闭", "seconds", "5");
+    parser.addOptions({bindOption, mqttPortOption, udpPortOption, topicOption, noRespondOption, lossOption,
+                       delayOption, jitterOption, seedOption, clientIdOption, statsOption});
+    parser.process(app);
+
+    const QHostAddress bindAddress(parser.value(bindOption));
+
+    UdpEchoOptions udpOptions;
+    udpOptions.bindAddress = bindAddress;
+    udpOptions.port = static_cast<quint16>(parser.value(udpPortOption).toUInt());
+    udpOptions.lossRate = parser.value(lossOption).toDouble();
+    udpOptions.delayMs = parser.value(delayOption).toInt();
+    udpOptions.jitterMs = parser.value(jitterOption).toInt();
+    udpOptions.seed = parser.value(seedOption).toUInt();
+
+    UdpEchoServer echoServer(udpOptions);
+    if (!echoServer.start()) {
+        return 1;
+    }
+
+    MqttBrokerOptions brokerOptions;
+    brokerOptions.bindAddress = bindAddress;
+    brokerOptions.port = static_cast<quint16>(parser.value(mqttPortOption).toUInt());
+    brokerOptions.serverTopic = parser.value(topicOption);
+    brokerOptions.respondAsServer = !parser.isSet(noRespondOption);
+    brokerOptions.udpServer = bindAddress.toString();
+    brokerOptions.udpPort = echoServer.serverPort();
+
+    MqttBrokerStub broker(brokerOptions);
+    if (!broker.start()) {
+        return 1;
+    }
+
+    qInfo().noquote() << "将以下内容写入 SYSTEM_OPTIONS.NETWORK.MQTT_INFO，并设置 TRANSPORT 为 mqtt_udp:";
+    qInfo().noquote() << QJsonDocument(broker.mqttInfoFor(parser.value(clientIdOption))).toJson(QJsonDocument::Indented);
+
+    const int statsInterval = parser.value(statsOption).toInt();
+    QTimer statsTimer;
+    if (statsInterval > 0) {
+        QObject::connect(&statsTimer, &QTimer::timeout, [&broker, &echoServer]() {
+            qInfo().noquote() << broker.statsSummary() << "|" << echoServer.statsSummary();
+        });
+        statsTimer.start(statsInterval * 1000);
+    }
+
+    return app.exec();
+}